@@ -34,6 +34,7 @@
 #include "gedit-commands-private.h"
 #include "gedit-notebook.h"
 #include "gedit-debug.h"
+#include "gedit-document-private.h"
 #include "gedit-utils.h"
 #include "gedit-enum-types.h"
 #include "gedit-dirs.h"
@@ -1154,6 +1155,7 @@ gedit_app_shutdown (GApplication *app)
 	save_accels ();
 	save_page_setup (GEDIT_APP (app));
 	save_print_settings (GEDIT_APP (app));
+	_gedit_document_flush_all_metadata ();
 
 	G_APPLICATION_CLASS (gedit_app_parent_class)->shutdown (app);
 }
@@ -1287,15 +1289,14 @@ load_print_settings (GeditApp *app)
 static void
 gedit_app_init (GeditApp *app)
 {
-	TeplApplication *tepl_app;
-
 	g_set_application_name ("gedit");
 	gtk_window_set_default_icon_name ("org.gnome.gedit");
 
 	g_application_add_main_option_entries (G_APPLICATION (app), option_entries);
 
-	tepl_app = tepl_application_get_from_gtk_application (GTK_APPLICATION (app));
-	tepl_application_handle_metadata (tepl_app);
+	/* The metadata is handled by GeditMetadataStore, not by the
+	 * TeplMetadataManager.
+	 */
 }
 
 /**
@@ -34,6 +34,7 @@
 #include "gedit-file-chooser-dialog.h"
 #include "gedit-file-chooser-open.h"
 #include "gedit-notebook.h"
+#include "gedit-settings.h"
 #include "gedit-statusbar.h"
 #include "gedit-tab.h"
 #include "gedit-tab-private.h"
@@ -60,46 +61,356 @@ _gedit_cmd_file_new (GSimpleAction *action,
 	gedit_window_create_tab (window, TRUE);
 }
 
-static GeditTab *
-get_tab_from_file (GList *docs,
-		   GFile *file)
+/* Load scheduler.
+ *
+ * When a lot of files are opened at once (from a shell glob for example),
+ * loading them all at the same time makes the UI stall. The tabs are created
+ * directly with a deferred load, and at most max-concurrent-loads files are
+ * read at the same time. The load of the active tab is always started first,
+ * including when the user switches to a tab that is still waiting.
+ *
+ * With the lazy-tab-loading setting, the background tabs are not even queued:
+ * they stay lightweight placeholders until they are shown, or until something
+ * else starts their load with _gedit_tab_start_deferred_load().
+ */
+
+#define GEDIT_LOAD_SCHEDULER_KEY "gedit-load-scheduler"
+
+typedef struct
+{
+	GeditWindow *window;
+
+	/* The tabs waiting to be shown, the tabs waiting their turn, and the
+	 * tabs being loaded. Not owned, a tab is removed when it is destroyed.
+	 */
+	GList *lazy_tabs;
+	GQueue queued_tabs;
+	GList *running_tabs;
+
+	/* For the progress message. Reset when there is nothing left to
+	 * load.
+	 */
+	gint n_scheduled;
+	gint n_finished;
+} LoadScheduler;
+
+static void scheduled_tab_state_notify_cb (GeditTab      *tab,
+					   GParamSpec    *pspec,
+					   LoadScheduler *scheduler);
+static void scheduled_tab_destroy_cb (GeditTab      *tab,
+				      LoadScheduler *scheduler);
+
+static void
+load_scheduler_untrack_tab (LoadScheduler *scheduler,
+			    GeditTab      *tab)
+{
+	g_signal_handlers_disconnect_by_func (tab, scheduled_tab_state_notify_cb, scheduler);
+	g_signal_handlers_disconnect_by_func (tab, scheduled_tab_destroy_cb, scheduler);
+}
+
+static LoadScheduler *get_load_scheduler (GeditWindow *window);
+static void load_scheduler_track_tab (LoadScheduler *scheduler,
+				      GeditTab      *tab);
+static void load_scheduler_run (LoadScheduler *scheduler);
+
+static void
+load_scheduler_free (LoadScheduler *scheduler)
 {
 	GList *l;
 
-	for (l = docs; l != NULL; l = l->next)
+	/* The lazy tabs start their load when they are shown. */
+	for (l = scheduler->lazy_tabs; l != NULL; l = l->next)
 	{
-		GeditDocument *doc;
-		GtkSourceFile *source_file;
-		GFile *location;
+		load_scheduler_untrack_tab (scheduler, l->data);
+	}
 
-		doc = l->data;
-		source_file = gedit_document_get_file (doc);
-		location = gtk_source_file_get_location (source_file);
+	/* The tabs of the window are destroyed before it, the tabs still queued
+	 * have been moved to another window. They are handed to the scheduler
+	 * of that window, or started right away if they are not in a window.
+	 */
+	for (l = scheduler->queued_tabs.head; l != NULL; l = l->next)
+	{
+		GeditTab *tab = l->data;
+		GtkWidget *toplevel;
 
-		if (location != NULL && g_file_equal (location, file))
+		load_scheduler_untrack_tab (scheduler, tab);
+
+		toplevel = gtk_widget_get_toplevel (GTK_WIDGET (tab));
+
+		if (GEDIT_IS_WINDOW (toplevel) &&
+		    toplevel != GTK_WIDGET (scheduler->window) &&
+		    !gtk_widget_in_destruction (toplevel))
+		{
+			LoadScheduler *new_scheduler = get_load_scheduler (GEDIT_WINDOW (toplevel));
+
+			load_scheduler_track_tab (new_scheduler, tab);
+			new_scheduler->n_scheduled++;
+			g_queue_push_tail (&new_scheduler->queued_tabs, tab);
+			load_scheduler_run (new_scheduler);
+		}
+		else
 		{
-			return gedit_tab_get_from_document (doc);
+			_gedit_tab_start_deferred_load (tab);
 		}
 	}
 
-	return NULL;
+	for (l = scheduler->running_tabs; l != NULL; l = l->next)
+	{
+		load_scheduler_untrack_tab (scheduler, l->data);
+	}
+
+	g_list_free (scheduler->lazy_tabs);
+	g_queue_clear (&scheduler->queued_tabs);
+	g_list_free (scheduler->running_tabs);
+	g_free (scheduler);
 }
 
-static gboolean
-is_duplicated_file (GSList *files,
-		    GFile  *file)
+static GSettings *
+get_editor_settings (void)
 {
-	GSList *l;
+	return _gedit_settings_peek_editor_settings (_gedit_settings_get_singleton ());
+}
 
-	for (l = files; l != NULL; l = l->next)
+static guint
+get_max_concurrent_loads (void)
+{
+	return MAX (g_settings_get_uint (get_editor_settings (), GEDIT_SETTINGS_MAX_CONCURRENT_LOADS), 1);
+}
+
+static void
+load_scheduler_report_progress (LoadScheduler *scheduler)
+{
+	GeditStatusbar *statusbar;
+
+	/* For a single file, the "Loading file" message is enough. */
+	if (scheduler->n_scheduled <= 1)
 	{
-		if (g_file_equal (l->data, file))
-		{
-			return TRUE;
-		}
+		return;
 	}
 
-	return FALSE;
+	statusbar = GEDIT_STATUSBAR (gedit_window_get_statusbar (scheduler->window));
+
+	if (scheduler->n_finished < scheduler->n_scheduled)
+	{
+		/* Translators: the first %d is the number of files already
+		 * loaded, the second %d is the total number of files.
+		 */
+		_gedit_statusbar_flash_generic_message (statusbar,
+							_("Loading files: %d of %d done\342\200\246"),
+							scheduler->n_finished,
+							scheduler->n_scheduled);
+	}
+	else
+	{
+		_gedit_statusbar_flash_generic_message (statusbar,
+							ngettext ("Loaded %d file",
+								  "Loaded %d files",
+								  scheduler->n_scheduled),
+							scheduler->n_scheduled);
+	}
+}
+
+/* @tab must not be in the lists anymore. */
+static void
+load_scheduler_start_tab (LoadScheduler *scheduler,
+			  GeditTab      *tab)
+{
+	scheduler->running_tabs = g_list_prepend (scheduler->running_tabs, tab);
+	_gedit_tab_start_deferred_load (tab);
+}
+
+static void
+load_scheduler_remove_lazy_tab (LoadScheduler *scheduler,
+				GeditTab      *tab)
+{
+	GList *link = g_list_find (scheduler->lazy_tabs, tab);
+
+	if (link != NULL)
+	{
+		scheduler->lazy_tabs = g_list_delete_link (scheduler->lazy_tabs, link);
+
+		/* It was not counted until now. */
+		scheduler->n_scheduled++;
+	}
+}
+
+static void
+load_scheduler_run (LoadScheduler *scheduler)
+{
+	guint max_concurrent_loads = get_max_concurrent_loads ();
+
+	while (g_list_length (scheduler->running_tabs) < max_concurrent_loads &&
+	       !g_queue_is_empty (&scheduler->queued_tabs))
+	{
+		load_scheduler_start_tab (scheduler,
+					  g_queue_pop_head (&scheduler->queued_tabs));
+	}
+
+	if (scheduler->running_tabs == NULL)
+	{
+		scheduler->n_scheduled = 0;
+		scheduler->n_finished = 0;
+	}
+}
+
+static void
+load_scheduler_tab_finished (LoadScheduler *scheduler,
+			     GeditTab      *tab)
+{
+	GList *lazy_link;
+
+	load_scheduler_untrack_tab (scheduler, tab);
+
+	lazy_link = g_list_find (scheduler->lazy_tabs, tab);
+
+	if (lazy_link != NULL)
+	{
+		scheduler->lazy_tabs = g_list_delete_link (scheduler->lazy_tabs, lazy_link);
+		return;
+	}
+
+	scheduler->running_tabs = g_list_remove (scheduler->running_tabs, tab);
+	g_queue_remove (&scheduler->queued_tabs, tab);
+	scheduler->n_finished++;
+
+	/* The tabs are destroyed with the window. */
+	if (gtk_widget_in_destruction (GTK_WIDGET (scheduler->window)))
+	{
+		return;
+	}
+
+	load_scheduler_report_progress (scheduler);
+	load_scheduler_run (scheduler);
+}
+
+static void
+scheduled_tab_state_notify_cb (GeditTab      *tab,
+			       GParamSpec    *pspec,
+			       LoadScheduler *scheduler)
+{
+	/* The state is GEDIT_TAB_STATE_LOADING while the tab waits its turn,
+	 * then until the file is loaded or an error occurred.
+	 */
+	if (gedit_tab_get_state (tab) != GEDIT_TAB_STATE_LOADING)
+	{
+		load_scheduler_tab_finished (scheduler, tab);
+		return;
+	}
+
+	/* The load has been started by someone else, for example because the
+	 * content of all the documents is needed.
+	 */
+	if (!_gedit_tab_has_deferred_load (tab) &&
+	    g_list_find (scheduler->running_tabs, tab) == NULL)
+	{
+		load_scheduler_remove_lazy_tab (scheduler, tab);
+		g_queue_remove (&scheduler->queued_tabs, tab);
+		scheduler->running_tabs = g_list_prepend (scheduler->running_tabs, tab);
+	}
+}
+
+static void
+scheduled_tab_destroy_cb (GeditTab      *tab,
+			  LoadScheduler *scheduler)
+{
+	load_scheduler_tab_finished (scheduler, tab);
+}
+
+static void
+active_tab_changed_cb (GeditWindow   *window,
+		       LoadScheduler *scheduler)
+{
+	GeditTab *tab;
+	GList *link;
+
+	tab = gedit_window_get_active_tab (window);
+
+	if (tab == NULL || !_gedit_tab_has_deferred_load (tab))
+	{
+		return;
+	}
+
+	/* Don't wait for a free slot, the user wants to see this file. */
+	load_scheduler_remove_lazy_tab (scheduler, tab);
+
+	link = g_queue_find (&scheduler->queued_tabs, tab);
+	if (link != NULL)
+	{
+		g_queue_delete_link (&scheduler->queued_tabs, link);
+	}
+
+	load_scheduler_start_tab (scheduler, tab);
+}
+
+static LoadScheduler *
+get_load_scheduler (GeditWindow *window)
+{
+	LoadScheduler *scheduler;
+
+	scheduler = g_object_get_data (G_OBJECT (window), GEDIT_LOAD_SCHEDULER_KEY);
+
+	if (scheduler == NULL)
+	{
+		scheduler = g_new0 (LoadScheduler, 1);
+		scheduler->window = window;
+		g_queue_init (&scheduler->queued_tabs);
+
+		g_object_set_data_full (G_OBJECT (window),
+					GEDIT_LOAD_SCHEDULER_KEY,
+					scheduler,
+					(GDestroyNotify) load_scheduler_free);
+
+		g_signal_connect (window,
+				  "active-tab-changed",
+				  G_CALLBACK (active_tab_changed_cb),
+				  scheduler);
+	}
+
+	return scheduler;
+}
+
+static void
+load_scheduler_track_tab (LoadScheduler *scheduler,
+			  GeditTab      *tab)
+{
+	g_signal_connect (tab,
+			  "notify::state",
+			  G_CALLBACK (scheduled_tab_state_notify_cb),
+			  scheduler);
+
+	g_signal_connect (tab,
+			  "destroy",
+			  G_CALLBACK (scheduled_tab_destroy_cb),
+			  scheduler);
+}
+
+/* Call load_scheduler_run() afterwards. */
+static void
+load_scheduler_add (LoadScheduler           *scheduler,
+		    GeditTab                *tab,
+		    GFile                   *location,
+		    const GtkSourceEncoding *encoding,
+		    gint                     line_pos,
+		    gint                     column_pos,
+		    gboolean                 create)
+{
+	_gedit_tab_load_file_deferred (tab, location, encoding, line_pos, column_pos, create);
+	load_scheduler_track_tab (scheduler, tab);
+
+	if (tab == gedit_window_get_active_tab (scheduler->window))
+	{
+		scheduler->n_scheduled++;
+		load_scheduler_start_tab (scheduler, tab);
+	}
+	else if (g_settings_get_boolean (get_editor_settings (), GEDIT_SETTINGS_LAZY_TAB_LOADING))
+	{
+		scheduler->lazy_tabs = g_list_prepend (scheduler->lazy_tabs, tab);
+	}
+	else
+	{
+		scheduler->n_scheduled++;
+		g_queue_push_tail (&scheduler->queued_tabs, tab);
+	}
 }
 
 /* File loading */
@@ -111,7 +422,7 @@ load_file_list (GeditWindow             *window,
 		gint                     column_pos,
 		gboolean                 create)
 {
-	GList *win_docs;
+	GHashTable *seen_files;
 	GSList *files_to_load = NULL;
 	GSList *loaded_files = NULL;
 	GeditTab *tab;
@@ -119,10 +430,11 @@ load_file_list (GeditWindow             *window,
 	const GSList *l;
 	gint num_loaded_files = 0;
 	GeditStatusbar *statusbar;
+	LoadScheduler *scheduler;
 
 	gedit_debug (DEBUG_COMMANDS);
 
-	win_docs = gedit_window_get_documents (window);
+	seen_files = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
 
 	/* Remove the files corresponding to documents already opened in
 	 * "window" and remove duplicates from the "files" list.
@@ -131,12 +443,12 @@ load_file_list (GeditWindow             *window,
 	{
 		GFile *file = l->data;
 
-		if (is_duplicated_file (files_to_load, file))
+		if (!g_hash_table_add (seen_files, file))
 		{
 			continue;
 		}
 
-		tab = get_tab_from_file (win_docs, file);
+		tab = gedit_window_get_tab_from_location (window, file);
 
 		if (tab == NULL)
 		{
@@ -173,7 +485,7 @@ load_file_list (GeditWindow             *window,
 		}
 	}
 
-	g_list_free (win_docs);
+	g_hash_table_unref (seen_files);
 
 	if (files_to_load == NULL)
 	{
@@ -183,6 +495,8 @@ load_file_list (GeditWindow             *window,
 	files_to_load = g_slist_reverse (files_to_load);
 	l = files_to_load;
 
+	scheduler = get_load_scheduler (window);
+
 	tab = gedit_window_get_active_tab (window);
 	if (tab != NULL)
 	{
@@ -193,12 +507,13 @@ load_file_list (GeditWindow             *window,
 		if (tepl_buffer_is_untouched (TEPL_BUFFER (doc)) &&
 		    gedit_tab_get_state (tab) == GEDIT_TAB_STATE_NORMAL)
 		{
-			gedit_tab_load_file (tab,
-					     l->data,
-					     encoding,
-					     line_pos,
-					     column_pos,
-					     create);
+			load_scheduler_add (scheduler,
+					    tab,
+					    l->data,
+					    encoding,
+					    line_pos,
+					    column_pos,
+					    create);
 
 			/* make sure the view has focus */
 			gtk_widget_grab_focus (GTK_WIDGET (gedit_tab_get_view (tab)));
@@ -217,12 +532,13 @@ load_file_list (GeditWindow             *window,
 		g_return_val_if_fail (l->data != NULL, NULL);
 
 		tab = gedit_window_create_tab (window, jump_to);
-		gedit_tab_load_file (tab,
-				     l->data,
-				     encoding,
-				     line_pos,
-				     column_pos,
-				     create);
+		load_scheduler_add (scheduler,
+				    tab,
+				    l->data,
+				    encoding,
+				    line_pos,
+				    column_pos,
+				    create);
 
 		jump_to = FALSE;
 
@@ -235,6 +551,8 @@ load_file_list (GeditWindow             *window,
 
 	loaded_files = g_slist_reverse (loaded_files);
 
+	load_scheduler_run (scheduler);
+
 	statusbar = GEDIT_STATUSBAR (gedit_window_get_statusbar (window));
 
 	if (num_loaded_files == 1)
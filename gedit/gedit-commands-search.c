@@ -163,6 +163,68 @@ finish_search_from_dialog (GeditWindow *window,
 	}
 }
 
+/* Search in a file shown by a GeditFileViewer: only a part of the file is in the
+ * buffer, so the search context cannot be used for moving to the next match.
+ */
+
+static void
+viewer_search_finished_cb (GObject      *source_object,
+			   GAsyncResult *result,
+			   gpointer      user_data)
+{
+	_gedit_file_viewer_search_finish (GEDIT_FILE_VIEWER (source_object), result);
+}
+
+static void
+viewer_search_from_dialog_finished (GeditFileViewer *viewer,
+				    GAsyncResult    *result,
+				    GeditWindow     *window)
+{
+	gboolean found;
+
+	found = _gedit_file_viewer_search_finish (viewer, result);
+
+	if (!g_task_had_error (G_TASK (result)))
+	{
+		finish_search_from_dialog (window, found);
+	}
+}
+
+/* Returns TRUE if the search is handled by a file viewer. */
+static gboolean
+run_viewer_search (GeditWindow                    *window,
+		   GtkSourceSearchContext         *search_context,
+		   GeditFileViewerSearchDirection  direction,
+		   gboolean                        from_dialog)
+{
+	GeditTab *tab;
+	GeditFileViewer *viewer;
+	GtkSourceSearchSettings *search_settings;
+	const gchar *text;
+
+	tab = gedit_window_get_active_tab (window);
+	viewer = tab != NULL ? _gedit_tab_get_file_viewer (tab) : NULL;
+
+	if (viewer == NULL)
+	{
+		return FALSE;
+	}
+
+	search_settings = gtk_source_search_context_get_settings (search_context);
+	text = gtk_source_search_settings_get_search_text (search_settings);
+
+	_gedit_file_viewer_search_async (viewer,
+					 text != NULL ? text : "",
+					 gtk_source_search_settings_get_case_sensitive (search_settings),
+					 direction,
+					 from_dialog ?
+					 (GAsyncReadyCallback) viewer_search_from_dialog_finished :
+					 viewer_search_finished_cb,
+					 from_dialog ? (gpointer) window : NULL);
+
+	return TRUE;
+}
+
 static gboolean
 forward_search_finished (GtkSourceSearchContext *search_context,
 			 GAsyncResult           *result,
@@ -260,6 +322,11 @@ run_forward_search (GeditWindow *window,
 		return;
 	}
 
+	if (run_viewer_search (window, search_context, GEDIT_FILE_VIEWER_SEARCH_FORWARD, from_dialog))
+	{
+		return;
+	}
+
 	gtk_text_buffer_get_selection_bounds (buffer, NULL, &start_at);
 
 	if (from_dialog)
@@ -377,6 +444,11 @@ run_backward_search (GeditWindow *window,
 		return;
 	}
 
+	if (run_viewer_search (window, search_context, GEDIT_FILE_VIEWER_SEARCH_BACKWARD, from_dialog))
+	{
+		return;
+	}
+
 	gtk_text_buffer_get_selection_bounds (buffer, &start_at, NULL);
 
 	if (from_dialog)
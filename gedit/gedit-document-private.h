@@ -51,6 +51,26 @@ gboolean	_gedit_document_get_create				(GeditDocument *doc);
 G_GNUC_INTERNAL
 gboolean	_gedit_document_is_untitled				(GeditDocument       *doc);
 
+G_GNUC_INTERNAL
+void		_gedit_document_set_save_cursor_position		(GeditDocument *doc,
+									 gboolean       save_cursor_position);
+
+G_GNUC_INTERNAL
+GPtrArray *	_gedit_document_peek_documents_for_location		(GFile *location);
+
+G_GNUC_INTERNAL
+void		_gedit_document_flush_all_metadata			(void);
+
+G_GNUC_INTERNAL
+GtkSourceLanguage *
+		_gedit_document_guess_language				(const gchar *basename,
+									 const gchar *content_type);
+
+G_GNUC_INTERNAL
+void		_gedit_document_set_sniffed_info			(GeditDocument     *doc,
+									 const gchar       *content_type,
+									 GtkSourceLanguage *language);
+
 G_END_DECLS
 
 #endif /* GEDIT_DOCUMENT_PRIVATE_H */
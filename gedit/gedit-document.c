@@ -27,6 +27,7 @@
 #include <glib/gi18n.h>
 #include "gedit-settings.h"
 #include "gedit-debug.h"
+#include "gedit-metadata-store.h"
 #include "gedit-utils.h"
 
 /**
@@ -40,6 +41,8 @@
 
 #define NO_LANGUAGE_NAME "_NORMAL_"
 
+#define METADATA_FLUSH_DELAY_MS (2000)
+
 static void	gedit_document_loaded_real	(GeditDocument *doc);
 
 static void	gedit_document_saved_real	(GeditDocument *doc);
@@ -51,8 +54,19 @@ typedef struct
 {
 	GtkSourceFile *file;
 
+	/* The location under which the document is in documents_by_location. */
+	GFile *indexed_location;
+
 	TeplMetadata *metadata;
 
+	/* The keys present in metadata. Key: owned string. */
+	GHashTable *metadata_keys;
+
+	/* The keys changed since the metadata was last written to the
+	 * GeditMetadataStore. Key: owned string.
+	 */
+	GHashTable *dirty_metadata_keys;
+
 	gchar *content_type;
 
 	GDateTime *time_of_last_save_or_load;
@@ -76,6 +90,23 @@ typedef struct
 	 * when opened from the command line).
 	 */
 	guint create : 1;
+
+	/* FALSE when the buffer doesn't contain the file content (yet), the
+	 * cursor position is then meaningless and the one stored in the
+	 * metadata must be kept.
+	 */
+	guint save_cursor_position : 1;
+
+	/* The content type and language have been set from the sniffing stage
+	 * of the file loading, they don't need to be guessed again when the
+	 * document is loaded.
+	 */
+	guint sniffed : 1;
+
+	/* Set while the content type is changed without guessing the
+	 * language again.
+	 */
+	guint ignore_content_type_change : 1;
 } GeditDocumentPrivate;
 
 enum
@@ -99,39 +130,191 @@ enum
 static GParamSpec *properties[N_PROPERTIES];
 static guint document_signals[N_SIGNALS];
 
+/* Index of all the documents of the application by location, to find the
+ * documents of a GFile without comparing it with every document.
+ * Key: owned GFile. Value: owned GPtrArray of unowned GeditDocument's, usually
+ * with only one element.
+ */
+static GHashTable *documents_by_location = NULL;
+
+/* The documents having dirty metadata keys (unowned). Their metadata is
+ * written in one batch METADATA_FLUSH_DELAY_MS after the first change, instead
+ * of at every gedit_document_set_metadata() call.
+ */
+static GHashTable *documents_with_dirty_metadata = NULL;
+static guint metadata_flush_timeout_id = 0;
+
 G_DEFINE_TYPE_WITH_PRIVATE (GeditDocument, gedit_document, TEPL_TYPE_BUFFER)
 
 static void
-load_metadata_from_metadata_manager (GeditDocument *doc)
+location_index_remove (GeditDocument *doc)
+{
+	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
+	GPtrArray *docs;
+
+	if (priv->indexed_location == NULL)
+	{
+		return;
+	}
+
+	docs = g_hash_table_lookup (documents_by_location, priv->indexed_location);
+
+	if (docs != NULL)
+	{
+		g_ptr_array_remove_fast (docs, doc);
+
+		if (docs->len == 0)
+		{
+			g_hash_table_remove (documents_by_location, priv->indexed_location);
+		}
+	}
+
+	g_clear_object (&priv->indexed_location);
+}
+
+static void
+location_index_update (GeditDocument *doc)
 {
 	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
 	GFile *location;
+	GPtrArray *docs;
 
-	location = gtk_source_file_get_location (priv->file);
+	location = priv->file != NULL ? gtk_source_file_get_location (priv->file) : NULL;
 
-	if (location != NULL)
+	if (location != NULL &&
+	    priv->indexed_location != NULL &&
+	    g_file_equal (location, priv->indexed_location))
+	{
+		return;
+	}
+
+	location_index_remove (doc);
+
+	if (location == NULL)
+	{
+		return;
+	}
+
+	if (documents_by_location == NULL)
 	{
-		TeplMetadataManager *manager;
+		documents_by_location = g_hash_table_new_full (g_file_hash,
+							       (GEqualFunc) g_file_equal,
+							       g_object_unref,
+							       (GDestroyNotify) g_ptr_array_unref);
+	}
+
+	docs = g_hash_table_lookup (documents_by_location, location);
 
-		manager = tepl_metadata_manager_get_singleton ();
-		tepl_metadata_manager_copy_from (manager, location, priv->metadata);
+	if (docs == NULL)
+	{
+		docs = g_ptr_array_new ();
+		g_hash_table_insert (documents_by_location, g_object_ref (location), docs);
 	}
+
+	g_ptr_array_add (docs, doc);
+	priv->indexed_location = g_object_ref (location);
 }
 
 static void
-save_metadata_into_metadata_manager (GeditDocument *doc)
+load_metadata_from_store (GeditDocument *doc)
 {
 	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
 	GFile *location;
+	GHashTable *attributes;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
 
 	location = gtk_source_file_get_location (priv->file);
 
-	if (location != NULL)
+	if (location == NULL)
+	{
+		return;
+	}
+
+	attributes = _gedit_metadata_store_lookup (_gedit_metadata_store_get_singleton (), location);
+
+	if (attributes == NULL)
+	{
+		return;
+	}
+
+	g_hash_table_iter_init (&iter, attributes);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		tepl_metadata_set (priv->metadata, key, value);
+		g_hash_table_add (priv->metadata_keys, g_strdup (key));
+	}
+}
+
+/* Writes the dirty metadata keys of @doc for @location. */
+static void
+flush_metadata (GeditDocument *doc,
+		GFile         *location)
+{
+	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
+
+	if (documents_with_dirty_metadata != NULL)
+	{
+		g_hash_table_remove (documents_with_dirty_metadata, doc);
+	}
+
+	if (priv->dirty_metadata_keys == NULL ||
+	    g_hash_table_size (priv->dirty_metadata_keys) == 0)
+	{
+		return;
+	}
+
+	if (location != NULL && priv->metadata != NULL)
+	{
+		GHashTable *attributes;
+		GHashTableIter iter;
+		gpointer key;
+
+		attributes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+		g_hash_table_iter_init (&iter, priv->dirty_metadata_keys);
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+		{
+			g_hash_table_insert (attributes, key, tepl_metadata_get (priv->metadata, key));
+		}
+
+		_gedit_metadata_store_merge (_gedit_metadata_store_get_singleton (), location, attributes);
+		g_hash_table_unref (attributes);
+	}
+
+	g_hash_table_remove_all (priv->dirty_metadata_keys);
+}
+
+static gboolean
+metadata_flush_timeout_cb (gpointer user_data)
+{
+	metadata_flush_timeout_id = 0;
+	_gedit_document_flush_all_metadata ();
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+mark_metadata_key_dirty (GeditDocument *doc,
+			 const gchar   *key)
+{
+	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
+
+	g_hash_table_add (priv->dirty_metadata_keys, g_strdup (key));
+
+	if (documents_with_dirty_metadata == NULL)
 	{
-		TeplMetadataManager *manager;
+		documents_with_dirty_metadata = g_hash_table_new (NULL, NULL);
+	}
 
-		manager = tepl_metadata_manager_get_singleton ();
-		tepl_metadata_manager_merge_into (manager, location, priv->metadata);
+	g_hash_table_add (documents_with_dirty_metadata, doc);
+
+	if (metadata_flush_timeout_id == 0)
+	{
+		metadata_flush_timeout_id = g_timeout_add (METADATA_FLUSH_DELAY_MS,
+							   metadata_flush_timeout_cb,
+							   NULL);
 	}
 }
 
@@ -170,6 +353,18 @@ save_metadata (GeditDocument *doc)
 		language = get_language_string (doc);
 	}
 
+	if (!priv->save_cursor_position)
+	{
+		if (language != NULL)
+		{
+			gedit_document_set_metadata (doc,
+						     GEDIT_METADATA_ATTRIBUTE_LANGUAGE, language,
+						     NULL);
+		}
+
+		return;
+	}
+
 	gtk_text_buffer_get_iter_at_mark (GTK_TEXT_BUFFER (doc),
 					  &iter,
 					  gtk_text_buffer_get_insert (GTK_TEXT_BUFFER (doc)));
@@ -201,6 +396,8 @@ gedit_document_dispose (GObject *object)
 
 	gedit_debug (DEBUG_DOCUMENT);
 
+	location_index_remove (doc);
+
 	if (priv->settings_binding_group != NULL)
 	{
 		tepl_settings_binding_group_unbind (priv->settings_binding_group, object);
@@ -214,11 +411,15 @@ gedit_document_dispose (GObject *object)
 	if (priv->metadata != NULL)
 	{
 		save_metadata (doc);
+		flush_metadata (doc, gtk_source_file_get_location (priv->file));
 
 		g_object_unref (priv->metadata);
 		priv->metadata = NULL;
 	}
 
+	g_clear_pointer (&priv->metadata_keys, g_hash_table_unref);
+	g_clear_pointer (&priv->dirty_metadata_keys, g_hash_table_unref);
+
 	g_clear_object (&priv->file);
 	g_clear_object (&priv->search_context);
 
@@ -325,6 +526,11 @@ gedit_document_class_init (GeditDocumentClass *klass)
 	klass->loaded = gedit_document_loaded_real;
 	klass->saved = gedit_document_saved_real;
 
+	g_signal_connect (gtk_source_language_manager_get_default (),
+			  "notify::search-path",
+			  G_CALLBACK (language_cache_clear),
+			  NULL);
+
 	/**
 	 * GeditDocument:content-type:
 	 *
@@ -502,30 +708,249 @@ save_encoding_metadata (GeditDocument *doc)
 				     NULL);
 }
 
-static GtkSourceLanguage *
-guess_language (GeditDocument *doc)
+/* Cache of the gtk_source_language_manager_guess_language() results, which
+ * compare the file name and content type with the globs and mime types of
+ * every language.
+ *
+ * The key is the content type and the part of the file name starting at the
+ * first dot: the globs starting with "*." only depend on it. The file names
+ * matching another kind of glob (like "Makefile" or "CMakeLists.txt") are
+ * taken entirely.
+ *
+ * The cache is also used by the sniffing stage of the file loading, in a
+ * worker thread, hence the mutex.
+ */
+#define LANGUAGE_CACHE_SIZE (64)
+
+typedef struct
 {
-	GeditDocumentPrivate *priv;
-	gchar *data;
-	GtkSourceLanguageManager *manager = gtk_source_language_manager_get_default ();
-	GtkSourceLanguage *language = NULL;
+	gchar *key;
 
-	priv = gedit_document_get_instance_private (doc);
+	/* Unowned, nullable. */
+	GtkSourceLanguage *language;
+} LanguageCacheEntry;
 
-	data = gedit_document_get_metadata (doc, GEDIT_METADATA_ATTRIBUTE_LANGUAGE);
+static GMutex language_cache_mutex;
+
+/* Element type: owned LanguageCacheEntry. The most recently used first. */
+static GQueue language_cache = G_QUEUE_INIT;
+
+/* Key: the key of an entry. Value: its GList link in language_cache. */
+static GHashTable *language_cache_links = NULL;
+
+/* Element type: owned GPatternSpec. NULL if not computed. */
+static GPtrArray *language_cache_special_globs = NULL;
+
+static guint language_cache_n_hits = 0;
+static guint language_cache_n_misses = 0;
+
+static void
+language_cache_entry_free (LanguageCacheEntry *entry)
+{
+	g_free (entry->key);
+	g_free (entry);
+}
+
+static void
+language_cache_clear (GtkSourceLanguageManager *manager,
+		      GParamSpec               *pspec,
+		      gpointer                  user_data)
+{
+	g_mutex_lock (&language_cache_mutex);
+
+	gedit_debug_message (DEBUG_DOCUMENT, "Language search path changed, clearing the guess cache");
+
+	if (language_cache_links != NULL)
+	{
+		g_hash_table_remove_all (language_cache_links);
+	}
+
+	g_queue_clear_full (&language_cache, (GDestroyNotify) language_cache_entry_free);
+	g_clear_pointer (&language_cache_special_globs, g_ptr_array_unref);
+
+	g_mutex_unlock (&language_cache_mutex);
+}
+
+static void
+compute_special_globs (GtkSourceLanguageManager *manager)
+{
+	const gchar * const *ids;
+	gint i;
+
+	language_cache_special_globs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_pattern_spec_free);
 
-	if (data != NULL)
+	ids = gtk_source_language_manager_get_language_ids (manager);
+
+	for (i = 0; ids != NULL && ids[i] != NULL; i++)
 	{
-		gedit_debug_message (DEBUG_DOCUMENT, "Language from metadata: %s", data);
+		GtkSourceLanguage *language;
+		gchar **globs;
+		gint j;
+
+		language = gtk_source_language_manager_get_language (manager, ids[i]);
+		globs = gtk_source_language_get_globs (language);
 
-		if (!g_str_equal (data, NO_LANGUAGE_NAME))
+		for (j = 0; globs != NULL && globs[j] != NULL; j++)
 		{
-			language = gtk_source_language_manager_get_language (manager, data);
+			if (!g_str_has_prefix (globs[j], "*."))
+			{
+				g_ptr_array_add (language_cache_special_globs,
+						 g_pattern_spec_new (globs[j]));
+			}
 		}
 
-		g_free (data);
+		g_strfreev (globs);
 	}
-	else
+}
+
+static gchar *
+get_language_cache_key (const gchar *basename,
+			const gchar *content_type)
+{
+	const gchar *name_key = "";
+
+	if (basename != NULL && basename[0] != '\0')
+	{
+		const gchar *dot;
+		guint i;
+
+		/* Not the leading dot of a hidden file. */
+		dot = strchr (basename + 1, '.');
+		name_key = dot != NULL ? dot : basename;
+
+		for (i = 0; i < language_cache_special_globs->len; i++)
+		{
+			if (g_pattern_spec_match_string (g_ptr_array_index (language_cache_special_globs, i),
+							 basename))
+			{
+				name_key = basename;
+				break;
+			}
+		}
+	}
+
+	return g_strconcat (name_key, "\n", content_type != NULL ? content_type : "", NULL);
+}
+
+/*
+ * _gedit_document_guess_language:
+ * @basename: (nullable): the file name.
+ * @content_type: (nullable): the content type.
+ *
+ * Like gtk_source_language_manager_guess_language() with the default language
+ * manager, but with a cache. Can be called from any thread.
+ *
+ * Returns: (transfer none) (nullable): the guessed language.
+ */
+GtkSourceLanguage *
+_gedit_document_guess_language (const gchar *basename,
+				const gchar *content_type)
+{
+	GtkSourceLanguageManager *manager = gtk_source_language_manager_get_default ();
+	GtkSourceLanguage *language;
+	LanguageCacheEntry *entry;
+	GList *link;
+	gchar *key;
+
+	g_mutex_lock (&language_cache_mutex);
+
+	if (language_cache_links == NULL)
+	{
+		language_cache_links = g_hash_table_new (g_str_hash, g_str_equal);
+	}
+
+	if (language_cache_special_globs == NULL)
+	{
+		compute_special_globs (manager);
+	}
+
+	key = get_language_cache_key (basename, content_type);
+	link = g_hash_table_lookup (language_cache_links, key);
+
+	if (link != NULL)
+	{
+		language_cache_n_hits++;
+
+		g_queue_unlink (&language_cache, link);
+		g_queue_push_head_link (&language_cache, link);
+
+		entry = link->data;
+		language = entry->language;
+
+		gedit_debug_message (DEBUG_DOCUMENT,
+				     "Language guess cache hit (%u hits, %u misses)",
+				     language_cache_n_hits,
+				     language_cache_n_misses);
+
+		g_free (key);
+		g_mutex_unlock (&language_cache_mutex);
+		return language;
+	}
+
+	language_cache_n_misses++;
+
+	gedit_debug_message (DEBUG_DOCUMENT,
+			     "Language guess cache miss (%u hits, %u misses)",
+			     language_cache_n_hits,
+			     language_cache_n_misses);
+
+	language = gtk_source_language_manager_guess_language (manager, basename, content_type);
+
+	if (g_queue_get_length (&language_cache) >= LANGUAGE_CACHE_SIZE)
+	{
+		entry = g_queue_pop_tail (&language_cache);
+		g_hash_table_remove (language_cache_links, entry->key);
+		language_cache_entry_free (entry);
+	}
+
+	entry = g_new (LanguageCacheEntry, 1);
+	entry->key = key;
+	entry->language = language;
+
+	g_queue_push_head (&language_cache, entry);
+	g_hash_table_insert (language_cache_links, entry->key, language_cache.head);
+
+	g_mutex_unlock (&language_cache_mutex);
+	return language;
+}
+
+/* Returns FALSE if the language is not stored in the metadata. */
+static gboolean
+get_language_from_metadata (GeditDocument      *doc,
+			    GtkSourceLanguage **language)
+{
+	GtkSourceLanguageManager *manager = gtk_source_language_manager_get_default ();
+	gchar *data;
+
+	*language = NULL;
+
+	data = gedit_document_get_metadata (doc, GEDIT_METADATA_ATTRIBUTE_LANGUAGE);
+
+	if (data == NULL)
+	{
+		return FALSE;
+	}
+
+	gedit_debug_message (DEBUG_DOCUMENT, "Language from metadata: %s", data);
+
+	if (!g_str_equal (data, NO_LANGUAGE_NAME))
+	{
+		*language = gtk_source_language_manager_get_language (manager, data);
+	}
+
+	g_free (data);
+	return TRUE;
+}
+
+static GtkSourceLanguage *
+guess_language (GeditDocument *doc)
+{
+	GeditDocumentPrivate *priv;
+	GtkSourceLanguage *language = NULL;
+
+	priv = gedit_document_get_instance_private (doc);
+
+	if (!get_language_from_metadata (doc, &language))
 	{
 		GFile *location;
 		gchar *basename = NULL;
@@ -538,9 +963,7 @@ guess_language (GeditDocument *doc)
 			basename = g_file_get_basename (location);
 		}
 
-		language = gtk_source_language_manager_guess_language (manager,
-								       basename,
-								       priv->content_type);
+		language = _gedit_document_guess_language (basename, priv->content_type);
 
 		g_free (basename);
 	}
@@ -557,7 +980,8 @@ on_content_type_changed (GeditDocument *doc,
 
 	priv = gedit_document_get_instance_private (doc);
 
-	if (!priv->language_set_by_user)
+	if (!priv->language_set_by_user &&
+	    !priv->ignore_content_type_change)
 	{
 		GtkSourceLanguage *language = guess_language (doc);
 
@@ -579,8 +1003,28 @@ on_location_changed (GtkSourceFile *file,
 		     GParamSpec    *pspec,
 		     GeditDocument *doc)
 {
+	GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
+	GHashTableIter iter;
+	gpointer key;
+
 	gedit_debug (DEBUG_DOCUMENT);
-	load_metadata_from_metadata_manager (doc);
+
+	priv->sniffed = FALSE;
+
+	/* The pending changes belong to the previous location. */
+	flush_metadata (doc, priv->indexed_location);
+
+	/* The current metadata is carried over to the new location, except
+	 * for what is already stored for it.
+	 */
+	g_hash_table_iter_init (&iter, priv->metadata_keys);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+	{
+		mark_metadata_key_dirty (doc, key);
+	}
+
+	location_index_update (doc);
+	load_metadata_from_store (doc);
 }
 
 static void
@@ -596,6 +1040,7 @@ gedit_document_init (GeditDocument *doc)
 	priv->content_type = get_default_content_type ();
 	priv->language_set_by_user = FALSE;
 	priv->empty_search = TRUE;
+	priv->save_cursor_position = TRUE;
 	priv->settings_binding_group = tepl_settings_binding_group_new ();
 
 	update_time_of_last_save_or_load (doc);
@@ -608,6 +1053,8 @@ gedit_document_init (GeditDocument *doc)
 				G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
 
 	priv->metadata = tepl_metadata_new ();
+	priv->metadata_keys = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	priv->dirty_metadata_keys = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
 	g_signal_connect_object (priv->file,
 				 "notify::location",
@@ -853,6 +1300,14 @@ gedit_document_loaded_real (GeditDocument *doc)
 
 	priv = gedit_document_get_instance_private (doc);
 
+	update_time_of_last_save_or_load (doc);
+
+	if (priv->sniffed)
+	{
+		priv->sniffed = FALSE;
+		return;
+	}
+
 	if (!priv->language_set_by_user)
 	{
 		GtkSourceLanguage *language = guess_language (doc);
@@ -863,7 +1318,6 @@ gedit_document_loaded_real (GeditDocument *doc)
 		set_language (doc, language, FALSE);
 	}
 
-	update_time_of_last_save_or_load (doc);
 	set_content_type (doc, NULL);
 
 	location = gtk_source_file_get_location (priv->file);
@@ -1098,11 +1552,11 @@ gedit_document_set_metadata (GeditDocument *doc,
 	{
 		const gchar *value = va_arg (var_args, const gchar *);
 		tepl_metadata_set (priv->metadata, key, value);
+		g_hash_table_add (priv->metadata_keys, g_strdup (key));
+		mark_metadata_key_dirty (doc, key);
 	}
 
 	va_end (var_args);
-
-	save_metadata_into_metadata_manager (doc);
 }
 
 static void
@@ -1307,4 +1761,119 @@ _gedit_document_get_create (GeditDocument *doc)
 	return priv->create;
 }
 
+void
+_gedit_document_set_save_cursor_position (GeditDocument *doc,
+					  gboolean       save_cursor_position)
+{
+	GeditDocumentPrivate *priv;
+
+	g_return_if_fail (GEDIT_IS_DOCUMENT (doc));
+
+	priv = gedit_document_get_instance_private (doc);
+
+	priv->save_cursor_position = save_cursor_position != FALSE;
+}
+
+/*
+ * _gedit_document_peek_documents_for_location:
+ * @location: a #GFile.
+ *
+ * Returns: (transfer none) (nullable) (element-type GeditDocument): the
+ * documents of the application whose location is @location, or %NULL if there
+ * is none. The array must not be modified.
+ */
+GPtrArray *
+_gedit_document_peek_documents_for_location (GFile *location)
+{
+	g_return_val_if_fail (G_IS_FILE (location), NULL);
+
+	if (documents_by_location == NULL)
+	{
+		return NULL;
+	}
+
+	return g_hash_table_lookup (documents_by_location, location);
+}
+
+/*
+ * _gedit_document_flush_all_metadata:
+ *
+ * Writes the pending metadata changes of all the documents, without waiting
+ * for the timeout.
+ */
+void
+_gedit_document_flush_all_metadata (void)
+{
+	GList *docs;
+	GList *l;
+
+	if (metadata_flush_timeout_id != 0)
+	{
+		g_source_remove (metadata_flush_timeout_id);
+		metadata_flush_timeout_id = 0;
+	}
+
+	if (documents_with_dirty_metadata == NULL)
+	{
+		return;
+	}
+
+	docs = g_hash_table_get_keys (documents_with_dirty_metadata);
+
+	for (l = docs; l != NULL; l = l->next)
+	{
+		GeditDocument *doc = l->data;
+		GeditDocumentPrivate *priv = gedit_document_get_instance_private (doc);
+
+		flush_metadata (doc, gtk_source_file_get_location (priv->file));
+	}
+
+	g_list_free (docs);
+}
+
+/*
+ * _gedit_document_set_sniffed_info:
+ * @doc: a #GeditDocument.
+ * @content_type: (nullable): the content type found by the sniffing stage of
+ *   the file loading.
+ * @language: (nullable): the language found by the sniffing stage.
+ *
+ * Sets the content type and the language (unless it is stored in the metadata
+ * or has been chosen by the user) of @doc, before its content is loaded. They
+ * are then not guessed again when the document is loaded.
+ */
+void
+_gedit_document_set_sniffed_info (GeditDocument     *doc,
+				  const gchar       *content_type,
+				  GtkSourceLanguage *language)
+{
+	GeditDocumentPrivate *priv;
+
+	g_return_if_fail (GEDIT_IS_DOCUMENT (doc));
+	g_return_if_fail (language == NULL || GTK_SOURCE_IS_LANGUAGE (language));
+
+	priv = gedit_document_get_instance_private (doc);
+
+	priv->ignore_content_type_change = TRUE;
+	set_content_type (doc, content_type);
+	priv->ignore_content_type_change = FALSE;
+
+	if (!priv->language_set_by_user)
+	{
+		GtkSourceLanguage *metadata_language;
+
+		if (get_language_from_metadata (doc, &metadata_language))
+		{
+			language = metadata_language;
+		}
+
+		gedit_debug_message (DEBUG_DOCUMENT, "Language: %s",
+				     language != NULL ? gtk_source_language_get_name (language) : "None");
+
+		set_language (doc, language, FALSE);
+	}
+
+	priv->sniffed = TRUE;
+}
+
 /* ex:set ts=8 noet: */
@@ -40,12 +40,16 @@ typedef struct _GeditDocumentsGenericRow GeditDocumentsGenericRow;
 typedef struct _GeditDocumentsGenericRow GeditDocumentsGroupRow;
 typedef struct _GeditDocumentsGenericRow GeditDocumentsDocumentRow;
 
-struct _GeditDocumentsGenericRow
-{
-	GtkListBoxRow        parent_instance;
+typedef struct _RowContent RowContent;
 
-	GeditDocumentsPanel *panel;
-	GtkWidget           *ref;
+/* The widgets of a row. A document row only has them while it is in view,
+ * they are taken from a pool when it is scrolled into view and given back
+ * when it is scrolled out, see update_bound_rows().
+ */
+struct _RowContent
+{
+	/* Owned */
+	GtkWidget           *event_box;
 
 	GtkWidget           *box;
 	GtkWidget           *label;
@@ -56,6 +60,24 @@ struct _GeditDocumentsGenericRow
 	GtkWidget           *status_label;
 };
 
+struct _GeditDocumentsGenericRow
+{
+	GtkListBoxRow        parent_instance;
+
+	GeditDocumentsPanel *panel;
+	GtkWidget           *ref;
+
+	/* NULL for a document row out of view */
+	RowContent          *content;
+
+	/* The state of the tab, shown by the content.
+	 * Not used in GeditDocumentsGroupRow */
+	gchar               *name;
+	const gchar         *icon_name;
+	guint                modified : 1;
+	guint                read_only : 1;
+};
+
 #define GEDIT_TYPE_DOCUMENTS_GROUP_ROW            (gedit_documents_group_row_get_type ())
 #define GEDIT_DOCUMENTS_GROUP_ROW(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), GEDIT_TYPE_DOCUMENTS_GROUP_ROW, GeditDocumentsGroupRow))
 #define GEDIT_DOCUMENTS_GROUP_ROW_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  GEDIT_TYPE_DOCUMENTS_GROUP_ROW, GeditDocumentsGroupRowClass))
@@ -118,6 +140,27 @@ struct _GeditDocumentsPanel
 	guint               nb_row_notebook;
 	guint               nb_row_tab;
 
+	/* Key: the GeditTab or the GeditNotebook of the row. Value: owned row. */
+	GHashTable         *rows;
+
+	/* The rows of the removed tabs are kept until the next idle, in case
+	 * the tab is added back, as when it is moved to another notebook.
+	 * Element type: the GeditTab of the row.
+	 */
+	GHashTable         *detached_tabs;
+	guint               detached_idle_id;
+
+	/* Set of the document rows which have a content */
+	GHashTable         *bound_rows;
+
+	/* Element type: owned RowContent, not in use */
+	GPtrArray          *content_pool;
+
+	/* The height of a document row with a content, which the rows
+	 * without one are given so that the list keeps its size */
+	gint                bound_row_height;
+	guint               bind_idle_id;
+
 	GtkTargetList      *source_targets;
 	GtkWidget          *dnd_window;
 	GtkWidget          *row_placeholder;
@@ -150,6 +193,14 @@ static const GtkTargetEntry panel_targets[] = {
 
 #define ROW_OUTSIDE_LISTBOX -1
 
+/* The rows bound before and after the visible ones, for the small scrolls */
+#define BIND_MARGIN 8
+
+#define CONTENT_POOL_MAX_SIZE 32
+
+static RowContent *row_content_new  (gboolean    with_image);
+static void        row_content_free (RowContent *content);
+
 static guint
 get_nb_visible_rows (GeditDocumentsPanel *panel)
 {
@@ -169,40 +220,17 @@ static guint
 get_row_visible_index (GeditDocumentsPanel *panel,
                        GtkWidget           *searched_row)
 {
-	GList *children;
-	GList *l;
-	guint nb_notebook_row = 0;
-	guint nb_tab_row = 0;
+	gint index;
 
-	children = gtk_container_get_children (GTK_CONTAINER (panel->listbox));
+	index = gtk_list_box_row_get_index (GTK_LIST_BOX_ROW (searched_row));
 
-	for (l = children; l != NULL; l = g_list_next (l))
+	/* The group row of a unique notebook is hidden */
+	if (panel->nb_row_notebook == 1 && index > 0)
 	{
-		GtkWidget *row = l->data;
-
-		if (GEDIT_IS_DOCUMENTS_GROUP_ROW (row))
-		{
-			nb_notebook_row += 1;
-		}
-		else
-		{
-			nb_tab_row += 1;
-		}
-
-		if (row == searched_row)
-		{
-			break;
-		}
-	}
-
-	g_list_free (children);
-
-	if (panel->nb_row_notebook == 1)
-	{
-		nb_notebook_row = 0;
+		index -= 1;
 	}
 
-	return nb_tab_row + nb_notebook_row - 1;
+	return MAX (index, 0);
 }
 
 /* We do not grab focus on the row, so scroll it into view manually */
@@ -249,33 +277,23 @@ make_row_visible (GeditDocumentsPanel *panel,
 	gtk_adjustment_set_value (panel->adjustment, new_adjustment_value);
 }
 
-/* This function is a GCompareFunc to use with g_list_find_custom */
-static gint
-listbox_search_function (gconstpointer row,
-                         gconstpointer item)
-{
-	GeditDocumentsGenericRow *generic_row = (GeditDocumentsGenericRow *)row;
-	gpointer *searched_item = (gpointer *)generic_row->ref;
-
-	return searched_item == item ? 0 : -1;
-}
-
+/* Returns the row of a tab or of a notebook, %NULL if it is not in the
+ * listbox.
+ */
 static GtkListBoxRow *
 get_row_from_widget (GeditDocumentsPanel *panel,
                      GtkWidget           *widget)
 {
-	GList *children;
-	GList *item;
-	GtkListBoxRow *row;
-
-	children = gtk_container_get_children (GTK_CONTAINER (panel->listbox));
+	GtkWidget *row;
 
-	item = g_list_find_custom (children, widget, listbox_search_function);
-	row = item ? item->data : NULL;
+	row = g_hash_table_lookup (panel->rows, widget);
 
-	g_list_free (children);
+	if (row == NULL || gtk_widget_get_parent (row) == NULL)
+	{
+		return NULL;
+	}
 
-	return row;
+	return GTK_LIST_BOX_ROW (row);
 }
 
 static void
@@ -332,24 +350,11 @@ select_active_tab (GeditDocumentsPanel *panel)
 static GtkListBoxRow *
 get_first_notebook_found (GeditDocumentsPanel *panel)
 {
-	GList *children;
-	GList *l;
-	GtkListBoxRow *row = NULL;
-
-	children = gtk_container_get_children (GTK_CONTAINER (panel->listbox));
-
-	for (l = children; l != NULL; l = g_list_next (l))
-	{
-		if (GEDIT_IS_DOCUMENTS_GROUP_ROW (l->data))
-		{
-			row = l->data;
-			break;
-		}
-	}
+	GeditNotebook *notebook;
 
-	g_list_free (children);
+	notebook = gedit_multi_notebook_get_nth_notebook (panel->mnb, 0);
 
-	return row;
+	return notebook != NULL ? get_row_from_widget (panel, GTK_WIDGET (notebook)) : NULL;
 }
 
 static void
@@ -396,32 +401,29 @@ group_row_set_notebook_name (GtkWidget *row)
 
 	name = g_strdup_printf (_("Tab Group %i"), num + 1);
 
-	gtk_label_set_text (GTK_LABEL (group_row->label), name);
+	gtk_label_set_text (GTK_LABEL (group_row->content->label), name);
 
 	g_free (name);
 }
 
 static void
-group_row_update_names (GeditDocumentsPanel *panel,
-                        GtkWidget           *listbox)
+group_row_update_name_foreach (GeditNotebook       *notebook,
+                               GeditDocumentsPanel *panel)
 {
-	GList *children;
-	GList *l;
-	GtkWidget *row;
+	GtkListBoxRow *row = get_row_from_widget (panel, GTK_WIDGET (notebook));
 
-	children = gtk_container_get_children (GTK_CONTAINER (listbox));
-
-	for (l = children; l != NULL; l = g_list_next (l))
+	if (row != NULL)
 	{
-		row = l->data;
-
-		if (GEDIT_IS_DOCUMENTS_GROUP_ROW (row))
-		{
-			group_row_set_notebook_name (row);
-		}
+		group_row_set_notebook_name (GTK_WIDGET (row));
 	}
+}
 
-	g_list_free (children);
+static void
+group_row_update_names (GeditDocumentsPanel *panel)
+{
+	gedit_multi_notebook_foreach_notebook (panel->mnb,
+	                                       (GtkCallback)group_row_update_name_foreach,
+	                                       panel);
 }
 
 static void
@@ -433,46 +435,54 @@ group_row_refresh_visibility (GeditDocumentsPanel *panel)
 	notebook_is_unique = gedit_multi_notebook_get_n_notebooks (panel->mnb) <= 1;
 	first_group_row = GTK_WIDGET (get_first_notebook_found (panel));
 
+	if (first_group_row == NULL)
+	{
+		return;
+	}
+
 	gtk_widget_set_no_show_all (first_group_row, notebook_is_unique);
 	gtk_widget_set_visible (first_group_row, !notebook_is_unique);
 }
 
+static gchar *
+document_row_get_markup (GeditDocumentsDocumentRow *document_row)
+{
+	if (document_row->modified)
+	{
+		return g_markup_printf_escaped ("<b>%s</b>", document_row->name);
+	}
+
+	return g_markup_escape_text (document_row->name, -1);
+}
+
 static void
-document_row_sync_tab_name_and_icon (GeditTab   *tab,
-                                     GParamSpec *pspec,
-                                     GtkWidget  *row)
+document_row_update_content (GeditDocumentsDocumentRow *document_row)
 {
-	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
-	GeditDocument *doc;
-	GtkSourceFile *file;
-	gchar *name;
-	const gchar *icon_name;
+	RowContent *content = document_row->content;
 
-	doc = gedit_tab_get_document (tab);
-	name = tepl_file_get_short_name (tepl_buffer_get_file (TEPL_BUFFER (doc)));
+	if (content == NULL)
+	{
+		return;
+	}
 
-	if (!gtk_text_buffer_get_modified (GTK_TEXT_BUFFER (doc)))
+	if (!document_row->modified)
 	{
-		gtk_label_set_text (GTK_LABEL (document_row->label), name);
+		gtk_label_set_text (GTK_LABEL (content->label), document_row->name);
 	}
 	else
 	{
 		gchar *markup;
 
-		markup = g_markup_printf_escaped ("<b>%s</b>", name);
-		gtk_label_set_markup (GTK_LABEL (document_row->label), markup);
+		markup = document_row_get_markup (document_row);
+		gtk_label_set_markup (GTK_LABEL (content->label), markup);
 
 		g_free (markup);
 	}
 
-	g_free (name);
-
-	file = gedit_document_get_file (doc);
-
 	/* The status has as separate label to prevent ellipsizing */
-	if (!gtk_source_file_is_readonly (file))
+	if (!document_row->read_only)
 	{
-		gtk_widget_hide (GTK_WIDGET (document_row->status_label));
+		gtk_widget_hide (GTK_WIDGET (content->status_label));
 	}
 	else
 	{
@@ -480,25 +490,345 @@ document_row_sync_tab_name_and_icon (GeditTab   *tab,
 
 		status = g_strdup_printf ("[%s]", _("Read-Only"));
 
-		gtk_label_set_text (GTK_LABEL (document_row->status_label), status);
-		gtk_widget_show (GTK_WIDGET (document_row->status_label));
+		gtk_label_set_text (GTK_LABEL (content->status_label), status);
+		gtk_widget_show (GTK_WIDGET (content->status_label));
 
 		g_free (status);
 	}
 
 	/* Update header of the row */
-	icon_name = _gedit_tab_get_icon_name (tab);
-
-	if (icon_name != NULL)
+	if (document_row->icon_name != NULL)
 	{
-		gtk_image_set_from_icon_name (GTK_IMAGE (document_row->image),
-					      icon_name,
+		gtk_image_set_from_icon_name (GTK_IMAGE (content->image),
+					      document_row->icon_name,
 					      GTK_ICON_SIZE_MENU);
 	}
 	else
 	{
-		gtk_image_clear (GTK_IMAGE (document_row->image));
+		gtk_image_clear (GTK_IMAGE (content->image));
+	}
+}
+
+static void
+document_row_sync_tab_name_and_icon (GeditTab   *tab,
+                                     GParamSpec *pspec,
+                                     GtkWidget  *row)
+{
+	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
+	GeditDocument *doc;
+
+	doc = gedit_tab_get_document (tab);
+
+	g_free (document_row->name);
+	document_row->name = tepl_file_get_short_name (tepl_buffer_get_file (TEPL_BUFFER (doc)));
+	document_row->modified = gtk_text_buffer_get_modified (GTK_TEXT_BUFFER (doc));
+	document_row->read_only = gtk_source_file_is_readonly (gedit_document_get_file (doc));
+	document_row->icon_name = _gedit_tab_get_icon_name (tab);
+
+	document_row_update_content (document_row);
+}
+
+static void
+document_row_bind (GeditDocumentsPanel *panel,
+                   GtkWidget           *row)
+{
+	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
+
+	if (panel->content_pool->len > 0)
+	{
+		document_row->content = g_ptr_array_steal_index_fast (panel->content_pool,
+		                                                      panel->content_pool->len - 1);
+	}
+	else
+	{
+		document_row->content = row_content_new (TRUE);
+	}
+
+	gtk_container_add (GTK_CONTAINER (row), document_row->content->event_box);
+	gtk_widget_set_size_request (row, -1, -1);
+
+	document_row_update_content (document_row);
+
+	g_hash_table_add (panel->bound_rows, row);
+}
+
+static void
+document_row_unbind (GeditDocumentsPanel *panel,
+                     GtkWidget           *row)
+{
+	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
+	RowContent *content = document_row->content;
+
+	if (content == NULL)
+	{
+		return;
+	}
+
+	document_row->content = NULL;
+	g_hash_table_remove (panel->bound_rows, row);
+
+	gtk_container_remove (GTK_CONTAINER (row), content->event_box);
+
+	if (panel->content_pool->len < CONTENT_POOL_MAX_SIZE)
+	{
+		g_ptr_array_add (panel->content_pool, content);
+	}
+	else
+	{
+		row_content_free (content);
+	}
+
+	if (panel->bound_row_height > 0)
+	{
+		gtk_widget_set_size_request (row, -1, panel->bound_row_height);
+	}
+}
+
+static void
+set_bound_row_height (GeditDocumentsPanel *panel,
+                      gint                 height)
+{
+	GHashTableIter iter;
+	gpointer row;
+
+	if (height <= 0 || height == panel->bound_row_height)
+	{
+		return;
+	}
+
+	panel->bound_row_height = height;
+
+	g_hash_table_iter_init (&iter, panel->rows);
+
+	while (g_hash_table_iter_next (&iter, NULL, &row))
+	{
+		if (GEDIT_IS_DOCUMENTS_DOCUMENT_ROW (row) &&
+		    GEDIT_DOCUMENTS_DOCUMENT_ROW (row)->content == NULL)
+		{
+			gtk_widget_set_size_request (row, -1, height);
+		}
+	}
+}
+
+/* Gives the height of the rows with a content to the rows without one */
+static void
+update_bound_row_height (GeditDocumentsPanel *panel)
+{
+	GHashTableIter iter;
+	gpointer row;
+	gint height = 0;
+
+	g_hash_table_iter_init (&iter, panel->bound_rows);
+
+	while (g_hash_table_iter_next (&iter, &row, NULL))
+	{
+		if (gtk_widget_get_visible (row) &&
+		    gtk_widget_get_allocated_height (row) > 1)
+		{
+			height = gtk_widget_get_allocated_height (row);
+			break;
+		}
+	}
+
+	set_bound_row_height (panel, height);
+}
+
+/* Before any row is allocated, the height of a pooled content is the guess */
+static void
+estimate_bound_row_height (GeditDocumentsPanel *panel)
+{
+	RowContent *content;
+	gint height = 0;
+
+	if (panel->content_pool->len == 0)
+	{
+		g_ptr_array_add (panel->content_pool, row_content_new (TRUE));
+	}
+
+	content = g_ptr_array_index (panel->content_pool, panel->content_pool->len - 1);
+	gtk_widget_get_preferred_height (content->event_box, NULL, &height);
+
+	set_bound_row_height (panel, height);
+}
+
+/* Only the document rows in view, and a few around, have their widgets. */
+static gboolean
+update_bound_rows (GeditDocumentsPanel *panel)
+{
+	GtkListBox *listbox = GTK_LIST_BOX (panel->listbox);
+	GHashTableIter iter;
+	gpointer row;
+	GPtrArray *out_of_view;
+	gint first = 0;
+	gint last = G_MAXINT;
+
+	panel->bind_idle_id = 0;
+
+	if (!gtk_widget_get_mapped (panel->listbox))
+	{
+		return G_SOURCE_REMOVE;
+	}
+
+	update_bound_row_height (panel);
+
+	if (panel->bound_row_height == 0)
+	{
+		estimate_bound_row_height (panel);
+	}
+
+	if (panel->adjustment != NULL)
+	{
+		gdouble value;
+		gdouble page_size;
+		GtkListBoxRow *first_row;
+		GtkListBoxRow *last_row;
+		gint first_in_view = 0;
+
+		value = gtk_adjustment_get_value (panel->adjustment);
+		page_size = gtk_adjustment_get_page_size (panel->adjustment);
+
+		first_row = gtk_list_box_get_row_at_y (listbox, value);
+		last_row = gtk_list_box_get_row_at_y (listbox, value + page_size);
+
+		if (first_row != NULL)
+		{
+			first_in_view = gtk_list_box_row_get_index (first_row);
+		}
+		else if (panel->bound_row_height > 0)
+		{
+			first_in_view = value / panel->bound_row_height;
+		}
+
+		first = MAX (0, first_in_view - BIND_MARGIN);
+
+		if (last_row != NULL)
+		{
+			last = gtk_list_box_row_get_index (last_row) + BIND_MARGIN;
+		}
+		else if (panel->bound_row_height > 0)
+		{
+			/* Past the last row, or not allocated yet: as many rows
+			 * as the page holds, the others get bound on the next
+			 * allocation.
+			 */
+			last = first_in_view + page_size / panel->bound_row_height + 1 + BIND_MARGIN;
+		}
+	}
+
+	out_of_view = g_ptr_array_new ();
+
+	g_hash_table_iter_init (&iter, panel->bound_rows);
+
+	while (g_hash_table_iter_next (&iter, &row, NULL))
+	{
+		gint index = gtk_list_box_row_get_index (row);
+
+		if (index < first || index > last)
+		{
+			g_ptr_array_add (out_of_view, row);
+		}
 	}
+
+	for (guint i = 0; i < out_of_view->len; i++)
+	{
+		document_row_unbind (panel, g_ptr_array_index (out_of_view, i));
+	}
+
+	g_ptr_array_unref (out_of_view);
+
+	for (gint i = first; i <= last; i++)
+	{
+		GtkListBoxRow *list_row = gtk_list_box_get_row_at_index (listbox, i);
+
+		if (list_row == NULL)
+		{
+			break;
+		}
+
+		if (GEDIT_IS_DOCUMENTS_DOCUMENT_ROW (list_row) &&
+		    GEDIT_DOCUMENTS_DOCUMENT_ROW (list_row)->content == NULL)
+		{
+			document_row_bind (panel, GTK_WIDGET (list_row));
+		}
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+queue_update_bound_rows (GeditDocumentsPanel *panel)
+{
+	if (panel->bind_idle_id == 0)
+	{
+		/* After the allocation, before the drawing */
+		panel->bind_idle_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+		                                       (GSourceFunc)update_bound_rows,
+		                                       panel,
+		                                       NULL);
+	}
+}
+
+static void
+document_row_connect (GtkWidget *row)
+{
+	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
+
+	/* The handlers go away with the row if the tab outlives it */
+	g_signal_connect_object (document_row->ref,
+	                         "notify::name",
+	                         G_CALLBACK (document_row_sync_tab_name_and_icon),
+	                         row,
+	                         0);
+	g_signal_connect_object (document_row->ref,
+	                         "notify::state",
+	                         G_CALLBACK (document_row_sync_tab_name_and_icon),
+	                         row,
+	                         0);
+
+	document_row_sync_tab_name_and_icon (GEDIT_TAB (document_row->ref), NULL, row);
+}
+
+static void
+document_row_disconnect (GtkWidget *row)
+{
+	/* Disconnect before destroying it so document_row_sync_tab_name_and_icon()
+	 * doesn't get invalid data */
+	g_signal_handlers_disconnect_by_func (GEDIT_DOCUMENTS_DOCUMENT_ROW (row)->ref,
+	                                      G_CALLBACK (document_row_sync_tab_name_and_icon),
+	                                      row);
+}
+
+static void
+add_row (GeditDocumentsPanel *panel,
+         GtkWidget           *row,
+         gint                 position)
+{
+	GeditDocumentsGenericRow *generic_row = (GeditDocumentsGenericRow *)row;
+
+	g_hash_table_insert (panel->rows, generic_row->ref, g_object_ref_sink (row));
+	insert_row (panel, GTK_LIST_BOX (panel->listbox), row, position);
+}
+
+static void
+forget_row (GeditDocumentsPanel *panel,
+            GtkWidget           *row)
+{
+	GeditDocumentsGenericRow *generic_row = (GeditDocumentsGenericRow *)row;
+
+	if (panel->current_selection == row)
+	{
+		panel->current_selection = NULL;
+	}
+
+	if (panel->drag_document_row == row)
+	{
+		panel->drag_document_row = NULL;
+	}
+
+	gtk_widget_destroy (row);
+
+	/* Drops the last reference */
+	g_hash_table_remove (panel->rows, generic_row->ref);
 }
 
 static void
@@ -515,7 +845,7 @@ refresh_notebook (GeditDocumentsPanel *panel,
 		GtkWidget *row;
 
 		row = gedit_documents_document_row_new (panel, GEDIT_TAB (l->data));
-		insert_row (panel, GTK_LIST_BOX (panel->listbox), row, -1);
+		add_row (panel, row, -1);
 		panel->nb_row_tab += 1;
 	}
 
@@ -529,42 +859,43 @@ refresh_notebook_foreach (GeditNotebook       *notebook,
 	GtkWidget *row;
 
 	row = gedit_documents_group_row_new (panel, notebook);
-	insert_row (panel, GTK_LIST_BOX (panel->listbox), row, -1);
+	add_row (panel, row, -1);
 	panel->nb_row_notebook += 1;
 
 	group_row_refresh_visibility (panel);
 	refresh_notebook (panel, notebook);
 }
 
+/* Builds all the rows. After that, the rows are updated one by one on the
+ * signals of the multi notebook.
+ */
 static void
 refresh_list (GeditDocumentsPanel *panel)
 {
-	GList *children;
-	GList *l;
+	GHashTableIter iter;
+	gpointer row;
 
 	/* Clear the listbox */
-	children = gtk_container_get_children (GTK_CONTAINER (panel->listbox));
+	g_hash_table_iter_init (&iter, panel->rows);
 
-	for (l = children; l != NULL; l = g_list_next (l))
+	while (g_hash_table_iter_next (&iter, NULL, &row))
 	{
-		GeditDocumentsGenericRow *row = l->data;
-
-		if (GEDIT_IS_DOCUMENTS_DOCUMENT_ROW (row))
+		/* The detached rows are already disconnected */
+		if (GEDIT_IS_DOCUMENTS_DOCUMENT_ROW (row) &&
+		    gtk_widget_get_parent (row) != NULL)
 		{
-			GeditTab *tab = GEDIT_TAB (row->ref);
-			g_signal_handlers_disconnect_matched (tab,
-			                                      G_SIGNAL_MATCH_FUNC,
-			                                      0,
-			                                      0,
-			                                      NULL,
-			                                      G_CALLBACK (document_row_sync_tab_name_and_icon),
-			                                      NULL);
+			document_row_disconnect (row);
 		}
 
-		gtk_widget_destroy (GTK_WIDGET (row));
+		gtk_widget_destroy (row);
 	}
 
-	g_list_free (children);
+	g_hash_table_remove_all (panel->rows);
+	g_hash_table_remove_all (panel->detached_tabs);
+
+	panel->current_selection = NULL;
+	panel->nb_row_tab = 0;
+	panel->nb_row_notebook = 0;
 
 	gedit_multi_notebook_foreach_notebook (panel->mnb,
 	                                       (GtkCallback)refresh_notebook_foreach,
@@ -572,6 +903,27 @@ refresh_list (GeditDocumentsPanel *panel)
 	select_active_tab (panel);
 }
 
+static gboolean
+destroy_detached_rows (GeditDocumentsPanel *panel)
+{
+	GHashTableIter iter;
+	gpointer tab;
+
+	panel->detached_idle_id = 0;
+
+	g_hash_table_iter_init (&iter, panel->detached_tabs);
+
+	while (g_hash_table_iter_next (&iter, &tab, NULL))
+	{
+		GtkWidget *row = g_hash_table_lookup (panel->rows, tab);
+
+		g_hash_table_iter_remove (&iter);
+		forget_row (panel, row);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
 static void
 multi_notebook_tab_removed (GeditMultiNotebook  *mnb,
                             GeditNotebook       *notebook,
@@ -584,14 +936,28 @@ multi_notebook_tab_removed (GeditMultiNotebook  *mnb,
 
 	row = get_row_from_widget (panel, GTK_WIDGET (tab));
 
-	/* Disconnect before destroy it so document_row_sync_tab_name_and_icon()
-	 * don't get invalid data */
-	g_signal_handlers_disconnect_by_func (GEDIT_DOCUMENTS_DOCUMENT_ROW (row)->ref,
-	                                      G_CALLBACK (document_row_sync_tab_name_and_icon),
-	                                      row);
+	if (row == NULL)
+	{
+		return;
+	}
 
-	gtk_widget_destroy (GTK_WIDGET (row));
+	document_row_disconnect (GTK_WIDGET (row));
+	document_row_unbind (panel, GTK_WIDGET (row));
+
+	if (panel->current_selection == GTK_WIDGET (row))
+	{
+		panel->current_selection = NULL;
+	}
+
+	/* Keep the row, referenced by the map, for a while */
+	gtk_container_remove (GTK_CONTAINER (panel->listbox), GTK_WIDGET (row));
+	g_hash_table_add (panel->detached_tabs, tab);
 	panel->nb_row_tab -= 1;
+
+	if (panel->detached_idle_id == 0)
+	{
+		panel->detached_idle_id = g_idle_add ((GSourceFunc)destroy_detached_rows, panel);
+	}
 }
 
 static gint
@@ -600,26 +966,21 @@ get_dest_position_for_tab (GeditDocumentsPanel *panel,
                            GeditTab            *tab)
 {
 	gint page_num;
-	GList *children;
-	GList *item;
-	gint res = -1;
+	GtkListBoxRow *notebook_row;
 
 	/* Get tab's position in notebook and notebook's position in GtkListBox
 	 * then return future tab's position in GtkListBox */
 
-	page_num = gtk_notebook_page_num (GTK_NOTEBOOK (notebook), GTK_WIDGET (tab));
-
-	children = gtk_container_get_children (GTK_CONTAINER (panel->listbox));
-	item = g_list_find_custom (children, notebook, listbox_search_function);
+	notebook_row = get_row_from_widget (panel, GTK_WIDGET (notebook));
 
-	if (item)
+	if (notebook_row == NULL)
 	{
-		res = 1 + page_num + g_list_position (children, item);
+		return -1;
 	}
 
-	g_list_free (children);
+	page_num = gtk_notebook_page_num (GTK_NOTEBOOK (notebook), GTK_WIDGET (tab));
 
-	return res;
+	return 1 + page_num + gtk_list_box_row_get_index (notebook_row);
 }
 
 static void
@@ -637,16 +998,24 @@ multi_notebook_tab_added (GeditMultiNotebook  *mnb,
 
 	if (position == -1)
 	{
-		panel->nb_row_tab = 0;
-		panel->nb_row_notebook = 0;
-
 		refresh_list (panel);
 	}
 	else
 	{
-		/* Add a new tab's row to the listbox */
-		row = gedit_documents_document_row_new (panel, tab);
-		insert_row (panel, GTK_LIST_BOX (panel->listbox), row, position);
+		row = g_hash_table_lookup (panel->rows, tab);
+
+		if (row != NULL && g_hash_table_remove (panel->detached_tabs, tab))
+		{
+			/* The tab was moved, put back its row */
+			document_row_connect (row);
+			insert_row (panel, GTK_LIST_BOX (panel->listbox), row, position);
+		}
+		else
+		{
+			/* Add a new tab's row to the listbox */
+			row = gedit_documents_document_row_new (panel, tab);
+			add_row (panel, row, position);
+		}
 
 		panel->nb_row_tab += 1;
 
@@ -657,6 +1026,42 @@ multi_notebook_tab_added (GeditMultiNotebook  *mnb,
 	}
 }
 
+static void
+multi_notebook_notebook_added (GeditMultiNotebook  *mnb,
+                               GeditNotebook       *notebook,
+                               GeditDocumentsPanel *panel)
+{
+	gint num;
+	gint position = -1;
+	GtkWidget *row;
+
+	gedit_debug (DEBUG_PANEL);
+
+	/* Before the group row of the next notebook */
+	num = gedit_multi_notebook_get_notebook_num (panel->mnb, notebook);
+
+	if (num + 1 < gedit_multi_notebook_get_n_notebooks (panel->mnb))
+	{
+		GeditNotebook *next_notebook;
+		GtkListBoxRow *next_row;
+
+		next_notebook = gedit_multi_notebook_get_nth_notebook (panel->mnb, num + 1);
+		next_row = get_row_from_widget (panel, GTK_WIDGET (next_notebook));
+
+		if (next_row != NULL)
+		{
+			position = gtk_list_box_row_get_index (next_row);
+		}
+	}
+
+	row = gedit_documents_group_row_new (panel, notebook);
+	add_row (panel, row, position);
+	panel->nb_row_notebook += 1;
+
+	group_row_refresh_visibility (panel);
+	group_row_update_names (panel);
+}
+
 static void
 multi_notebook_notebook_removed (GeditMultiNotebook  *mnb,
                                  GeditNotebook       *notebook,
@@ -667,12 +1072,15 @@ multi_notebook_notebook_removed (GeditMultiNotebook  *mnb,
 	gedit_debug (DEBUG_PANEL);
 
 	row = get_row_from_widget (panel, GTK_WIDGET (notebook));
-	gtk_container_remove (GTK_CONTAINER (panel->listbox), GTK_WIDGET (row));
 
-	panel->nb_row_notebook -= 1;
+	if (row != NULL)
+	{
+		forget_row (panel, GTK_WIDGET (row));
+		panel->nb_row_notebook -= 1;
+	}
 
 	group_row_refresh_visibility (panel);
-	group_row_update_names (panel, panel->listbox);
+	group_row_update_names (panel);
 }
 
 static void
@@ -709,6 +1117,11 @@ multi_notebook_tabs_reordered (GeditMultiNotebook  *mnb,
 
 	row = get_row_from_widget (panel, GTK_WIDGET (page));
 
+	if (row == NULL)
+	{
+		return;
+	}
+
 	row_move (panel, notebook, page, GTK_WIDGET (row));
 
 	row_select (panel, GTK_LIST_BOX (panel->listbox), GTK_LIST_BOX_ROW (row));
@@ -721,6 +1134,10 @@ set_window (GeditDocumentsPanel *panel,
 	panel->window = g_object_ref (window);
 	panel->mnb = _gedit_window_get_multi_notebook (window);
 
+	g_signal_connect (panel->mnb,
+	                  "notebook-added",
+	                  G_CALLBACK (multi_notebook_notebook_added),
+	                  panel);
 	g_signal_connect (panel->mnb,
 	                  "notebook-removed",
 	                  G_CALLBACK (multi_notebook_notebook_removed),
@@ -838,6 +1255,9 @@ gedit_documents_panel_finalize (GObject *object)
 {
 	GeditDocumentsPanel *panel = GEDIT_DOCUMENTS_PANEL (object);
 
+	g_signal_handlers_disconnect_by_func (panel->mnb,
+	                                      G_CALLBACK (multi_notebook_notebook_added),
+	                                      panel);
 	g_signal_handlers_disconnect_by_func (panel->mnb,
 	                                      G_CALLBACK (multi_notebook_notebook_removed),
 	                                      panel);
@@ -854,6 +1274,21 @@ gedit_documents_panel_finalize (GObject *object)
 	                                      G_CALLBACK (multi_notebook_tab_switched),
 	                                      panel);
 
+	if (panel->detached_idle_id != 0)
+	{
+		g_source_remove (panel->detached_idle_id);
+	}
+
+	if (panel->bind_idle_id != 0)
+	{
+		g_source_remove (panel->bind_idle_id);
+	}
+
+	g_hash_table_destroy (panel->detached_tabs);
+	g_hash_table_destroy (panel->rows);
+	g_hash_table_destroy (panel->bound_rows);
+	g_ptr_array_unref (panel->content_pool);
+
 	G_OBJECT_CLASS (gedit_documents_panel_parent_class)->finalize (object);
 }
 
@@ -864,6 +1299,12 @@ gedit_documents_panel_dispose (GObject *object)
 
 	g_clear_object (&panel->window);
 
+	if (panel->bind_idle_id != 0)
+	{
+		g_source_remove (panel->bind_idle_id);
+		panel->bind_idle_id = 0;
+	}
+
 	if (panel->source_targets)
 	{
 		gtk_target_list_unref (panel->source_targets);
@@ -895,7 +1336,7 @@ panel_on_drag_begin (GtkWidget      *widget,
 	GeditDocumentsPanel *panel = GEDIT_DOCUMENTS_PANEL (widget);
 	GtkWidget *drag_document_row;
 	GtkAllocation allocation;
-	const gchar *name;
+	gchar *markup;
 	GtkWidget *label;
 	gint width, height;
 	GtkWidget *image_box;
@@ -908,10 +1349,11 @@ panel_on_drag_begin (GtkWidget      *widget,
 
 	panel->document_row_height = allocation.height;
 
-	name = gtk_label_get_label (GTK_LABEL (GEDIT_DOCUMENTS_DOCUMENT_ROW (drag_document_row)->label));
+	markup = document_row_get_markup (GEDIT_DOCUMENTS_DOCUMENT_ROW (drag_document_row));
 
 	label = gtk_label_new (NULL);
-	gtk_label_set_markup (GTK_LABEL (label), name);
+	gtk_label_set_markup (GTK_LABEL (label), markup);
+	g_free (markup);
 	gtk_label_set_ellipsize (GTK_LABEL (label), PANGO_ELLIPSIZE_MIDDLE);
 	gtk_widget_set_halign (label, GTK_ALIGN_START);
 	gtk_widget_set_valign (label, GTK_ALIGN_CENTER);
@@ -1385,6 +1827,26 @@ gedit_documents_panel_init (GeditDocumentsPanel *panel)
 
 	panel->adjustment = gtk_list_box_get_adjustment (GTK_LIST_BOX (panel->listbox));
 
+	/* Bind the document rows which come into view */
+	if (panel->adjustment != NULL)
+	{
+		g_signal_connect_object (panel->adjustment,
+		                         "value-changed",
+		                         G_CALLBACK (queue_update_bound_rows),
+		                         panel,
+		                         G_CONNECT_SWAPPED);
+		g_signal_connect_object (panel->adjustment,
+		                         "changed",
+		                         G_CALLBACK (queue_update_bound_rows),
+		                         panel,
+		                         G_CONNECT_SWAPPED);
+	}
+
+	g_signal_connect_swapped (panel->listbox,
+	                          "size-allocate",
+	                          G_CALLBACK (queue_update_bound_rows),
+	                          panel);
+
 	/* Disable focus so it doesn't steal focus each time from the view */
 	gtk_widget_set_can_focus (panel->listbox, FALSE);
 
@@ -1401,6 +1863,18 @@ gedit_documents_panel_init (GeditDocumentsPanel *panel)
 	panel->nb_row_notebook = 0;
 	panel->nb_row_tab = 0;
 
+	panel->rows = g_hash_table_new_full (g_direct_hash,
+	                                     g_direct_equal,
+	                                     NULL,
+	                                     g_object_unref);
+	panel->detached_tabs = g_hash_table_new (g_direct_hash, g_direct_equal);
+	panel->detached_idle_id = 0;
+
+	panel->bound_rows = g_hash_table_new (g_direct_hash, g_direct_equal);
+	panel->content_pool = g_ptr_array_new_with_free_func ((GDestroyNotify) row_content_free);
+	panel->bound_row_height = 0;
+	panel->bind_idle_id = 0;
+
 	/* Drag and drop support */
 	panel->source_targets = gtk_target_list_new (panel_targets, G_N_ELEMENTS (panel_targets));
 	gtk_target_list_add_text_targets (panel->source_targets, 0);
@@ -1433,10 +1907,12 @@ gedit_documents_panel_new (GeditWindow *window)
 	                     NULL);
 }
 
+/* The content of a row is shared, so the row is found from the widget */
 static void
 row_on_close_button_clicked (GtkWidget *close_button,
-                             GtkWidget *row)
+                             gpointer   user_data)
 {
+	GtkWidget *row = gtk_widget_get_ancestor (close_button, GTK_TYPE_LIST_BOX_ROW);
 	GeditDocumentsGenericRow *generic_row = (GeditDocumentsGenericRow *)row;
 	GeditWindow *window = generic_row->panel->window;
 	GtkWidget *ref;
@@ -1460,8 +1936,10 @@ row_on_close_button_clicked (GtkWidget *close_button,
 static gboolean
 row_on_button_pressed (GtkWidget      *row_event_box,
                        GdkEventButton *event,
-                       GtkWidget      *row)
+                       gpointer        user_data)
 {
+	GtkWidget *row = gtk_widget_get_parent (row_event_box);
+
 	if (gdk_event_get_event_type ((GdkEvent *)event) == GDK_BUTTON_PRESS &&
 	    GEDIT_IS_DOCUMENTS_DOCUMENT_ROW (row))
 	{
@@ -1504,9 +1982,8 @@ row_on_button_pressed (GtkWidget      *row_event_box,
 }
 
 static void
-document_row_create_header (GtkWidget *row)
+row_content_create_header (RowContent *content)
 {
-	GeditDocumentsDocumentRow *document_row = GEDIT_DOCUMENTS_DOCUMENT_ROW (row);
 	GtkWidget *image_box;
 	gint width, height;
 
@@ -1515,51 +1992,52 @@ document_row_create_header (GtkWidget *row)
 	image_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
 	gtk_widget_set_size_request (image_box, width, height);
 
-	document_row->image = gtk_image_new ();
+	content->image = gtk_image_new ();
 
-	gtk_container_add (GTK_CONTAINER (image_box), document_row->image);
+	gtk_container_add (GTK_CONTAINER (image_box), content->image);
 
-	gtk_box_pack_start (GTK_BOX (document_row->box),
+	gtk_box_pack_start (GTK_BOX (content->box),
 	                    image_box, FALSE, FALSE, 0);
 
 	/* Set the header on front of all other widget in the row */
-	gtk_box_reorder_child (GTK_BOX (document_row->box),
+	gtk_box_reorder_child (GTK_BOX (content->box),
 	                       image_box, 0);
 
 	gtk_widget_show_all (image_box);
 }
 
-static GtkWidget *
-row_create (GtkWidget *row)
+static RowContent *
+row_content_new (gboolean with_image)
 {
-	GeditDocumentsGenericRow *generic_row = (GeditDocumentsGenericRow *)row;
-	GtkWidget *event_box;
+	RowContent *content;
 	GtkStyleContext *context;
 	GtkWidget *image;
 	GIcon *icon;
 
 	gedit_debug (DEBUG_PANEL);
 
-	event_box = gtk_event_box_new ();
-	generic_row->box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 4);
+	content = g_slice_new0 (RowContent);
 
-	gtk_container_add (GTK_CONTAINER (event_box), generic_row->box);
+	content->event_box = g_object_ref_sink (gtk_event_box_new ());
+	content->box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 4);
 
-	generic_row->label = gtk_label_new (NULL);
-	gtk_label_set_ellipsize (GTK_LABEL (generic_row->label), PANGO_ELLIPSIZE_MIDDLE);
-	gtk_widget_set_halign (generic_row->label, GTK_ALIGN_START);
-	gtk_widget_set_valign (generic_row->label, GTK_ALIGN_CENTER);
+	gtk_container_add (GTK_CONTAINER (content->event_box), content->box);
 
-	generic_row->status_label = gtk_label_new (NULL);
-	gtk_widget_set_halign (generic_row->status_label, GTK_ALIGN_END);
-	gtk_widget_set_valign (generic_row->status_label, GTK_ALIGN_CENTER);
+	content->label = gtk_label_new (NULL);
+	gtk_label_set_ellipsize (GTK_LABEL (content->label), PANGO_ELLIPSIZE_MIDDLE);
+	gtk_widget_set_halign (content->label, GTK_ALIGN_START);
+	gtk_widget_set_valign (content->label, GTK_ALIGN_CENTER);
 
-	generic_row->close_button = GTK_WIDGET (g_object_new (GTK_TYPE_BUTTON,
-	                                                      "relief", GTK_RELIEF_NONE,
-	                                                      "focus-on-click", FALSE,
-	                                                      NULL));
+	content->status_label = gtk_label_new (NULL);
+	gtk_widget_set_halign (content->status_label, GTK_ALIGN_END);
+	gtk_widget_set_valign (content->status_label, GTK_ALIGN_CENTER);
 
-	context = gtk_widget_get_style_context (generic_row->close_button);
+	content->close_button = GTK_WIDGET (g_object_new (GTK_TYPE_BUTTON,
+	                                                  "relief", GTK_RELIEF_NONE,
+	                                                  "focus-on-click", FALSE,
+	                                                  NULL));
+
+	context = gtk_widget_get_style_context (content->close_button);
 	gtk_style_context_add_class (context, "flat");
 	gtk_style_context_add_class (context, "small-button");
 
@@ -1568,29 +2046,43 @@ row_create (GtkWidget *row)
 	gtk_widget_show (image);
 	g_object_unref (icon);
 
-	gtk_container_add (GTK_CONTAINER (generic_row->close_button), image);
+	gtk_container_add (GTK_CONTAINER (content->close_button), image);
 
-	gtk_box_pack_start (GTK_BOX (generic_row->box),
-	                    generic_row->label, FALSE, FALSE, 0);
-	gtk_box_pack_start (GTK_BOX (generic_row->box),
-	                    generic_row->status_label, FALSE, FALSE, 0);
+	gtk_box_pack_start (GTK_BOX (content->box),
+	                    content->label, FALSE, FALSE, 0);
+	gtk_box_pack_start (GTK_BOX (content->box),
+	                    content->status_label, FALSE, FALSE, 0);
 
-	gtk_box_pack_end (GTK_BOX (generic_row->box),
-	                  generic_row->close_button, FALSE, FALSE, 0);
+	gtk_box_pack_end (GTK_BOX (content->box),
+	                  content->close_button, FALSE, FALSE, 0);
 
-	g_signal_connect (event_box,
+	g_signal_connect (content->event_box,
 	                  "button-press-event",
 	                  G_CALLBACK (row_on_button_pressed),
-	                  row);
-	g_signal_connect (generic_row->close_button,
+	                  NULL);
+	g_signal_connect (content->close_button,
 	                  "clicked",
 	                  G_CALLBACK (row_on_close_button_clicked),
-	                  row);
+	                  NULL);
 
-	gtk_widget_set_no_show_all (generic_row->status_label, TRUE);
-	gtk_widget_show_all (event_box);
+	gtk_widget_set_no_show_all (content->status_label, TRUE);
+	gtk_widget_show_all (content->event_box);
 
-	return event_box;
+	if (with_image)
+	{
+		row_content_create_header (content);
+	}
+
+	return content;
+}
+
+static void
+row_content_free (RowContent *content)
+{
+	gtk_widget_destroy (content->event_box);
+	g_object_unref (content->event_box);
+
+	g_slice_free (RowContent, content);
 }
 
 static gboolean
@@ -1617,51 +2109,88 @@ document_row_query_tooltip (GtkWidget   *row,
 }
 
 /* Gedit Document Row */
+static void
+gedit_documents_document_row_dispose (GObject *object)
+{
+	GeditDocumentsDocumentRow *row = GEDIT_DOCUMENTS_DOCUMENT_ROW (object);
+
+	if (row->content != NULL)
+	{
+		g_hash_table_remove (row->panel->bound_rows, row);
+
+		row_content_free (row->content);
+		row->content = NULL;
+	}
+
+	G_OBJECT_CLASS (gedit_documents_document_row_parent_class)->dispose (object);
+}
+
+static void
+gedit_documents_document_row_finalize (GObject *object)
+{
+	GeditDocumentsDocumentRow *row = GEDIT_DOCUMENTS_DOCUMENT_ROW (object);
+
+	g_free (row->name);
+
+	G_OBJECT_CLASS (gedit_documents_document_row_parent_class)->finalize (object);
+}
+
 static void
 gedit_documents_document_row_class_init (GeditDocumentsDocumentRowClass *klass)
 {
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = gedit_documents_document_row_dispose;
+	object_class->finalize = gedit_documents_document_row_finalize;
 }
 
 static void
 gedit_documents_document_row_init (GeditDocumentsDocumentRow *row)
 {
-	GtkWidget *row_widget;
 	GtkStyleContext *context;
 
 	gedit_debug (DEBUG_PANEL);
 
-	row_widget = row_create (GTK_WIDGET (row));
-	gtk_container_add (GTK_CONTAINER (row), row_widget);
-
-	document_row_create_header (GTK_WIDGET (row));
-
+	/* The content is bound when the row comes into view */
 	gtk_widget_set_has_tooltip (GTK_WIDGET (row), TRUE);
 
 	/* Css style */
 	context = gtk_widget_get_style_context (GTK_WIDGET (row));
 	gtk_style_context_add_class (context, "gedit-document-panel-document-row");
 
-	gtk_widget_show_all (GTK_WIDGET (row));
+	gtk_widget_show (GTK_WIDGET (row));
 
 	gtk_widget_set_can_focus (GTK_WIDGET (row), FALSE);
 }
 
 /* Gedit Group Row */
+static void
+gedit_documents_group_row_dispose (GObject *object)
+{
+	GeditDocumentsGroupRow *row = GEDIT_DOCUMENTS_GROUP_ROW (object);
+
+	g_clear_pointer (&row->content, row_content_free);
+
+	G_OBJECT_CLASS (gedit_documents_group_row_parent_class)->dispose (object);
+}
+
 static void
 gedit_documents_group_row_class_init (GeditDocumentsGroupRowClass *klass)
 {
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = gedit_documents_group_row_dispose;
 }
 
 static void
 gedit_documents_group_row_init (GeditDocumentsGroupRow *row)
 {
-	GtkWidget *row_widget;
 	GtkStyleContext *context;
 
 	gedit_debug (DEBUG_PANEL);
 
-	row_widget = row_create (GTK_WIDGET (row));
-	gtk_container_add (GTK_CONTAINER (row), row_widget);
+	row->content = row_content_new (FALSE);
+	gtk_container_add (GTK_CONTAINER (row), row->content->event_box);
 
 	/* Css style */
 	context = gtk_widget_get_style_context (GTK_WIDGET (row));
@@ -1687,20 +2216,17 @@ gedit_documents_document_row_new (GeditDocumentsPanel *panel,
 	row->ref = GTK_WIDGET (tab);
 	row->panel = panel;
 
-	g_signal_connect (row->ref,
-	                  "notify::name",
-	                  G_CALLBACK (document_row_sync_tab_name_and_icon),
-	                  row);
-	g_signal_connect (row->ref,
-	                  "notify::state",
-	                  G_CALLBACK (document_row_sync_tab_name_and_icon),
-	                  row);
 	g_signal_connect (row,
 	                  "query-tooltip",
 	                  G_CALLBACK (document_row_query_tooltip),
 	                  NULL);
 
-	document_row_sync_tab_name_and_icon (GEDIT_TAB (row->ref), NULL, GTK_WIDGET (row));
+	if (panel->bound_row_height > 0)
+	{
+		gtk_widget_set_size_request (GTK_WIDGET (row), -1, panel->bound_row_height);
+	}
+
+	document_row_connect (GTK_WIDGET (row));
 
 	return GTK_WIDGET (row);
 }
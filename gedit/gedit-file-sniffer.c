@@ -0,0 +1,308 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-file-sniffer.h"
+#include "gedit-document-private.h"
+#include "gedit-utils.h"
+
+/* The sniffing stage of the file loading: in a worker thread, the file info is
+ * queried and the head of the file is read once, to know the encoding, the
+ * newline type, the content type and the language before the content is put in
+ * the buffer.
+ *
+ * The result is only a hint, the file loader still validates the whole
+ * content.
+ */
+
+#define SNIFF_SIZE (64 * 1024)
+
+typedef struct
+{
+	GFile *location;
+
+	/* Element type: unowned GtkSourceEncoding. */
+	GSList *candidate_encodings;
+} SniffData;
+
+static void
+sniff_data_free (SniffData *data)
+{
+	if (data != NULL)
+	{
+		g_object_unref (data->location);
+		g_slist_free (data->candidate_encodings);
+		g_free (data);
+	}
+}
+
+void
+_gedit_file_sniff_result_free (GeditFileSniffResult *result)
+{
+	if (result != NULL)
+	{
+		g_free (result->content_type);
+		g_free (result);
+	}
+}
+
+/* @truncated is whether @text is only the head of the content, in which case
+ * an incomplete character at the end is accepted.
+ */
+static gboolean
+can_decode (const GtkSourceEncoding *encoding,
+	    const gchar             *text,
+	    gsize                    length,
+	    gboolean                 truncated)
+{
+	gchar *converted;
+	GError *error = NULL;
+
+	if (encoding == gtk_source_encoding_get_utf8 ())
+	{
+		const gchar *end;
+
+		if (g_utf8_validate_len (text, length, &end))
+		{
+			return TRUE;
+		}
+
+		return (truncated &&
+			text + length - end < 4 &&
+			g_utf8_get_char_validated (end, text + length - end) == (gunichar) -2);
+	}
+
+	converted = g_convert (text,
+			       length,
+			       "UTF-8",
+			       gtk_source_encoding_get_charset (encoding),
+			       NULL,
+			       NULL,
+			       &error);
+
+	if (converted != NULL)
+	{
+		g_free (converted);
+		return TRUE;
+	}
+
+	if (truncated &&
+	    g_error_matches (error, G_CONVERT_ERROR, G_CONVERT_ERROR_PARTIAL_INPUT))
+	{
+		g_error_free (error);
+		return TRUE;
+	}
+
+	g_error_free (error);
+	return FALSE;
+}
+
+static GtkSourceNewlineType
+get_newline_type (const gchar *text,
+		  gsize        length)
+{
+	gsize i;
+
+	for (i = 0; i < length; i++)
+	{
+		if (text[i] == '\n')
+		{
+			return GTK_SOURCE_NEWLINE_TYPE_LF;
+		}
+
+		if (text[i] == '\r')
+		{
+			if (i + 1 < length && text[i + 1] == '\n')
+			{
+				return GTK_SOURCE_NEWLINE_TYPE_CR_LF;
+			}
+
+			return GTK_SOURCE_NEWLINE_TYPE_CR;
+		}
+	}
+
+	return GTK_SOURCE_NEWLINE_TYPE_DEFAULT;
+}
+
+/* Errors when reading are not reported, the file loader reports them. */
+static void
+sniff_content (GeditFileSniffResult *result,
+	       SniffData            *data,
+	       GCancellable         *cancellable)
+{
+	GInputStream *stream;
+	gchar *head;
+	gsize length = 0;
+	GSList *l;
+
+	stream = G_INPUT_STREAM (g_file_read (data->location, cancellable, NULL));
+	if (stream == NULL)
+	{
+		return;
+	}
+
+	if (gedit_utils_get_compression_type_from_content_type (result->content_type) ==
+	    GTK_SOURCE_COMPRESSION_TYPE_GZIP)
+	{
+		GZlibDecompressor *decompressor;
+		GInputStream *converter_stream;
+
+		decompressor = g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+		converter_stream = g_converter_input_stream_new (stream, G_CONVERTER (decompressor));
+
+		g_object_unref (decompressor);
+		g_object_unref (stream);
+		stream = converter_stream;
+
+		result->compressed = TRUE;
+	}
+
+	head = g_malloc (SNIFF_SIZE);
+
+	if (!g_input_stream_read_all (stream, head, SNIFF_SIZE, &length, cancellable, NULL))
+	{
+		g_object_unref (stream);
+		g_free (head);
+		return;
+	}
+
+	g_object_unref (stream);
+
+	if (result->compressed)
+	{
+		g_free (result->content_type);
+		result->content_type = g_content_type_guess (NULL, (const guchar *) head, length, NULL);
+	}
+
+	for (l = data->candidate_encodings; l != NULL; l = l->next)
+	{
+		const GtkSourceEncoding *encoding = l->data;
+
+		if (can_decode (encoding, head, length, length == SNIFF_SIZE))
+		{
+			result->encoding = encoding;
+			break;
+		}
+	}
+
+	/* The newline type is only meaningful for an ASCII-compatible
+	 * encoding.
+	 */
+	if (result->encoding != NULL &&
+	    !g_str_has_prefix (gtk_source_encoding_get_charset (result->encoding), "UTF-16") &&
+	    !g_str_has_prefix (gtk_source_encoding_get_charset (result->encoding), "UCS-"))
+	{
+		result->newline_type = get_newline_type (head, length);
+	}
+
+	g_free (head);
+}
+
+static void
+sniff_thread (GTask        *task,
+	      gpointer      source_object,
+	      gpointer      task_data,
+	      GCancellable *cancellable)
+{
+	SniffData *data = task_data;
+	GeditFileSniffResult *result;
+	GFileInfo *info;
+	gchar *basename;
+	GError *error = NULL;
+
+	info = g_file_query_info (data->location,
+				  G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+				  G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+				  G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE,
+				  G_FILE_QUERY_INFO_NONE,
+				  cancellable,
+				  &error);
+
+	if (info == NULL)
+	{
+		g_task_return_error (task, error);
+		return;
+	}
+
+	result = g_new0 (GeditFileSniffResult, 1);
+	result->file_type = g_file_info_get_file_type (info);
+	result->size = g_file_info_get_size (info);
+	result->content_type = g_strdup (g_file_info_get_content_type (info));
+	result->newline_type = GTK_SOURCE_NEWLINE_TYPE_DEFAULT;
+	g_object_unref (info);
+
+	if (result->file_type == G_FILE_TYPE_REGULAR)
+	{
+		sniff_content (result, data, cancellable);
+	}
+
+	/* The languages have been loaded in the main thread by
+	 * _gedit_file_sniff_async(), the language manager is then only read.
+	 */
+	basename = g_file_get_basename (data->location);
+	result->language = _gedit_document_guess_language (basename, result->content_type);
+	g_free (basename);
+
+	if (g_task_return_error_if_cancelled (task))
+	{
+		_gedit_file_sniff_result_free (result);
+		return;
+	}
+
+	g_task_return_pointer (task, result, (GDestroyNotify) _gedit_file_sniff_result_free);
+}
+
+/*
+ * _gedit_file_sniff_async:
+ * @location: the #GFile to sniff.
+ * @candidate_encodings: (element-type GtkSourceEncoding): the encodings to try,
+ *   in order.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the callback.
+ * @user_data: the data to pass to @callback.
+ *
+ * Queries the type, size and content type of @location, and reads the head of
+ * its content, in a worker thread.
+ */
+void
+_gedit_file_sniff_async (GFile               *location,
+			 GSList              *candidate_encodings,
+			 GCancellable        *cancellable,
+			 GAsyncReadyCallback  callback,
+			 gpointer             user_data)
+{
+	GTask *task;
+	SniffData *data;
+
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	/* Make sure that the language definitions are loaded. */
+	gtk_source_language_manager_get_language_ids (gtk_source_language_manager_get_default ());
+
+	data = g_new0 (SniffData, 1);
+	data->location = g_object_ref (location);
+	data->candidate_encodings = g_slist_copy (candidate_encodings);
+
+	task = g_task_new (NULL, cancellable, callback, user_data);
+	g_task_set_task_data (task, data, (GDestroyNotify) sniff_data_free);
+	g_task_run_in_thread (task, sniff_thread);
+	g_object_unref (task);
+}
+
+/*
+ * _gedit_file_sniff_finish:
+ * @result: a #GAsyncResult.
+ * @error: a #GError.
+ *
+ * Returns: (transfer full) (nullable): the #GeditFileSniffResult, to free with
+ * _gedit_file_sniff_result_free(), or %NULL on error.
+ */
+GeditFileSniffResult *
+_gedit_file_sniff_finish (GAsyncResult  *result,
+			  GError       **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
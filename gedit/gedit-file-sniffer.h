@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_SNIFFER_H
+#define GEDIT_FILE_SNIFFER_H
+
+#include <gtksourceview/gtksource.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GeditFileSniffResult GeditFileSniffResult;
+
+struct _GeditFileSniffResult
+{
+	GFileType file_type;
+	goffset size;
+
+	/* Guessed from the content for compressed files. Nullable. */
+	gchar *content_type;
+	guint compressed : 1;
+
+	/* The first candidate encoding that can decode the head of the file,
+	 * or NULL.
+	 */
+	const GtkSourceEncoding *encoding;
+
+	/* Of the first line ending, GTK_SOURCE_NEWLINE_TYPE_DEFAULT if there
+	 * is none in the head of the file.
+	 */
+	GtkSourceNewlineType newline_type;
+
+	/* Nullable. */
+	GtkSourceLanguage *language;
+};
+
+void			_gedit_file_sniff_async		(GFile                *location,
+							 GSList               *candidate_encodings,
+							 GCancellable         *cancellable,
+							 GAsyncReadyCallback   callback,
+							 gpointer              user_data);
+
+GeditFileSniffResult *	_gedit_file_sniff_finish	(GAsyncResult         *result,
+							 GError              **error);
+
+void			_gedit_file_sniff_result_free	(GeditFileSniffResult *result);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_SNIFFER_H */
@@ -0,0 +1,1279 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-file-viewer.h"
+#include <string.h>
+#include "gedit-debug.h"
+
+/* GeditFileViewer: read-only access to a file too big to be put entirely in a
+ * GtkTextBuffer.
+ *
+ * A sparse index of the line start offsets is built in a worker thread. Only a
+ * window of lines around the visible part is put in the buffer of the attached
+ * view, and the window is moved when scrolling near its edges. Line numbers,
+ * the cursor position, goto-line and search are computed against the whole
+ * file.
+ *
+ * The file is read at given offsets, not memory-mapped: such big files are
+ * often logs, and a mapped file that is truncated makes the process crash with
+ * SIGBUS. If the file shrinks, the reads just return less than expected.
+ *
+ * The content is expected to be UTF-8, invalid bytes are shown as replacement
+ * characters. Lines longer than WINDOW_MAX_BYTES are truncated in the view.
+ */
+
+/* One index entry every LINE_INDEX_INTERVAL lines. */
+#define LINE_INDEX_INTERVAL (1024)
+
+#define WINDOW_N_LINES (4000)
+#define WINDOW_MAX_BYTES (4 * 1024 * 1024)
+
+/* When the visible part comes this close to an edge of the window, the window
+ * is moved.
+ */
+#define WINDOW_MARGIN_N_LINES (500)
+
+/* How often the cancellable is checked when indexing the file. */
+#define SCAN_CHECK_CANCELLED_INTERVAL (16 * 1024 * 1024)
+
+/* The size of the reads when scanning the file. */
+#define SCAN_CHUNK_SIZE (256 * 1024)
+
+struct _GeditFileViewer
+{
+	GObject parent_instance;
+
+	GFile *location;
+
+	/* Used from the main thread only, a search opens its own stream. */
+	GInputStream *stream;
+
+	/* The size when the file was indexed. */
+	guint64 size;
+
+	/* Element type: guint64. Element i is the byte offset of the start of
+	 * line i * LINE_INDEX_INTERVAL.
+	 */
+	GArray *line_index;
+	gint64 n_lines;
+
+	/* Weak ref */
+	GeditView *view;
+	GtkTextBuffer *buffer;
+	GtkAdjustment *vadjustment;
+	gulong vadjustment_handler_id;
+	gulong mark_set_handler_id;
+	guint move_window_idle_id;
+
+	/* The lines currently in the buffer. */
+	gint64 window_first_line;
+	gint64 window_n_lines;
+
+	GCancellable *search_cancellable;
+
+	guint filling_window : 1;
+};
+
+enum
+{
+	SIGNAL_CURSOR_MOVED,
+	N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+G_DEFINE_TYPE (GeditFileViewer, _gedit_file_viewer, G_TYPE_OBJECT)
+
+static void
+detach_view (GeditFileViewer *viewer)
+{
+	if (viewer->move_window_idle_id != 0)
+	{
+		g_source_remove (viewer->move_window_idle_id);
+		viewer->move_window_idle_id = 0;
+	}
+
+	if (viewer->vadjustment != NULL)
+	{
+		g_signal_handler_disconnect (viewer->vadjustment,
+					     viewer->vadjustment_handler_id);
+		viewer->vadjustment_handler_id = 0;
+		g_clear_object (&viewer->vadjustment);
+	}
+
+	if (viewer->buffer != NULL)
+	{
+		g_signal_handler_disconnect (viewer->buffer, viewer->mark_set_handler_id);
+		viewer->mark_set_handler_id = 0;
+		g_clear_object (&viewer->buffer);
+	}
+
+	if (viewer->view != NULL)
+	{
+		g_object_remove_weak_pointer (G_OBJECT (viewer->view),
+					      (gpointer *) &viewer->view);
+		viewer->view = NULL;
+	}
+}
+
+static void
+_gedit_file_viewer_dispose (GObject *object)
+{
+	GeditFileViewer *viewer = GEDIT_FILE_VIEWER (object);
+
+	detach_view (viewer);
+
+	if (viewer->search_cancellable != NULL)
+	{
+		g_cancellable_cancel (viewer->search_cancellable);
+		g_clear_object (&viewer->search_cancellable);
+	}
+
+	G_OBJECT_CLASS (_gedit_file_viewer_parent_class)->dispose (object);
+}
+
+static void
+_gedit_file_viewer_finalize (GObject *object)
+{
+	GeditFileViewer *viewer = GEDIT_FILE_VIEWER (object);
+
+	if (viewer->line_index != NULL)
+	{
+		g_array_unref (viewer->line_index);
+	}
+
+	g_clear_object (&viewer->stream);
+	g_clear_object (&viewer->location);
+
+	G_OBJECT_CLASS (_gedit_file_viewer_parent_class)->finalize (object);
+}
+
+static void
+_gedit_file_viewer_class_init (GeditFileViewerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = _gedit_file_viewer_dispose;
+	object_class->finalize = _gedit_file_viewer_finalize;
+
+	/*
+	 * GeditFileViewer::cursor-moved:
+	 * @viewer: the #GeditFileViewer emitting the signal.
+	 *
+	 * Emitted when the cursor position in the file has changed, either
+	 * because the cursor moved or because the window of lines moved.
+	 */
+	signals[SIGNAL_CURSOR_MOVED] =
+		g_signal_new ("cursor-moved",
+			      G_TYPE_FROM_CLASS (klass),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+}
+
+static void
+_gedit_file_viewer_init (GeditFileViewer *viewer)
+{
+	viewer->line_index = g_array_new (FALSE, FALSE, sizeof (guint64));
+}
+
+/* Index and offset computations. They only read the file and the index, so
+ * the searches can run in a thread once the index is built.
+ */
+
+/* Reads up to @length bytes at @offset. Returns the number of bytes read, which
+ * is less than @length at the end of the file or if an error occurred.
+ */
+static gsize
+read_at (GInputStream *stream,
+	 guint64       offset,
+	 gchar        *buffer,
+	 gsize         length,
+	 GCancellable *cancellable)
+{
+	gsize n_read = 0;
+
+	if (!g_seekable_seek (G_SEEKABLE (stream), offset, G_SEEK_SET, cancellable, NULL))
+	{
+		return 0;
+	}
+
+	/* On error, @n_read is what was read before. */
+	g_input_stream_read_all (stream, buffer, length, &n_read, cancellable, NULL);
+
+	return n_read;
+}
+
+static gboolean
+build_line_index (GeditFileViewer  *viewer,
+		  GCancellable     *cancellable,
+		  GError          **error)
+{
+	gchar *buffer;
+	guint64 offset = 0;
+	guint64 next_check = SCAN_CHECK_CANCELLED_INTERVAL;
+
+	g_array_set_size (viewer->line_index, 0);
+	g_array_append_val (viewer->line_index, offset);
+	viewer->n_lines = 1;
+
+	buffer = g_malloc (SCAN_CHUNK_SIZE);
+
+	while (offset < viewer->size)
+	{
+		gsize n_read;
+		const gchar *p = buffer;
+		const gchar *end;
+
+		if (!g_input_stream_read_all (viewer->stream,
+					      buffer,
+					      MIN (SCAN_CHUNK_SIZE, viewer->size - offset),
+					      &n_read,
+					      cancellable,
+					      error))
+		{
+			g_free (buffer);
+			return FALSE;
+		}
+
+		/* Truncated in the meantime. */
+		if (n_read == 0)
+		{
+			viewer->size = offset;
+			break;
+		}
+
+		end = buffer + n_read;
+
+		while ((p = memchr (p, '\n', end - p)) != NULL)
+		{
+			p++;
+
+			if (viewer->n_lines % LINE_INDEX_INTERVAL == 0)
+			{
+				guint64 line_start = offset + (p - buffer);
+
+				g_array_append_val (viewer->line_index, line_start);
+			}
+
+			viewer->n_lines++;
+		}
+
+		offset += n_read;
+
+		if (offset >= next_check)
+		{
+			if (g_cancellable_set_error_if_cancelled (cancellable, error))
+			{
+				g_free (buffer);
+				return FALSE;
+			}
+
+			next_check = offset + SCAN_CHECK_CANCELLED_INTERVAL;
+		}
+	}
+
+	g_free (buffer);
+	return TRUE;
+}
+
+/* Looks for newlines in [@offset, @end), stopping after the @max_newlines-th
+ * one. Returns the offset after the last newline found, or @end if there are
+ * fewer than @max_newlines.
+ */
+static guint64
+scan_newlines (GeditFileViewer *viewer,
+	       guint64          offset,
+	       guint64          end,
+	       gint64           max_newlines,
+	       gint64          *n_newlines)
+{
+	gchar *buffer;
+
+	*n_newlines = 0;
+	end = MIN (end, viewer->size);
+
+	if (max_newlines <= 0 || offset >= end)
+	{
+		return MIN (offset, end);
+	}
+
+	buffer = g_malloc (SCAN_CHUNK_SIZE);
+
+	while (offset < end)
+	{
+		gsize n_read;
+		const gchar *p = buffer;
+		const gchar *newline;
+
+		n_read = read_at (viewer->stream, offset, buffer, MIN (SCAN_CHUNK_SIZE, end - offset), NULL);
+
+		if (n_read == 0)
+		{
+			break;
+		}
+
+		while ((newline = memchr (p, '\n', buffer + n_read - p)) != NULL)
+		{
+			p = newline + 1;
+
+			if (++(*n_newlines) == max_newlines)
+			{
+				g_free (buffer);
+				return offset + (p - buffer);
+			}
+		}
+
+		offset += n_read;
+	}
+
+	g_free (buffer);
+	return end;
+}
+
+/* Returns the byte offset of the start of @line. */
+static guint64
+get_line_start (GeditFileViewer *viewer,
+		gint64           line)
+{
+	guint64 offset;
+	gint64 n_newlines;
+
+	line = CLAMP (line, 0, viewer->n_lines - 1);
+	offset = g_array_index (viewer->line_index, guint64, line / LINE_INDEX_INTERVAL);
+
+	return scan_newlines (viewer, offset, viewer->size, line % LINE_INDEX_INTERVAL, &n_newlines);
+}
+
+/* Returns the byte offset of the end of @line, without the newline. */
+static guint64
+get_line_end (GeditFileViewer *viewer,
+	      gint64           line)
+{
+	guint64 offset;
+	gint64 n_newlines;
+
+	offset = scan_newlines (viewer, get_line_start (viewer, line), viewer->size, 1, &n_newlines);
+
+	return n_newlines == 1 ? offset - 1 : viewer->size;
+}
+
+static gint64
+get_line_at_offset (GeditFileViewer *viewer,
+		    guint64          offset)
+{
+	guint low = 0;
+	guint high = viewer->line_index->len;
+	gint64 n_newlines;
+
+	offset = MIN (offset, viewer->size);
+
+	/* Last index entry <= offset. */
+	while (high - low > 1)
+	{
+		guint middle = low + (high - low) / 2;
+
+		if (g_array_index (viewer->line_index, guint64, middle) <= offset)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	scan_newlines (viewer,
+		       g_array_index (viewer->line_index, guint64, low),
+		       offset,
+		       G_MAXINT64,
+		       &n_newlines);
+
+	return (gint64) low * LINE_INDEX_INTERVAL + n_newlines;
+}
+
+/* Number of characters in @text once passed through g_utf8_make_valid(), which
+ * replaces each invalid byte by one replacement character.
+ */
+static glong
+count_chars (const gchar *text,
+	     gsize        length)
+{
+	const gchar *p = text;
+	const gchar *end = text + length;
+	glong n_chars = 0;
+
+	while (p < end)
+	{
+		const gchar *valid_end;
+
+		if (g_utf8_validate (p, end - p, &valid_end))
+		{
+			n_chars += g_utf8_strlen (p, end - p);
+			break;
+		}
+
+		n_chars += g_utf8_strlen (p, valid_end - p) + 1;
+		p = valid_end + 1;
+	}
+
+	return n_chars;
+}
+
+/* The reverse of count_chars(): the number of bytes of the first @n_chars
+ * characters of @text.
+ */
+static gsize
+count_bytes (const gchar *text,
+	     gsize        length,
+	     glong        n_chars)
+{
+	const gchar *p = text;
+	const gchar *end = text + length;
+
+	while (p < end && n_chars > 0)
+	{
+		gunichar c = g_utf8_get_char_validated (p, end - p);
+
+		if (c == (gunichar) -1 || c == (gunichar) -2 || c == 0)
+		{
+			p++;
+		}
+		else
+		{
+			p = g_utf8_next_char (p);
+		}
+
+		n_chars--;
+	}
+
+	return MIN (p, end) - text;
+}
+
+/* Window of lines in the buffer */
+
+static void
+fill_window (GeditFileViewer *viewer,
+	     gint64           first_line)
+{
+	GtkTextBuffer *buffer;
+	guint64 start;
+	guint64 end;
+	gint64 n_lines;
+	gchar *contents;
+	gsize length;
+	gchar *text;
+
+	g_return_if_fail (viewer->view != NULL);
+
+	first_line = CLAMP (first_line, 0, viewer->n_lines - 1);
+	n_lines = MIN (WINDOW_N_LINES, viewer->n_lines - first_line);
+
+	start = get_line_start (viewer, first_line);
+	end = get_line_end (viewer, first_line + n_lines - 1);
+
+	length = MIN (end - start, WINDOW_MAX_BYTES);
+	contents = g_malloc (length);
+	length = read_at (viewer->stream, start, contents, length, NULL);
+
+	/* Lines too long, or the file has been truncated: keep only what has
+	 * been read, ending on a line boundary when possible.
+	 */
+	if (length < end - start)
+	{
+		const gchar *last_newline = NULL;
+		const gchar *p = contents;
+
+		n_lines = 0;
+
+		while ((p = memchr (p, '\n', contents + length - p)) != NULL)
+		{
+			last_newline = p++;
+			n_lines++;
+		}
+
+		if (last_newline != NULL)
+		{
+			length = last_newline - contents;
+		}
+		else
+		{
+			n_lines = 1;
+		}
+	}
+
+	gedit_debug_message (DEBUG_TAB,
+			     "Lines %" G_GINT64_FORMAT " to %" G_GINT64_FORMAT,
+			     first_line, first_line + n_lines - 1);
+
+	text = g_utf8_make_valid (contents, length);
+	g_free (contents);
+
+	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+
+	viewer->filling_window = TRUE;
+
+	gtk_source_buffer_begin_not_undoable_action (GTK_SOURCE_BUFFER (buffer));
+	gtk_text_buffer_set_text (buffer, text, -1);
+	gtk_source_buffer_end_not_undoable_action (GTK_SOURCE_BUFFER (buffer));
+	gtk_text_buffer_set_modified (buffer, FALSE);
+
+	viewer->filling_window = FALSE;
+
+	viewer->window_first_line = first_line;
+	viewer->window_n_lines = n_lines;
+
+	g_free (text);
+}
+
+static gboolean
+line_is_in_window (GeditFileViewer *viewer,
+		   gint64           line)
+{
+	return (viewer->window_first_line <= line &&
+		line < viewer->window_first_line + viewer->window_n_lines);
+}
+
+/* Puts @line in the window, not too close to its edges. */
+static void
+ensure_line_in_window (GeditFileViewer *viewer,
+		       gint64           line)
+{
+	gboolean near_start;
+	gboolean near_end;
+
+	near_start = (line - viewer->window_first_line < WINDOW_MARGIN_N_LINES &&
+		      viewer->window_first_line > 0);
+
+	near_end = (viewer->window_first_line + viewer->window_n_lines - line < WINDOW_MARGIN_N_LINES &&
+		    viewer->window_first_line + viewer->window_n_lines < viewer->n_lines);
+
+	if (!line_is_in_window (viewer, line) || near_start || near_end)
+	{
+		fill_window (viewer, line - WINDOW_N_LINES / 2);
+	}
+}
+
+static void
+get_iter_at_position (GeditFileViewer *viewer,
+		      GtkTextIter     *iter,
+		      gint64           line,
+		      gint             column)
+{
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+	gint buffer_line;
+
+	buffer_line = CLAMP (line - viewer->window_first_line, 0, viewer->window_n_lines - 1);
+	gtk_text_buffer_get_iter_at_line (buffer, iter, buffer_line);
+
+	column = CLAMP (column, 0, gtk_text_iter_get_chars_in_line (iter));
+
+	if (column > 0 &&
+	    column == gtk_text_iter_get_chars_in_line (iter) &&
+	    !gtk_text_iter_ends_line (iter))
+	{
+		/* Don't go after the newline. */
+		gtk_text_iter_forward_to_line_end (iter);
+	}
+	else
+	{
+		gtk_text_iter_set_line_offset (iter, column);
+	}
+}
+
+static void
+scroll_to_line (GeditFileViewer *viewer,
+		gint64           top_line)
+{
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+	GtkTextIter iter;
+	GtkTextMark *mark;
+
+	get_iter_at_position (viewer, &iter, top_line, 0);
+
+	mark = gtk_text_buffer_create_mark (buffer, NULL, &iter, TRUE);
+	gtk_text_view_scroll_to_mark (GTK_TEXT_VIEW (viewer->view), mark, 0.0, TRUE, 0.0, 0.0);
+	gtk_text_buffer_delete_mark (buffer, mark);
+}
+
+static gboolean
+move_window_idle_cb (gpointer user_data)
+{
+	GeditFileViewer *viewer = GEDIT_FILE_VIEWER (user_data);
+	GdkRectangle visible_rect;
+	GtkTextIter top;
+	GtkTextIter bottom;
+	gint64 top_line;
+	gint64 bottom_line;
+	gint64 cursor_line;
+	gint cursor_column;
+
+	viewer->move_window_idle_id = 0;
+
+	if (viewer->view == NULL)
+	{
+		return G_SOURCE_REMOVE;
+	}
+
+	gtk_text_view_get_visible_rect (GTK_TEXT_VIEW (viewer->view), &visible_rect);
+	gtk_text_view_get_line_at_y (GTK_TEXT_VIEW (viewer->view), &top, visible_rect.y, NULL);
+	gtk_text_view_get_line_at_y (GTK_TEXT_VIEW (viewer->view), &bottom,
+				     visible_rect.y + visible_rect.height, NULL);
+
+	top_line = viewer->window_first_line + gtk_text_iter_get_line (&top);
+	bottom_line = viewer->window_first_line + gtk_text_iter_get_line (&bottom);
+
+	if (!(top_line - viewer->window_first_line < WINDOW_MARGIN_N_LINES &&
+	      viewer->window_first_line > 0) &&
+	    !(viewer->window_first_line + viewer->window_n_lines - bottom_line < WINDOW_MARGIN_N_LINES &&
+	      viewer->window_first_line + viewer->window_n_lines < viewer->n_lines))
+	{
+		return G_SOURCE_REMOVE;
+	}
+
+	_gedit_file_viewer_get_cursor_position (viewer, &cursor_line, &cursor_column);
+
+	fill_window (viewer, top_line - WINDOW_N_LINES / 2);
+
+	/* Keep the cursor where it was in the file if it is still in the
+	 * window, otherwise put it on the first visible line.
+	 */
+	if (line_is_in_window (viewer, cursor_line))
+	{
+		GtkTextIter iter;
+
+		get_iter_at_position (viewer, &iter, cursor_line, cursor_column);
+		gtk_text_buffer_place_cursor (gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view)), &iter);
+	}
+	else
+	{
+		GtkTextIter iter;
+
+		get_iter_at_position (viewer, &iter, top_line, 0);
+		gtk_text_buffer_place_cursor (gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view)), &iter);
+	}
+
+	scroll_to_line (viewer, top_line);
+
+	g_signal_emit (viewer, signals[SIGNAL_CURSOR_MOVED], 0);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+vadjustment_value_changed_cb (GtkAdjustment   *vadjustment,
+			      GeditFileViewer *viewer)
+{
+	if (viewer->filling_window || viewer->move_window_idle_id != 0)
+	{
+		return;
+	}
+
+	/* Let the view finish its scrolling first. */
+	viewer->move_window_idle_id = g_idle_add (move_window_idle_cb, viewer);
+}
+
+static void
+mark_set_cb (GtkTextBuffer   *buffer,
+	     GtkTextIter     *location,
+	     GtkTextMark     *mark,
+	     GeditFileViewer *viewer)
+{
+	if (!viewer->filling_window &&
+	    mark == gtk_text_buffer_get_insert (buffer))
+	{
+		g_signal_emit (viewer, signals[SIGNAL_CURSOR_MOVED], 0);
+	}
+}
+
+/* Creation */
+
+static void
+new_thread (GTask        *task,
+	    gpointer      source_object,
+	    gpointer      task_data,
+	    GCancellable *cancellable)
+{
+	GFile *location = G_FILE (task_data);
+	GeditFileViewer *viewer;
+	GFileInputStream *stream;
+	GFileInfo *info;
+	GError *error = NULL;
+
+	if (!g_file_is_native (location))
+	{
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 G_IO_ERROR_NOT_SUPPORTED,
+					 "The file viewer supports only local files");
+		return;
+	}
+
+	stream = g_file_read (location, cancellable, &error);
+
+	if (error != NULL)
+	{
+		g_task_return_error (task, error);
+		return;
+	}
+
+	info = g_file_input_stream_query_info (stream, G_FILE_ATTRIBUTE_STANDARD_SIZE, cancellable, &error);
+
+	if (error != NULL)
+	{
+		g_task_return_error (task, error);
+		g_object_unref (stream);
+		return;
+	}
+
+	viewer = g_object_new (GEDIT_TYPE_FILE_VIEWER, NULL);
+	viewer->location = g_object_ref (location);
+	viewer->stream = G_INPUT_STREAM (stream);
+	viewer->size = g_file_info_get_size (info);
+	g_object_unref (info);
+
+	if (!build_line_index (viewer, cancellable, &error))
+	{
+		g_task_return_error (task, error);
+		g_object_unref (viewer);
+		return;
+	}
+
+	gedit_debug_message (DEBUG_TAB,
+			     "%" G_GINT64_FORMAT " lines, %u index entries",
+			     viewer->n_lines,
+			     viewer->line_index->len);
+
+	g_task_return_pointer (task, viewer, g_object_unref);
+}
+
+/*
+ * _gedit_file_viewer_new_async:
+ * @location: a local file.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the callback to call when the viewer is ready.
+ * @user_data: data to pass to @callback.
+ *
+ * Opens @location and indexes its lines, in a thread.
+ */
+void
+_gedit_file_viewer_new_async (GFile               *location,
+			      GCancellable        *cancellable,
+			      GAsyncReadyCallback  callback,
+			      gpointer             user_data)
+{
+	GTask *task;
+
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (NULL, cancellable, callback, user_data);
+	g_task_set_task_data (task, g_object_ref (location), g_object_unref);
+	g_task_run_in_thread (task, new_thread);
+	g_object_unref (task);
+}
+
+GeditFileViewer *
+_gedit_file_viewer_new_finish (GAsyncResult  *result,
+			       GError       **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/*
+ * _gedit_file_viewer_attach:
+ * @viewer: a #GeditFileViewer.
+ * @view: the #GeditView to show the file in.
+ *
+ * Replaces the content of the @view buffer by the start of the file. From now
+ * on the buffer content is managed by @viewer.
+ */
+void
+_gedit_file_viewer_attach (GeditFileViewer *viewer,
+			   GeditView       *view)
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter start;
+
+	g_return_if_fail (GEDIT_IS_FILE_VIEWER (viewer));
+	g_return_if_fail (GEDIT_IS_VIEW (view));
+	g_return_if_fail (viewer->view == NULL);
+
+	viewer->view = view;
+	g_object_add_weak_pointer (G_OBJECT (view), (gpointer *) &viewer->view);
+
+	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+	viewer->buffer = g_object_ref (buffer);
+
+	viewer->mark_set_handler_id =
+		g_signal_connect (buffer,
+				  "mark-set",
+				  G_CALLBACK (mark_set_cb),
+				  viewer);
+
+	viewer->vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+
+	if (viewer->vadjustment != NULL)
+	{
+		g_object_ref (viewer->vadjustment);
+
+		viewer->vadjustment_handler_id =
+			g_signal_connect (viewer->vadjustment,
+					  "value-changed",
+					  G_CALLBACK (vadjustment_value_changed_cb),
+					  viewer);
+	}
+
+	fill_window (viewer, 0);
+
+	gtk_text_buffer_get_start_iter (buffer, &start);
+	gtk_text_buffer_place_cursor (buffer, &start);
+}
+
+gint64
+_gedit_file_viewer_get_n_lines (GeditFileViewer *viewer)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_VIEWER (viewer), 0);
+
+	return viewer->n_lines;
+}
+
+/*
+ * _gedit_file_viewer_get_cursor_position:
+ * @viewer: a #GeditFileViewer.
+ * @line: (out): the line of the cursor in the file, starting at 0.
+ * @column: (out): the character offset of the cursor in its line.
+ */
+void
+_gedit_file_viewer_get_cursor_position (GeditFileViewer *viewer,
+					gint64          *line,
+					gint            *column)
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter iter;
+
+	g_return_if_fail (GEDIT_IS_FILE_VIEWER (viewer));
+	g_return_if_fail (line != NULL);
+	g_return_if_fail (column != NULL);
+
+	if (viewer->view == NULL)
+	{
+		*line = 0;
+		*column = 0;
+		return;
+	}
+
+	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+	gtk_text_buffer_get_iter_at_mark (buffer, &iter, gtk_text_buffer_get_insert (buffer));
+
+	*line = viewer->window_first_line + gtk_text_iter_get_line (&iter);
+	*column = gtk_text_iter_get_line_offset (&iter);
+}
+
+/*
+ * _gedit_file_viewer_goto_line:
+ * @viewer: a #GeditFileViewer.
+ * @line: a line in the file, starting at 0.
+ * @column: a character offset in @line.
+ *
+ * Returns: %FALSE if @line is not in the file.
+ */
+gboolean
+_gedit_file_viewer_goto_line (GeditFileViewer *viewer,
+			      gint64           line,
+			      gint             column)
+{
+	GtkTextIter iter;
+
+	g_return_val_if_fail (GEDIT_IS_FILE_VIEWER (viewer), FALSE);
+	g_return_val_if_fail (viewer->view != NULL, FALSE);
+
+	if (line < 0 || line >= viewer->n_lines)
+	{
+		return FALSE;
+	}
+
+	ensure_line_in_window (viewer, line);
+
+	get_iter_at_position (viewer, &iter, line, column);
+	gtk_text_buffer_place_cursor (gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view)), &iter);
+	tepl_view_scroll_to_cursor (TEPL_VIEW (viewer->view));
+
+	return TRUE;
+}
+
+/* Search */
+
+typedef struct
+{
+	GeditFileViewer *viewer;
+
+	/* Opened by the search thread. */
+	GInputStream *stream;
+
+	gchar *text;
+	gsize text_length;
+	guint64 start_offset;
+	guint64 match_offset;
+	guint case_sensitive : 1;
+	guint backward : 1;
+} SearchData;
+
+static void
+search_data_free (SearchData *data)
+{
+	if (data != NULL)
+	{
+		g_object_unref (data->viewer);
+		g_clear_object (&data->stream);
+		g_free (data->text);
+		g_free (data);
+	}
+}
+
+static gboolean
+match_at (const SearchData *data,
+	  const gchar      *p)
+{
+	if (data->case_sensitive)
+	{
+		return memcmp (p, data->text, data->text_length) == 0;
+	}
+
+	/* ASCII-only case folding. */
+	return g_ascii_strncasecmp (p, data->text, data->text_length) == 0;
+}
+
+/* Searches a match starting in [from, to). The file is read in chunks, each
+ * one followed by enough bytes for a match starting at its end.
+ */
+static gboolean
+search_range (const SearchData *data,
+	      guint64           from,
+	      guint64           to,
+	      GCancellable     *cancellable,
+	      guint64          *match_offset)
+{
+	guint64 last_start;
+	gchar *buffer;
+	gboolean found = FALSE;
+
+	if (data->viewer->size < data->text_length)
+	{
+		return FALSE;
+	}
+
+	last_start = data->viewer->size - data->text_length;
+	to = MIN (to, last_start + 1);
+
+	if (from >= to)
+	{
+		return FALSE;
+	}
+
+	buffer = g_malloc (SCAN_CHUNK_SIZE + data->text_length - 1);
+
+	while (!found && from < to && !g_cancellable_is_cancelled (cancellable))
+	{
+		guint64 chunk_start;
+		gsize n_starts;
+		gsize n_read;
+
+		n_starts = MIN (SCAN_CHUNK_SIZE, to - from);
+		chunk_start = data->backward ? to - n_starts : from;
+
+		n_read = read_at (data->stream,
+				  chunk_start,
+				  buffer,
+				  n_starts + data->text_length - 1,
+				  cancellable);
+
+		/* Truncated in the meantime. */
+		if (n_read < data->text_length)
+		{
+			break;
+		}
+
+		n_starts = MIN (n_starts, n_read - data->text_length + 1);
+
+		if (!data->backward)
+		{
+			gsize i;
+
+			for (i = 0; i < n_starts; i++)
+			{
+				/* Jump to the next candidate with memchr()
+				 * when the first byte is not a letter.
+				 */
+				if (data->case_sensitive || !g_ascii_isalpha (data->text[0]))
+				{
+					const gchar *p = memchr (buffer + i, data->text[0], n_starts - i);
+
+					if (p == NULL)
+					{
+						break;
+					}
+
+					i = p - buffer;
+				}
+
+				if (match_at (data, buffer + i))
+				{
+					*match_offset = chunk_start + i;
+					found = TRUE;
+					break;
+				}
+			}
+
+			from = chunk_start + MIN (SCAN_CHUNK_SIZE, to - from);
+		}
+		else
+		{
+			gsize i;
+
+			for (i = n_starts; i > 0; i--)
+			{
+				if (match_at (data, buffer + i - 1))
+				{
+					*match_offset = chunk_start + i - 1;
+					found = TRUE;
+					break;
+				}
+			}
+
+			to = chunk_start;
+		}
+	}
+
+	g_free (buffer);
+	return found;
+}
+
+static void
+search_thread (GTask        *task,
+	       gpointer      source_object,
+	       gpointer      task_data,
+	       GCancellable *cancellable)
+{
+	SearchData *data = task_data;
+	GFileInputStream *stream;
+	gboolean found;
+	GError *error = NULL;
+
+	stream = g_file_read (data->viewer->location, cancellable, &error);
+
+	if (error != NULL)
+	{
+		g_task_return_error (task, error);
+		return;
+	}
+
+	data->stream = G_INPUT_STREAM (stream);
+
+	/* With wrap around. */
+	if (!data->backward)
+	{
+		found = (search_range (data, data->start_offset, G_MAXUINT64, cancellable, &data->match_offset) ||
+			 search_range (data, 0, data->start_offset, cancellable, &data->match_offset));
+	}
+	else
+	{
+		found = (search_range (data, 0, data->start_offset, cancellable, &data->match_offset) ||
+			 search_range (data, data->start_offset, G_MAXUINT64, cancellable, &data->match_offset));
+	}
+
+	if (g_task_return_error_if_cancelled (task))
+	{
+		return;
+	}
+
+	g_task_return_boolean (task, found);
+}
+
+static guint64
+get_offset_at_iter (GeditFileViewer   *viewer,
+		    const GtkTextIter *iter)
+{
+	gint64 line;
+	guint64 line_start;
+	gchar *contents;
+	gsize length;
+	gsize n_bytes;
+
+	line = viewer->window_first_line + gtk_text_iter_get_line (iter);
+	line_start = get_line_start (viewer, line);
+
+	contents = read_line_part (viewer, line_start, get_line_end (viewer, line), &length);
+	n_bytes = count_bytes (contents, length, gtk_text_iter_get_line_offset (iter));
+	g_free (contents);
+
+	return line_start + n_bytes;
+}
+
+/* The line offset of @offset, in its line starting at @line_start. */
+static glong
+get_line_offset (GeditFileViewer *viewer,
+		 guint64          line_start,
+		 guint64          offset)
+{
+	gchar *contents;
+	gsize length;
+	glong n_chars;
+
+	contents = read_line_part (viewer, line_start, offset, &length);
+	n_chars = count_chars (contents, length);
+	g_free (contents);
+
+	return n_chars;
+}
+
+static void
+select_range (GeditFileViewer *viewer,
+	      guint64          start_offset,
+	      guint64          end_offset)
+{
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+	GtkTextIter start;
+	GtkTextIter end;
+	gint64 start_line;
+	gint64 end_line;
+
+	start_line = get_line_at_offset (viewer, start_offset);
+	end_line = get_line_at_offset (viewer, end_offset);
+
+	ensure_line_in_window (viewer, start_line);
+
+	get_iter_at_position (viewer, &start, start_line,
+			      get_line_offset (viewer,
+					       get_line_start (viewer, start_line),
+					       start_offset));
+
+	if (line_is_in_window (viewer, end_line))
+	{
+		get_iter_at_position (viewer, &end, end_line,
+				      get_line_offset (viewer,
+						       get_line_start (viewer, end_line),
+						       end_offset));
+	}
+	else
+	{
+		end = start;
+	}
+
+	gtk_text_buffer_select_range (buffer, &start, &end);
+	tepl_view_scroll_to_cursor (TEPL_VIEW (viewer->view));
+}
+
+/*
+ * _gedit_file_viewer_search_async:
+ * @viewer: a #GeditFileViewer.
+ * @text: the text to search, not escaped. Regular expressions are not
+ *   supported, and the case folding is ASCII-only.
+ * @case_sensitive: whether the search is case sensitive.
+ * @direction: where to start and in which direction to search.
+ * @callback: the callback to call when the search is finished.
+ * @user_data: data to pass to @callback.
+ *
+ * Searches @text in the whole file, in a thread, wrapping around. A previous
+ * search that is not finished is cancelled.
+ */
+void
+_gedit_file_viewer_search_async (GeditFileViewer                *viewer,
+				 const gchar                    *text,
+				 gboolean                        case_sensitive,
+				 GeditFileViewerSearchDirection  direction,
+				 GAsyncReadyCallback             callback,
+				 gpointer                        user_data)
+{
+	GtkTextBuffer *buffer;
+	GtkTextIter selection_start;
+	GtkTextIter selection_end;
+	GTask *task;
+	SearchData *data;
+
+	g_return_if_fail (GEDIT_IS_FILE_VIEWER (viewer));
+	g_return_if_fail (text != NULL);
+	g_return_if_fail (viewer->view != NULL);
+
+	if (viewer->search_cancellable != NULL)
+	{
+		g_cancellable_cancel (viewer->search_cancellable);
+		g_object_unref (viewer->search_cancellable);
+	}
+
+	viewer->search_cancellable = g_cancellable_new ();
+
+	task = g_task_new (viewer, viewer->search_cancellable, callback, user_data);
+
+	if (text[0] == '\0')
+	{
+		g_task_return_boolean (task, FALSE);
+		g_object_unref (task);
+		return;
+	}
+
+	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (viewer->view));
+	gtk_text_buffer_get_selection_bounds (buffer, &selection_start, &selection_end);
+
+	data = g_new0 (SearchData, 1);
+	data->viewer = g_object_ref (viewer);
+	data->text = g_strdup (text);
+	data->text_length = strlen (text);
+	data->case_sensitive = case_sensitive != FALSE;
+	data->backward = direction == GEDIT_FILE_VIEWER_SEARCH_BACKWARD;
+
+	switch (direction)
+	{
+		case GEDIT_FILE_VIEWER_SEARCH_FORWARD:
+			data->start_offset = get_offset_at_iter (viewer, &selection_end);
+			break;
+
+		case GEDIT_FILE_VIEWER_SEARCH_BACKWARD:
+		case GEDIT_FILE_VIEWER_SEARCH_INCREMENTAL:
+		default:
+			data->start_offset = get_offset_at_iter (viewer, &selection_start);
+			break;
+	}
+
+	g_task_set_task_data (task, data, (GDestroyNotify) search_data_free);
+	g_task_run_in_thread (task, search_thread);
+	g_object_unref (task);
+}
+
+/*
+ * _gedit_file_viewer_search_finish:
+ * @viewer: a #GeditFileViewer.
+ * @result: a #GAsyncResult.
+ *
+ * Selects the match, if any.
+ *
+ * Returns: whether a match has been found. %FALSE too if the search has been
+ * cancelled.
+ */
+gboolean
+_gedit_file_viewer_search_finish (GeditFileViewer *viewer,
+				  GAsyncResult    *result)
+{
+	SearchData *data;
+
+	g_return_val_if_fail (GEDIT_IS_FILE_VIEWER (viewer), FALSE);
+	g_return_val_if_fail (g_task_is_valid (result, viewer), FALSE);
+
+	if (!g_task_propagate_boolean (G_TASK (result), NULL))
+	{
+		return FALSE;
+	}
+
+	if (viewer->view == NULL)
+	{
+		return FALSE;
+	}
+
+	data = g_task_get_task_data (G_TASK (result));
+	select_range (viewer, data->match_offset, data->match_offset + data->text_length);
+
+	return TRUE;
+}
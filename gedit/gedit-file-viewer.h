@@ -0,0 +1,61 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_VIEWER_H
+#define GEDIT_FILE_VIEWER_H
+
+#include "gedit-view.h"
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_VIEWER (_gedit_file_viewer_get_type ())
+G_DECLARE_FINAL_TYPE (GeditFileViewer, _gedit_file_viewer,
+		      GEDIT, FILE_VIEWER,
+		      GObject)
+
+typedef enum
+{
+	GEDIT_FILE_VIEWER_SEARCH_FORWARD,
+	GEDIT_FILE_VIEWER_SEARCH_BACKWARD,
+
+	/* Forward, but starting at the beginning of the selection, so that the
+	 * current match is kept if it still matches (search-as-you-type).
+	 */
+	GEDIT_FILE_VIEWER_SEARCH_INCREMENTAL
+} GeditFileViewerSearchDirection;
+
+void			_gedit_file_viewer_new_async		(GFile               *location,
+								 GCancellable        *cancellable,
+								 GAsyncReadyCallback  callback,
+								 gpointer             user_data);
+
+GeditFileViewer *	_gedit_file_viewer_new_finish		(GAsyncResult        *result,
+								 GError             **error);
+
+void			_gedit_file_viewer_attach		(GeditFileViewer     *viewer,
+								 GeditView           *view);
+
+gint64			_gedit_file_viewer_get_n_lines		(GeditFileViewer     *viewer);
+
+void			_gedit_file_viewer_get_cursor_position	(GeditFileViewer     *viewer,
+								 gint64              *line,
+								 gint                *column);
+
+gboolean		_gedit_file_viewer_goto_line		(GeditFileViewer     *viewer,
+								 gint64               line,
+								 gint                 column);
+
+void			_gedit_file_viewer_search_async		(GeditFileViewer                *viewer,
+								 const gchar                    *text,
+								 gboolean                        case_sensitive,
+								 GeditFileViewerSearchDirection  direction,
+								 GAsyncReadyCallback             callback,
+								 gpointer                        user_data);
+
+gboolean		_gedit_file_viewer_search_finish	(GeditFileViewer     *viewer,
+								 GAsyncResult        *result);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_VIEWER_H */
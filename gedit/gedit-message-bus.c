@@ -21,6 +21,8 @@
  */
 
 #include "gedit-message-bus.h"
+#include "gedit-message-private.h"
+#include "gedit-debug.h"
 
 #include <string.h>
 #include <stdarg.h>
@@ -110,48 +112,121 @@
  * </example>
  */
 
+/* The message types and the listeners are keyed by the interned
+ * GeditMessageIdentifier of their (object path, method), which a GeditMessage
+ * caches, so that sending a message does not allocate.
+ *
+ * The messages sent asynchronously wait in a ring buffer, in the order in which
+ * they were sent. They are dispatched in slices of DISPATCH_BUDGET: the first
+ * slice runs at G_PRIORITY_HIGH, as soon as possible, and if messages remain
+ * the next ones run at G_PRIORITY_DEFAULT_IDLE, so that a burst of messages
+ * does not hold off the input and the redraws.
+ *
+ * The messages posted from other threads are pushed on a lock-free stack. The
+ * first message pushed on the empty stack wakes up a source of the main
+ * context of the bus, which moves all of them to the ring buffer.
+ */
+
+/* In microseconds */
+#define DISPATCH_BUDGET (4 * 1000)
+
+/* The ring buffer is freed when it empties above this capacity. */
+#define QUEUE_KEEP_CAPACITY 256
+
 typedef struct
 {
-	gchar *object_path;
-	gchar *method;
+	guint id;
+	guint blocked : 1;
+
+	/* Disconnected during a dispatch, removed after it. */
+	guint removed : 1;
 
-	gchar *identifier;
-} MessageIdentifier;
+	GDestroyNotify destroy_data;
+	GeditMessageCallback callback;
+	gpointer user_data;
+} Listener;
 
 typedef struct
 {
-	MessageIdentifier *identifier;
+	const GeditMessageIdentifier *identifier;
 
-	GList *listeners;
+	/* Element type: Listener, in the order of connection. */
+	GArray *listeners;
+
+	guint n_removed;
+
+	/* The depth of the dispatches in progress. */
+	guint dispatch_depth;
 } Message;
 
+/* The key of a pending coalesced message. */
 typedef struct
 {
-	guint id;
-	gboolean blocked;
+	const GeditMessageIdentifier *identifier;
+	gchar *key;
 
-	GDestroyNotify destroy_data;
-	GeditMessageCallback callback;
-	gpointer user_data;
-} Listener;
+	/* The sequence number of the item in the queue. */
+	guint64 seq;
+} CoalesceKey;
 
 typedef struct
 {
-	Message *message;
-	GList *listener;
-} IdMap;
+	GeditMessage *message;
+
+	/* Owned by the coalesce table, NULL if not coalesced. */
+	CoalesceKey *coalesce_key;
+
+	gint64 enqueue_time;
+} QueueItem;
+
+/* A message posted from another thread. */
+typedef struct _PostedMessage PostedMessage;
+
+struct _PostedMessage
+{
+	PostedMessage *next;
+	GeditMessage *message;
+};
 
 struct _GeditMessageBusPrivate
 {
+	/* Key: GeditMessageIdentifier. Value: owned Message. */
 	GHashTable *messages;
+
+	/* Key: listener id. Value: Message. */
 	GHashTable *idmap;
 
-	GList *message_queue;
+	/* The ring buffer of the pending async messages. */
+	QueueItem *queue;
+	guint queue_capacity;
+	guint queue_head;
+	guint queue_length;
+
+	/* The sequence number of the item at the head of the queue. */
+	guint64 queue_head_seq;
+
+	/* Element type: owned CoalesceKey. */
+	GHashTable *coalesce;
+
 	guint idle_id;
 
+	/* Whether the idle is a continuation, at a lower priority. */
+	guint idle_continued : 1;
+
+	/* The time the message being dispatched waited in the queue. */
+	gint64 dispatch_latency;
+
+	/* The stack of the posted messages, the most recent first. Only
+	   accessed atomically. */
+	PostedMessage *posted;
+
+	/* Ready when messages are posted, in the main context of the bus. */
+	GSource *posted_source;
+
 	guint next_id;
 
-	GHashTable *types; /* mapping from identifier to GeditMessageType */
+	/* Key: GeditMessageIdentifier. Value: GType. */
+	GHashTable *types;
 };
 
 /* signals */
@@ -170,70 +245,145 @@ static void gedit_message_bus_dispatch_real (GeditMessageBus *bus,
 
 G_DEFINE_TYPE_WITH_PRIVATE (GeditMessageBus, gedit_message_bus, G_TYPE_OBJECT)
 
-static MessageIdentifier *
-message_identifier_new (const gchar *object_path,
-                        const gchar *method)
+static void
+message_free (Message *message)
 {
-	MessageIdentifier *ret;
-
-	ret = g_slice_new (MessageIdentifier);
-
-	ret->object_path = g_strdup (object_path);
-	ret->method = g_strdup (method);
+	for (guint i = 0; i < message->listeners->len; i++)
+	{
+		Listener *listener = &g_array_index (message->listeners, Listener, i);
 
-	ret->identifier = gedit_message_type_identifier (object_path, method);
+		if (!listener->removed && listener->destroy_data != NULL)
+		{
+			listener->destroy_data (listener->user_data);
+		}
+	}
 
-	return ret;
+	g_array_unref (message->listeners);
+	g_slice_free (Message, message);
 }
 
-static void
-message_identifier_free (MessageIdentifier *identifier)
+static PostedMessage *
+posted_steal_all (GeditMessageBus *bus)
 {
-	g_free (identifier->object_path);
-	g_free (identifier->method);
-	g_free (identifier->identifier);
+	PostedMessage *posted;
+	PostedMessage *reversed = NULL;
 
-	g_slice_free (MessageIdentifier, identifier);
+	posted = g_atomic_pointer_exchange (&bus->priv->posted, NULL);
+
+	/* to the order in which they were posted */
+	while (posted != NULL)
+	{
+		PostedMessage *next = posted->next;
+
+		posted->next = reversed;
+		reversed = posted;
+		posted = next;
+	}
+
+	return reversed;
 }
 
 static guint
-message_identifier_hash (gconstpointer id)
+coalesce_key_hash (gconstpointer key)
 {
-	return g_str_hash (((MessageIdentifier *)id)->identifier);
+	const CoalesceKey *coalesce_key = key;
+
+	return g_direct_hash (coalesce_key->identifier) * 31 +
+	       g_str_hash (coalesce_key->key);
 }
 
 static gboolean
-message_identifier_equal (gconstpointer id1,
-                          gconstpointer id2)
+coalesce_key_equal (gconstpointer a,
+                    gconstpointer b)
 {
-	return g_str_equal (((MessageIdentifier *)id1)->identifier,
-	                    ((MessageIdentifier *)id2)->identifier);
+	const CoalesceKey *key_a = a;
+	const CoalesceKey *key_b = b;
+
+	return key_a->identifier == key_b->identifier &&
+	       g_str_equal (key_a->key, key_b->key);
 }
 
 static void
-listener_free (Listener *listener)
+coalesce_key_free (CoalesceKey *coalesce_key)
+{
+	g_free (coalesce_key->key);
+	g_slice_free (CoalesceKey, coalesce_key);
+}
+
+static QueueItem *
+queue_nth (GeditMessageBus *bus,
+           guint            n)
 {
-	if (listener->destroy_data)
+	return &bus->priv->queue[(bus->priv->queue_head + n) % bus->priv->queue_capacity];
+}
+
+static void
+queue_clear (GeditMessageBus *bus)
+{
+	for (guint i = 0; i < bus->priv->queue_length; i++)
 	{
-		listener->destroy_data (listener->user_data);
+		g_object_unref (queue_nth (bus, i)->message);
 	}
 
-	g_slice_free (Listener, listener);
+	g_clear_pointer (&bus->priv->queue, g_free);
+	bus->priv->queue_capacity = 0;
+	bus->priv->queue_head = 0;
+	bus->priv->queue_head_seq += bus->priv->queue_length;
+	bus->priv->queue_length = 0;
+
+	g_hash_table_remove_all (bus->priv->coalesce);
 }
 
-static void
-message_free (Message *message)
+static QueueItem *
+queue_push_tail (GeditMessageBus *bus)
 {
-	message_identifier_free (message->identifier);
+	GeditMessageBusPrivate *priv = bus->priv;
 
-	g_list_free_full (message->listeners, (GDestroyNotify) listener_free);
-	g_slice_free (Message, message);
+	if (priv->queue_length == priv->queue_capacity)
+	{
+		guint capacity = MAX (16, priv->queue_capacity * 2);
+		QueueItem *queue = g_new (QueueItem, capacity);
+
+		/* linearize, the head goes back to the start */
+		for (guint i = 0; i < priv->queue_length; i++)
+		{
+			queue[i] = *queue_nth (bus, i);
+		}
+
+		g_free (priv->queue);
+		priv->queue = queue;
+		priv->queue_capacity = capacity;
+		priv->queue_head = 0;
+	}
+
+	return queue_nth (bus, priv->queue_length++);
 }
 
-static void
-message_queue_free (GList *queue)
+static QueueItem
+queue_pop_head (GeditMessageBus *bus)
 {
-	g_list_free_full (queue, g_object_unref);
+	GeditMessageBusPrivate *priv = bus->priv;
+	QueueItem item = *queue_nth (bus, 0);
+
+	priv->queue_head = (priv->queue_head + 1) % priv->queue_capacity;
+	priv->queue_head_seq++;
+	priv->queue_length--;
+
+	if (item.coalesce_key != NULL)
+	{
+		g_hash_table_remove (priv->coalesce, item.coalesce_key);
+		item.coalesce_key = NULL;
+	}
+
+	/* do not keep the memory of a burst */
+	if (priv->queue_length == 0 && priv->queue_capacity > QUEUE_KEEP_CAPACITY)
+	{
+		g_clear_pointer (&priv->queue, g_free);
+		priv->queue_capacity = 0;
+		priv->queue_head = 0;
+	}
+
+	return item;
 }
 
 static void
@@ -246,7 +396,20 @@ gedit_message_bus_finalize (GObject *object)
 		g_source_remove (bus->priv->idle_id);
 	}
 
-	message_queue_free (bus->priv->message_queue);
+	g_source_destroy (bus->priv->posted_source);
+	g_source_unref (bus->priv->posted_source);
+
+	for (PostedMessage *posted = posted_steal_all (bus); posted != NULL; )
+	{
+		PostedMessage *next = posted->next;
+
+		g_object_unref (posted->message);
+		g_slice_free (PostedMessage, posted);
+		posted = next;
+	}
+
+	queue_clear (bus);
+	g_hash_table_destroy (bus->priv->coalesce);
 
 	g_hash_table_destroy (bus->priv->messages);
 	g_hash_table_destroy (bus->priv->idmap);
@@ -274,6 +437,10 @@ gedit_message_bus_class_init (GeditMessageBusClass *klass)
 	 * Primary use of this signal is to customize the dispatch of a message
 	 * (for instance to automatically dispatch all messages over DBus).
 	 *
+	 * While a message is dispatched, gedit_message_bus_get_queue_depth()
+	 * and gedit_message_bus_get_dispatch_latency() tell how many messages
+	 * are waiting after it and how long it waited itself.
+	 *
 	 */
 	message_bus_signals[DISPATCH] =
 		g_signal_new ("dispatch",
@@ -329,17 +496,18 @@ gedit_message_bus_class_init (GeditMessageBusClass *klass)
 }
 
 static Message *
-message_new (GeditMessageBus *bus,
-             const gchar     *object_path,
-             const gchar     *method)
+message_new (GeditMessageBus              *bus,
+             const GeditMessageIdentifier *identifier)
 {
 	Message *message = g_slice_new (Message);
 
-	message->identifier = message_identifier_new (object_path, method);
-	message->listeners = NULL;
+	message->identifier = identifier;
+	message->listeners = g_array_new (FALSE, FALSE, sizeof (Listener));
+	message->n_removed = 0;
+	message->dispatch_depth = 0;
 
 	g_hash_table_insert (bus->priv->messages,
-	                     message->identifier,
+	                     (gpointer) identifier,
 	                     message);
 
 	return message;
@@ -351,12 +519,11 @@ lookup_message (GeditMessageBus *bus,
                 const gchar      *method,
                 gboolean          create)
 {
-	MessageIdentifier *identifier;
+	const GeditMessageIdentifier *identifier;
 	Message *message;
 
-	identifier = message_identifier_new (object_path, method);
+	identifier = _gedit_message_identifier_intern (object_path, method);
 	message = g_hash_table_lookup (bus->priv->messages, identifier);
-	message_identifier_free (identifier);
 
 	if (!message && !create)
 	{
@@ -365,7 +532,7 @@ lookup_message (GeditMessageBus *bus,
 
 	if (!message)
 	{
-		message = message_new (bus, object_path, method);
+		message = message_new (bus, identifier);
 	}
 
 	return message;
@@ -378,70 +545,101 @@ add_listener (GeditMessageBus      *bus,
               gpointer		    user_data,
               GDestroyNotify        destroy_data)
 {
-	Listener *listener;
-	IdMap *idmap;
+	Listener listener;
 
-	listener = g_slice_new (Listener);
-	listener->id = ++bus->priv->next_id;
-	listener->callback = callback;
-	listener->user_data = user_data;
-	listener->blocked = FALSE;
-	listener->destroy_data = destroy_data;
+	listener.id = ++bus->priv->next_id;
+	listener.callback = callback;
+	listener.user_data = user_data;
+	listener.blocked = FALSE;
+	listener.removed = FALSE;
+	listener.destroy_data = destroy_data;
 
-	message->listeners = g_list_append (message->listeners, listener);
+	g_array_append_val (message->listeners, listener);
 
-	idmap = g_new (IdMap, 1);
-	idmap->message = message;
-	idmap->listener = g_list_last (message->listeners);
+	g_hash_table_insert (bus->priv->idmap, GUINT_TO_POINTER (listener.id), message);
 
-	g_hash_table_insert (bus->priv->idmap, GINT_TO_POINTER (listener->id), idmap);
+	return listener.id;
+}
+
+/* Removes the listeners disconnected during the dispatches, and the message
+ * once it has no listeners.
+ */
+static void
+compact_listeners (GeditMessageBus *bus,
+                   Message         *message)
+{
+	if (message->dispatch_depth > 0)
+	{
+		return;
+	}
 
-	return listener->id;
+	if (message->n_removed > 0)
+	{
+		guint j = 0;
+
+		for (guint i = 0; i < message->listeners->len; i++)
+		{
+			Listener *listener = &g_array_index (message->listeners, Listener, i);
+
+			if (!listener->removed)
+			{
+				g_array_index (message->listeners, Listener, j++) = *listener;
+			}
+		}
+
+		g_array_set_size (message->listeners, j);
+		message->n_removed = 0;
+	}
+
+	if (message->listeners->len == 0)
+	{
+		/* remove message because it does not have any listeners */
+		g_hash_table_remove (bus->priv->messages, message->identifier);
+	}
 }
 
 static void
 remove_listener (GeditMessageBus *bus,
                  Message         *message,
-                 GList		 *listener)
+                 guint            index)
 {
-	Listener *lst;
+	Listener *listener;
+	GDestroyNotify destroy_data;
+	gpointer user_data;
 
-	lst = (Listener *)listener->data;
+	listener = &g_array_index (message->listeners, Listener, index);
+	destroy_data = listener->destroy_data;
+	user_data = listener->user_data;
 
 	/* remove from idmap */
-	g_hash_table_remove (bus->priv->idmap, GINT_TO_POINTER (lst->id));
-	listener_free (lst);
+	g_hash_table_remove (bus->priv->idmap, GUINT_TO_POINTER (listener->id));
+
+	/* remove from the listeners, after the dispatches in progress */
+	listener->removed = TRUE;
+	message->n_removed++;
 
-	/* remove from list of listeners */
-	message->listeners = g_list_delete_link (message->listeners, listener);
+	compact_listeners (bus, message);
 
-	if (!message->listeners)
+	if (destroy_data)
 	{
-		/* remove message because it does not have any listeners */
-		g_hash_table_remove (bus->priv->messages, message->identifier);
+		destroy_data (user_data);
 	}
 }
 
 static void
 block_listener (GeditMessageBus *bus,
                 Message         *message,
-                GList           *listener)
+                guint            index)
 {
-	Listener *lst;
-
-	lst = listener->data;
-	lst->blocked = TRUE;
+	g_array_index (message->listeners, Listener, index).blocked = TRUE;
 }
 
 static void
 unblock_listener (GeditMessageBus *bus,
                   Message         *message,
-                  GList           *listener)
+                  guint            index)
 {
-	Listener *lst;
-
-	lst = listener->data;
-	lst->blocked = FALSE;
+	g_array_index (message->listeners, Listener, index).blocked = FALSE;
 }
 
 static void
@@ -449,34 +647,37 @@ dispatch_message_real (GeditMessageBus *bus,
                        Message         *msg,
                        GeditMessage    *message)
 {
-	GList *item;
+	msg->dispatch_depth++;
 
-	for (item = msg->listeners; item; item = item->next)
+	/* The array can grow during the dispatch, the listeners connected
+	   meanwhile are called too */
+	for (guint i = 0; i < msg->listeners->len; i++)
 	{
-		Listener *listener = (Listener *)item->data;
+		Listener *listener = &g_array_index (msg->listeners, Listener, i);
 
-		if (!listener->blocked)
+		if (!listener->blocked && !listener->removed)
 		{
 			listener->callback (bus, message, listener->user_data);
 		}
 	}
+
+	msg->dispatch_depth--;
+
+	compact_listeners (bus, msg);
 }
 
 static void
 gedit_message_bus_dispatch_real (GeditMessageBus *bus,
                                  GeditMessage    *message)
 {
-	const gchar *object_path;
-	const gchar *method;
+	const GeditMessageIdentifier *identifier;
 	Message *msg;
 
-	object_path = gedit_message_get_object_path (message);
-	method = gedit_message_get_method (message);
+	identifier = _gedit_message_get_identifier (message);
 
-	g_return_if_fail (object_path != NULL);
-	g_return_if_fail (method != NULL);
+	g_return_if_fail (identifier != NULL);
 
-	msg = lookup_message (bus, object_path, method, FALSE);
+	msg = g_hash_table_lookup (bus->priv->messages, identifier);
 
 	if (msg)
 	{
@@ -486,54 +687,152 @@ gedit_message_bus_dispatch_real (GeditMessageBus *bus,
 
 static void
 dispatch_message (GeditMessageBus *bus,
-                  GeditMessage    *message)
+                  GeditMessage    *message,
+                  gint64           latency)
 {
+	gint64 saved_latency = bus->priv->dispatch_latency;
+
+	/* a sync message can be sent while an async one is dispatched */
+	bus->priv->dispatch_latency = latency;
 	g_signal_emit (bus, message_bus_signals[DISPATCH], 0, message);
+	bus->priv->dispatch_latency = saved_latency;
 }
 
 static gboolean
 idle_dispatch (GeditMessageBus *bus)
 {
-	GList *list;
-	GList *item;
+	GeditMessageBusPrivate *priv = bus->priv;
+	gint64 start;
+	gint64 now;
+	gint64 max_latency = 0;
+	guint n_dispatched = 0;
+
+	start = now = g_get_monotonic_time ();
+
+	/* the messages sent during the dispatch are queued after the pending
+	   ones, and dispatched in this slice if there is time left */
+	while (priv->queue_length > 0)
+	{
+		QueueItem item = queue_pop_head (bus);
+		gint64 latency = now - item.enqueue_time;
+
+		max_latency = MAX (max_latency, latency);
+
+		dispatch_message (bus, item.message, latency);
+		g_object_unref (item.message);
+		n_dispatched++;
+
+		now = g_get_monotonic_time ();
+
+		if (now - start >= DISPATCH_BUDGET)
+		{
+			break;
+		}
+	}
+
+	gedit_debug_message (DEBUG_PLUGINS,
+	                     "Dispatched %u messages in %" G_GINT64_FORMAT " us, "
+	                     "%u pending, waited up to %" G_GINT64_FORMAT " us",
+	                     n_dispatched,
+	                     now - start,
+	                     priv->queue_length,
+	                     max_latency);
+
+	if (priv->queue_length == 0)
+	{
+		priv->idle_id = 0;
+		priv->idle_continued = FALSE;
+		return G_SOURCE_REMOVE;
+	}
+
+	if (priv->idle_continued)
+	{
+		return G_SOURCE_CONTINUE;
+	}
+
+	/* let the input and the redraws in before the next slice */
+	priv->idle_continued = TRUE;
+	priv->idle_id = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+	                                 (GSourceFunc)idle_dispatch,
+	                                 bus,
+	                                 NULL);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void send_message_real (GeditMessageBus *bus,
+                               GeditMessage    *message,
+                               const gchar     *coalesce_key);
+
+static gboolean
+posted_dispatch (GeditMessageBus *bus)
+{
+	PostedMessage *posted;
 
-	/* make sure to set idle_id to 0 first so that any new async messages
-	   will be queued properly */
-	bus->priv->idle_id = 0;
+	/* before taking the messages, so that a message posted after them
+	   makes the source ready again */
+	g_source_set_ready_time (bus->priv->posted_source, -1);
 
-	/* reverse queue to get correct delivery order */
-	list = g_list_reverse (bus->priv->message_queue);
-	bus->priv->message_queue = NULL;
+	posted = posted_steal_all (bus);
 
-	for (item = list; item; item = item->next)
+	while (posted != NULL)
 	{
-		GeditMessage *msg = GEDIT_MESSAGE (item->data);
+		PostedMessage *next = posted->next;
+
+		send_message_real (bus, posted->message, NULL);
 
-		dispatch_message (bus, msg);
+		g_object_unref (posted->message);
+		g_slice_free (PostedMessage, posted);
+		posted = next;
 	}
 
-	message_queue_free (list);
-	return FALSE;
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+posted_source_dispatch (GSource     *source,
+                        GSourceFunc  callback,
+                        gpointer     user_data)
+{
+	return callback (user_data);
 }
 
-typedef void (*MatchCallback) (GeditMessageBus *, Message *, GList *);
+static GSourceFuncs posted_source_funcs =
+{
+	NULL,
+	NULL,
+	posted_source_dispatch,
+	NULL,
+	NULL,
+	NULL
+};
+
+typedef void (*MatchCallback) (GeditMessageBus *, Message *, guint);
 
 static void
 process_by_id (GeditMessageBus *bus,
                guint            id,
                MatchCallback    processor)
 {
-	IdMap *idmap;
+	Message *message;
 
-	idmap = (IdMap *)g_hash_table_lookup (bus->priv->idmap, GINT_TO_POINTER (id));
+	message = g_hash_table_lookup (bus->priv->idmap, GUINT_TO_POINTER (id));
 
-	if (idmap == NULL)
+	if (message != NULL)
 	{
-		g_warning ("No handler registered with id `%d'", id);
-		return;
+		for (guint i = 0; i < message->listeners->len; i++)
+		{
+			Listener *listener = &g_array_index (message->listeners, Listener, i);
+
+			if (listener->id == id && !listener->removed)
+			{
+				processor (bus, message, i);
+				return;
+			}
+		}
 	}
 
-	processor (bus, idmap->message, idmap->listener);
+	g_warning ("No handler registered with id `%d'", id);
 }
 
 static void
@@ -545,7 +844,6 @@ process_by_match (GeditMessageBus      *bus,
                   MatchCallback         processor)
 {
 	Message *message;
-	GList *item;
 
 	message = lookup_message (bus, object_path, method, FALSE);
 
@@ -555,14 +853,15 @@ process_by_match (GeditMessageBus      *bus,
 		return;
 	}
 
-	for (item = message->listeners; item; item = item->next)
+	for (guint i = 0; i < message->listeners->len; i++)
 	{
-		Listener *listener = (Listener *)item->data;
+		Listener *listener = &g_array_index (message->listeners, Listener, i);
 
 		if (listener->callback == callback &&
-		    listener->user_data == user_data)
+		    listener->user_data == user_data &&
+		    !listener->removed)
 		{
-			processor (bus, message, item);
+			processor (bus, message, i);
 			return;
 		}
 	}
@@ -570,31 +869,38 @@ process_by_match (GeditMessageBus      *bus,
 	g_warning ("No such handler registered for %s.%s", object_path, method);
 }
 
-static void
-free_type (gpointer data)
-{
-	g_slice_free (GType, data);
-}
-
 static void
 gedit_message_bus_init (GeditMessageBus *self)
 {
+	GMainContext *context;
+
 	self->priv = gedit_message_bus_get_instance_private (self);
 
-	self->priv->messages = g_hash_table_new_full (message_identifier_hash,
-	                                              message_identifier_equal,
+	self->priv->messages = g_hash_table_new_full (g_direct_hash,
+	                                              g_direct_equal,
 	                                              NULL,
 	                                              (GDestroyNotify) message_free);
 
-	self->priv->idmap = g_hash_table_new_full (g_direct_hash,
-	                                           g_direct_equal,
-	                                           NULL,
-	                                           (GDestroyNotify) g_free);
+	self->priv->idmap = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	self->priv->types = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	self->priv->coalesce = g_hash_table_new_full (coalesce_key_hash,
+	                                              coalesce_key_equal,
+	                                              (GDestroyNotify) coalesce_key_free,
+	                                              NULL);
 
-	self->priv->types = g_hash_table_new_full (message_identifier_hash,
-	                                           message_identifier_equal,
-	                                           (GDestroyNotify) message_identifier_free,
-	                                           (GDestroyNotify) free_type);
+	self->priv->posted_source = g_source_new (&posted_source_funcs, sizeof (GSource));
+	g_source_set_name (self->priv->posted_source, "[gedit] posted messages");
+	g_source_set_ready_time (self->priv->posted_source, -1);
+	g_source_set_callback (self->priv->posted_source,
+	                       (GSourceFunc)posted_dispatch,
+	                       self,
+	                       NULL);
+
+	context = g_main_context_ref_thread_default ();
+	g_source_attach (self->priv->posted_source, context);
+	g_main_context_unref (context);
 }
 
 /**
@@ -655,25 +961,16 @@ gedit_message_bus_lookup (GeditMessageBus *bus,
                           const gchar	  *object_path,
                           const gchar	  *method)
 {
-	MessageIdentifier *identifier;
-	GType *message_type;
+	const GeditMessageIdentifier *identifier;
 
 	g_return_val_if_fail (GEDIT_IS_MESSAGE_BUS (bus), G_TYPE_INVALID);
 	g_return_val_if_fail (object_path != NULL, G_TYPE_INVALID);
 	g_return_val_if_fail (method != NULL, G_TYPE_INVALID);
 
-	identifier = message_identifier_new (object_path, method);
-	message_type = g_hash_table_lookup (bus->priv->types, identifier);
-	message_identifier_free (identifier);
+	identifier = _gedit_message_identifier_intern (object_path, method);
 
-	if (!message_type)
-	{
-		return G_TYPE_INVALID;
-	}
-	else
-	{
-		return *message_type;
-	}
+	/* G_TYPE_INVALID is 0, that is NULL when not found */
+	return (GType) GPOINTER_TO_SIZE (g_hash_table_lookup (bus->priv->types, identifier));
 }
 
 /**
@@ -696,8 +993,7 @@ gedit_message_bus_register (GeditMessageBus *bus,
                             const gchar     *object_path,
                             const gchar	    *method)
 {
-	MessageIdentifier *identifier;
-	GType *ntype;
+	const GeditMessageIdentifier *identifier;
 
 	g_return_if_fail (GEDIT_IS_MESSAGE_BUS (bus));
 	g_return_if_fail (gedit_message_is_valid_object_path (object_path));
@@ -710,14 +1006,11 @@ gedit_message_bus_register (GeditMessageBus *bus,
 		           method);
 	}
 
-	identifier = message_identifier_new (object_path, method);
-	ntype = g_slice_new (GType);
-
-	*ntype = message_type;
+	identifier = _gedit_message_identifier_intern (object_path, method);
 
 	g_hash_table_insert (bus->priv->types,
-	                     identifier,
-	                     ntype);
+	                     (gpointer) identifier,
+	                     GSIZE_TO_POINTER (message_type));
 
 	g_signal_emit (bus,
 	               message_bus_signals[REGISTERED],
@@ -732,9 +1025,9 @@ gedit_message_bus_unregister_real (GeditMessageBus  *bus,
                                    const gchar      *method,
                                    gboolean          remove_from_store)
 {
-	MessageIdentifier *identifier;
+	const GeditMessageIdentifier *identifier;
 
-	identifier = message_identifier_new (object_path, method);
+	identifier = _gedit_message_identifier_intern (object_path, method);
 
 	if (!remove_from_store || g_hash_table_remove (bus->priv->types,
 	                                               identifier))
@@ -745,8 +1038,6 @@ gedit_message_bus_unregister_real (GeditMessageBus  *bus,
 		               object_path,
 		               method);
 	}
-
-	message_identifier_free (identifier);
 }
 
 /**
@@ -783,9 +1074,9 @@ typedef struct
 } UnregisterInfo;
 
 static gboolean
-unregister_each (MessageIdentifier *identifier,
-                 GType             *gtype,
-                 UnregisterInfo    *info)
+unregister_each (const GeditMessageIdentifier *identifier,
+                 gpointer                      gtype,
+                 UnregisterInfo               *info)
 {
 	if (g_strcmp0 (identifier->object_path, info->object_path) == 0)
 	{
@@ -844,18 +1135,15 @@ gedit_message_bus_is_registered (GeditMessageBus  *bus,
                                  const gchar	  *object_path,
                                  const gchar      *method)
 {
-	MessageIdentifier *identifier;
-	gboolean ret;
+	const GeditMessageIdentifier *identifier;
 
 	g_return_val_if_fail (GEDIT_IS_MESSAGE_BUS (bus), FALSE);
 	g_return_val_if_fail (object_path != NULL, FALSE);
 	g_return_val_if_fail (method != NULL, FALSE);
 
-	identifier = message_identifier_new (object_path, method);
-	ret = g_hash_table_lookup (bus->priv->types, identifier) != NULL;
-	message_identifier_free (identifier);
+	identifier = _gedit_message_identifier_intern (object_path, method);
 
-	return ret;
+	return g_hash_table_contains (bus->priv->types, identifier);
 }
 
 typedef struct
@@ -865,9 +1153,9 @@ typedef struct
 } ForeachInfo;
 
 static void
-foreach_type (MessageIdentifier *identifier,
-              GType              *message_type,
-              ForeachInfo       *info)
+foreach_type (const GeditMessageIdentifier *identifier,
+              gpointer                      message_type,
+              ForeachInfo                  *info)
 {
 	info->func (identifier->object_path,
 	            identifier->method,
@@ -1074,12 +1362,58 @@ gedit_message_bus_unblock_by_func (GeditMessageBus      *bus,
 
 static void
 send_message_real (GeditMessageBus *bus,
-                   GeditMessage    *message)
+                   GeditMessage    *message,
+                   const gchar     *coalesce_key)
 {
-	bus->priv->message_queue = g_list_prepend (bus->priv->message_queue,
-	                                           g_object_ref (message));
+	GeditMessageBusPrivate *priv = bus->priv;
+	gint64 now = g_get_monotonic_time ();
+	QueueItem *item;
+
+	if (coalesce_key != NULL)
+	{
+		CoalesceKey key;
+		CoalesceKey *pending;
+
+		key.identifier = _gedit_message_get_identifier (message);
+		key.key = (gchar *) coalesce_key;
+
+		g_return_if_fail (key.identifier != NULL);
+
+		pending = g_hash_table_lookup (priv->coalesce, &key);
+
+		if (pending != NULL)
+		{
+			/* replace the pending message, in its place in the queue */
+			item = queue_nth (bus, pending->seq - priv->queue_head_seq);
+
+			g_object_ref (message);
+			g_object_unref (item->message);
+			item->message = message;
+			item->enqueue_time = now;
+
+			return;
+		}
+
+		pending = g_slice_new (CoalesceKey);
+		pending->identifier = key.identifier;
+		pending->key = g_strdup (coalesce_key);
+		pending->seq = priv->queue_head_seq + priv->queue_length;
+
+		g_hash_table_add (priv->coalesce, pending);
+
+		item = queue_push_tail (bus);
+		item->coalesce_key = pending;
+	}
+	else
+	{
+		item = queue_push_tail (bus);
+		item->coalesce_key = NULL;
+	}
+
+	item->message = g_object_ref (message);
+	item->enqueue_time = now;
 
-	if (bus->priv->idle_id == 0)
+	if (priv->idle_id == 0)
 	{
 		bus->priv->idle_id = g_idle_add_full (G_PRIORITY_HIGH,
 		                                      (GSourceFunc)idle_dispatch,
@@ -1106,7 +1440,35 @@ gedit_message_bus_send_message (GeditMessageBus *bus,
 	g_return_if_fail (GEDIT_IS_MESSAGE_BUS (bus));
 	g_return_if_fail (GEDIT_IS_MESSAGE (message));
 
-	send_message_real (bus, message);
+	send_message_real (bus, message, NULL);
+}
+
+/**
+ * gedit_message_bus_send_message_coalesced:
+ * @bus: a #GeditMessageBus
+ * @message: the message to send
+ * @key: (allow-none): the coalescing key
+ *
+ * This sends the provided @message asynchronously over the bus, like
+ * gedit_message_bus_send_message(), but if a message of the same object path
+ * and method, sent with the same @key, is still waiting to be dispatched,
+ * @message replaces it: only the most recent one is dispatched, in the place
+ * of the first one in the queue.
+ *
+ * This is useful for the messages which only carry a state, where the
+ * intermediate states do not matter. A %NULL @key coalesces all the messages
+ * of the object path and method of @message.
+ *
+ */
+void
+gedit_message_bus_send_message_coalesced (GeditMessageBus *bus,
+                                          GeditMessage    *message,
+                                          const gchar     *key)
+{
+	g_return_if_fail (GEDIT_IS_MESSAGE_BUS (bus));
+	g_return_if_fail (GEDIT_IS_MESSAGE (message));
+
+	send_message_real (bus, message, key != NULL ? key : "");
 }
 
 /**
@@ -1127,7 +1489,86 @@ gedit_message_bus_send_message_sync (GeditMessageBus *bus,
 	g_return_if_fail (GEDIT_IS_MESSAGE_BUS (bus));
 	g_return_if_fail (GEDIT_IS_MESSAGE (message));
 
-	dispatch_message (bus, message);
+	dispatch_message (bus, message, 0);
+}
+
+/**
+ * gedit_message_bus_post_message:
+ * @bus: a #GeditMessageBus
+ * @message: the message to send
+ *
+ * This sends the provided @message asynchronously over the bus, like
+ * gedit_message_bus_send_message(), but can be called from any thread. The
+ * message is dispatched in the main context of the thread which created
+ * @bus, after the messages already sent.
+ *
+ * The caller must hold a reference to @bus, and must not modify @message
+ * afterwards.
+ *
+ */
+void
+gedit_message_bus_post_message (GeditMessageBus *bus,
+                                GeditMessage    *message)
+{
+	PostedMessage *posted;
+	PostedMessage *head;
+
+	g_return_if_fail (GEDIT_IS_MESSAGE_BUS (bus));
+	g_return_if_fail (GEDIT_IS_MESSAGE (message));
+
+	posted = g_slice_new (PostedMessage);
+	posted->message = g_object_ref (message);
+
+	do
+	{
+		head = g_atomic_pointer_get (&bus->priv->posted);
+		posted->next = head;
+	}
+	while (!g_atomic_pointer_compare_and_exchange (&bus->priv->posted, head, posted));
+
+	/* the messages already on the stack have woken up the source */
+	if (head == NULL)
+	{
+		g_source_set_ready_time (bus->priv->posted_source, 0);
+	}
+}
+
+/**
+ * gedit_message_bus_get_queue_depth:
+ * @bus: a #GeditMessageBus
+ *
+ * Get the number of messages sent asynchronously which are waiting to be
+ * dispatched. During the dispatch of a message, the message itself is not
+ * counted.
+ *
+ * Return value: the number of pending messages
+ *
+ */
+guint
+gedit_message_bus_get_queue_depth (GeditMessageBus *bus)
+{
+	g_return_val_if_fail (GEDIT_IS_MESSAGE_BUS (bus), 0);
+
+	return bus->priv->queue_length;
+}
+
+/**
+ * gedit_message_bus_get_dispatch_latency:
+ * @bus: a #GeditMessageBus
+ *
+ * Get the time the message being dispatched waited in the queue, from
+ * a #GeditMessageBus::dispatch handler or a #GeditMessageCallback. This is 0
+ * for a message sent synchronously, or outside of a dispatch.
+ *
+ * Return value: the latency of the current dispatch, in microseconds
+ *
+ */
+gint64
+gedit_message_bus_get_dispatch_latency (GeditMessageBus *bus)
+{
+	g_return_val_if_fail (GEDIT_IS_MESSAGE_BUS (bus), 0);
+
+	return bus->priv->dispatch_latency;
 }
 
 static GeditMessage *
@@ -1201,7 +1642,7 @@ gedit_message_bus_send (GeditMessageBus *bus,
 
 	if (message)
 	{
-		send_message_real (bus, message);
+		send_message_real (bus, message, NULL);
 		g_object_unref (message);
 	}
 	else
@@ -1248,7 +1689,7 @@ gedit_message_bus_send_sync (GeditMessageBus *bus,
 
 	if (message)
 	{
-		dispatch_message (bus, message);
+		dispatch_message (bus, message, 0);
 	}
 
 	va_end (var_args);
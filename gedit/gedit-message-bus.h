@@ -134,6 +134,12 @@ void              gedit_message_bus_send_message       (GeditMessageBus        *
                                                         GeditMessage           *message);
 void              gedit_message_bus_send_message_sync  (GeditMessageBus        *bus,
                                                         GeditMessage           *message);
+void              gedit_message_bus_send_message_coalesced
+                                                       (GeditMessageBus        *bus,
+                                                        GeditMessage           *message,
+                                                        const gchar            *key);
+void              gedit_message_bus_post_message       (GeditMessageBus        *bus,
+                                                        GeditMessage           *message);
 
 void              gedit_message_bus_send               (GeditMessageBus        *bus,
                                                         const gchar            *object_path,
@@ -147,6 +153,10 @@ GeditMessage     *gedit_message_bus_send_sync          (GeditMessageBus        *
                                                         const gchar            *first_property,
                                                         ...) G_GNUC_NULL_TERMINATED;
 
+guint             gedit_message_bus_get_queue_depth    (GeditMessageBus        *bus);
+gint64            gedit_message_bus_get_dispatch_latency
+                                                       (GeditMessageBus        *bus);
+
 G_END_DECLS
 
 #endif /* GEDIT_MESSAGE_BUS_H */
@@ -0,0 +1,36 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_MESSAGE_PRIVATE_H
+#define GEDIT_MESSAGE_PRIVATE_H
+
+#include "gedit-message.h"
+
+G_BEGIN_DECLS
+
+/* An (object path, method) pair, interned for the whole process: the same
+ * pair is always the same pointer, so it can be compared and hashed as a
+ * pointer. Never freed.
+ */
+typedef struct _GeditMessageIdentifier GeditMessageIdentifier;
+
+struct _GeditMessageIdentifier
+{
+	const gchar *object_path;
+	const gchar *method;
+
+	/* "object_path.method" */
+	const gchar *identifier;
+};
+
+const GeditMessageIdentifier *	_gedit_message_identifier_intern	(const gchar  *object_path,
+									 const gchar  *method);
+
+const GeditMessageIdentifier *	_gedit_message_get_identifier		(GeditMessage *message);
+
+G_END_DECLS
+
+#endif /* GEDIT_MESSAGE_PRIVATE_H */
+
+/* ex:set ts=8 noet: */
@@ -21,6 +21,7 @@
  */
 
 #include "gedit-message.h"
+#include "gedit-message-private.h"
 
 #include <string.h>
 
@@ -43,6 +44,9 @@ struct _GeditMessagePrivate
 {
 	gchar *object_path;
 	gchar *method;
+
+	/* Of object_path and method, NULL until both are set. */
+	const GeditMessageIdentifier *identifier;
 };
 
 enum
@@ -55,8 +59,89 @@ enum
 
 static GParamSpec *properties[LAST_PROP];
 
+/* Element type: GeditMessageIdentifier, never freed. */
+static GHashTable *identifiers = NULL;
+G_LOCK_DEFINE_STATIC (identifiers);
+
 G_DEFINE_TYPE_WITH_PRIVATE (GeditMessage, gedit_message, G_TYPE_OBJECT)
 
+static guint
+identifier_hash (gconstpointer key)
+{
+	const GeditMessageIdentifier *identifier = key;
+
+	return g_str_hash (identifier->object_path) * 33 + g_str_hash (identifier->method);
+}
+
+static gboolean
+identifier_equal (gconstpointer a,
+                  gconstpointer b)
+{
+	const GeditMessageIdentifier *identifier_a = a;
+	const GeditMessageIdentifier *identifier_b = b;
+
+	return strcmp (identifier_a->object_path, identifier_b->object_path) == 0 &&
+	       strcmp (identifier_a->method, identifier_b->method) == 0;
+}
+
+/* Only allocates the first time a pair is seen. */
+const GeditMessageIdentifier *
+_gedit_message_identifier_intern (const gchar *object_path,
+                                  const gchar *method)
+{
+	GeditMessageIdentifier key;
+	GeditMessageIdentifier *identifier;
+
+	g_return_val_if_fail (object_path != NULL, NULL);
+	g_return_val_if_fail (method != NULL, NULL);
+
+	key.object_path = object_path;
+	key.method = method;
+
+	G_LOCK (identifiers);
+
+	if (G_UNLIKELY (identifiers == NULL))
+	{
+		identifiers = g_hash_table_new (identifier_hash, identifier_equal);
+	}
+
+	identifier = g_hash_table_lookup (identifiers, &key);
+
+	if (identifier == NULL)
+	{
+		gchar *str;
+
+		str = gedit_message_type_identifier (object_path, method);
+
+		identifier = g_new (GeditMessageIdentifier, 1);
+		identifier->object_path = g_intern_string (object_path);
+		identifier->method = g_intern_string (method);
+		identifier->identifier = g_intern_string (str);
+
+		g_hash_table_add (identifiers, identifier);
+
+		g_free (str);
+	}
+
+	G_UNLOCK (identifiers);
+
+	return identifier;
+}
+
+static void
+update_identifier (GeditMessage *msg)
+{
+	if (msg->priv->object_path != NULL && msg->priv->method != NULL)
+	{
+		msg->priv->identifier = _gedit_message_identifier_intern (msg->priv->object_path,
+		                                                          msg->priv->method);
+	}
+	else
+	{
+		msg->priv->identifier = NULL;
+	}
+}
+
 static void
 gedit_message_finalize (GObject *object)
 {
@@ -105,10 +190,12 @@ gedit_message_set_property (GObject      *object,
 		case PROP_OBJECT_PATH:
 			g_free (msg->priv->object_path);
 			msg->priv->object_path = g_value_dup_string (value);
+			update_identifier (msg);
 			break;
 		case PROP_METHOD:
 			g_free (msg->priv->method);
 			msg->priv->method = g_value_dup_string (value);
+			update_identifier (msg);
 			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -195,6 +282,14 @@ gedit_message_get_object_path (GeditMessage *message)
 	return message->priv->object_path;
 }
 
+const GeditMessageIdentifier *
+_gedit_message_get_identifier (GeditMessage *message)
+{
+	g_return_val_if_fail (GEDIT_IS_MESSAGE (message), NULL);
+
+	return message->priv->identifier;
+}
+
 /**
  * gedit_message_is_valid_object_path:
  * @object_path: (allow-none): the object path
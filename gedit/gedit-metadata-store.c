@@ -0,0 +1,1783 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-metadata-store.h"
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+#include <tepl/tepl.h>
+#include "gedit-debug.h"
+#include "gedit-dirs.h"
+
+/* GeditMetadataStore: the documents metadata, stored in two files in the user
+ * data directory.
+ *
+ * gedit-metadata.db is a log of records. A record contains the URI of a
+ * document and all its metadata attributes; when the metadata of a document
+ * changes a new record is appended, superseding the previous one. Nothing is
+ * ever rewritten in place.
+ *
+ * gedit-metadata.idx is a hash table with open addressing, mapping the URIs to
+ * the offsets of their latest record. It covers the data file up to a certain
+ * offset, the records appended after it (the tail) are read when the store is
+ * opened. Both files are memory-mapped, so looking up a document doesn't
+ * depend on the number of entries, and opening the store only costs the size
+ * of the tail.
+ *
+ * When the tail or the superseded records become too big, or when there are
+ * too many documents, the store is compacted in a worker thread: the latest
+ * records are copied in a new data file, and a new index is written for it.
+ * Only the MAX_ENTRIES documents accessed most recently are kept, like the
+ * Tepl metadata manager limits the number of locations.
+ *
+ * The first time the store is created, the gedit-metadata.xml file of the Tepl
+ * metadata manager is imported.
+ *
+ * All the integers are stored in little-endian.
+ *
+ * Data file: header, then records.
+ *   header: magic (8 bytes), generation (u64).
+ *   record: payload size (u32), checksum of the payload (u32), payload.
+ *   payload: access time (u64, seconds since the Epoch), number of strings
+ *     (u32), then the strings: the URI followed by the key/value pairs. Each
+ *     string is its length (u32) followed by its bytes, without nul
+ *     terminator.
+ *
+ * Index file: header, then the slots.
+ *   header: magic (8 bytes), generation (u64) which must match the one of the
+ *     data file, data end (u64), live bytes (u64), number of slots (u32, a
+ *     power of two), number of entries (u32).
+ *   slot: URI hash (u32), reserved (u32), record offset (u64, 0 for an empty
+ *     slot).
+ */
+
+#define DATA_FILENAME "gedit-metadata.db"
+#define INDEX_FILENAME "gedit-metadata.idx"
+
+#define DATA_MAGIC "GEDITMD2"
+#define INDEX_MAGIC "GEDITMI2"
+#define MAGIC_SIZE (8)
+
+#define DATA_HEADER_SIZE (MAGIC_SIZE + 8)
+#define INDEX_HEADER_SIZE (MAGIC_SIZE + 8 + 8 + 8 + 4 + 4)
+#define SLOT_SIZE (16)
+#define RECORD_HEADER_SIZE (8)
+#define RECORD_MIN_PAYLOAD_SIZE (8 + 4)
+
+#define MIN_N_SLOTS (64)
+
+/* Compaction happens when the part of the data file not covered by the index
+ * is bigger than MAX_TAIL_SIZE, or when the superseded records take more than
+ * MIN_DEAD_SIZE and more than the live records.
+ */
+#define MAX_TAIL_SIZE (256 * 1024)
+#define MIN_DEAD_SIZE (512 * 1024)
+
+/* The compaction also happens when the number of documents exceeds
+ * MAX_ENTRIES by more than a tenth, and drops the least recently accessed
+ * ones.
+ */
+#define MAX_ENTRIES (10000)
+
+/* The access time of a record is only updated when it is older than that, so
+ * that opening a document doesn't always write a record.
+ */
+#define ATIME_RESOLUTION_SECONDS (24 * 60 * 60)
+
+/* Don't compete with the loading of the documents at startup. */
+#define COMPACTION_DELAY_SECONDS (10)
+
+#define COPY_BUFFER_SIZE (64 * 1024)
+
+struct _GeditMetadataStore
+{
+	GObject parent_instance;
+
+	gchar *data_path;
+	gchar *index_path;
+
+	/* Opened for reading and writing, the new records are written at
+	 * data_size. NULL if the store could not be opened, in which case the
+	 * metadata is only kept in memory.
+	 */
+	FILE *data_stream;
+	guint64 data_size;
+	guint64 generation;
+
+	/* The files as they were when the store was opened or last compacted.
+	 * The index covers the data file up to index_data_end, the records of
+	 * the tail are all in entries.
+	 */
+	GMappedFile *data_map;
+	GMappedFile *index_map;
+	const guint8 *index_slots;
+	guint32 index_n_slots;
+	guint32 index_n_entries;
+	guint64 index_data_end;
+
+	/* The documents not in the index, approximately. */
+	guint n_new_entries;
+
+	/* Approximate size of the records that are not superseded. */
+	guint64 live_bytes;
+
+	/* Key: owned URI. Value: owned Entry.
+	 * The documents looked up or modified since the store was opened.
+	 */
+	GHashTable *entries;
+
+	guint flush_idle_id;
+	guint compaction_timeout_id;
+	GCancellable *compaction_cancellable;
+};
+
+typedef struct
+{
+	/* Key: owned attribute key. Value: owned attribute value. */
+	GHashTable *attributes;
+
+	/* In seconds since the Epoch. */
+	gint64 atime;
+
+	/* The latest record of the entry, offset is 0 if there is none. */
+	guint64 offset;
+	guint32 record_size;
+} Entry;
+
+typedef struct
+{
+	gchar *uri;
+	guint64 offset;
+	gint64 atime;
+} OverlayRecord;
+
+/* A record copied by the compaction. */
+typedef struct
+{
+	gchar *uri;
+	guint64 offset;
+	guint32 record_size;
+	gint64 atime;
+} LiveRecord;
+
+typedef struct
+{
+	gchar *data_path;
+	gchar *new_data_path;
+	gchar *new_index_path;
+	guint64 snapshot_end;
+	guint64 new_generation;
+
+	GMappedFile *index_map;
+	guint32 index_n_slots;
+
+	/* The entries in memory, which take precedence over the index.
+	 * Element type: OverlayRecord.
+	 */
+	GArray *overlay;
+	GHashTable *overlay_uris;
+
+	/* Results. Key: owned URI. Value: owned guint64, the new offset. */
+	GHashTable *new_offsets;
+	guint64 new_data_end;
+} CompactionData;
+
+static GeditMetadataStore *singleton = NULL;
+
+G_DEFINE_TYPE (GeditMetadataStore, _gedit_metadata_store, G_TYPE_OBJECT)
+
+static guint32
+read_uint32 (const guint8 *data)
+{
+	guint32 value;
+
+	memcpy (&value, data, sizeof (value));
+	return GUINT32_FROM_LE (value);
+}
+
+static guint64
+read_uint64 (const guint8 *data)
+{
+	guint64 value;
+
+	memcpy (&value, data, sizeof (value));
+	return GUINT64_FROM_LE (value);
+}
+
+static void
+write_uint32 (guint8  *data,
+	      guint32  value)
+{
+	value = GUINT32_TO_LE (value);
+	memcpy (data, &value, sizeof (value));
+}
+
+static void
+write_uint64 (guint8  *data,
+	      guint64  value)
+{
+	value = GUINT64_TO_LE (value);
+	memcpy (data, &value, sizeof (value));
+}
+
+static void
+append_uint32 (GByteArray *bytes,
+	       guint32     value)
+{
+	value = GUINT32_TO_LE (value);
+	g_byte_array_append (bytes, (const guint8 *) &value, sizeof (value));
+}
+
+static void
+append_uint64 (GByteArray *bytes,
+	       guint64     value)
+{
+	value = GUINT64_TO_LE (value);
+	g_byte_array_append (bytes, (const guint8 *) &value, sizeof (value));
+}
+
+static void
+append_string (GByteArray  *bytes,
+	       const gchar *str)
+{
+	gsize length = strlen (str);
+
+	append_uint32 (bytes, length);
+	g_byte_array_append (bytes, (const guint8 *) str, length);
+}
+
+/* FNV-1a, for the checksums and the index. */
+static guint32
+hash_bytes (const guint8 *data,
+	    gsize         length)
+{
+	guint32 hash = 2166136261u;
+	gsize i;
+
+	for (i = 0; i < length; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static guint32
+hash_uri (const gchar *uri)
+{
+	return hash_bytes ((const guint8 *) uri, strlen (uri));
+}
+
+static guint64
+new_generation (void)
+{
+	return ((guint64) g_random_int () << 32) | g_random_int ();
+}
+
+static Entry *
+entry_new (void)
+{
+	Entry *entry = g_new0 (Entry, 1);
+
+	entry->attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	return entry;
+}
+
+static void
+entry_free (Entry *entry)
+{
+	if (entry != NULL)
+	{
+		g_hash_table_unref (entry->attributes);
+		g_free (entry);
+	}
+}
+
+static GByteArray *
+encode_record (const gchar *uri,
+	       gint64       atime,
+	       GHashTable  *attributes)
+{
+	GByteArray *record;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	guint32 payload_size;
+
+	record = g_byte_array_new ();
+
+	/* The header is filled at the end. */
+	g_byte_array_set_size (record, RECORD_HEADER_SIZE);
+
+	append_uint64 (record, atime);
+	append_uint32 (record, 1 + 2 * g_hash_table_size (attributes));
+	append_string (record, uri);
+
+	g_hash_table_iter_init (&iter, attributes);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		append_string (record, key);
+		append_string (record, value);
+	}
+
+	payload_size = record->len - RECORD_HEADER_SIZE;
+	write_uint32 (record->data, payload_size);
+	write_uint32 (record->data + 4, hash_bytes (record->data + RECORD_HEADER_SIZE, payload_size));
+
+	return record;
+}
+
+/* Returns FALSE if there is no valid record at @offset. @atime, @uri and
+ * @attributes are optional.
+ */
+static gboolean
+parse_record (const guint8  *data,
+	      gsize          length,
+	      guint64        offset,
+	      guint32       *record_size,
+	      gint64        *atime,
+	      gchar        **uri,
+	      GHashTable   **attributes)
+{
+	const guint8 *payload;
+	guint32 payload_size;
+	guint32 n_strings;
+	gsize pos;
+	gchar *parsed_uri = NULL;
+	GHashTable *parsed_attributes = NULL;
+	gchar *key = NULL;
+	guint32 i;
+
+	if (offset > length ||
+	    length - offset < RECORD_HEADER_SIZE)
+	{
+		return FALSE;
+	}
+
+	payload_size = read_uint32 (data + offset);
+	payload = data + offset + RECORD_HEADER_SIZE;
+
+	if (length - offset - RECORD_HEADER_SIZE < payload_size ||
+	    payload_size < RECORD_MIN_PAYLOAD_SIZE ||
+	    read_uint32 (data + offset + 4) != hash_bytes (payload, payload_size))
+	{
+		return FALSE;
+	}
+
+	n_strings = read_uint32 (payload + 8);
+	if (n_strings % 2 != 1)
+	{
+		return FALSE;
+	}
+
+	if (attributes != NULL)
+	{
+		parsed_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	}
+
+	pos = RECORD_MIN_PAYLOAD_SIZE;
+	for (i = 0; i < n_strings; i++)
+	{
+		const gchar *str;
+		guint32 str_length;
+
+		if (payload_size - pos < 4)
+		{
+			goto error;
+		}
+
+		str_length = read_uint32 (payload + pos);
+		pos += 4;
+
+		if (payload_size - pos < str_length)
+		{
+			goto error;
+		}
+
+		str = (const gchar *) payload + pos;
+		pos += str_length;
+
+		if (i == 0)
+		{
+			if (uri != NULL)
+			{
+				parsed_uri = g_strndup (str, str_length);
+			}
+
+			if (attributes == NULL)
+			{
+				/* Nothing else to extract, the checksum
+				 * already guarantees the rest.
+				 */
+				break;
+			}
+		}
+		else if (i % 2 == 1)
+		{
+			key = g_strndup (str, str_length);
+		}
+		else
+		{
+			g_hash_table_replace (parsed_attributes, key, g_strndup (str, str_length));
+			key = NULL;
+		}
+	}
+
+	if (record_size != NULL)
+	{
+		*record_size = RECORD_HEADER_SIZE + payload_size;
+	}
+	if (atime != NULL)
+	{
+		*atime = (gint64) read_uint64 (payload);
+	}
+	if (uri != NULL)
+	{
+		*uri = parsed_uri;
+	}
+	if (attributes != NULL)
+	{
+		*attributes = parsed_attributes;
+	}
+
+	return TRUE;
+
+error:
+	g_free (parsed_uri);
+	g_free (key);
+	if (parsed_attributes != NULL)
+	{
+		g_hash_table_unref (parsed_attributes);
+	}
+
+	return FALSE;
+}
+
+static gboolean
+index_lookup (GeditMetadataStore *store,
+	      const gchar        *uri,
+	      guint64            *offset)
+{
+	const guint8 *data;
+	gsize length;
+	guint32 hash;
+	guint32 i;
+
+	if (store->index_slots == NULL || store->data_map == NULL)
+	{
+		return FALSE;
+	}
+
+	data = (const guint8 *) g_mapped_file_get_contents (store->data_map);
+	length = MIN (g_mapped_file_get_length (store->data_map), store->index_data_end);
+	hash = hash_uri (uri);
+
+	for (i = 0; i < store->index_n_slots; i++)
+	{
+		const guint8 *slot;
+		guint64 slot_offset;
+		gchar *slot_uri = NULL;
+		gboolean found;
+
+		slot = store->index_slots + ((hash + i) & (store->index_n_slots - 1)) * SLOT_SIZE;
+		slot_offset = read_uint64 (slot + 8);
+
+		if (slot_offset == 0)
+		{
+			return FALSE;
+		}
+
+		if (read_uint32 (slot) != hash ||
+		    !parse_record (data, length, slot_offset, NULL, NULL, &slot_uri, NULL))
+		{
+			continue;
+		}
+
+		found = g_str_equal (slot_uri, uri);
+		g_free (slot_uri);
+
+		if (found)
+		{
+			*offset = slot_offset;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static Entry *
+get_entry (GeditMetadataStore *store,
+	   const gchar        *uri,
+	   gboolean            create)
+{
+	Entry *entry;
+	guint64 offset;
+
+	entry = g_hash_table_lookup (store->entries, uri);
+	if (entry != NULL)
+	{
+		return entry;
+	}
+
+	if (index_lookup (store, uri, &offset))
+	{
+		GHashTable *attributes = NULL;
+		guint32 record_size = 0;
+		gint64 atime = 0;
+
+		if (parse_record ((const guint8 *) g_mapped_file_get_contents (store->data_map),
+				  store->index_data_end,
+				  offset,
+				  &record_size,
+				  &atime,
+				  NULL,
+				  &attributes))
+		{
+			entry = g_new0 (Entry, 1);
+			entry->attributes = attributes;
+			entry->atime = atime;
+			entry->offset = offset;
+			entry->record_size = record_size;
+		}
+	}
+
+	if (entry == NULL)
+	{
+		if (!create)
+		{
+			return NULL;
+		}
+
+		entry = entry_new ();
+		store->n_new_entries++;
+	}
+
+	g_hash_table_insert (store->entries, g_strdup (uri), entry);
+	return entry;
+}
+
+/* Takes into account that the record at @offset supersedes the previous record
+ * of @entry.
+ */
+static void
+set_entry_record (GeditMetadataStore *store,
+		  Entry              *entry,
+		  guint64             offset,
+		  guint32             record_size)
+{
+	if (entry->offset != 0)
+	{
+		store->live_bytes -= MIN (store->live_bytes, entry->record_size);
+	}
+
+	entry->offset = offset;
+	entry->record_size = record_size;
+	store->live_bytes += record_size;
+}
+
+static gboolean
+compaction_needed (GeditMetadataStore *store)
+{
+	guint64 tail_size;
+	guint64 dead_size;
+
+	tail_size = store->data_size - store->index_data_end;
+	dead_size = store->data_size - DATA_HEADER_SIZE;
+	dead_size -= MIN (dead_size, store->live_bytes);
+
+	return (tail_size > MAX_TAIL_SIZE ||
+		(dead_size > MIN_DEAD_SIZE && dead_size > store->live_bytes) ||
+		(guint64) store->index_n_entries + store->n_new_entries > MAX_ENTRIES + MAX_ENTRIES / 10);
+}
+
+static void start_compaction (GeditMetadataStore *store);
+
+static gboolean
+compaction_timeout_cb (gpointer user_data)
+{
+	GeditMetadataStore *store = GEDIT_METADATA_STORE (user_data);
+
+	store->compaction_timeout_id = 0;
+	start_compaction (store);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_compaction (GeditMetadataStore *store)
+{
+	if (store->data_stream == NULL ||
+	    store->compaction_timeout_id != 0 ||
+	    store->compaction_cancellable != NULL ||
+	    !compaction_needed (store))
+	{
+		return;
+	}
+
+	store->compaction_timeout_id = g_timeout_add_seconds (COMPACTION_DELAY_SECONDS,
+							      compaction_timeout_cb,
+							      store);
+}
+
+/* Appends a record with the current attributes of @entry. The stream is not
+ * flushed.
+ */
+static void
+write_entry (GeditMetadataStore *store,
+	     const gchar        *uri,
+	     Entry              *entry)
+{
+	GByteArray *record;
+
+	if (store->data_stream == NULL)
+	{
+		return;
+	}
+
+	record = encode_record (uri, entry->atime, entry->attributes);
+
+	if (fseek (store->data_stream, store->data_size, SEEK_SET) != 0 ||
+	    fwrite (record->data, 1, record->len, store->data_stream) != record->len)
+	{
+		g_warning ("Error when writing the metadata to “%s”.", store->data_path);
+
+		/* A partial record is overwritten by the next one, or ignored
+		 * when the store is opened the next time.
+		 */
+		clearerr (store->data_stream);
+	}
+	else
+	{
+		set_entry_record (store, entry, store->data_size, record->len);
+		store->data_size += record->len;
+	}
+
+	g_byte_array_unref (record);
+}
+
+static void
+flush_stream (GeditMetadataStore *store)
+{
+	if (store->data_stream != NULL &&
+	    fflush (store->data_stream) != 0)
+	{
+		g_warning ("Error when writing the metadata to “%s”.", store->data_path);
+		clearerr (store->data_stream);
+	}
+}
+
+static gboolean
+flush_idle_cb (gpointer user_data)
+{
+	GeditMetadataStore *store = GEDIT_METADATA_STORE (user_data);
+
+	store->flush_idle_id = 0;
+	flush_stream (store);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* The records written during one main loop iteration are flushed together. */
+static void
+schedule_flush (GeditMetadataStore *store)
+{
+	if (store->data_stream != NULL && store->flush_idle_id == 0)
+	{
+		store->flush_idle_id = g_idle_add_full (G_PRIORITY_LOW,
+							flush_idle_cb,
+							store,
+							NULL);
+	}
+}
+
+static void
+unmap_files (GeditMetadataStore *store)
+{
+	g_clear_pointer (&store->data_map, g_mapped_file_unref);
+	g_clear_pointer (&store->index_map, g_mapped_file_unref);
+	store->index_slots = NULL;
+	store->index_n_slots = 0;
+	store->index_n_entries = 0;
+	store->index_data_end = DATA_HEADER_SIZE;
+}
+
+/* Maps the index file if it is valid for the data file. */
+static void
+map_index (GeditMetadataStore *store)
+{
+	GMappedFile *index_map;
+	const guint8 *data;
+	gsize length;
+	guint64 data_end;
+	guint32 n_slots;
+
+	index_map = g_mapped_file_new (store->index_path, FALSE, NULL);
+	if (index_map == NULL)
+	{
+		return;
+	}
+
+	data = (const guint8 *) g_mapped_file_get_contents (index_map);
+	length = g_mapped_file_get_length (index_map);
+
+	if (length < INDEX_HEADER_SIZE ||
+	    memcmp (data, INDEX_MAGIC, MAGIC_SIZE) != 0 ||
+	    read_uint64 (data + MAGIC_SIZE) != store->generation)
+	{
+		gedit_debug_message (DEBUG_DOCUMENT, "Metadata index out of date");
+		g_mapped_file_unref (index_map);
+		return;
+	}
+
+	data_end = read_uint64 (data + MAGIC_SIZE + 8);
+	n_slots = read_uint32 (data + MAGIC_SIZE + 24);
+
+	if (data_end < DATA_HEADER_SIZE ||
+	    store->data_map == NULL ||
+	    data_end > g_mapped_file_get_length (store->data_map) ||
+	    n_slots == 0 ||
+	    (n_slots & (n_slots - 1)) != 0 ||
+	    length != INDEX_HEADER_SIZE + (gsize) n_slots * SLOT_SIZE)
+	{
+		g_warning ("The metadata index “%s” is invalid, it will be rebuilt.",
+			   store->index_path);
+		g_mapped_file_unref (index_map);
+		return;
+	}
+
+	store->index_map = index_map;
+	store->index_slots = data + INDEX_HEADER_SIZE;
+	store->index_n_slots = n_slots;
+	store->index_n_entries = read_uint32 (data + MAGIC_SIZE + 28);
+	store->index_data_end = data_end;
+	store->live_bytes = read_uint64 (data + MAGIC_SIZE + 16);
+}
+
+/* Reads the records not covered by the index. */
+static void
+replay_tail (GeditMetadataStore *store)
+{
+	const guint8 *data;
+	gsize length;
+	guint64 offset;
+	guint n_records = 0;
+
+	data = (const guint8 *) g_mapped_file_get_contents (store->data_map);
+	length = g_mapped_file_get_length (store->data_map);
+	offset = store->index_data_end;
+
+	while (offset < length)
+	{
+		gchar *uri = NULL;
+		GHashTable *attributes = NULL;
+		guint32 record_size = 0;
+		gint64 atime = 0;
+		Entry *entry;
+
+		if (!parse_record (data, length, offset, &record_size, &atime, &uri, &attributes))
+		{
+			/* Most probably a record partially written when gedit
+			 * was killed. It will be overwritten.
+			 */
+			gedit_debug_message (DEBUG_DOCUMENT,
+					     "Ignoring %" G_GUINT64_FORMAT " bytes at the end of the metadata",
+					     (guint64) length - offset);
+			break;
+		}
+
+		entry = get_entry (store, uri, TRUE);
+		g_hash_table_unref (entry->attributes);
+		entry->attributes = attributes;
+		entry->atime = atime;
+		set_entry_record (store, entry, offset, record_size);
+
+		offset += record_size;
+		n_records++;
+		g_free (uri);
+	}
+
+	store->data_size = offset;
+
+	gedit_debug_message (DEBUG_DOCUMENT,
+			     "Metadata opened: %u indexed slots, %u records in the tail",
+			     store->index_n_slots,
+			     n_records);
+}
+
+static gboolean
+create_data_file (GeditMetadataStore *store)
+{
+	guint8 header[DATA_HEADER_SIZE];
+
+	g_mkdir_with_parents (gedit_dirs_get_user_data_dir (), 0755);
+
+	store->data_stream = g_fopen (store->data_path, "w+b");
+	if (store->data_stream == NULL)
+	{
+		g_warning ("Impossible to create the metadata file “%s”: %s",
+			   store->data_path,
+			   g_strerror (errno));
+		return FALSE;
+	}
+
+	store->generation = new_generation ();
+	memcpy (header, DATA_MAGIC, MAGIC_SIZE);
+	write_uint64 (header + MAGIC_SIZE, store->generation);
+
+	if (fwrite (header, 1, DATA_HEADER_SIZE, store->data_stream) != DATA_HEADER_SIZE ||
+	    fflush (store->data_stream) != 0)
+	{
+		g_warning ("Error when writing the metadata to “%s”.", store->data_path);
+		fclose (store->data_stream);
+		store->data_stream = NULL;
+		return FALSE;
+	}
+
+	store->data_size = DATA_HEADER_SIZE;
+	return TRUE;
+}
+
+/* Returns FALSE if the data file doesn't exist or is not valid. */
+static gboolean
+open_data_file (GeditMetadataStore *store)
+{
+	const guint8 *data;
+
+	store->data_map = g_mapped_file_new (store->data_path, FALSE, NULL);
+	if (store->data_map == NULL)
+	{
+		return FALSE;
+	}
+
+	data = (const guint8 *) g_mapped_file_get_contents (store->data_map);
+
+	if (g_mapped_file_get_length (store->data_map) < DATA_HEADER_SIZE ||
+	    memcmp (data, DATA_MAGIC, MAGIC_SIZE) != 0)
+	{
+		g_warning ("The metadata file “%s” is invalid, it will be recreated.",
+			   store->data_path);
+		g_clear_pointer (&store->data_map, g_mapped_file_unref);
+		return FALSE;
+	}
+
+	store->generation = read_uint64 (data + MAGIC_SIZE);
+
+	store->data_stream = g_fopen (store->data_path, "r+b");
+	if (store->data_stream == NULL)
+	{
+		g_warning ("Impossible to open the metadata file “%s”: %s",
+			   store->data_path,
+			   g_strerror (errno));
+	}
+
+	return TRUE;
+}
+
+/* Import of the gedit-metadata.xml file of the Tepl metadata manager:
+ *
+ * <metadata>
+ *   <document uri="file:///…" atime="seconds since the Epoch">
+ *     <entry key="…" value="…"/>
+ *   </document>
+ * </metadata>
+ */
+
+typedef struct
+{
+	GeditMetadataStore *store;
+	gchar *uri;
+	gint64 atime;
+	GHashTable *attributes;
+	guint n_documents;
+} ImportData;
+
+static const gchar *
+find_attribute (const gchar  *name,
+		const gchar **attribute_names,
+		const gchar **attribute_values)
+{
+	gint i;
+
+	for (i = 0; attribute_names[i] != NULL; i++)
+	{
+		if (g_str_equal (attribute_names[i], name))
+		{
+			return attribute_values[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void
+import_start_element (GMarkupParseContext  *context,
+		      const gchar          *element_name,
+		      const gchar         **attribute_names,
+		      const gchar         **attribute_values,
+		      gpointer              user_data,
+		      GError              **error)
+{
+	ImportData *data = user_data;
+
+	if (g_str_equal (element_name, "document"))
+	{
+		const gchar *uri;
+		const gchar *atime;
+
+		uri = find_attribute ("uri", attribute_names, attribute_values);
+		atime = find_attribute ("atime", attribute_names, attribute_values);
+
+		g_free (data->uri);
+		data->uri = g_strdup (uri);
+		data->atime = atime != NULL ? g_ascii_strtoll (atime, NULL, 10) : 0;
+		g_hash_table_remove_all (data->attributes);
+	}
+	else if (g_str_equal (element_name, "entry") && data->uri != NULL)
+	{
+		const gchar *key;
+		const gchar *value;
+
+		key = find_attribute ("key", attribute_names, attribute_values);
+		value = find_attribute ("value", attribute_names, attribute_values);
+
+		if (key != NULL && value != NULL)
+		{
+			g_hash_table_replace (data->attributes, g_strdup (key), g_strdup (value));
+		}
+	}
+}
+
+static void
+import_end_element (GMarkupParseContext  *context,
+		    const gchar          *element_name,
+		    gpointer              user_data,
+		    GError              **error)
+{
+	ImportData *data = user_data;
+	Entry *entry;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	if (!g_str_equal (element_name, "document") ||
+	    data->uri == NULL ||
+	    g_hash_table_size (data->attributes) == 0)
+	{
+		return;
+	}
+
+	entry = get_entry (data->store, data->uri, TRUE);
+
+	g_hash_table_iter_init (&iter, data->attributes);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		g_hash_table_replace (entry->attributes, g_strdup (key), g_strdup (value));
+	}
+
+	entry->atime = data->atime > 0 ? data->atime : g_get_real_time () / G_USEC_PER_SEC;
+	write_entry (data->store, data->uri, entry);
+	data->n_documents++;
+
+	g_clear_pointer (&data->uri, g_free);
+}
+
+static void
+import_xml_file (GeditMetadataStore *store)
+{
+	static const GMarkupParser parser =
+	{
+		import_start_element,
+		import_end_element,
+		NULL,
+		NULL,
+		NULL
+	};
+	TeplAbstractFactory *factory;
+	GFile *xml_file;
+	gchar *xml_path;
+	gchar *contents = NULL;
+	gsize length;
+	ImportData data = { store, NULL, 0, NULL, 0 };
+	GMarkupParseContext *context;
+	GError *error = NULL;
+
+	factory = tepl_abstract_factory_get_singleton ();
+	xml_file = tepl_abstract_factory_create_metadata_manager_file (factory);
+	if (xml_file == NULL)
+	{
+		return;
+	}
+
+	xml_path = g_file_get_path (xml_file);
+	g_object_unref (xml_file);
+
+	if (xml_path == NULL ||
+	    !g_file_get_contents (xml_path, &contents, &length, NULL))
+	{
+		g_free (xml_path);
+		return;
+	}
+
+	data.attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	context = g_markup_parse_context_new (&parser, 0, &data, NULL);
+
+	if (!g_markup_parse_context_parse (context, contents, length, &error) ||
+	    !g_markup_parse_context_end_parse (context, &error))
+	{
+		g_warning ("Error when importing the metadata from “%s”: %s",
+			   xml_path,
+			   error->message);
+		g_clear_error (&error);
+	}
+
+	flush_stream (store);
+
+	gedit_debug_message (DEBUG_DOCUMENT,
+			     "Imported the metadata of %u documents from %s",
+			     data.n_documents,
+			     xml_path);
+
+	g_markup_parse_context_free (context);
+	g_hash_table_unref (data.attributes);
+	g_free (data.uri);
+	g_free (contents);
+	g_free (xml_path);
+}
+
+static void
+open_store (GeditMetadataStore *store)
+{
+	store->data_path = g_build_filename (gedit_dirs_get_user_data_dir (), DATA_FILENAME, NULL);
+	store->index_path = g_build_filename (gedit_dirs_get_user_data_dir (), INDEX_FILENAME, NULL);
+	store->index_data_end = DATA_HEADER_SIZE;
+
+	if (open_data_file (store))
+	{
+		map_index (store);
+		replay_tail (store);
+	}
+	else if (create_data_file (store))
+	{
+		import_xml_file (store);
+	}
+
+	schedule_compaction (store);
+}
+
+static void
+close_store (GeditMetadataStore *store)
+{
+	if (store->flush_idle_id != 0)
+	{
+		g_source_remove (store->flush_idle_id);
+		store->flush_idle_id = 0;
+	}
+
+	if (store->compaction_timeout_id != 0)
+	{
+		g_source_remove (store->compaction_timeout_id);
+		store->compaction_timeout_id = 0;
+	}
+
+	if (store->compaction_cancellable != NULL)
+	{
+		g_cancellable_cancel (store->compaction_cancellable);
+		g_clear_object (&store->compaction_cancellable);
+	}
+
+	if (store->data_stream != NULL)
+	{
+		flush_stream (store);
+		fclose (store->data_stream);
+		store->data_stream = NULL;
+	}
+
+	unmap_files (store);
+}
+
+/* Compaction */
+
+static void
+compaction_data_free (CompactionData *data)
+{
+	if (data != NULL)
+	{
+		guint i;
+
+		for (i = 0; i < data->overlay->len; i++)
+		{
+			g_free (g_array_index (data->overlay, OverlayRecord, i).uri);
+		}
+
+		g_free (data->data_path);
+		g_free (data->new_data_path);
+		g_free (data->new_index_path);
+		g_clear_pointer (&data->index_map, g_mapped_file_unref);
+		g_array_unref (data->overlay);
+		g_hash_table_unref (data->overlay_uris);
+		g_clear_pointer (&data->new_offsets, g_hash_table_unref);
+		g_free (data);
+	}
+}
+
+static gboolean
+copy_record (FILE         *stream,
+	     const guint8 *record,
+	     guint32       record_size,
+	     gchar        *uri,
+	     GArray       *slots,
+	     GHashTable   *new_offsets,
+	     guint64      *position)
+{
+	guint64 *new_offset;
+	guint8 slot[SLOT_SIZE] = { 0 };
+
+	if (fwrite (record, 1, record_size, stream) != record_size)
+	{
+		g_free (uri);
+		return FALSE;
+	}
+
+	write_uint32 (slot, hash_uri (uri));
+	write_uint64 (slot + 8, *position);
+	g_array_append_vals (slots, slot, 1);
+
+	new_offset = g_new (guint64, 1);
+	*new_offset = *position;
+	g_hash_table_replace (new_offsets, uri, new_offset);
+
+	*position += record_size;
+	return TRUE;
+}
+
+static gboolean
+write_index (CompactionData  *data,
+	     GArray          *slots,
+	     GError         **error)
+{
+	guint8 *index;
+	gsize index_size;
+	guint32 n_slots = MIN_N_SLOTS;
+	guint i;
+	gboolean ok;
+
+	/* Keep the load factor under one half. */
+	while (n_slots < 2 * slots->len)
+	{
+		n_slots *= 2;
+	}
+
+	index_size = INDEX_HEADER_SIZE + (gsize) n_slots * SLOT_SIZE;
+	index = g_malloc0 (index_size);
+
+	memcpy (index, INDEX_MAGIC, MAGIC_SIZE);
+	write_uint64 (index + MAGIC_SIZE, data->new_generation);
+	write_uint64 (index + MAGIC_SIZE + 8, data->new_data_end);
+	write_uint64 (index + MAGIC_SIZE + 16, data->new_data_end - DATA_HEADER_SIZE);
+	write_uint32 (index + MAGIC_SIZE + 24, n_slots);
+	write_uint32 (index + MAGIC_SIZE + 28, slots->len);
+
+	for (i = 0; i < slots->len; i++)
+	{
+		const guint8 *slot = (const guint8 *) slots->data + i * SLOT_SIZE;
+		guint32 pos = read_uint32 (slot);
+
+		while (read_uint64 (index + INDEX_HEADER_SIZE + (pos & (n_slots - 1)) * SLOT_SIZE + 8) != 0)
+		{
+			pos++;
+		}
+
+		memcpy (index + INDEX_HEADER_SIZE + (pos & (n_slots - 1)) * SLOT_SIZE, slot, SLOT_SIZE);
+	}
+
+	ok = g_file_set_contents (data->new_index_path, (const gchar *) index, index_size, error);
+	g_free (index);
+
+	return ok;
+}
+
+static gint
+compare_live_records_by_atime (gconstpointer a,
+			       gconstpointer b)
+{
+	const LiveRecord *record_a = a;
+	const LiveRecord *record_b = b;
+
+	/* The most recent first. */
+	if (record_a->atime != record_b->atime)
+	{
+		return record_a->atime > record_b->atime ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/* Drops the least recently accessed records beyond MAX_ENTRIES. */
+static void
+evict_live_records (GArray *records)
+{
+	guint i;
+
+	if (records->len <= MAX_ENTRIES)
+	{
+		return;
+	}
+
+	g_array_sort (records, compare_live_records_by_atime);
+
+	for (i = MAX_ENTRIES; i < records->len; i++)
+	{
+		g_free (g_array_index (records, LiveRecord, i).uri);
+	}
+
+	gedit_debug_message (DEBUG_DOCUMENT,
+			     "Dropping the metadata of %u documents",
+			     records->len - MAX_ENTRIES);
+
+	g_array_set_size (records, MAX_ENTRIES);
+}
+
+static void
+compact_thread (GTask        *task,
+		gpointer      source_object,
+		gpointer      task_data,
+		GCancellable *cancellable)
+{
+	CompactionData *data = task_data;
+	GMappedFile *data_map;
+	const guint8 *contents;
+	gsize length;
+	FILE *stream;
+	guint8 header[DATA_HEADER_SIZE];
+	GArray *records;
+	GArray *slots;
+	guint64 position = DATA_HEADER_SIZE;
+	gboolean ok = TRUE;
+	GError *error = NULL;
+	guint32 i;
+
+	data_map = g_mapped_file_new (data->data_path, FALSE, &error);
+	if (data_map == NULL)
+	{
+		g_task_return_error (task, error);
+		return;
+	}
+
+	stream = g_fopen (data->new_data_path, "wb");
+	if (stream == NULL)
+	{
+		g_task_return_new_error (task,
+					 G_IO_ERROR,
+					 g_io_error_from_errno (errno),
+					 "%s",
+					 g_strerror (errno));
+		g_mapped_file_unref (data_map);
+		return;
+	}
+
+	contents = (const guint8 *) g_mapped_file_get_contents (data_map);
+	length = MIN (g_mapped_file_get_length (data_map), data->snapshot_end);
+
+	records = g_array_sized_new (FALSE, FALSE, sizeof (LiveRecord), data->overlay->len);
+
+	/* The indexed entries that are not in memory. */
+	if (data->index_map != NULL)
+	{
+		const guint8 *old_slots;
+
+		old_slots = (const guint8 *) g_mapped_file_get_contents (data->index_map) + INDEX_HEADER_SIZE;
+
+		for (i = 0; i < data->index_n_slots; i++)
+		{
+			LiveRecord record;
+
+			record.offset = read_uint64 (old_slots + i * SLOT_SIZE + 8);
+
+			if (record.offset == 0 ||
+			    !parse_record (contents, length, record.offset, &record.record_size,
+					   &record.atime, &record.uri, NULL))
+			{
+				continue;
+			}
+
+			if (g_hash_table_contains (data->overlay_uris, record.uri))
+			{
+				g_free (record.uri);
+				continue;
+			}
+
+			g_array_append_val (records, record);
+		}
+	}
+
+	for (i = 0; i < data->overlay->len; i++)
+	{
+		OverlayRecord *overlay_record = &g_array_index (data->overlay, OverlayRecord, i);
+		LiveRecord record;
+
+		record.offset = overlay_record->offset;
+
+		if (!parse_record (contents, length, record.offset, &record.record_size, NULL, NULL, NULL))
+		{
+			continue;
+		}
+
+		record.uri = g_strdup (overlay_record->uri);
+		record.atime = overlay_record->atime;
+		g_array_append_val (records, record);
+	}
+
+	evict_live_records (records);
+
+	slots = g_array_sized_new (FALSE, FALSE, SLOT_SIZE, records->len);
+	data->new_offsets = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	memcpy (header, DATA_MAGIC, MAGIC_SIZE);
+	write_uint64 (header + MAGIC_SIZE, data->new_generation);
+	ok = fwrite (header, 1, DATA_HEADER_SIZE, stream) == DATA_HEADER_SIZE;
+
+	for (i = 0; i < records->len; i++)
+	{
+		LiveRecord *record = &g_array_index (records, LiveRecord, i);
+
+		/* copy_record() takes the URI. */
+		if (ok)
+		{
+			ok = copy_record (stream, contents + record->offset, record->record_size, record->uri,
+					  slots, data->new_offsets, &position);
+		}
+		else
+		{
+			g_free (record->uri);
+		}
+
+		if (ok && i % 1024 == 0 && g_cancellable_is_cancelled (cancellable))
+		{
+			ok = FALSE;
+		}
+	}
+
+	g_array_unref (records);
+
+	if (fclose (stream) != 0)
+	{
+		ok = FALSE;
+	}
+
+	g_mapped_file_unref (data_map);
+
+	if (g_task_return_error_if_cancelled (task))
+	{
+		g_array_unref (slots);
+		return;
+	}
+
+	if (!ok)
+	{
+		g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+					 "Error when writing “%s”.",
+					 data->new_data_path);
+		g_array_unref (slots);
+		return;
+	}
+
+	data->new_data_end = position;
+
+	if (!write_index (data, slots, &error))
+	{
+		g_task_return_error (task, error);
+		g_array_unref (slots);
+		return;
+	}
+
+	g_array_unref (slots);
+	g_task_return_boolean (task, TRUE);
+}
+
+/* Copies the records written during the compaction at the end of the new data
+ * file.
+ */
+static gboolean
+copy_tail (GeditMetadataStore *store,
+	   CompactionData     *data)
+{
+	FILE *dest;
+	guint64 remaining;
+	guint8 *buffer;
+	gboolean ok = TRUE;
+
+	remaining = store->data_size - data->snapshot_end;
+	if (remaining == 0)
+	{
+		return TRUE;
+	}
+
+	if (fseek (store->data_stream, data->snapshot_end, SEEK_SET) != 0)
+	{
+		return FALSE;
+	}
+
+	dest = g_fopen (data->new_data_path, "ab");
+	if (dest == NULL)
+	{
+		return FALSE;
+	}
+
+	buffer = g_malloc (COPY_BUFFER_SIZE);
+
+	while (ok && remaining > 0)
+	{
+		gsize n = MIN (remaining, COPY_BUFFER_SIZE);
+
+		ok = (fread (buffer, 1, n, store->data_stream) == n &&
+		      fwrite (buffer, 1, n, dest) == n);
+
+		remaining -= n;
+	}
+
+	g_free (buffer);
+
+	if (fclose (dest) != 0)
+	{
+		ok = FALSE;
+	}
+
+	return ok;
+}
+
+static void
+compaction_finished_cb (GObject      *source_object,
+			GAsyncResult *result,
+			gpointer      user_data)
+{
+	GeditMetadataStore *store = GEDIT_METADATA_STORE (source_object);
+	CompactionData *data = g_task_get_task_data (G_TASK (result));
+	guint64 tail_size;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	GError *error = NULL;
+
+	if (!g_task_propagate_boolean (G_TASK (result), &error))
+	{
+		if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		{
+			g_warning ("Error when compacting the metadata: %s", error->message);
+		}
+
+		g_clear_error (&error);
+		goto out;
+	}
+
+	if (store->data_stream == NULL)
+	{
+		goto out;
+	}
+
+	flush_stream (store);
+
+	if (!copy_tail (store, data))
+	{
+		g_warning ("Error when compacting the metadata: error when writing “%s”.",
+			   data->new_data_path);
+		goto out;
+	}
+
+	/* If only the index is replaced, its generation doesn't match the data
+	 * file, so it is rebuilt the next time.
+	 */
+	if (g_rename (data->new_index_path, store->index_path) != 0 ||
+	    g_rename (data->new_data_path, store->data_path) != 0)
+	{
+		g_warning ("Error when compacting the metadata: %s", g_strerror (errno));
+		goto out;
+	}
+
+	tail_size = store->data_size - data->snapshot_end;
+
+	fclose (store->data_stream);
+	unmap_files (store);
+
+	store->generation = data->new_generation;
+	store->data_size = data->new_data_end + tail_size;
+
+	store->data_stream = g_fopen (store->data_path, "r+b");
+	if (store->data_stream == NULL)
+	{
+		g_warning ("Impossible to open the metadata file “%s”: %s",
+			   store->data_path,
+			   g_strerror (errno));
+	}
+
+	store->data_map = g_mapped_file_new (store->data_path, FALSE, NULL);
+	map_index (store);
+	store->live_bytes = data->new_data_end - DATA_HEADER_SIZE + tail_size;
+	store->n_new_entries = 0;
+
+	g_hash_table_iter_init (&iter, store->entries);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		Entry *entry = value;
+
+		if (entry->offset >= data->snapshot_end)
+		{
+			entry->offset = entry->offset - data->snapshot_end + data->new_data_end;
+		}
+		else if (entry->offset != 0)
+		{
+			guint64 *new_offset = g_hash_table_lookup (data->new_offsets, key);
+
+			/* 0 if the record has been dropped. */
+			entry->offset = new_offset != NULL ? *new_offset : 0;
+		}
+
+		if (!g_hash_table_contains (data->new_offsets, key))
+		{
+			store->n_new_entries++;
+		}
+	}
+
+	gedit_debug_message (DEBUG_DOCUMENT,
+			     "Metadata compacted: %" G_GUINT64_FORMAT " bytes",
+			     store->data_size);
+
+out:
+	g_remove (data->new_data_path);
+	g_remove (data->new_index_path);
+	g_clear_object (&store->compaction_cancellable);
+}
+
+static void
+start_compaction (GeditMetadataStore *store)
+{
+	CompactionData *data;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	GTask *task;
+	guint i;
+
+	if (store->data_stream == NULL ||
+	    store->compaction_cancellable != NULL)
+	{
+		return;
+	}
+
+	/* The worker thread reads the data file up to snapshot_end, the
+	 * records written after are copied when it has finished.
+	 */
+	flush_stream (store);
+
+	data = g_new0 (CompactionData, 1);
+	data->data_path = g_strdup (store->data_path);
+	data->new_data_path = g_strconcat (store->data_path, ".new", NULL);
+	data->new_index_path = g_strconcat (store->index_path, ".new", NULL);
+	data->snapshot_end = store->data_size;
+	data->new_generation = new_generation ();
+
+	if (store->index_map != NULL)
+	{
+		data->index_map = g_mapped_file_ref (store->index_map);
+		data->index_n_slots = store->index_n_slots;
+	}
+
+	data->overlay = g_array_new (FALSE, FALSE, sizeof (OverlayRecord));
+	data->overlay_uris = g_hash_table_new (g_str_hash, g_str_equal);
+
+	g_hash_table_iter_init (&iter, store->entries);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		Entry *entry = value;
+		OverlayRecord overlay_record;
+
+		if (entry->offset == 0)
+		{
+			continue;
+		}
+
+		overlay_record.uri = g_strdup (key);
+		overlay_record.offset = entry->offset;
+		overlay_record.atime = entry->atime;
+		g_array_append_val (data->overlay, overlay_record);
+	}
+
+	/* The strings are owned by the array, which is not resized anymore. */
+	for (i = 0; i < data->overlay->len; i++)
+	{
+		g_hash_table_add (data->overlay_uris,
+				  g_array_index (data->overlay, OverlayRecord, i).uri);
+	}
+
+	store->compaction_cancellable = g_cancellable_new ();
+
+	task = g_task_new (store, store->compaction_cancellable, compaction_finished_cb, NULL);
+	g_task_set_task_data (task, data, (GDestroyNotify) compaction_data_free);
+	g_task_run_in_thread (task, compact_thread);
+	g_object_unref (task);
+}
+
+static void
+_gedit_metadata_store_finalize (GObject *object)
+{
+	GeditMetadataStore *store = GEDIT_METADATA_STORE (object);
+
+	close_store (store);
+
+	g_hash_table_unref (store->entries);
+	g_free (store->data_path);
+	g_free (store->index_path);
+
+	if (singleton == store)
+	{
+		singleton = NULL;
+	}
+
+	G_OBJECT_CLASS (_gedit_metadata_store_parent_class)->finalize (object);
+}
+
+static void
+_gedit_metadata_store_class_init (GeditMetadataStoreClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->finalize = _gedit_metadata_store_finalize;
+}
+
+static void
+_gedit_metadata_store_init (GeditMetadataStore *store)
+{
+	store->entries = g_hash_table_new_full (g_str_hash,
+						g_str_equal,
+						g_free,
+						(GDestroyNotify) entry_free);
+}
+
+GeditMetadataStore *
+_gedit_metadata_store_get_singleton (void)
+{
+	if (singleton == NULL)
+	{
+		singleton = g_object_new (GEDIT_TYPE_METADATA_STORE, NULL);
+		open_store (singleton);
+	}
+
+	return singleton;
+}
+
+void
+_gedit_metadata_store_unref_singleton (void)
+{
+	if (singleton != NULL)
+	{
+		/* A compaction in progress keeps a ref, so close the files
+		 * now.
+		 */
+		close_store (singleton);
+		g_object_unref (singleton);
+	}
+
+	/* singleton is not set to NULL here, it is set to NULL in
+	 * _gedit_metadata_store_finalize() (i.e. when we are sure that the ref
+	 * count reaches 0).
+	 */
+}
+
+/*
+ * _gedit_metadata_store_lookup:
+ * @store: the #GeditMetadataStore.
+ * @location: a #GFile.
+ *
+ * The lookup counts as an access to @location, the least recently accessed
+ * documents are the ones dropped when there are too many.
+ *
+ * Returns: (transfer none) (nullable): the metadata attributes of @location, as
+ * a hash table of strings, or %NULL if there is none. The hash table must not
+ * be modified.
+ */
+GHashTable *
+_gedit_metadata_store_lookup (GeditMetadataStore *store,
+			      GFile              *location)
+{
+	gchar *uri;
+	Entry *entry;
+
+	g_return_val_if_fail (GEDIT_IS_METADATA_STORE (store), NULL);
+	g_return_val_if_fail (G_IS_FILE (location), NULL);
+
+	uri = g_file_get_uri (location);
+	entry = get_entry (store, uri, FALSE);
+
+	if (entry != NULL)
+	{
+		gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+
+		if (now - entry->atime > ATIME_RESOLUTION_SECONDS)
+		{
+			entry->atime = now;
+			write_entry (store, uri, entry);
+			schedule_flush (store);
+			schedule_compaction (store);
+		}
+	}
+
+	g_free (uri);
+
+	return entry != NULL ? entry->attributes : NULL;
+}
+
+/*
+ * _gedit_metadata_store_merge:
+ * @store: the #GeditMetadataStore.
+ * @location: a #GFile.
+ * @attributes: a hash table of strings, a %NULL value unsets the key.
+ *
+ * Sets the metadata attributes of @location. A single record is written, and
+ * only if something changed. The file is flushed when the main loop is idle.
+ */
+void
+_gedit_metadata_store_merge (GeditMetadataStore *store,
+			     GFile              *location,
+			     GHashTable         *attributes)
+{
+	gchar *uri;
+	Entry *entry;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	gboolean changed = FALSE;
+
+	g_return_if_fail (GEDIT_IS_METADATA_STORE (store));
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (attributes != NULL);
+
+	uri = g_file_get_uri (location);
+	entry = get_entry (store, uri, TRUE);
+
+	g_hash_table_iter_init (&iter, attributes);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		if (value == NULL)
+		{
+			changed = g_hash_table_remove (entry->attributes, key) || changed;
+		}
+		else if (g_strcmp0 (g_hash_table_lookup (entry->attributes, key), value) != 0)
+		{
+			g_hash_table_replace (entry->attributes, g_strdup (key), g_strdup (value));
+			changed = TRUE;
+		}
+	}
+
+	if (changed)
+	{
+		entry->atime = g_get_real_time () / G_USEC_PER_SEC;
+		write_entry (store, uri, entry);
+		schedule_flush (store);
+		schedule_compaction (store);
+	}
+
+	g_free (uri);
+}
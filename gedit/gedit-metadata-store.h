@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_METADATA_STORE_H
+#define GEDIT_METADATA_STORE_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_METADATA_STORE (_gedit_metadata_store_get_type ())
+G_DECLARE_FINAL_TYPE (GeditMetadataStore, _gedit_metadata_store,
+		      GEDIT, METADATA_STORE,
+		      GObject)
+
+GeditMetadataStore *	_gedit_metadata_store_get_singleton	(void);
+
+void			_gedit_metadata_store_unref_singleton	(void);
+
+GHashTable *		_gedit_metadata_store_lookup		(GeditMetadataStore *store,
+								 GFile              *location);
+
+void			_gedit_metadata_store_merge		(GeditMetadataStore *store,
+								 GFile              *location,
+								 GHashTable         *attributes);
+
+G_END_DECLS
+
+#endif /* GEDIT_METADATA_STORE_H */
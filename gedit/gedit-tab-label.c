@@ -168,7 +168,8 @@ update_state (GeditTabLabel *tab_label)
 
 	state = gedit_tab_get_state (tab_label->tab);
 
-	if ((state == GEDIT_TAB_STATE_LOADING) ||
+	/* A tab waiting to be shown before being loaded is not busy. */
+	if ((state == GEDIT_TAB_STATE_LOADING && !_gedit_tab_has_deferred_load (tab_label->tab)) ||
 	    (state == GEDIT_TAB_STATE_SAVING) ||
 	    (state == GEDIT_TAB_STATE_REVERTING))
 	{
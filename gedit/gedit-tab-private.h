@@ -23,6 +23,7 @@
 
 #include "gedit-tab.h"
 #include "gedit-view-frame.h"
+#include "gedit-file-viewer.h"
 
 G_BEGIN_DECLS
 
@@ -61,6 +62,21 @@ gboolean	 _gedit_tab_get_can_close		(GeditTab                 *tab);
 
 GeditViewFrame	*_gedit_tab_get_view_frame		(GeditTab                 *tab);
 
+gboolean	 _gedit_tab_get_loading_progressively	(GeditTab                 *tab);
+
+GeditFileViewer	*_gedit_tab_get_file_viewer		(GeditTab                 *tab);
+
+void		 _gedit_tab_load_file_deferred		(GeditTab                 *tab,
+							 GFile                    *location,
+							 const GtkSourceEncoding  *encoding,
+							 gint                      line_pos,
+							 gint                      column_pos,
+							 gboolean                  create);
+
+gboolean	 _gedit_tab_has_deferred_load		(GeditTab                 *tab);
+
+void		 _gedit_tab_start_deferred_load		(GeditTab                 *tab);
+
 G_END_DECLS
 
 #endif  /* GEDIT_TAB_PRIVATE_H */
@@ -23,6 +23,7 @@
 #include "gedit-tab-private.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <glib/gi18n.h>
 #include <tepl/tepl.h>
 
@@ -37,6 +38,7 @@
 #include "gedit-document.h"
 #include "gedit-document-private.h"
 #include "gedit-enum-types.h"
+#include "gedit-file-sniffer.h"
 #include "gedit-settings.h"
 #include "gedit-view-frame.h"
 
@@ -80,6 +82,26 @@ struct _GeditTab
 	guint auto_save : 1;
 
 	guint ask_if_externally_modified : 1;
+
+	/* A large file is being loaded progressively, the state is
+	 * GEDIT_TAB_STATE_LOADING but the view can already be used.
+	 */
+	guint loading_progressively : 1;
+
+	/* Non-NULL if the file is too big and is shown in a read-only viewer
+	 * instead of being loaded in the document.
+	 */
+	GeditFileViewer *file_viewer;
+
+	/* The GtkSourceFile doesn't know the modification time of a file
+	 * loaded progressively, it is kept here until the next load or save.
+	 */
+	GDateTime *progressive_mtime;
+
+	/* A load that waits its turn, see _gedit_tab_load_file_deferred(). The
+	 * tab is already in GEDIT_TAB_STATE_LOADING.
+	 */
+	GTask *deferred_loading_task;
 };
 
 typedef struct _SaverData SaverData;
@@ -119,6 +141,19 @@ struct _LoaderData
 	GTimer *timer;
 	gint line_pos;
 	gint column_pos;
+	const GtkSourceEncoding *encoding;
+
+	/* NULL if the file has not been sniffed. */
+	GeditFileSniffResult *sniff_result;
+
+	/* For the progressive loading. */
+	GInputStream *stream;
+	GString *pending_text;
+	GDateTime *mtime;
+	goffset total_size;
+	goffset n_bytes_read;
+	guint cursor_placed : 1;
+
 	guint user_requested_encoding : 1;
 };
 
@@ -191,6 +226,15 @@ loader_data_free (LoaderData *data)
 			g_timer_destroy (data->timer);
 		}
 
+		g_clear_object (&data->stream);
+		g_clear_pointer (&data->mtime, g_date_time_unref);
+		_gedit_file_sniff_result_free (data->sniff_result);
+
+		if (data->pending_text != NULL)
+		{
+			g_string_free (data->pending_text, TRUE);
+		}
+
 		g_free (data);
 	}
 }
@@ -329,6 +373,17 @@ gedit_tab_dispose (GObject *object)
 	g_clear_object (&tab->editor_settings);
 	g_clear_object (&tab->print_job);
 	g_clear_object (&tab->print_preview);
+	g_clear_object (&tab->file_viewer);
+	g_clear_pointer (&tab->progressive_mtime, g_date_time_unref);
+
+	if (tab->deferred_loading_task != NULL)
+	{
+		GTask *loading_task = tab->deferred_loading_task;
+
+		tab->deferred_loading_task = NULL;
+		g_task_return_boolean (loading_task, FALSE);
+		g_object_unref (loading_task);
+	}
 
 	remove_auto_save_timeout (tab);
 
@@ -371,6 +426,20 @@ gedit_tab_grab_focus (GtkWidget *widget)
 	}
 }
 
+/* The current page of a notebook is the only one mapped. A placeholder tab
+ * shown for the first time starts its load, whichever window it is in, even
+ * if no load scheduler tracks it anymore.
+ */
+static void
+gedit_tab_map (GtkWidget *widget)
+{
+	GeditTab *tab = GEDIT_TAB (widget);
+
+	GTK_WIDGET_CLASS (gedit_tab_parent_class)->map (widget);
+
+	_gedit_tab_start_deferred_load (tab);
+}
+
 static void
 gedit_tab_class_init (GeditTabClass *klass)
 {
@@ -382,6 +451,7 @@ gedit_tab_class_init (GeditTabClass *klass)
 	object_class->set_property = gedit_tab_set_property;
 
 	gtkwidget_class->grab_focus = gedit_tab_grab_focus;
+	gtkwidget_class->map = gedit_tab_map;
 
 	/**
 	 * GeditTab:name:
@@ -534,11 +604,11 @@ set_view_properties_according_to_state (GeditTab      *tab,
 	       tab->editable);
 	gtk_text_view_set_editable (GTK_TEXT_VIEW (view), val);
 
-	val = ((state != GEDIT_TAB_STATE_LOADING) &&
+	val = ((state != GEDIT_TAB_STATE_LOADING || tab->loading_progressively) &&
 	       (state != GEDIT_TAB_STATE_CLOSING));
 	gtk_text_view_set_cursor_visible (GTK_TEXT_VIEW (view), val);
 
-	val = ((state != GEDIT_TAB_STATE_LOADING) &&
+	val = ((state != GEDIT_TAB_STATE_LOADING || tab->loading_progressively) &&
 	       (state != GEDIT_TAB_STATE_CLOSING) &&
 	       (hl_current_line));
 	gtk_source_view_set_highlight_current_line (GTK_SOURCE_VIEW (view), val);
@@ -1192,6 +1262,47 @@ display_externally_modified_notification (GeditTab *tab)
 			  tab);
 }
 
+/* Does for a file loaded progressively what
+ * gtk_source_file_is_externally_modified() does for the others.
+ */
+static gboolean
+progressive_file_externally_modified (GeditTab *tab)
+{
+	GtkSourceFile *file;
+	GFileInfo *info;
+	gboolean externally_modified = FALSE;
+
+	if (tab->progressive_mtime == NULL)
+	{
+		return FALSE;
+	}
+
+	file = gedit_document_get_file (gedit_tab_get_document (tab));
+
+	if (!gtk_source_file_is_local (file))
+	{
+		return FALSE;
+	}
+
+	info = g_file_query_info (gtk_source_file_get_location (file),
+				  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+				  G_FILE_QUERY_INFO_NONE,
+				  NULL,
+				  NULL);
+
+	if (info != NULL &&
+	    g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_TIME_MODIFIED))
+	{
+		GDateTime *mtime = g_file_info_get_modification_date_time (info);
+
+		externally_modified = !g_date_time_equal (mtime, tab->progressive_mtime);
+		g_date_time_unref (mtime);
+	}
+
+	g_clear_object (&info);
+	return externally_modified;
+}
+
 static gboolean
 view_focused_in (GtkWidget     *widget,
                  GdkEventFocus *event,
@@ -1222,7 +1333,8 @@ view_focused_in (GtkWidget     *widget,
 	{
 		gtk_source_file_check_file_on_disk (file);
 
-		if (gtk_source_file_is_externally_modified (file))
+		if (gtk_source_file_is_externally_modified (file) ||
+		    progressive_file_externally_modified (tab))
 		{
 			gedit_tab_set_state (tab, GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION);
 
@@ -1485,6 +1597,32 @@ loader_progress_cb (goffset  size,
 	}
 }
 
+static gboolean
+get_position_from_metadata (GeditDocument *doc,
+			    gint          *offset)
+{
+	gchar *position_str;
+	guint64 value = 0;
+	gboolean found = FALSE;
+
+	position_str = gedit_document_get_metadata (doc, GEDIT_METADATA_ATTRIBUTE_POSITION);
+
+	if (position_str != NULL &&
+	    g_ascii_string_to_unsigned (position_str,
+					10,
+					0,
+					G_MAXINT,
+					&value,
+					NULL))
+	{
+		*offset = (gint) value;
+		found = TRUE;
+	}
+
+	g_free (position_str);
+	return found;
+}
+
 static void
 goto_line (GTask *loading_task)
 {
@@ -1510,26 +1648,15 @@ goto_line (GTask *loading_task)
 	else if (g_settings_get_boolean (data->tab->editor_settings,
 					 GEDIT_SETTINGS_RESTORE_CURSOR_POSITION))
 	{
-		gchar *position_str;
-		guint64 offset = 0;
+		gint offset;
 
-		position_str = gedit_document_get_metadata (doc, GEDIT_METADATA_ATTRIBUTE_POSITION);
-
-		if (position_str != NULL &&
-		    g_ascii_string_to_unsigned (position_str,
-						10,
-						0,
-						G_MAXINT,
-						&offset,
-						NULL))
+		if (get_position_from_metadata (doc, &offset))
 		{
 			gtk_text_buffer_get_iter_at_offset (GTK_TEXT_BUFFER (doc),
 							    &iter,
-							    (gint) offset);
+							    offset);
 			check_is_cursor_position = TRUE;
 		}
-
-		g_free (position_str);
 	}
 
 	/* Make sure it's a valid position, to not end up in the middle of a
@@ -1558,42 +1685,30 @@ static gboolean
 file_already_opened (GeditDocument *doc,
 		     GFile         *location)
 {
-	GList *all_documents;
-	GList *l;
-	gboolean already_opened = FALSE;
+	GPtrArray *docs;
+	guint i;
 
 	if (location == NULL)
 	{
 		return FALSE;
 	}
 
-	all_documents = gedit_app_get_documents (GEDIT_APP (g_application_get_default ()));
+	docs = _gedit_document_peek_documents_for_location (location);
 
-	for (l = all_documents; l != NULL; l = l->next)
+	if (docs == NULL)
 	{
-		GeditDocument *cur_doc = l->data;
-		GtkSourceFile *cur_file;
-		GFile *cur_location;
-
-		if (cur_doc == doc)
-		{
-			continue;
-		}
-
-		cur_file = gedit_document_get_file (cur_doc);
-		cur_location = gtk_source_file_get_location (cur_file);
+		return FALSE;
+	}
 
-		if (cur_location != NULL &&
-		    g_file_equal (location, cur_location))
+	for (i = 0; i < docs->len; i++)
+	{
+		if (g_ptr_array_index (docs, i) != doc)
 		{
-			already_opened = TRUE;
-			break;
+			return TRUE;
 		}
 	}
 
-	g_list_free (all_documents);
-
-	return already_opened;
+	return FALSE;
 }
 
 static void
@@ -1604,6 +1719,8 @@ successful_load (GTask *loading_task)
 	GtkSourceFile *file = gedit_document_get_file (doc);
 	GFile *location;
 
+	g_clear_pointer (&data->tab->progressive_mtime, g_date_time_unref);
+
 	if (data->user_requested_encoding)
 	{
 		const GtkSourceEncoding *encoding = gtk_source_file_loader_get_encoding (data->loader);
@@ -1614,7 +1731,11 @@ successful_load (GTask *loading_task)
 					     NULL);
 	}
 
-	goto_line (loading_task);
+	/* With the progressive loading, it may have been done already. */
+	if (!data->cursor_placed)
+	{
+		goto_line (loading_task);
+	}
 
 	location = gtk_source_file_loader_get_location (data->loader);
 
@@ -1648,6 +1769,8 @@ successful_load (GTask *loading_task)
 
 	data->tab->ask_if_externally_modified = TRUE;
 
+	_gedit_document_set_save_cursor_position (doc, TRUE);
+
 	g_signal_emit_by_name (doc, "loaded");
 }
 
@@ -1866,6 +1989,16 @@ launch_loader (GTask                   *loading_task,
 	{
 		data->user_requested_encoding = FALSE;
 		candidate_encodings = get_candidate_encodings (data->tab);
+
+		/* Tried first, so the file loader normally doesn't need to
+		 * restart with another encoding.
+		 */
+		if (data->sniff_result != NULL &&
+		    data->sniff_result->encoding != NULL)
+		{
+			candidate_encodings = g_slist_prepend (candidate_encodings,
+							       (gpointer) data->sniff_result->encoding);
+		}
 	}
 
 	gtk_source_file_loader_set_candidate_encodings (data->loader, candidate_encodings);
@@ -1891,168 +2024,910 @@ launch_loader (GTask                   *loading_task,
 					   loading_task);
 }
 
-static void
-load_async (GeditTab                *tab,
-	    GFile                   *location,
-	    const GtkSourceEncoding *encoding,
-	    gint                     line_pos,
-	    gint                     column_pos,
-	    gboolean                 create,
-	    GCancellable            *cancellable,
-	    GAsyncReadyCallback      callback,
-	    gpointer                 user_data)
-{
-	GeditDocument *doc;
-	GtkSourceFile *file;
-	GTask *loading_task;
-	LoaderData *data;
+/* Progressive loading of large files.
+ *
+ * With GtkSourceFileLoader the tab stays in GEDIT_TAB_STATE_LOADING until the
+ * whole file is read, converted and inserted, and the view cannot be used in
+ * the meantime. For files bigger than the large-file-threshold setting, the
+ * content is instead read and inserted here chunk by chunk, at a low priority,
+ * so that the part already loaded can be scrolled and searched while the rest
+ * is still being read.
+ *
+ * Only the simple case is handled: uncompressed UTF-8 content with "\n" line
+ * endings and without NUL bytes. If a chunk doesn't qualify, the buffer is
+ * emptied and the regular file loader is launched instead, which also takes
+ * care of reporting errors.
+ */
 
-	g_return_if_fail (GEDIT_IS_TAB (tab));
-	g_return_if_fail (G_IS_FILE (location));
-	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
-	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+#define LARGE_FILE_CHUNK_SIZE (256 * 1024)
 
-	gedit_tab_set_state (tab, GEDIT_TAB_STATE_LOADING);
+static void progressive_read_next_chunk (GTask *loading_task);
 
-	doc = gedit_tab_get_document (tab);
-	file = gedit_document_get_file (doc);
-	gtk_source_file_set_location (file, location);
+static goffset
+get_large_file_threshold (GeditTab *tab)
+{
+	guint n_megabytes;
 
-	loading_task = g_task_new (NULL, cancellable, callback, user_data);
+	n_megabytes = g_settings_get_uint (tab->editor_settings,
+					   GEDIT_SETTINGS_LARGE_FILE_THRESHOLD);
 
-	data = loader_data_new ();
-	g_task_set_task_data (loading_task, data, (GDestroyNotify) loader_data_free);
+	return (goffset) n_megabytes * 1024 * 1024;
+}
 
-	data->tab = tab;
-	data->loader = gtk_source_file_loader_new (GTK_SOURCE_BUFFER (doc), file);
-	data->line_pos = line_pos;
-	data->column_pos = column_pos;
+static gboolean
+can_load_progressively (GeditTab *tab)
+{
+	GSList *candidate_encodings;
+	gboolean utf8_first;
 
-	_gedit_document_set_create (doc, create);
+	if (get_large_file_threshold (tab) == 0)
+	{
+		return FALSE;
+	}
 
-	launch_loader (loading_task, encoding);
+	/* Don't take another encoding than the one that the file loader would
+	 * try first, for example because of the metadata.
+	 */
+	candidate_encodings = get_candidate_encodings (tab);
+	utf8_first = (candidate_encodings != NULL &&
+		      candidate_encodings->data == gtk_source_encoding_get_utf8 ());
+	g_slist_free (candidate_encodings);
+
+	return utf8_first;
 }
 
-static gboolean
-load_finish (GeditTab     *tab,
-	     GAsyncResult *result)
+static void
+set_loading_progressively (GeditTab *tab,
+			   gboolean  loading_progressively)
 {
-	g_return_val_if_fail (g_task_is_valid (result, tab), FALSE);
+	loading_progressively = loading_progressively != FALSE;
 
-	return g_task_propagate_boolean (G_TASK (result), NULL);
+	if (tab->loading_progressively == loading_progressively)
+	{
+		return;
+	}
+
+	tab->loading_progressively = loading_progressively;
+
+	set_view_properties_according_to_state (tab, tab->state);
+
+	/* The state doesn't change, but what can be done with the tab does
+	 * (e.g. the sensitivity of the search actions).
+	 */
+	g_object_notify_by_pspec (G_OBJECT (tab), properties[PROP_STATE]);
 }
 
-static void
-tab_load_cb (GObject      *source_object,
-	     GAsyncResult *result,
-	     gpointer      user_data)
+/* Returns the number of bytes at the start of @text that can be inserted into
+ * the buffer, or -1 if @text cannot be loaded progressively. An incomplete UTF-8
+ * character at the end is excluded, it will be completed by the next chunk.
+ */
+static gssize
+get_progressive_text_length (const gchar *text,
+			     gsize        length)
 {
-	GeditTab *tab = GEDIT_TAB (source_object);
-	load_finish (tab, result);
+	const gchar *end;
+	gsize valid_length;
+	gsize remaining_length;
+
+	if (memchr (text, '\r', length) != NULL)
+	{
+		return -1;
+	}
+
+	/* Embedded NUL bytes make the validation fail too. */
+	if (g_utf8_validate (text, length, &end))
+	{
+		return length;
+	}
+
+	valid_length = end - text;
+	remaining_length = length - valid_length;
+
+	if (remaining_length <= 3 &&
+	    g_utf8_get_char_validated (end, remaining_length) == (gunichar) -2)
+	{
+		return valid_length;
+	}
+
+	return -1;
 }
 
-/**
- * gedit_tab_load_file:
- * @tab: a #GeditTab.
- * @location: the #GFile to load.
- * @encoding: (nullable): a #GtkSourceEncoding, or %NULL.
- * @line_pos: the line position to visualize.
- * @column_pos: the column position to visualize.
- * @create: %TRUE to show no errors if @location doesn't exist.
- *
- * This function tries to load @location into @tab. It is usually called only on
- * a newly-created tab.
- *
- * If @location doesn't exist, the behavior depends on @create:
- * - If @create is %FALSE, an error is shown.
- * - If @create is %TRUE, an empty #GeditDocument is created without error (but
- *   the file is not yet created on disk).
- *
- * The @tab needs to be in %GEDIT_TAB_STATE_NORMAL. The previous
- * #GtkTextBuffer's content is lost.
- *
- * Since: 45
+/* Whether the position where goto_line() would place the cursor is already
+ * loaded.
  */
-void
-gedit_tab_load_file (GeditTab                *tab,
-		     GFile                   *location,
-		     const GtkSourceEncoding *encoding,
-		     gint                     line_pos,
-		     gint                     column_pos,
-		     gboolean                 create)
+static gboolean
+requested_position_is_loaded (GTask *loading_task)
 {
-	g_return_if_fail (GEDIT_IS_TAB (tab));
-	g_return_if_fail (G_IS_FILE (location));
-	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GeditDocument *doc = gedit_tab_get_document (data->tab);
+	gint offset;
 
-	if (tab->cancellable != NULL)
+	if (data->line_pos > 0)
 	{
-		g_cancellable_cancel (tab->cancellable);
-		g_object_unref (tab->cancellable);
+		/* The line is complete only when the next one has started. */
+		return gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (doc)) > data->line_pos;
 	}
 
-	tab->cancellable = g_cancellable_new ();
+	if (g_settings_get_boolean (data->tab->editor_settings,
+				    GEDIT_SETTINGS_RESTORE_CURSOR_POSITION) &&
+	    get_position_from_metadata (doc, &offset))
+	{
+		return gtk_text_buffer_get_char_count (GTK_TEXT_BUFFER (doc)) > offset;
+	}
 
-	load_async (tab,
-		    location,
-		    encoding,
-		    line_pos,
-		    column_pos,
-		    create,
-		    tab->cancellable,
-		    tab_load_cb,
-		    NULL);
+	return TRUE;
 }
 
 static void
-load_stream_async (GeditTab                *tab,
-		   GInputStream            *stream,
-		   const GtkSourceEncoding *encoding,
-		   gint                     line_pos,
-		   gint                     column_pos,
-		   GCancellable            *cancellable,
-		   GAsyncReadyCallback      callback,
-		   gpointer                 user_data)
+progressive_close_stream (LoaderData *data)
 {
-	GeditDocument *doc;
-	GtkSourceFile *file;
-	GTask *loading_task;
-	LoaderData *data;
-
-	g_return_if_fail (GEDIT_IS_TAB (tab));
-	g_return_if_fail (G_IS_INPUT_STREAM (stream));
-	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
-	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+	if (data->stream != NULL)
+	{
+		g_input_stream_close_async (data->stream, G_PRIORITY_LOW, NULL, NULL, NULL);
+		g_clear_object (&data->stream);
+	}
 
-	gedit_tab_set_state (tab, GEDIT_TAB_STATE_LOADING);
+	if (data->pending_text != NULL)
+	{
+		g_string_set_size (data->pending_text, 0);
+	}
+}
 
-	doc = gedit_tab_get_document (tab);
-	file = gedit_document_get_file (doc);
+static void
+progressive_fall_back_to_file_loader (GTask *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
 
-	gtk_source_file_set_location (file, NULL);
+	gedit_debug_message (DEBUG_TAB, "Cannot load the file progressively, launching the file loader");
 
-	loading_task = g_task_new (NULL, cancellable, callback, user_data);
+	if (data->tab->loading_progressively)
+	{
+		GeditDocument *doc = gedit_tab_get_document (data->tab);
 
-	data = loader_data_new ();
-	g_task_set_task_data (loading_task, data, (GDestroyNotify) loader_data_free);
+		gtk_text_buffer_set_text (GTK_TEXT_BUFFER (doc), "", 0);
+		gtk_source_buffer_end_not_undoable_action (GTK_SOURCE_BUFFER (doc));
 
-	data->tab = tab;
-	data->loader = gtk_source_file_loader_new_from_stream (GTK_SOURCE_BUFFER (doc),
-							       file,
-							       stream);
-	data->line_pos = line_pos;
-	data->column_pos = column_pos;
+		set_loading_progressively (data->tab, FALSE);
+	}
 
-	_gedit_document_set_create (doc, FALSE);
+	progressive_close_stream (data);
+	data->cursor_placed = FALSE;
 
-	launch_loader (loading_task, encoding);
+	launch_loader (loading_task, NULL);
 }
 
-/**
- * gedit_tab_load_stream:
- * @tab: a #GeditTab.
- * @stream: the #GInputStream to load, e.g. stdin.
- * @encoding: (nullable): a #GtkSourceEncoding, or %NULL.
+static void
+progressive_loading_error (GTask  *loading_task,
+			   GError *error)
+{
+	gedit_debug_message (DEBUG_TAB, "Progressive loading error: %s", error->message);
+
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+	{
+		/* Like in load_cb(), the tab may be already destroyed. */
+		g_task_return_boolean (loading_task, FALSE);
+		g_object_unref (loading_task);
+	}
+	else
+	{
+		progressive_fall_back_to_file_loader (loading_task);
+	}
+
+	g_error_free (error);
+}
+
+static void
+progressive_loading_finished (GTask *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GeditDocument *doc = gedit_tab_get_document (data->tab);
+	GtkSourceFile *file;
+
+	/* Nothing loaded (the file has been truncated in the meantime), or an
+	 * incomplete UTF-8 character at the end.
+	 */
+	if (!data->tab->loading_progressively ||
+	    data->pending_text->len > 0)
+	{
+		progressive_fall_back_to_file_loader (loading_task);
+		return;
+	}
+
+	progressive_close_stream (data);
+	g_clear_pointer (&data->timer, g_timer_destroy);
+
+	gtk_source_buffer_end_not_undoable_action (GTK_SOURCE_BUFFER (doc));
+	gtk_text_buffer_set_modified (GTK_TEXT_BUFFER (doc), FALSE);
+
+	/* What the file loader would have set on the GtkSourceFile. The
+	 * encoding stays unset, which means UTF-8, and the modification time
+	 * can only be kept by the tab.
+	 */
+	file = gedit_document_get_file (doc);
+	if (gtk_source_file_is_local (file))
+	{
+		gtk_source_file_check_file_on_disk (file);
+	}
+
+	set_loading_progressively (data->tab, FALSE);
+	set_info_bar (data->tab, NULL);
+	gedit_tab_set_state (data->tab, GEDIT_TAB_STATE_NORMAL);
+
+	successful_load (loading_task);
+	gedit_recent_add_document (doc);
+
+	data->tab->progressive_mtime = g_steal_pointer (&data->mtime);
+
+	g_task_return_boolean (loading_task, TRUE);
+	g_object_unref (loading_task);
+}
+
+static void
+progressive_read_bytes_cb (GInputStream *stream,
+			   GAsyncResult *result,
+			   GTask        *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GeditDocument *doc;
+	GBytes *bytes;
+	gconstpointer chunk;
+	gsize chunk_size;
+	gssize text_length;
+	GtkTextIter end;
+	GError *error = NULL;
+
+	bytes = g_input_stream_read_bytes_finish (stream, result, &error);
+
+	if (error != NULL)
+	{
+		progressive_loading_error (loading_task, error);
+		return;
+	}
+
+	chunk = g_bytes_get_data (bytes, &chunk_size);
+
+	if (chunk_size == 0)
+	{
+		g_bytes_unref (bytes);
+		progressive_loading_finished (loading_task);
+		return;
+	}
+
+	g_string_append_len (data->pending_text, chunk, chunk_size);
+	data->n_bytes_read += chunk_size;
+	g_bytes_unref (bytes);
+
+	/* Like the file loader, don't keep the UTF-8 byte order mark. */
+	if (data->n_bytes_read == (goffset) chunk_size &&
+	    g_str_has_prefix (data->pending_text->str, "\xEF\xBB\xBF"))
+	{
+		g_string_erase (data->pending_text, 0, 3);
+	}
+
+	text_length = get_progressive_text_length (data->pending_text->str,
+						   data->pending_text->len);
+
+	if (text_length < 0)
+	{
+		progressive_fall_back_to_file_loader (loading_task);
+		return;
+	}
+
+	doc = gedit_tab_get_document (data->tab);
+
+	/* The first chunk is valid, the view can be used from now on. */
+	if (!data->tab->loading_progressively)
+	{
+		g_signal_emit_by_name (doc, "load");
+
+		gtk_source_buffer_begin_not_undoable_action (GTK_SOURCE_BUFFER (doc));
+		gtk_text_buffer_set_text (GTK_TEXT_BUFFER (doc), "", 0);
+
+		set_loading_progressively (data->tab, TRUE);
+	}
+
+	gtk_text_buffer_get_end_iter (GTK_TEXT_BUFFER (doc), &end);
+	gtk_text_buffer_insert (GTK_TEXT_BUFFER (doc),
+				&end,
+				data->pending_text->str,
+				text_length);
+	g_string_erase (data->pending_text, 0, text_length);
+
+	if (!data->cursor_placed)
+	{
+		if (requested_position_is_loaded (loading_task))
+		{
+			goto_line (loading_task);
+			data->cursor_placed = TRUE;
+		}
+		else
+		{
+			/* Don't let the cursor follow the inserted text. */
+			GtkTextIter start;
+
+			gtk_text_buffer_get_start_iter (GTK_TEXT_BUFFER (doc), &start);
+			gtk_text_buffer_place_cursor (GTK_TEXT_BUFFER (doc), &start);
+		}
+	}
+
+	loader_progress_cb (data->n_bytes_read, data->total_size, loading_task);
+
+	progressive_read_next_chunk (loading_task);
+}
+
+static void
+progressive_read_next_chunk (GTask *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+
+	/* A low priority, so that redrawing and user input go first. */
+	g_input_stream_read_bytes_async (data->stream,
+					 LARGE_FILE_CHUNK_SIZE,
+					 G_PRIORITY_LOW,
+					 g_task_get_cancellable (loading_task),
+					 (GAsyncReadyCallback) progressive_read_bytes_cb,
+					 loading_task);
+}
+
+static void
+progressive_query_info_cb (GFileInputStream *stream,
+			   GAsyncResult     *result,
+			   GTask            *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GFileInfo *info;
+	GError *error = NULL;
+
+	info = g_file_input_stream_query_info_finish (stream, result, &error);
+
+	if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+	{
+		progressive_loading_error (loading_task, error);
+		return;
+	}
+
+	/* Without it, the external modifications are not detected, as for a
+	 * file whose modification time is unknown to the file loader.
+	 */
+	g_clear_error (&error);
+
+	g_clear_pointer (&data->mtime, g_date_time_unref);
+
+	if (info != NULL &&
+	    g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_TIME_MODIFIED))
+	{
+		data->mtime = g_file_info_get_modification_date_time (info);
+	}
+
+	g_clear_object (&info);
+
+	progressive_read_next_chunk (loading_task);
+}
+
+static void
+progressive_read_cb (GFile        *location,
+		     GAsyncResult *result,
+		     GTask        *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GFileInputStream *stream;
+	GError *error = NULL;
+
+	stream = g_file_read_finish (location, result, &error);
+
+	if (error != NULL)
+	{
+		progressive_loading_error (loading_task, error);
+		return;
+	}
+
+	data->stream = G_INPUT_STREAM (stream);
+	data->n_bytes_read = 0;
+
+	if (data->pending_text == NULL)
+	{
+		data->pending_text = g_string_sized_new (LARGE_FILE_CHUNK_SIZE);
+	}
+
+	g_clear_pointer (&data->timer, g_timer_destroy);
+	data->timer = g_timer_new ();
+
+	/* The modification time of the content that is read. */
+	g_file_input_stream_query_info_async (stream,
+					      G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					      G_PRIORITY_DEFAULT,
+					      g_task_get_cancellable (loading_task),
+					      (GAsyncReadyCallback) progressive_query_info_cb,
+					      loading_task);
+}
+
+/* Read-only viewer for huge files.
+ *
+ * Above the viewer-threshold setting, loading the file in the document would
+ * need several times its size in memory. A local file is then shown by a
+ * GeditFileViewer instead, which reads only the visible lines into the
+ * document. The document stays unmodified and the tab is not editable.
+ */
+
+static goffset
+get_viewer_threshold (GeditTab *tab)
+{
+	guint n_megabytes;
+
+	n_megabytes = g_settings_get_uint (tab->editor_settings,
+					   GEDIT_SETTINGS_VIEWER_THRESHOLD);
+
+	return (goffset) n_megabytes * 1024 * 1024;
+}
+
+static void
+viewer_info_bar_response (GtkWidget *info_bar,
+			  gint       response_id,
+			  GeditTab  *tab)
+{
+	set_info_bar (tab, NULL);
+}
+
+static void
+viewer_new_cb (GObject      *source_object,
+	       GAsyncResult *result,
+	       gpointer      user_data)
+{
+	GTask *loading_task = G_TASK (user_data);
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GeditTab *tab;
+	GeditDocument *doc;
+	GeditView *view;
+	GeditFileViewer *viewer;
+	TeplInfoBar *info_bar;
+	GError *error = NULL;
+
+	viewer = _gedit_file_viewer_new_finish (result, &error);
+
+	if (error != NULL)
+	{
+		gedit_debug_message (DEBUG_TAB, "File viewer error: %s", error->message);
+
+		if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		{
+			/* Like in load_cb(), the tab may be already destroyed. */
+			g_task_return_boolean (loading_task, FALSE);
+			g_object_unref (loading_task);
+		}
+		else
+		{
+			/* The file loader reports the error, if any. */
+			launch_loader (loading_task, NULL);
+		}
+
+		g_error_free (error);
+		return;
+	}
+
+	tab = data->tab;
+	doc = gedit_tab_get_document (tab);
+	view = gedit_tab_get_view (tab);
+
+	g_clear_pointer (&data->timer, g_timer_destroy);
+	g_clear_pointer (&tab->progressive_mtime, g_date_time_unref);
+
+	g_signal_emit_by_name (doc, "load");
+
+	g_clear_object (&tab->file_viewer);
+	tab->file_viewer = viewer;
+	_gedit_file_viewer_attach (viewer, view);
+	gedit_view_frame_set_file_viewer (tab->frame, viewer);
+
+	/* The line numbers of the view would be relative to the part of the
+	 * file that is in the document.
+	 */
+	g_settings_unbind (view, "show-line-numbers");
+	gtk_source_view_set_show_line_numbers (GTK_SOURCE_VIEW (view), FALSE);
+
+	set_editable (tab, FALSE);
+	set_info_bar (tab, NULL);
+	gedit_tab_set_state (tab, GEDIT_TAB_STATE_NORMAL);
+
+	if (data->line_pos > 0)
+	{
+		_gedit_file_viewer_goto_line (viewer,
+					      data->line_pos - 1,
+					      MAX (0, data->column_pos - 1));
+	}
+
+	info_bar = tepl_info_bar_new_simple (GTK_MESSAGE_INFO,
+					     _("This file is too big to be edited."),
+					     _("It is shown read-only, only the visible part is loaded."));
+	gtk_info_bar_set_show_close_button (GTK_INFO_BAR (info_bar), TRUE);
+	g_signal_connect (info_bar,
+			  "response",
+			  G_CALLBACK (viewer_info_bar_response),
+			  tab);
+	set_info_bar (tab, GTK_WIDGET (info_bar));
+
+	gedit_recent_add_document (doc);
+	g_signal_emit_by_name (doc, "loaded");
+
+	g_task_return_boolean (loading_task, TRUE);
+	g_object_unref (loading_task);
+}
+
+static void
+sniff_cb (GObject      *source_object,
+	  GAsyncResult *result,
+	  GTask        *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GeditFileSniffResult *sniff_result;
+	GFile *location;
+	gboolean regular_file;
+	gboolean load_progressively;
+	GError *error = NULL;
+
+	sniff_result = _gedit_file_sniff_finish (result, &error);
+
+	if (error != NULL)
+	{
+		gedit_debug_message (DEBUG_TAB, "Sniffing error: %s", error->message);
+
+		if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		{
+			/* Like in load_cb(), the tab may be already destroyed. */
+			g_task_return_boolean (loading_task, FALSE);
+			g_object_unref (loading_task);
+		}
+		else
+		{
+			/* The file loader reports the error, or creates the
+			 * file.
+			 */
+			launch_loader (loading_task, data->encoding);
+		}
+
+		g_error_free (error);
+		return;
+	}
+
+	data->sniff_result = sniff_result;
+	location = gtk_source_file_loader_get_location (data->loader);
+
+	/* Before the content is inserted, so that it is highlighted right
+	 * away.
+	 */
+	_gedit_document_set_sniffed_info (gedit_tab_get_document (data->tab),
+					  sniff_result->content_type,
+					  sniff_result->language);
+
+	regular_file = (sniff_result->file_type == G_FILE_TYPE_REGULAR &&
+			!sniff_result->compressed);
+
+	data->total_size = sniff_result->size;
+
+	if (data->encoding != NULL)
+	{
+		launch_loader (loading_task, data->encoding);
+		return;
+	}
+
+	if (regular_file &&
+	    g_file_is_native (location) &&
+	    get_viewer_threshold (data->tab) > 0 &&
+	    data->total_size >= get_viewer_threshold (data->tab))
+	{
+		gedit_debug_message (DEBUG_TAB, "Opening %" G_GOFFSET_FORMAT " bytes in the file viewer", data->total_size);
+
+		show_loading_info_bar (loading_task);
+
+		_gedit_file_viewer_new_async (location,
+					      g_task_get_cancellable (loading_task),
+					      viewer_new_cb,
+					      loading_task);
+		return;
+	}
+
+	/* The progressive loading handles only UTF-8 with "\n" line endings,
+	 * don't start it if the head of the file already shows otherwise.
+	 */
+	load_progressively = (regular_file &&
+			      can_load_progressively (data->tab) &&
+			      data->total_size >= get_large_file_threshold (data->tab) &&
+			      sniff_result->encoding == gtk_source_encoding_get_utf8 () &&
+			      (sniff_result->newline_type == GTK_SOURCE_NEWLINE_TYPE_LF ||
+			       sniff_result->newline_type == GTK_SOURCE_NEWLINE_TYPE_DEFAULT));
+
+	if (!load_progressively)
+	{
+		launch_loader (loading_task, NULL);
+		return;
+	}
+
+	gedit_debug_message (DEBUG_TAB, "Loading %" G_GOFFSET_FORMAT " bytes progressively", data->total_size);
+
+	g_file_read_async (location,
+			   G_PRIORITY_DEFAULT,
+			   g_task_get_cancellable (loading_task),
+			   (GAsyncReadyCallback) progressive_read_cb,
+			   loading_task);
+}
+
+/* The file is sniffed in a worker thread before the file loader or the
+ * alternative loadings are launched. Several tabs loading at the same time
+ * thus sniff their file in parallel.
+ */
+static void
+start_loading (GTask *loading_task)
+{
+	LoaderData *data = g_task_get_task_data (loading_task);
+	GFile *location = gtk_source_file_loader_get_location (data->loader);
+	GSList *candidate_encodings;
+
+	if (data->encoding != NULL)
+	{
+		candidate_encodings = g_slist_append (NULL, (gpointer) data->encoding);
+	}
+	else
+	{
+		candidate_encodings = get_candidate_encodings (data->tab);
+	}
+
+	_gedit_file_sniff_async (location,
+				 candidate_encodings,
+				 g_task_get_cancellable (loading_task),
+				 (GAsyncReadyCallback) sniff_cb,
+				 loading_task);
+
+	g_slist_free (candidate_encodings);
+}
+
+static void
+load_async (GeditTab                *tab,
+	    GFile                   *location,
+	    const GtkSourceEncoding *encoding,
+	    gint                     line_pos,
+	    gint                     column_pos,
+	    gboolean                 create,
+	    gboolean                 deferred,
+	    GCancellable            *cancellable,
+	    GAsyncReadyCallback      callback,
+	    gpointer                 user_data)
+{
+	GeditDocument *doc;
+	GtkSourceFile *file;
+	GTask *loading_task;
+	LoaderData *data;
+
+	g_return_if_fail (GEDIT_IS_TAB (tab));
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+
+	gedit_tab_set_state (tab, GEDIT_TAB_STATE_LOADING);
+
+	doc = gedit_tab_get_document (tab);
+	file = gedit_document_get_file (doc);
+	gtk_source_file_set_location (file, location);
+
+	loading_task = g_task_new (NULL, cancellable, callback, user_data);
+
+	data = loader_data_new ();
+	g_task_set_task_data (loading_task, data, (GDestroyNotify) loader_data_free);
+
+	data->tab = tab;
+	data->loader = gtk_source_file_loader_new (GTK_SOURCE_BUFFER (doc), file);
+	data->line_pos = line_pos;
+	data->column_pos = column_pos;
+	data->encoding = encoding;
+
+	_gedit_document_set_create (doc, create);
+
+	/* Until the file is loaded, keep the cursor position stored in the
+	 * metadata if the tab is closed.
+	 */
+	_gedit_document_set_save_cursor_position (doc, FALSE);
+
+	if (deferred)
+	{
+		g_return_if_fail (tab->deferred_loading_task == NULL);
+		tab->deferred_loading_task = loading_task;
+		return;
+	}
+
+	start_loading (loading_task);
+}
+
+static gboolean
+load_finish (GeditTab     *tab,
+	     GAsyncResult *result)
+{
+	g_return_val_if_fail (g_task_is_valid (result, tab), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), NULL);
+}
+
+static void
+tab_load_cb (GObject      *source_object,
+	     GAsyncResult *result,
+	     gpointer      user_data)
+{
+	GeditTab *tab = GEDIT_TAB (source_object);
+	load_finish (tab, result);
+}
+
+static void
+load_file (GeditTab                *tab,
+	   GFile                   *location,
+	   const GtkSourceEncoding *encoding,
+	   gint                     line_pos,
+	   gint                     column_pos,
+	   gboolean                 create,
+	   gboolean                 deferred)
+{
+	if (tab->cancellable != NULL)
+	{
+		g_cancellable_cancel (tab->cancellable);
+		g_object_unref (tab->cancellable);
+	}
+
+	tab->cancellable = g_cancellable_new ();
+
+	load_async (tab,
+		    location,
+		    encoding,
+		    line_pos,
+		    column_pos,
+		    create,
+		    deferred,
+		    tab->cancellable,
+		    tab_load_cb,
+		    NULL);
+}
+
+/**
+ * gedit_tab_load_file:
+ * @tab: a #GeditTab.
+ * @location: the #GFile to load.
+ * @encoding: (nullable): a #GtkSourceEncoding, or %NULL.
+ * @line_pos: the line position to visualize.
+ * @column_pos: the column position to visualize.
+ * @create: %TRUE to show no errors if @location doesn't exist.
+ *
+ * This function tries to load @location into @tab. It is usually called only on
+ * a newly-created tab.
+ *
+ * If @location doesn't exist, the behavior depends on @create:
+ * - If @create is %FALSE, an error is shown.
+ * - If @create is %TRUE, an empty #GeditDocument is created without error (but
+ *   the file is not yet created on disk).
+ *
+ * The @tab needs to be in %GEDIT_TAB_STATE_NORMAL. The previous
+ * #GtkTextBuffer's content is lost.
+ *
+ * Since: 45
+ */
+void
+gedit_tab_load_file (GeditTab                *tab,
+		     GFile                   *location,
+		     const GtkSourceEncoding *encoding,
+		     gint                     line_pos,
+		     gint                     column_pos,
+		     gboolean                 create)
+{
+	g_return_if_fail (GEDIT_IS_TAB (tab));
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+
+	load_file (tab, location, encoding, line_pos, column_pos, create, FALSE);
+}
+
+/*
+ * _gedit_tab_load_file_deferred:
+ *
+ * Like gedit_tab_load_file(), but the file is not read until
+ * _gedit_tab_start_deferred_load() is called. In the meantime the tab is in
+ * %GEDIT_TAB_STATE_LOADING, with the location already set, so it cannot be
+ * edited or saved. It is a lightweight placeholder: the buffer is empty and
+ * nothing is read from the file.
+ *
+ * The load also starts when the tab is mapped, that is when it becomes the
+ * current page of a visible notebook.
+ *
+ * Code that needs the content of all documents must queue the placeholders
+ * in the load scheduler of their window, so that the max-concurrent-loads
+ * setting is respected, and wait for the tabs to leave the loading state.
+ */
+void
+_gedit_tab_load_file_deferred (GeditTab                *tab,
+			       GFile                   *location,
+			       const GtkSourceEncoding *encoding,
+			       gint                     line_pos,
+			       gint                     column_pos,
+			       gboolean                 create)
+{
+	g_return_if_fail (GEDIT_IS_TAB (tab));
+	g_return_if_fail (G_IS_FILE (location));
+	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+
+	load_file (tab, location, encoding, line_pos, column_pos, create, TRUE);
+}
+
+gboolean
+_gedit_tab_has_deferred_load (GeditTab *tab)
+{
+	g_return_val_if_fail (GEDIT_IS_TAB (tab), FALSE);
+
+	return tab->deferred_loading_task != NULL;
+}
+
+void
+_gedit_tab_start_deferred_load (GeditTab *tab)
+{
+	GTask *loading_task;
+
+	g_return_if_fail (GEDIT_IS_TAB (tab));
+
+	loading_task = tab->deferred_loading_task;
+
+	if (loading_task == NULL)
+	{
+		return;
+	}
+
+	tab->deferred_loading_task = NULL;
+	start_loading (loading_task);
+
+	/* The state doesn't change, but the tab is now really loading. */
+	g_object_notify_by_pspec (G_OBJECT (tab), properties[PROP_STATE]);
+}
+
+static void
+load_stream_async (GeditTab                *tab,
+		   GInputStream            *stream,
+		   const GtkSourceEncoding *encoding,
+		   gint                     line_pos,
+		   gint                     column_pos,
+		   GCancellable            *cancellable,
+		   GAsyncReadyCallback      callback,
+		   gpointer                 user_data)
+{
+	GeditDocument *doc;
+	GtkSourceFile *file;
+	GTask *loading_task;
+	LoaderData *data;
+
+	g_return_if_fail (GEDIT_IS_TAB (tab));
+	g_return_if_fail (G_IS_INPUT_STREAM (stream));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+	g_return_if_fail (tab->state == GEDIT_TAB_STATE_NORMAL);
+
+	gedit_tab_set_state (tab, GEDIT_TAB_STATE_LOADING);
+
+	doc = gedit_tab_get_document (tab);
+	file = gedit_document_get_file (doc);
+
+	gtk_source_file_set_location (file, NULL);
+
+	loading_task = g_task_new (NULL, cancellable, callback, user_data);
+
+	data = loader_data_new ();
+	g_task_set_task_data (loading_task, data, (GDestroyNotify) loader_data_free);
+
+	data->tab = tab;
+	data->loader = gtk_source_file_loader_new_from_stream (GTK_SOURCE_BUFFER (doc),
+							       file,
+							       stream);
+	data->line_pos = line_pos;
+	data->column_pos = column_pos;
+
+	_gedit_document_set_create (doc, FALSE);
+
+	launch_loader (loading_task, encoding);
+}
+
+/**
+ * gedit_tab_load_stream:
+ * @tab: a #GeditTab.
+ * @stream: the #GInputStream to load, e.g. stdin.
+ * @encoding: (nullable): a #GtkSourceEncoding, or %NULL.
  * @line_pos: the line position to visualize.
  * @column_pos: the column position to visualize.
  *
@@ -2296,6 +3171,9 @@ save_cb (GtkSourceFileSaver *saver,
 	}
 	else
 	{
+		/* The file saver has set the modification time. */
+		g_clear_pointer (&tab->progressive_mtime, g_date_time_unref);
+
 		gedit_recent_add_document (doc);
 
 		gedit_tab_set_state (tab, GEDIT_TAB_STATE_NORMAL);
@@ -2319,6 +3197,29 @@ launch_saver (GTask *saving_task)
 	GeditTab *tab = g_task_get_source_object (saving_task);
 	GeditDocument *doc = gedit_tab_get_document (tab);
 	SaverData *data = g_task_get_task_data (saving_task);
+	GFile *location = gtk_source_file_saver_get_location (data->saver);
+	GtkSourceFile *file = gedit_document_get_file (doc);
+
+	/* The check that the file saver does when it knows the modification
+	 * time.
+	 */
+	if (tab->progressive_mtime != NULL &&
+	    (gtk_source_file_saver_get_flags (data->saver) & GTK_SOURCE_FILE_SAVER_FLAGS_IGNORE_MODIFICATION_TIME) == 0 &&
+	    g_file_equal (location, gtk_source_file_get_location (file)) &&
+	    progressive_file_externally_modified (tab))
+	{
+		GtkWidget *info_bar;
+
+		gedit_tab_set_state (tab, GEDIT_TAB_STATE_SAVING_ERROR);
+
+		info_bar = GTK_WIDGET (tepl_io_error_info_bar_saving_externally_modified (location));
+		g_signal_connect (info_bar,
+				  "response",
+				  G_CALLBACK (externally_modified_error_info_bar_response),
+				  saving_task);
+		set_info_bar (tab, info_bar);
+		return;
+	}
 
 	gedit_tab_set_state (tab, GEDIT_TAB_STATE_SAVING);
 
@@ -2989,4 +3890,26 @@ _gedit_tab_get_view_frame (GeditTab *tab)
 	return tab->frame;
 }
 
+/* Whether the tab is in %GEDIT_TAB_STATE_LOADING while its view can already be
+ * used, because a large file is loaded progressively.
+ */
+gboolean
+_gedit_tab_get_loading_progressively (GeditTab *tab)
+{
+	g_return_val_if_fail (GEDIT_IS_TAB (tab), FALSE);
+
+	return tab->loading_progressively;
+}
+
+/* Returns: (transfer none) (nullable): the #GeditFileViewer showing the file,
+ * if it is too big to be loaded in the document.
+ */
+GeditFileViewer *
+_gedit_tab_get_file_viewer (GeditTab *tab)
+{
+	g_return_val_if_fail (GEDIT_IS_TAB (tab), NULL);
+
+	return tab->file_viewer;
+}
+
 /* ex:set ts=8 noet: */
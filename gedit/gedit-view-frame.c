@@ -79,6 +79,16 @@ struct _GeditViewFrame
 	 */
 	gchar *search_text;
 	gchar *old_search_text;
+
+	/* When the file is shown by a viewer, the buffer contains only a part
+	 * of it, and the search and goto line are done by the viewer. The
+	 * start position is then kept as a line and column in the file,
+	 * start_mark would be lost when the viewer replaces the buffer
+	 * content.
+	 */
+	GeditFileViewer *file_viewer;
+	gint64 start_line;
+	gint start_column;
 };
 
 G_DEFINE_TYPE (GeditViewFrame, gedit_view_frame, GTK_TYPE_OVERLAY)
@@ -152,6 +162,7 @@ gedit_view_frame_dispose (GObject *object)
 	g_clear_object (&frame->entry_tag);
 	g_clear_object (&frame->search_settings);
 	g_clear_object (&frame->old_search_settings);
+	g_clear_object (&frame->file_viewer);
 
 	G_OBJECT_CLASS (gedit_view_frame_parent_class)->dispose (object);
 }
@@ -195,7 +206,13 @@ hide_search_widget (GeditViewFrame *frame,
 
 	buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (frame->view));
 
-	if (cancel && frame->start_mark != NULL)
+	if (cancel && frame->file_viewer != NULL)
+	{
+		_gedit_file_viewer_goto_line (frame->file_viewer,
+					      frame->start_line,
+					      frame->start_column);
+	}
+	else if (cancel && frame->start_mark != NULL)
 	{
 		GtkTextIter iter;
 
@@ -297,6 +314,50 @@ finish_search (GeditViewFrame    *frame,
 	}
 }
 
+static void
+viewer_search_finished (GeditFileViewer *viewer,
+			GAsyncResult    *result,
+			GeditViewFrame  *frame)
+{
+	gboolean found;
+
+	found = _gedit_file_viewer_search_finish (viewer, result);
+
+	if (frame->file_viewer == viewer &&
+	    !g_task_had_error (G_TASK (result)))
+	{
+		finish_search (frame, found);
+	}
+
+	g_object_unref (frame);
+}
+
+static void
+viewer_search (GeditViewFrame                 *frame,
+	       GeditFileViewerSearchDirection  direction)
+{
+	const gchar *text;
+	gboolean case_sensitive;
+
+	if (frame->search_settings == NULL)
+	{
+		return;
+	}
+
+	/* The viewer doesn't support regular expressions nor the "at word
+	 * boundaries" setting, the text is always searched literally.
+	 */
+	text = gtk_source_search_settings_get_search_text (frame->search_settings);
+	case_sensitive = gtk_source_search_settings_get_case_sensitive (frame->search_settings);
+
+	_gedit_file_viewer_search_async (frame->file_viewer,
+					 text != NULL ? text : "",
+					 case_sensitive,
+					 direction,
+					 (GAsyncReadyCallback) viewer_search_finished,
+					 g_object_ref (frame));
+}
+
 static void
 start_search_finished (GtkSourceSearchContext *search_context,
 		       GAsyncResult           *result,
@@ -346,6 +407,16 @@ start_search (GeditViewFrame *frame)
 
 	g_return_if_fail (frame->search_mode == SEARCH_MODE_SIMPLE_SEARCH);
 
+	if (frame->file_viewer != NULL)
+	{
+		/* Search from where the search has started, like below. */
+		_gedit_file_viewer_goto_line (frame->file_viewer,
+					      frame->start_line,
+					      frame->start_column);
+		viewer_search (frame, GEDIT_FILE_VIEWER_SEARCH_INCREMENTAL);
+		return;
+	}
+
 	search_context = get_search_context (frame);
 
 	if (search_context == NULL)
@@ -399,6 +470,13 @@ forward_search (GeditViewFrame *frame)
 
 	g_return_if_fail (frame->search_mode == SEARCH_MODE_SIMPLE_SEARCH);
 
+	if (frame->file_viewer != NULL)
+	{
+		renew_flush_timeout (frame);
+		viewer_search (frame, GEDIT_FILE_VIEWER_SEARCH_FORWARD);
+		return;
+	}
+
 	search_context = get_search_context (frame);
 
 	if (search_context == NULL)
@@ -457,6 +535,13 @@ backward_search (GeditViewFrame *frame)
 
 	g_return_if_fail (frame->search_mode == SEARCH_MODE_SIMPLE_SEARCH);
 
+	if (frame->file_viewer != NULL)
+	{
+		renew_flush_timeout (frame);
+		viewer_search (frame, GEDIT_FILE_VIEWER_SEARCH_BACKWARD);
+		return;
+	}
+
 	search_context = get_search_context (frame);
 
 	if (search_context == NULL)
@@ -594,7 +679,11 @@ update_entry_tag (GeditViewFrame *frame)
 	gint pos;
 	gchar *label;
 
-	if (frame->search_mode == SEARCH_MODE_GOTO_LINE)
+	/* The occurrences are counted only in the part of the file that is in
+	 * the buffer, the count would be misleading.
+	 */
+	if (frame->search_mode == SEARCH_MODE_GOTO_LINE ||
+	    frame->file_viewer != NULL)
 	{
 		gd_tagged_entry_remove_tag (frame->search_entry,
 					    frame->entry_tag);
@@ -1045,7 +1134,8 @@ update_goto_line (GeditViewFrame *frame)
 	const gchar *entry_text;
 	gboolean moved;
 	gboolean moved_offset;
-	gint line;
+	gint64 cur_line;
+	gint64 line;
 	gint offset_line = 0;
 	gint line_offset = 0;
 	gchar **split_text = NULL;
@@ -1059,7 +1149,15 @@ update_goto_line (GeditViewFrame *frame)
 		return;
 	}
 
-	get_iter_at_start_mark (frame, &iter);
+	if (frame->file_viewer != NULL)
+	{
+		cur_line = frame->start_line;
+	}
+	else
+	{
+		get_iter_at_start_mark (frame, &iter);
+		cur_line = gtk_text_iter_get_line (&iter);
+	}
 
 	split_text = g_strsplit (entry_text, ":", -1);
 
@@ -1074,8 +1172,6 @@ update_goto_line (GeditViewFrame *frame)
 
 	if (text[0] == '-')
 	{
-		gint cur_line = gtk_text_iter_get_line (&iter);
-
 		if (text[1] != '\0')
 		{
 			offset_line = MAX (atoi (text + 1), 0);
@@ -1085,8 +1181,6 @@ update_goto_line (GeditViewFrame *frame)
 	}
 	else if (entry_text[0] == '+')
 	{
-		gint cur_line = gtk_text_iter_get_line (&iter);
-
 		if (text[1] != '\0')
 		{
 			offset_line = MAX (atoi (text + 1), 0);
@@ -1096,7 +1190,7 @@ update_goto_line (GeditViewFrame *frame)
 	}
 	else
 	{
-		line = MAX (atoi (text) - 1, 0);
+		line = MAX (g_ascii_strtoll (text, NULL, 10) - 1, 0);
 	}
 
 	if (split_text[1] != NULL)
@@ -1106,8 +1200,16 @@ update_goto_line (GeditViewFrame *frame)
 
 	g_strfreev (split_text);
 
-	moved = tepl_view_goto_line (TEPL_VIEW (frame->view), line);
-	moved_offset = tepl_view_goto_line_offset (TEPL_VIEW (frame->view), line, line_offset);
+	if (frame->file_viewer != NULL)
+	{
+		moved = _gedit_file_viewer_goto_line (frame->file_viewer, line, MAX (line_offset, 0));
+		moved_offset = moved;
+	}
+	else
+	{
+		moved = tepl_view_goto_line (TEPL_VIEW (frame->view), line);
+		moved_offset = tepl_view_goto_line_offset (TEPL_VIEW (frame->view), line, line_offset);
+	}
 
 	if (!moved || !moved_offset)
 	{
@@ -1199,15 +1301,22 @@ init_search_entry (GeditViewFrame *frame)
 {
 	if (frame->search_mode == SEARCH_MODE_GOTO_LINE)
 	{
-		gint line;
+		gint64 line;
 		gchar *line_str;
-		GtkTextIter iter;
 
-		get_iter_at_start_mark (frame, &iter);
+		if (frame->file_viewer != NULL)
+		{
+			line = frame->start_line;
+		}
+		else
+		{
+			GtkTextIter iter;
 
-		line = gtk_text_iter_get_line (&iter);
+			get_iter_at_start_mark (frame, &iter);
+			line = gtk_text_iter_get_line (&iter);
+		}
 
-		line_str = g_strdup_printf ("%d", line + 1);
+		line_str = g_strdup_printf ("%" G_GINT64_FORMAT, line + 1);
 
 		gtk_entry_set_text (GTK_ENTRY (frame->search_entry), line_str);
 
@@ -1375,6 +1484,13 @@ start_interactive_search_real (GeditViewFrame *frame,
 
 	frame->start_mark = gtk_text_buffer_create_mark (buffer, NULL, &iter, FALSE);
 
+	if (frame->file_viewer != NULL)
+	{
+		_gedit_file_viewer_get_cursor_position (frame->file_viewer,
+							&frame->start_line,
+							&frame->start_column);
+	}
+
 	gtk_revealer_set_reveal_child (frame->revealer, TRUE);
 
 	/* NOTE: we must be very careful here to not have any text before
@@ -1578,3 +1694,30 @@ gedit_view_frame_clear_search (GeditViewFrame *frame)
 
 	gtk_widget_grab_focus (GTK_WIDGET (frame->view));
 }
+
+/*
+ * gedit_view_frame_set_file_viewer:
+ * @frame: a #GeditViewFrame.
+ * @viewer: (nullable): the #GeditFileViewer attached to the view of @frame.
+ *
+ * From now on the search and goto line are done in the whole file shown by
+ * @viewer.
+ */
+void
+gedit_view_frame_set_file_viewer (GeditViewFrame  *frame,
+				  GeditFileViewer *viewer)
+{
+	g_return_if_fail (GEDIT_IS_VIEW_FRAME (frame));
+	g_return_if_fail (viewer == NULL || GEDIT_IS_FILE_VIEWER (viewer));
+
+	hide_search_widget (frame, FALSE);
+	g_set_object (&frame->file_viewer, viewer);
+}
+
+GeditFileViewer *
+gedit_view_frame_get_file_viewer (GeditViewFrame *frame)
+{
+	g_return_val_if_fail (GEDIT_IS_VIEW_FRAME (frame), NULL);
+
+	return frame->file_viewer;
+}
@@ -21,6 +21,7 @@
 #define GEDIT_VIEW_FRAME_H
 
 #include "gedit-view.h"
+#include "gedit-file-viewer.h"
 
 G_BEGIN_DECLS
 
@@ -40,6 +41,11 @@ void			gedit_view_frame_popup_goto_line	(GeditViewFrame *frame);
 
 void			gedit_view_frame_clear_search		(GeditViewFrame *frame);
 
+void			gedit_view_frame_set_file_viewer	(GeditViewFrame  *frame,
+								 GeditFileViewer *viewer);
+
+GeditFileViewer *	gedit_view_frame_get_file_viewer	(GeditViewFrame *frame);
+
 G_END_DECLS
 
 #endif /* GEDIT_VIEW_FRAME_H */
@@ -90,6 +90,12 @@ struct _GeditWindowPrivate
 	guint tab_width_id;
 	guint language_changed_id;
 
+	/* The line column indicator follows the viewer of the active tab, if
+	 * any, instead of the view.
+	 */
+	GeditFileViewer *file_viewer;
+	gulong file_viewer_cursor_moved_id;
+
 	/* Headerbars (can be NULL) */
 	GtkHeaderBar *side_headerbar;
 	GeditHeaderBar *headerbar;
@@ -147,6 +153,8 @@ G_DEFINE_TYPE_WITH_PRIVATE (GeditWindow, gedit_window, GTK_TYPE_APPLICATION_WIND
 
 /* Prototypes */
 static void remove_actions (GeditWindow *window);
+static void set_file_viewer (GeditWindow     *window,
+			     GeditFileViewer *viewer);
 
 static void
 gedit_window_get_property (GObject    *object,
@@ -210,6 +218,8 @@ gedit_window_dispose (GObject *object)
 		window->priv->dispose_has_run = TRUE;
 	}
 
+	set_file_viewer (window, NULL);
+
 	g_clear_object (&window->priv->message_bus);
 	g_clear_object (&window->priv->window_group);
 	g_clear_object (&window->priv->window_titles);
@@ -552,6 +562,8 @@ update_actions_sensitivity (GeditWindow *window)
 	GAction *action;
 	gboolean editable = FALSE;
 	gboolean empty_search = FALSE;
+	gboolean searchable = FALSE;
+	gboolean file_viewer = FALSE;
 	GtkClipboard *clipboard;
 	gboolean enable_syntax_highlighting;
 
@@ -574,6 +586,17 @@ update_actions_sensitivity (GeditWindow *window)
 		tab_number = gtk_notebook_page_num (GTK_NOTEBOOK (notebook), GTK_WIDGET (tab));
 		editable = gtk_text_view_get_editable (GTK_TEXT_VIEW (view));
 		empty_search = _gedit_document_get_empty_search (doc);
+
+		/* While a large file is loaded progressively, the part
+		 * already loaded can be searched.
+		 */
+		searchable = ((state == GEDIT_TAB_STATE_NORMAL) ||
+			      (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION) ||
+			      (state == GEDIT_TAB_STATE_LOADING &&
+			       _gedit_tab_get_loading_progressively (tab)));
+
+		/* The document contains only a part of the file. */
+		file_viewer = _gedit_tab_get_file_viewer (tab) != NULL;
 	}
 
 	clipboard = gtk_widget_get_clipboard (GTK_WIDGET (window), GDK_SELECTION_CLIPBOARD);
@@ -582,20 +605,22 @@ update_actions_sensitivity (GeditWindow *window)
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
 	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
 	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                             (file != NULL) && !gtk_source_file_is_readonly (file));
+	                             (file != NULL) && !gtk_source_file_is_readonly (file) &&
+	                             !file_viewer);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "save-as");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
 	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
 	                              (state == GEDIT_TAB_STATE_SAVING_ERROR) ||
 	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                             (doc != NULL));
+	                             (doc != NULL) && !file_viewer);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "revert");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
 	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
 	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                             (doc != NULL) && !_gedit_document_is_untitled (doc));
+	                             (doc != NULL) && !_gedit_document_is_untitled (doc) &&
+	                             !file_viewer);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "reopen-closed-tab");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action), (window->priv->closed_docs_stack != NULL));
@@ -604,7 +629,7 @@ update_actions_sensitivity (GeditWindow *window)
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
 	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
 	                              (state == GEDIT_TAB_STATE_SHOWING_PRINT_PREVIEW)) &&
-	                             (doc != NULL));
+	                             (doc != NULL) && !file_viewer);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "close");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
@@ -657,9 +682,7 @@ update_actions_sensitivity (GeditWindow *window)
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "find");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
-	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
-	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                             (doc != NULL));
+	                             searchable);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "replace");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
@@ -668,27 +691,19 @@ update_actions_sensitivity (GeditWindow *window)
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "find-next");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
-	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
-	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                              (doc != NULL) && !empty_search);
+	                             searchable && !empty_search);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "find-prev");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
-	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
-	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                              (doc != NULL) && !empty_search);
+	                             searchable && !empty_search);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "clear-highlight");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
-	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
-	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                              (doc != NULL) && !empty_search);
+	                             searchable && !empty_search);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "goto-line");
 	g_simple_action_set_enabled (G_SIMPLE_ACTION (action),
-	                             ((state == GEDIT_TAB_STATE_NORMAL) ||
-	                              (state == GEDIT_TAB_STATE_EXTERNALLY_MODIFIED_NOTIFICATION)) &&
-	                             (doc != NULL));
+	                             searchable);
 
 	action = g_action_map_lookup_action (G_ACTION_MAP (window), "highlight-mode");
 	/* TODO: listen for changes to that gsetting. */
@@ -986,6 +1001,78 @@ sync_current_tab_actions (GeditWindow *window,
 	}
 }
 
+static void
+file_viewer_cursor_moved_cb (GeditFileViewer *viewer,
+			     GeditWindow     *window)
+{
+	gint64 line;
+	gint column;
+
+	_gedit_file_viewer_get_cursor_position (viewer, &line, &column);
+
+	tepl_line_column_indicator_set_line_and_column (window->priv->line_column_indicator,
+							MIN (line + 1, G_MAXINT),
+							column + 1);
+}
+
+static void
+set_file_viewer (GeditWindow     *window,
+		 GeditFileViewer *viewer)
+{
+	if (window->priv->file_viewer == viewer)
+	{
+		return;
+	}
+
+	if (window->priv->file_viewer != NULL)
+	{
+		g_signal_handler_disconnect (window->priv->file_viewer,
+					     window->priv->file_viewer_cursor_moved_id);
+		window->priv->file_viewer_cursor_moved_id = 0;
+		g_clear_object (&window->priv->file_viewer);
+	}
+
+	if (viewer != NULL)
+	{
+		window->priv->file_viewer = g_object_ref (viewer);
+		window->priv->file_viewer_cursor_moved_id =
+			g_signal_connect (viewer,
+					  "cursor-moved",
+					  G_CALLBACK (file_viewer_cursor_moved_cb),
+					  window);
+	}
+}
+
+/* For a file shown by a viewer, the line numbers of the view are relative to
+ * the part of the file that is in the buffer.
+ */
+static void
+update_line_column_indicator (GeditWindow *window)
+{
+	GeditTab *tab;
+	GeditFileViewer *viewer = NULL;
+
+	tab = gedit_multi_notebook_get_active_tab (window->priv->multi_notebook);
+
+	if (tab != NULL)
+	{
+		viewer = _gedit_tab_get_file_viewer (tab);
+	}
+
+	set_file_viewer (window, viewer);
+
+	if (viewer != NULL)
+	{
+		tepl_line_column_indicator_set_view (window->priv->line_column_indicator, NULL);
+		file_viewer_cursor_moved_cb (viewer, window);
+	}
+	else if (tab != NULL)
+	{
+		tepl_line_column_indicator_set_view (window->priv->line_column_indicator,
+						     TEPL_VIEW (gedit_tab_get_view (tab)));
+	}
+}
+
 static void
 update_statusbar (GeditWindow *window,
 		  GeditView   *old_view,
@@ -1020,6 +1107,7 @@ update_statusbar (GeditWindow *window,
 
 		tepl_line_column_indicator_set_view (window->priv->line_column_indicator,
 						     TEPL_VIEW (new_view));
+		update_line_column_indicator (window);
 		gtk_widget_show (GTK_WIDGET (window->priv->line_column_indicator));
 
 		gtk_widget_show (GTK_WIDGET (window->priv->tab_width_button));
@@ -1082,6 +1170,13 @@ analyze_tab_state (GeditTab    *tab,
 	switch (ts)
 	{
 		case GEDIT_TAB_STATE_LOADING:
+			/* Tabs loaded only when shown don't count. */
+			if (!_gedit_tab_has_deferred_load (tab))
+			{
+				window->priv->state |= GEDIT_WINDOW_STATE_LOADING;
+			}
+			break;
+
 		case GEDIT_TAB_STATE_REVERTING:
 			window->priv->state |= GEDIT_WINDOW_STATE_LOADING;
 			break;
@@ -1182,6 +1277,7 @@ sync_state (GeditTab    *tab,
 
 	if (tab == gedit_window_get_active_tab (window))
 	{
+		update_line_column_indicator (window);
 		update_actions_sensitivity (window);
 	}
 }
@@ -1691,6 +1787,8 @@ on_tab_removed (GeditMultiNotebook *multi,
 			window->priv->language_changed_id = 0;
 		}
 
+		set_file_viewer (window, NULL);
+
 		gedit_multi_notebook_set_active_tab (multi, NULL);
 	}
 
@@ -3157,42 +3255,34 @@ GeditTab *
 gedit_window_get_tab_from_location (GeditWindow *window,
 				    GFile       *location)
 {
-	GList *tabs;
-	GList *l;
-	GeditTab *ret = NULL;
+	GPtrArray *docs;
+	guint i;
 
 	g_return_val_if_fail (GEDIT_IS_WINDOW (window), NULL);
 	g_return_val_if_fail (G_IS_FILE (location), NULL);
 
-	tabs = gedit_multi_notebook_get_all_tabs (window->priv->multi_notebook);
+	/* The documents are indexed by location for the whole application, a
+	 * document belongs to this window if its tab is inside it.
+	 */
+	docs = _gedit_document_peek_documents_for_location (location);
 
-	for (l = tabs; l != NULL; l = g_list_next (l))
+	if (docs == NULL)
 	{
-		GeditDocument *doc;
-		GtkSourceFile *file;
-		GeditTab *tab;
-		GFile *cur_location;
+		return NULL;
+	}
 
-		tab = GEDIT_TAB (l->data);
-		doc = gedit_tab_get_document (tab);
-		file = gedit_document_get_file (doc);
-		cur_location = gtk_source_file_get_location (file);
+	for (i = 0; i < docs->len; i++)
+	{
+		GeditTab *tab = gedit_tab_get_from_document (g_ptr_array_index (docs, i));
 
-		if (cur_location != NULL)
+		if (tab != NULL &&
+		    gtk_widget_get_toplevel (GTK_WIDGET (tab)) == GTK_WIDGET (window))
 		{
-			gboolean found = g_file_equal (location, cur_location);
-
-			if (found)
-			{
-				ret = tab;
-				break;
-			}
+			return tab;
 		}
 	}
 
-	g_list_free (tabs);
-
-	return ret;
+	return NULL;
 }
 
 /**
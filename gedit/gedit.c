@@ -35,6 +35,7 @@
 #include "gedit-dirs.h"
 #include "gedit-debug.h"
 #include "gedit-factory.h"
+#include "gedit-metadata-store.h"
 #include "gedit-settings.h"
 
 static void
@@ -120,6 +121,9 @@ main (int argc, char *argv[])
 		                     G_OBJECT (app)->ref_count);
 	}
 
+	/* After the app, the documents save their metadata when disposed. */
+	_gedit_metadata_store_unref_singleton ();
+
 	tepl_finalize ();
 	gedit_dirs_shutdown ();
 
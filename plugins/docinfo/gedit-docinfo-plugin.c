@@ -22,10 +22,9 @@
 
 #include "gedit-docinfo-plugin.h"
 
-#include <string.h> /* For strlen (...) */
+#include "gedit-docinfo-stats.h"
 
 #include <glib/gi18n.h>
-#include <pango/pango-break.h>
 #include <gmodule.h>
 
 #include <gedit/gedit-app.h>
@@ -64,6 +63,8 @@ struct _GeditDocinfoPluginPrivate
 
 	GeditApp  *app;
 	GeditMenuExtension *menu_ext;
+
+	guint update_retry_id;
 };
 
 enum
@@ -86,59 +87,49 @@ G_DEFINE_DYNAMIC_TYPE_EXTENDED (GeditDocinfoPlugin,
 							       gedit_window_activatable_iface_init)
 				G_ADD_PRIVATE_DYNAMIC (GeditDocinfoPlugin))
 
+/* In milliseconds. */
+#define UPDATE_RETRY_INTERVAL (250)
+
+static void update_info (GeditDocinfoPlugin *plugin);
+
 static void
-calculate_info (GeditDocument *doc,
-		GtkTextIter   *start,
-		GtkTextIter   *end,
-		gint          *chars,
-		gint          *words,
-		gint          *white_chars,
-		gint          *bytes)
+set_label_count (GtkWidget *label,
+		 gint       count)
 {
-	gchar *text;
+	gchar *tmp_str;
 
-	gedit_debug (DEBUG_PLUGINS);
+	tmp_str = g_strdup_printf("%d", count);
+	gtk_label_set_text (GTK_LABEL (label), tmp_str);
+	g_free (tmp_str);
+}
 
-	text = gtk_text_buffer_get_slice (GTK_TEXT_BUFFER (doc),
-					  start,
-					  end,
-					  TRUE);
+static gboolean
+update_retry_cb (gpointer user_data)
+{
+	GeditDocinfoPlugin *plugin = GEDIT_DOCINFO_PLUGIN (user_data);
 
-	*chars = g_utf8_strlen (text, -1);
-	*bytes = strlen (text);
+	plugin->priv->update_retry_id = 0;
 
-	if (*chars > 0)
+	if (plugin->priv->dialog != NULL)
 	{
-		PangoLogAttr *attrs;
-		gint i;
-
-		attrs = g_new0 (PangoLogAttr, *chars + 1);
-
-		pango_get_log_attrs (text,
-				     -1,
-				     0,
-				     pango_language_from_string ("C"),
-				     attrs,
-				     *chars + 1);
-
-		for (i = 0; i < (*chars); i++)
-		{
-			if (attrs[i].is_white)
-				++(*white_chars);
+		update_info (plugin);
+	}
 
-			if (attrs[i].is_word_start)
-				++(*words);
-		}
+	return G_SOURCE_REMOVE;
+}
 
-		g_free (attrs);
-	}
-	else
+/* The statistics of a big document are first counted in the background, the
+ * labels are updated again when they are ready.
+ */
+static void
+retry_update_later (GeditDocinfoPlugin *plugin)
+{
+	if (plugin->priv->update_retry_id == 0)
 	{
-		*white_chars = 0;
-		*words = 0;
+		plugin->priv->update_retry_id = g_timeout_add (UPDATE_RETRY_INTERVAL,
+							       update_retry_cb,
+							       plugin);
 	}
-
-	g_free (text);
 }
 
 static void
@@ -146,63 +137,58 @@ update_document_info (GeditDocinfoPlugin *plugin,
 		      GeditDocument      *doc)
 {
 	GeditDocinfoPluginPrivate *priv;
+	GeditDocinfoStats *stats;
+	GeditDocinfoCounts counts;
 	GtkTextIter start, end;
-	gint words = 0;
-	gint chars = 0;
-	gint white_chars = 0;
 	gint lines = 0;
-	gint bytes = 0;
 	gchar *doc_name;
-	gchar *tmp_str;
 
 	gedit_debug (DEBUG_PLUGINS);
 
 	priv = plugin->priv;
 
+	doc_name = tepl_file_get_short_name (tepl_buffer_get_file (TEPL_BUFFER (doc)));
+	gtk_header_bar_set_subtitle (GTK_HEADER_BAR (priv->header_bar), doc_name);
+	g_free (doc_name);
+
 	gtk_text_buffer_get_bounds (GTK_TEXT_BUFFER (doc),
 				    &start,
 				    &end);
 
-	lines = gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (doc));
-
-	calculate_info (doc,
-			&start, &end,
-			&chars, &words, &white_chars, &bytes);
+	stats = gedit_docinfo_stats_get_for_buffer (GTK_TEXT_BUFFER (doc));
 
-	if (chars == 0)
+	if (!gedit_docinfo_stats_get_counts (stats, &start, &end, &counts))
 	{
-		lines = 0;
-	}
+		gedit_debug_message (DEBUG_PLUGINS, "Document statistics not ready");
 
-	gedit_debug_message (DEBUG_PLUGINS, "Chars: %d", chars);
-	gedit_debug_message (DEBUG_PLUGINS, "Lines: %d", lines);
-	gedit_debug_message (DEBUG_PLUGINS, "Words: %d", words);
-	gedit_debug_message (DEBUG_PLUGINS, "Chars non-space: %d", chars - white_chars);
-	gedit_debug_message (DEBUG_PLUGINS, "Bytes: %d", bytes);
-
-	doc_name = tepl_file_get_short_name (tepl_buffer_get_file (TEPL_BUFFER (doc)));
-	gtk_header_bar_set_subtitle (GTK_HEADER_BAR (priv->header_bar), doc_name);
-	g_free (doc_name);
+		gtk_label_set_text (GTK_LABEL (priv->document_lines_label), "…");
+		gtk_label_set_text (GTK_LABEL (priv->document_words_label), "…");
+		gtk_label_set_text (GTK_LABEL (priv->document_chars_label), "…");
+		gtk_label_set_text (GTK_LABEL (priv->document_chars_ns_label), "…");
+		gtk_label_set_text (GTK_LABEL (priv->document_bytes_label), "…");
 
-	tmp_str = g_strdup_printf("%d", lines);
-	gtk_label_set_text (GTK_LABEL (priv->document_lines_label), tmp_str);
-	g_free (tmp_str);
-
-	tmp_str = g_strdup_printf("%d", words);
-	gtk_label_set_text (GTK_LABEL (priv->document_words_label), tmp_str);
-	g_free (tmp_str);
+		retry_update_later (plugin);
+		return;
+	}
 
-	tmp_str = g_strdup_printf("%d", chars);
-	gtk_label_set_text (GTK_LABEL (priv->document_chars_label), tmp_str);
-	g_free (tmp_str);
+	lines = gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (doc));
 
-	tmp_str = g_strdup_printf("%d", chars - white_chars);
-	gtk_label_set_text (GTK_LABEL (priv->document_chars_ns_label), tmp_str);
-	g_free (tmp_str);
+	if (counts.chars == 0)
+	{
+		lines = 0;
+	}
 
-	tmp_str = g_strdup_printf("%d", bytes);
-	gtk_label_set_text (GTK_LABEL (priv->document_bytes_label), tmp_str);
-	g_free (tmp_str);
+	gedit_debug_message (DEBUG_PLUGINS, "Chars: %d", counts.chars);
+	gedit_debug_message (DEBUG_PLUGINS, "Lines: %d", lines);
+	gedit_debug_message (DEBUG_PLUGINS, "Words: %d", counts.words);
+	gedit_debug_message (DEBUG_PLUGINS, "Chars non-space: %d", counts.chars - counts.white_chars);
+	gedit_debug_message (DEBUG_PLUGINS, "Bytes: %d", counts.bytes);
+
+	set_label_count (priv->document_lines_label, lines);
+	set_label_count (priv->document_words_label, counts.words);
+	set_label_count (priv->document_chars_label, counts.chars);
+	set_label_count (priv->document_chars_ns_label, counts.chars - counts.white_chars);
+	set_label_count (priv->document_bytes_label, counts.bytes);
 }
 
 static void
@@ -212,12 +198,8 @@ update_selection_info (GeditDocinfoPlugin *plugin,
 	GeditDocinfoPluginPrivate *priv;
 	gboolean sel;
 	GtkTextIter start, end;
-	gint words = 0;
-	gint chars = 0;
-	gint white_chars = 0;
+	GeditDocinfoCounts counts = { 0 };
 	gint lines = 0;
-	gint bytes = 0;
-	gchar *tmp_str;
 
 	gedit_debug (DEBUG_PLUGINS);
 
@@ -229,17 +211,31 @@ update_selection_info (GeditDocinfoPlugin *plugin,
 
 	if (sel)
 	{
-		lines = gtk_text_iter_get_line (&end) - gtk_text_iter_get_line (&start) + 1;
+		GeditDocinfoStats *stats;
 
-		calculate_info (doc,
-				&start, &end,
-				&chars, &words, &white_chars, &bytes);
+		stats = gedit_docinfo_stats_get_for_buffer (GTK_TEXT_BUFFER (doc));
 
-		gedit_debug_message (DEBUG_PLUGINS, "Selected chars: %d", chars);
+		if (!gedit_docinfo_stats_get_counts (stats, &start, &end, &counts))
+		{
+			gedit_debug_message (DEBUG_PLUGINS, "Selection statistics not ready");
+
+			gtk_label_set_text (GTK_LABEL (priv->selected_lines_label), "…");
+			gtk_label_set_text (GTK_LABEL (priv->selected_words_label), "…");
+			gtk_label_set_text (GTK_LABEL (priv->selected_chars_label), "…");
+			gtk_label_set_text (GTK_LABEL (priv->selected_chars_ns_label), "…");
+			gtk_label_set_text (GTK_LABEL (priv->selected_bytes_label), "…");
+
+			retry_update_later (plugin);
+			return;
+		}
+
+		lines = gtk_text_iter_get_line (&end) - gtk_text_iter_get_line (&start) + 1;
+
+		gedit_debug_message (DEBUG_PLUGINS, "Selected chars: %d", counts.chars);
 		gedit_debug_message (DEBUG_PLUGINS, "Selected lines: %d", lines);
-		gedit_debug_message (DEBUG_PLUGINS, "Selected words: %d", words);
-		gedit_debug_message (DEBUG_PLUGINS, "Selected chars non-space: %d", chars - white_chars);
-		gedit_debug_message (DEBUG_PLUGINS, "Selected bytes: %d", bytes);
+		gedit_debug_message (DEBUG_PLUGINS, "Selected words: %d", counts.words);
+		gedit_debug_message (DEBUG_PLUGINS, "Selected chars non-space: %d", counts.chars - counts.white_chars);
+		gedit_debug_message (DEBUG_PLUGINS, "Selected bytes: %d", counts.bytes);
 
 		gtk_widget_set_sensitive (priv->selection_label, TRUE);
 		gtk_widget_set_sensitive (priv->selected_words_label, TRUE);
@@ -260,28 +256,28 @@ update_selection_info (GeditDocinfoPlugin *plugin,
 		gtk_widget_set_sensitive (priv->selected_chars_ns_label, FALSE);
 	}
 
-	if (chars == 0)
+	if (counts.chars == 0)
 		lines = 0;
 
-	tmp_str = g_strdup_printf("%d", lines);
-	gtk_label_set_text (GTK_LABEL (priv->selected_lines_label), tmp_str);
-	g_free (tmp_str);
-
-	tmp_str = g_strdup_printf("%d", words);
-	gtk_label_set_text (GTK_LABEL (priv->selected_words_label), tmp_str);
-	g_free (tmp_str);
+	set_label_count (priv->selected_lines_label, lines);
+	set_label_count (priv->selected_words_label, counts.words);
+	set_label_count (priv->selected_chars_label, counts.chars);
+	set_label_count (priv->selected_chars_ns_label, counts.chars - counts.white_chars);
+	set_label_count (priv->selected_bytes_label, counts.bytes);
+}
 
-	tmp_str = g_strdup_printf("%d", chars);
-	gtk_label_set_text (GTK_LABEL (priv->selected_chars_label), tmp_str);
-	g_free (tmp_str);
+static void
+update_info (GeditDocinfoPlugin *plugin)
+{
+	GeditDocument *doc;
 
-	tmp_str = g_strdup_printf("%d", chars - white_chars);
-	gtk_label_set_text (GTK_LABEL (priv->selected_chars_ns_label), tmp_str);
-	g_free (tmp_str);
+	doc = gedit_window_get_active_document (plugin->priv->window);
 
-	tmp_str = g_strdup_printf("%d", bytes);
-	gtk_label_set_text (GTK_LABEL (priv->selected_bytes_label), tmp_str);
-	g_free (tmp_str);
+	if (doc != NULL)
+	{
+		update_document_info (plugin, doc);
+		update_selection_info (plugin, doc);
+	}
 }
 
 static void
@@ -308,14 +304,9 @@ docinfo_dialog_response_cb (GtkDialog          *widget,
 
 		case GTK_RESPONSE_OK:
 		{
-			GeditDocument *doc;
-
 			gedit_debug_message (DEBUG_PLUGINS, "GTK_RESPONSE_OK");
 
-			doc = gedit_window_get_active_document (priv->window);
-
-			update_document_info (plugin, doc);
-			update_selection_info (plugin, doc);
+			update_info (plugin);
 
 			break;
 		}
@@ -400,14 +391,11 @@ docinfo_cb (GAction            *action,
             GeditDocinfoPlugin *plugin)
 {
 	GeditDocinfoPluginPrivate *priv;
-	GeditDocument *doc;
 
 	gedit_debug (DEBUG_PLUGINS);
 
 	priv = plugin->priv;
 
-	doc = gedit_window_get_active_document (priv->window);
-
 	if (priv->dialog != NULL)
 	{
 		gtk_window_present (GTK_WINDOW (priv->dialog));
@@ -419,8 +407,7 @@ docinfo_cb (GAction            *action,
 		gtk_widget_show (GTK_WIDGET (priv->dialog));
 	}
 
-	update_document_info (plugin, doc);
-	update_selection_info (plugin, doc);
+	update_info (plugin);
 }
 
 static void
@@ -438,6 +425,12 @@ gedit_docinfo_plugin_dispose (GObject *object)
 
 	gedit_debug_message (DEBUG_PLUGINS, "GeditDocinfoPlugin dispose");
 
+	if (plugin->priv->update_retry_id != 0)
+	{
+		g_source_remove (plugin->priv->update_retry_id);
+		plugin->priv->update_retry_id = 0;
+	}
+
 	g_clear_object (&plugin->priv->action);
 	g_clear_object (&plugin->priv->window);
 	g_clear_object (&plugin->priv->menu_ext);
@@ -571,12 +564,22 @@ static void
 gedit_docinfo_plugin_window_deactivate (GeditWindowActivatable *activatable)
 {
 	GeditDocinfoPluginPrivate *priv;
+	GList *docs;
+	GList *l;
 
 	gedit_debug (DEBUG_PLUGINS);
 
 	priv = GEDIT_DOCINFO_PLUGIN (activatable)->priv;
 
 	g_action_map_remove_action (G_ACTION_MAP (priv->window), "docinfo");
+
+	/* The statistics run code of this module. */
+	docs = gedit_window_get_documents (priv->window);
+	for (l = docs; l != NULL; l = l->next)
+	{
+		gedit_docinfo_stats_remove_from_buffer (GTK_TEXT_BUFFER (l->data));
+	}
+	g_list_free (docs);
 }
 
 static void
@@ -0,0 +1,609 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-docinfo-stats.h"
+
+#include <string.h> /* For strlen (...) */
+
+#include <pango/pango-break.h>
+
+#include <gedit/gedit-debug.h>
+
+/* The statistics of a buffer, kept per block of lines.
+ *
+ * Each block starts at a line start, marked by a left-gravity GtkTextMark, and
+ * ends where the next block starts. An edit only marks the block(s) that it
+ * touches as dirty, and a dirty block is counted again the next time the
+ * statistics are asked for. Since a word never spans a line end, the counts of
+ * the blocks can simply be added up.
+ *
+ * When the statistics are created for a buffer, all the blocks are dirty and
+ * they are counted in an idle, a few at a time. The same happens when an edit
+ * leaves more dirty blocks than can be counted synchronously.
+ */
+
+#define STATS_KEY "gedit-docinfo-stats-key"
+
+#define BLOCK_N_LINES (256)
+
+/* Up to that number of dirty blocks, they are counted when the statistics are
+ * asked for.
+ */
+#define MAX_DIRTY_BLOCKS_SYNC (32)
+
+/* In microseconds. */
+#define IDLE_TIME_BUDGET (5000)
+
+typedef struct
+{
+	GtkTextMark *start;
+	GeditDocinfoCounts counts;
+	guint dirty : 1;
+} Block;
+
+struct _GeditDocinfoStats
+{
+	/* Unowned, the stats are attached to it. Set to NULL when it is
+	 * disposed.
+	 */
+	GtkTextBuffer *buffer;
+
+	/* Element type: owned Block, in the buffer order. */
+	GPtrArray *blocks;
+	guint n_dirty_blocks;
+
+	gulong insert_text_handler_id;
+	gulong delete_range_handler_id;
+	guint idle_id;
+};
+
+static void
+count_range (GtkTextBuffer      *buffer,
+	     const GtkTextIter  *start,
+	     const GtkTextIter  *end,
+	     GeditDocinfoCounts *counts)
+{
+	gchar *text;
+	gint n_chars;
+
+	n_chars = gtk_text_iter_get_offset (end) - gtk_text_iter_get_offset (start);
+
+	if (n_chars <= 0)
+	{
+		return;
+	}
+
+	text = gtk_text_buffer_get_slice (buffer, start, end, TRUE);
+
+	counts->chars += n_chars;
+	counts->bytes += strlen (text);
+
+	{
+		PangoLogAttr *attrs;
+		gint i;
+
+		attrs = g_new0 (PangoLogAttr, n_chars + 1);
+
+		pango_get_log_attrs (text,
+				     -1,
+				     0,
+				     pango_language_from_string ("C"),
+				     attrs,
+				     n_chars + 1);
+
+		for (i = 0; i < n_chars; i++)
+		{
+			if (attrs[i].is_white)
+				++counts->white_chars;
+
+			if (attrs[i].is_word_start)
+				++counts->words;
+		}
+
+		g_free (attrs);
+	}
+
+	g_free (text);
+}
+
+static void
+add_counts (GeditDocinfoCounts       *counts,
+	    const GeditDocinfoCounts *block_counts)
+{
+	counts->chars += block_counts->chars;
+	counts->words += block_counts->words;
+	counts->white_chars += block_counts->white_chars;
+	counts->bytes += block_counts->bytes;
+}
+
+static Block *
+get_block (GeditDocinfoStats *stats,
+	   guint              block_num)
+{
+	return g_ptr_array_index (stats->blocks, block_num);
+}
+
+static void
+get_block_start (GeditDocinfoStats *stats,
+		 guint              block_num,
+		 GtkTextIter       *iter)
+{
+	gtk_text_buffer_get_iter_at_mark (stats->buffer,
+					  iter,
+					  get_block (stats, block_num)->start);
+}
+
+static void
+get_block_end (GeditDocinfoStats *stats,
+	       guint              block_num,
+	       GtkTextIter       *iter)
+{
+	if (block_num + 1 < stats->blocks->len)
+	{
+		get_block_start (stats, block_num + 1, iter);
+	}
+	else
+	{
+		gtk_text_buffer_get_end_iter (stats->buffer, iter);
+	}
+}
+
+static gboolean count_idle_cb (gpointer user_data);
+
+static void
+queue_count_idle (GeditDocinfoStats *stats)
+{
+	if (stats->idle_id == 0)
+	{
+		stats->idle_id = g_idle_add_full (G_PRIORITY_LOW,
+						  count_idle_cb,
+						  stats,
+						  NULL);
+	}
+}
+
+/* When there are too many dirty blocks to count them synchronously, they are
+ * counted in the background again.
+ */
+static void
+mark_block_dirty (GeditDocinfoStats *stats,
+		  Block             *block)
+{
+	block->dirty = TRUE;
+	stats->n_dirty_blocks++;
+
+	if (stats->n_dirty_blocks > MAX_DIRTY_BLOCKS_SYNC)
+	{
+		queue_count_idle (stats);
+	}
+}
+
+static void
+insert_block (GeditDocinfoStats *stats,
+	      guint              block_num,
+	      const GtkTextIter *start)
+{
+	Block *block;
+
+	block = g_new0 (Block, 1);
+	block->start = gtk_text_buffer_create_mark (stats->buffer, NULL, start, TRUE);
+	mark_block_dirty (stats, block);
+
+	g_ptr_array_insert (stats->blocks, block_num, block);
+}
+
+static void
+remove_block (GeditDocinfoStats *stats,
+	      guint              block_num)
+{
+	Block *block = get_block (stats, block_num);
+
+	if (block->dirty)
+	{
+		stats->n_dirty_blocks--;
+	}
+
+	gtk_text_buffer_delete_mark (stats->buffer, block->start);
+	g_ptr_array_remove_index (stats->blocks, block_num);
+}
+
+static void
+set_block_dirty (GeditDocinfoStats *stats,
+		 guint              block_num)
+{
+	Block *block = get_block (stats, block_num);
+
+	if (!block->dirty)
+	{
+		mark_block_dirty (stats, block);
+	}
+}
+
+/* Returns the last block starting at or before @iter. */
+static guint
+find_block (GeditDocinfoStats *stats,
+	    const GtkTextIter *iter)
+{
+	guint low = 0;
+	guint high = stats->blocks->len - 1;
+
+	while (low < high)
+	{
+		guint middle = low + (high - low + 1) / 2;
+		GtkTextIter block_start;
+
+		get_block_start (stats, middle, &block_start);
+
+		if (gtk_text_iter_compare (&block_start, iter) <= 0)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return low;
+}
+
+/* The caller must iterate over the blocks backwards, since counting a block
+ * can make the previous one dirty, and can remove or split the block.
+ */
+static void
+count_block (GeditDocinfoStats *stats,
+	     guint              block_num)
+{
+	Block *block = get_block (stats, block_num);
+	GtkTextIter start;
+	GtkTextIter end;
+
+	get_block_start (stats, block_num, &start);
+
+	/* After a deletion across blocks, the start of a block can be in the
+	 * middle of a line. The first block always starts at the buffer start.
+	 */
+	if (!gtk_text_iter_starts_line (&start))
+	{
+		gtk_text_iter_set_line_offset (&start, 0);
+		gtk_text_buffer_move_mark (stats->buffer, block->start, &start);
+		set_block_dirty (stats, block_num - 1);
+	}
+
+	get_block_end (stats, block_num, &end);
+
+	if (block_num > 0 && gtk_text_iter_equal (&start, &end))
+	{
+		remove_block (stats, block_num);
+		return;
+	}
+
+	/* Split the blocks that have grown too much, the new blocks are
+	 * counted by the next pass.
+	 */
+	if (gtk_text_iter_get_line (&end) - gtk_text_iter_get_line (&start) > 2 * BLOCK_N_LINES)
+	{
+		GtkTextIter split = start;
+		guint new_block_num = block_num + 1;
+
+		while (gtk_text_iter_forward_lines (&split, BLOCK_N_LINES) &&
+		       gtk_text_iter_compare (&split, &end) < 0)
+		{
+			insert_block (stats, new_block_num, &split);
+			new_block_num++;
+		}
+
+		get_block_end (stats, block_num, &end);
+	}
+
+	memset (&block->counts, 0, sizeof (GeditDocinfoCounts));
+	count_range (stats->buffer, &start, &end, &block->counts);
+
+	block->dirty = FALSE;
+	stats->n_dirty_blocks--;
+}
+
+/* Returns whether all the blocks have been counted before @deadline, a
+ * monotonic time, and without the number of dirty blocks going over
+ * @max_dirty_blocks, which happens when a big block is split. A @deadline of
+ * -1 means no limit.
+ */
+static gboolean
+count_dirty_blocks (GeditDocinfoStats *stats,
+		    gint64             deadline,
+		    guint              max_dirty_blocks)
+{
+	while (stats->n_dirty_blocks > 0)
+	{
+		guint block_num;
+
+		for (block_num = stats->blocks->len; block_num > 0; block_num--)
+		{
+			if (block_num > stats->blocks->len ||
+			    !get_block (stats, block_num - 1)->dirty)
+			{
+				continue;
+			}
+
+			count_block (stats, block_num - 1);
+
+			if (stats->n_dirty_blocks > max_dirty_blocks ||
+			    (deadline != -1 && g_get_monotonic_time () >= deadline))
+			{
+				return stats->n_dirty_blocks == 0;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+count_idle_cb (gpointer user_data)
+{
+	GeditDocinfoStats *stats = user_data;
+
+	if (count_dirty_blocks (stats, g_get_monotonic_time () + IDLE_TIME_BUDGET, G_MAXUINT))
+	{
+		gedit_debug_message (DEBUG_PLUGINS, "All %u blocks counted", stats->blocks->len);
+
+		stats->idle_id = 0;
+		return G_SOURCE_REMOVE;
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+insert_text_after_cb (GtkTextBuffer     *buffer,
+		      GtkTextIter       *location,
+		      const gchar       *text,
+		      gint               length,
+		      GeditDocinfoStats *stats)
+{
+	GtkTextIter start = *location;
+
+	/* @location is at the end of the inserted text. */
+	gtk_text_iter_backward_chars (&start, g_utf8_strlen (text, length));
+
+	set_block_dirty (stats, find_block (stats, &start));
+}
+
+static void
+delete_range_after_cb (GtkTextBuffer     *buffer,
+		       GtkTextIter       *start,
+		       GtkTextIter       *end,
+		       GeditDocinfoStats *stats)
+{
+	guint block_num;
+
+	/* The blocks that were inside the deleted range now start at @start,
+	 * and the block containing the start of the range has been truncated.
+	 */
+	block_num = find_block (stats, start);
+	set_block_dirty (stats, block_num);
+
+	while (block_num > 0)
+	{
+		GtkTextIter block_start;
+
+		block_num--;
+		set_block_dirty (stats, block_num);
+
+		get_block_start (stats, block_num, &block_start);
+		if (!gtk_text_iter_equal (&block_start, start))
+		{
+			break;
+		}
+	}
+}
+
+static void
+buffer_disposed_cb (gpointer  user_data,
+		    GObject  *where_the_buffer_was)
+{
+	GeditDocinfoStats *stats = user_data;
+
+	/* The marks and the signal handlers go away with the buffer. */
+	stats->buffer = NULL;
+}
+
+static void
+stats_free (GeditDocinfoStats *stats)
+{
+	guint block_num;
+
+	if (stats->idle_id != 0)
+	{
+		g_source_remove (stats->idle_id);
+	}
+
+	if (stats->buffer != NULL)
+	{
+		g_signal_handler_disconnect (stats->buffer, stats->insert_text_handler_id);
+		g_signal_handler_disconnect (stats->buffer, stats->delete_range_handler_id);
+		g_object_weak_unref (G_OBJECT (stats->buffer), buffer_disposed_cb, stats);
+
+		for (block_num = 0; block_num < stats->blocks->len; block_num++)
+		{
+			gtk_text_buffer_delete_mark (stats->buffer, get_block (stats, block_num)->start);
+		}
+	}
+
+	g_ptr_array_free (stats->blocks, TRUE);
+	g_free (stats);
+}
+
+static GeditDocinfoStats *
+stats_new (GtkTextBuffer *buffer)
+{
+	GeditDocinfoStats *stats;
+	GtkTextIter iter;
+
+	stats = g_new0 (GeditDocinfoStats, 1);
+	stats->buffer = buffer;
+	stats->blocks = g_ptr_array_new_with_free_func (g_free);
+
+	gtk_text_buffer_get_start_iter (buffer, &iter);
+
+	do
+	{
+		insert_block (stats, stats->blocks->len, &iter);
+	}
+	while (gtk_text_iter_forward_lines (&iter, BLOCK_N_LINES));
+
+	gedit_debug_message (DEBUG_PLUGINS, "Created %u blocks", stats->blocks->len);
+
+	g_object_weak_ref (G_OBJECT (buffer), buffer_disposed_cb, stats);
+
+	stats->insert_text_handler_id =
+		g_signal_connect_after (buffer,
+					"insert-text",
+					G_CALLBACK (insert_text_after_cb),
+					stats);
+
+	stats->delete_range_handler_id =
+		g_signal_connect_after (buffer,
+					"delete-range",
+					G_CALLBACK (delete_range_after_cb),
+					stats);
+
+	queue_count_idle (stats);
+
+	return stats;
+}
+
+/**
+ * gedit_docinfo_stats_get_for_buffer:
+ * @buffer: a #GtkTextBuffer.
+ *
+ * Returns: (transfer none): the statistics of @buffer, created the first time
+ * and kept up to date for the lifetime of @buffer.
+ */
+GeditDocinfoStats *
+gedit_docinfo_stats_get_for_buffer (GtkTextBuffer *buffer)
+{
+	GeditDocinfoStats *stats;
+
+	g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), NULL);
+
+	stats = g_object_get_data (G_OBJECT (buffer), STATS_KEY);
+
+	if (stats == NULL)
+	{
+		stats = stats_new (buffer);
+		g_object_set_data_full (G_OBJECT (buffer),
+					STATS_KEY,
+					stats,
+					(GDestroyNotify) stats_free);
+	}
+
+	return stats;
+}
+
+/**
+ * gedit_docinfo_stats_remove_from_buffer:
+ * @buffer: a #GtkTextBuffer.
+ *
+ * Frees the statistics of @buffer, if any. To call before the plugin module
+ * is unloaded.
+ */
+void
+gedit_docinfo_stats_remove_from_buffer (GtkTextBuffer *buffer)
+{
+	g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+
+	g_object_set_data (G_OBJECT (buffer), STATS_KEY, NULL);
+}
+
+/**
+ * gedit_docinfo_stats_get_counts:
+ * @stats: a #GeditDocinfoStats.
+ * @start: the start of the range.
+ * @end: the end of the range.
+ * @counts: (out): the counts of the range.
+ *
+ * The blocks entirely inside the range are not counted again, only the partial
+ * blocks at its edges.
+ *
+ * Returns: %FALSE if the buffer is still being counted in the background, in
+ * which case @counts is not set.
+ */
+gboolean
+gedit_docinfo_stats_get_counts (GeditDocinfoStats  *stats,
+				const GtkTextIter  *start,
+				const GtkTextIter  *end,
+				GeditDocinfoCounts *counts)
+{
+	guint first_block_num;
+	guint last_block_num;
+	guint block_num;
+	GtkTextIter block_start;
+	GtkTextIter block_end;
+
+	g_return_val_if_fail (stats != NULL && stats->buffer != NULL, FALSE);
+	g_return_val_if_fail (start != NULL, FALSE);
+	g_return_val_if_fail (end != NULL, FALSE);
+	g_return_val_if_fail (counts != NULL, FALSE);
+
+	if (stats->n_dirty_blocks > MAX_DIRTY_BLOCKS_SYNC ||
+	    !count_dirty_blocks (stats, -1, MAX_DIRTY_BLOCKS_SYNC))
+	{
+		return FALSE;
+	}
+
+	memset (counts, 0, sizeof (GeditDocinfoCounts));
+
+	first_block_num = find_block (stats, start);
+	last_block_num = find_block (stats, end);
+
+	if (first_block_num == last_block_num)
+	{
+		get_block_start (stats, first_block_num, &block_start);
+		get_block_end (stats, first_block_num, &block_end);
+
+		if (gtk_text_iter_equal (start, &block_start) &&
+		    gtk_text_iter_equal (end, &block_end))
+		{
+			add_counts (counts, &get_block (stats, first_block_num)->counts);
+		}
+		else
+		{
+			count_range (stats->buffer, start, end, counts);
+		}
+
+		return TRUE;
+	}
+
+	get_block_start (stats, first_block_num, &block_start);
+	if (gtk_text_iter_equal (start, &block_start))
+	{
+		add_counts (counts, &get_block (stats, first_block_num)->counts);
+	}
+	else
+	{
+		get_block_end (stats, first_block_num, &block_end);
+		count_range (stats->buffer, start, &block_end, counts);
+	}
+
+	for (block_num = first_block_num + 1; block_num < last_block_num; block_num++)
+	{
+		add_counts (counts, &get_block (stats, block_num)->counts);
+	}
+
+	get_block_end (stats, last_block_num, &block_end);
+	if (gtk_text_iter_equal (end, &block_end))
+	{
+		add_counts (counts, &get_block (stats, last_block_num)->counts);
+	}
+	else
+	{
+		get_block_start (stats, last_block_num, &block_start);
+		count_range (stats->buffer, &block_start, end, counts);
+	}
+
+	return TRUE;
+}
+
+/* ex:set ts=8 noet: */
@@ -0,0 +1,36 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_DOCINFO_STATS_H
+#define GEDIT_DOCINFO_STATS_H
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GeditDocinfoStats GeditDocinfoStats;
+typedef struct _GeditDocinfoCounts GeditDocinfoCounts;
+
+struct _GeditDocinfoCounts
+{
+	gint chars;
+	gint words;
+	gint white_chars;
+	gint bytes;
+};
+
+GeditDocinfoStats *	gedit_docinfo_stats_get_for_buffer	(GtkTextBuffer      *buffer);
+
+void			gedit_docinfo_stats_remove_from_buffer	(GtkTextBuffer      *buffer);
+
+gboolean		gedit_docinfo_stats_get_counts		(GeditDocinfoStats  *stats,
+								 const GtkTextIter  *start,
+								 const GtkTextIter  *end,
+								 GeditDocinfoCounts *counts);
+
+G_END_DECLS
+
+#endif /* GEDIT_DOCINFO_STATS_H */
+
+/* ex:set ts=8 noet: */
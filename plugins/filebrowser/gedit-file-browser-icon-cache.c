@@ -0,0 +1,398 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "gedit-file-browser-icon-cache.h"
+
+/* The icons of the file browser nodes, interned: the nodes of the files of a
+ * same type, with a same emblem, share one GeditFileBrowserIcon and so one
+ * pixbuf. An icon stays in the cache as long as it is referenced.
+ *
+ * The pixbuf of an icon is loaded when it is first asked for, that is when
+ * the row is first drawn, and loaded again after a change of the icon theme.
+ *
+ * The emblems are interned too, by name, so that the nodes with a same emblem
+ * share one GeditFileBrowserIcon.
+ *
+ * The cache is only used from the main thread.
+ */
+
+struct _GeditFileBrowserIcon
+{
+	gint ref_count;
+
+	/* The key. @gicon is NULL for the fallback icon. */
+	GIcon *gicon;
+	GdkPixbuf *emblem;
+	gint size;
+	gint scale;
+
+	GdkPixbuf *pixbuf;
+	guint generation;
+	guint loaded : 1;
+};
+
+typedef struct
+{
+	gchar *name;
+	gint size;
+
+	/* Not owned, the entry is removed when it is finalized. */
+	GdkPixbuf *pixbuf;
+} EmblemEntry;
+
+typedef struct
+{
+	/* Element type: GeditFileBrowserIcon, not owned. */
+	GHashTable *icons;
+
+	/* Key: "size:name". Value: owned EmblemEntry. */
+	GHashTable *emblems;
+
+	/* Bumped on every change of the icon theme. */
+	guint generation;
+
+	gulong theme_changed_id;
+} IconCache;
+
+static IconCache cache;
+
+static void cache_check_empty (void);
+
+static guint
+icon_hash (gconstpointer key)
+{
+	const GeditFileBrowserIcon *icon = key;
+	guint hash;
+
+	hash = icon->gicon != NULL ? g_icon_hash ((gpointer) icon->gicon) : 0;
+	hash = hash * 31 + g_direct_hash (icon->emblem);
+	hash = hash * 31 + (guint) icon->size;
+	hash = hash * 31 + (guint) icon->scale;
+
+	return hash;
+}
+
+static gboolean
+icon_equal (gconstpointer a,
+	    gconstpointer b)
+{
+	const GeditFileBrowserIcon *icon_a = a;
+	const GeditFileBrowserIcon *icon_b = b;
+
+	return icon_a->emblem == icon_b->emblem &&
+	       icon_a->size == icon_b->size &&
+	       icon_a->scale == icon_b->scale &&
+	       g_icon_equal (icon_a->gicon, icon_b->gicon);
+}
+
+static void
+emblem_entry_weak_notify (gpointer  data,
+			  GObject  *where_the_object_was)
+{
+	EmblemEntry *entry = data;
+	gchar *key;
+
+	entry->pixbuf = NULL;
+
+	key = g_strdup_printf ("%d:%s", entry->size, entry->name);
+	g_hash_table_remove (cache.emblems, key);
+	g_free (key);
+
+	cache_check_empty ();
+}
+
+static void
+emblem_entry_free (EmblemEntry *entry)
+{
+	if (entry->pixbuf != NULL)
+		g_object_weak_unref (G_OBJECT (entry->pixbuf), emblem_entry_weak_notify, entry);
+
+	g_free (entry->name);
+	g_free (entry);
+}
+
+static void
+on_icon_theme_changed (GtkIconTheme *theme,
+		       gpointer      user_data)
+{
+	cache.generation++;
+
+	/* The emblems in use are kept by their nodes, the next ones are
+	 * loaded from the new theme.
+	 */
+	g_hash_table_remove_all (cache.emblems);
+	cache_check_empty ();
+}
+
+static void
+cache_ref (void)
+{
+	if (cache.icons == NULL)
+	{
+		cache.icons = g_hash_table_new (icon_hash, icon_equal);
+		cache.emblems = g_hash_table_new_full (g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify) emblem_entry_free);
+	}
+
+	if (cache.theme_changed_id == 0)
+	{
+		cache.theme_changed_id = g_signal_connect (gtk_icon_theme_get_default (),
+							   "changed",
+							   G_CALLBACK (on_icon_theme_changed),
+							   NULL);
+	}
+}
+
+/* Nothing is connected once the cache is empty, so that the plugin can be
+ * unloaded.
+ */
+static void
+cache_check_empty (void)
+{
+	if (cache.theme_changed_id != 0 &&
+	    g_hash_table_size (cache.icons) == 0 &&
+	    g_hash_table_size (cache.emblems) == 0)
+	{
+		g_signal_handler_disconnect (gtk_icon_theme_get_default (), cache.theme_changed_id);
+		cache.theme_changed_id = 0;
+	}
+}
+
+static GdkPixbuf *
+load_pixbuf (GeditFileBrowserIcon *icon)
+{
+	GtkIconTheme *theme = gtk_icon_theme_get_default ();
+	GdkPixbuf *pixbuf = NULL;
+	GdkPixbuf *composited;
+	gint width;
+	gint height;
+
+	if (icon->gicon != NULL)
+	{
+		GtkIconInfo *info;
+
+		info = gtk_icon_theme_lookup_by_gicon_for_scale (theme,
+								 icon->gicon,
+								 icon->size,
+								 icon->scale,
+								 GTK_ICON_LOOKUP_USE_BUILTIN);
+
+		if (info != NULL)
+		{
+			pixbuf = gtk_icon_info_load_icon (info, NULL);
+			g_object_unref (info);
+		}
+	}
+
+	/* Fallback to the same icon as the file browser */
+	if (pixbuf == NULL)
+	{
+		pixbuf = gtk_icon_theme_load_icon_for_scale (theme,
+							     "text-x-generic",
+							     icon->size,
+							     icon->scale,
+							     0,
+							     NULL);
+	}
+
+	if (icon->emblem == NULL)
+		return pixbuf;
+
+	if (pixbuf != NULL)
+	{
+		composited = gdk_pixbuf_copy (pixbuf);
+		g_object_unref (pixbuf);
+	}
+	else
+	{
+		composited = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (icon->emblem),
+					     TRUE,
+					     gdk_pixbuf_get_bits_per_sample (icon->emblem),
+					     icon->size * icon->scale,
+					     icon->size * icon->scale);
+		gdk_pixbuf_fill (composited, 0);
+	}
+
+	width = MIN (gdk_pixbuf_get_width (icon->emblem), gdk_pixbuf_get_width (composited));
+	height = MIN (gdk_pixbuf_get_height (icon->emblem), gdk_pixbuf_get_height (composited));
+
+	/* In the bottom right corner */
+	gdk_pixbuf_composite (icon->emblem, composited,
+			      gdk_pixbuf_get_width (composited) - width,
+			      gdk_pixbuf_get_height (composited) - height,
+			      width, height,
+			      gdk_pixbuf_get_width (composited) - width,
+			      gdk_pixbuf_get_height (composited) - height,
+			      1, 1, GDK_INTERP_NEAREST, 255);
+
+	return composited;
+}
+
+/**
+ * gedit_file_browser_icon_cache_lookup:
+ * @gicon: (nullable): the icon of the file, %NULL for the fallback icon.
+ * @emblem: (nullable): the emblem to draw over the icon.
+ * @size: the size of the icon, in logical pixels.
+ * @scale: the scale factor.
+ *
+ * Returns: (transfer full): the shared icon for this key.
+ */
+GeditFileBrowserIcon *
+gedit_file_browser_icon_cache_lookup (GIcon     *gicon,
+				      GdkPixbuf *emblem,
+				      gint       size,
+				      gint       scale)
+{
+	GeditFileBrowserIcon key;
+	GeditFileBrowserIcon *icon;
+
+	g_return_val_if_fail (gicon == NULL || G_IS_ICON (gicon), NULL);
+	g_return_val_if_fail (emblem == NULL || GDK_IS_PIXBUF (emblem), NULL);
+
+	cache_ref ();
+
+	key.gicon = gicon;
+	key.emblem = emblem;
+	key.size = size;
+	key.scale = scale;
+
+	icon = g_hash_table_lookup (cache.icons, &key);
+
+	if (icon != NULL)
+		return gedit_file_browser_icon_ref (icon);
+
+	icon = g_new0 (GeditFileBrowserIcon, 1);
+	icon->ref_count = 1;
+	icon->gicon = gicon != NULL ? g_object_ref (gicon) : NULL;
+	icon->emblem = emblem != NULL ? g_object_ref (emblem) : NULL;
+	icon->size = size;
+	icon->scale = scale;
+
+	g_hash_table_add (cache.icons, icon);
+
+	return icon;
+}
+
+/**
+ * gedit_file_browser_icon_cache_lookup_emblem:
+ * @name: the icon name of the emblem.
+ * @size: the size of the emblem, in pixels.
+ *
+ * Returns: (transfer full) (nullable): the shared emblem pixbuf, or %NULL if
+ * the icon theme has no such icon.
+ */
+GdkPixbuf *
+gedit_file_browser_icon_cache_lookup_emblem (const gchar *name,
+					     gint         size)
+{
+	EmblemEntry *entry;
+	GdkPixbuf *pixbuf;
+	gchar *key;
+
+	g_return_val_if_fail (name != NULL, NULL);
+
+	cache_ref ();
+
+	key = g_strdup_printf ("%d:%s", size, name);
+	entry = g_hash_table_lookup (cache.emblems, key);
+
+	if (entry != NULL)
+	{
+		g_free (key);
+		return g_object_ref (entry->pixbuf);
+	}
+
+	pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
+					   name,
+					   size,
+					   GTK_ICON_LOOKUP_FORCE_SIZE,
+					   NULL);
+
+	if (pixbuf == NULL)
+	{
+		g_free (key);
+		cache_check_empty ();
+		return NULL;
+	}
+
+	entry = g_new (EmblemEntry, 1);
+	entry->name = g_strdup (name);
+	entry->size = size;
+	entry->pixbuf = pixbuf;
+	g_object_weak_ref (G_OBJECT (pixbuf), emblem_entry_weak_notify, entry);
+
+	g_hash_table_insert (cache.emblems, key, entry);
+
+	return pixbuf;
+}
+
+GeditFileBrowserIcon *
+gedit_file_browser_icon_ref (GeditFileBrowserIcon *icon)
+{
+	g_return_val_if_fail (icon != NULL, NULL);
+
+	icon->ref_count++;
+	return icon;
+}
+
+void
+gedit_file_browser_icon_unref (GeditFileBrowserIcon *icon)
+{
+	g_return_if_fail (icon != NULL);
+
+	if (--icon->ref_count > 0)
+		return;
+
+	g_hash_table_remove (cache.icons, icon);
+
+	g_clear_object (&icon->gicon);
+	g_clear_object (&icon->emblem);
+	g_clear_object (&icon->pixbuf);
+	g_free (icon);
+
+	cache_check_empty ();
+}
+
+GIcon *
+gedit_file_browser_icon_get_gicon (GeditFileBrowserIcon *icon)
+{
+	g_return_val_if_fail (icon != NULL, NULL);
+
+	return icon->gicon;
+}
+
+GdkPixbuf *
+gedit_file_browser_icon_get_emblem (GeditFileBrowserIcon *icon)
+{
+	g_return_val_if_fail (icon != NULL, NULL);
+
+	return icon->emblem;
+}
+
+/**
+ * gedit_file_browser_icon_get_pixbuf:
+ * @icon: a #GeditFileBrowserIcon.
+ *
+ * Returns: (transfer none) (nullable): the pixbuf of @icon, loaded from the
+ * current icon theme.
+ */
+GdkPixbuf *
+gedit_file_browser_icon_get_pixbuf (GeditFileBrowserIcon *icon)
+{
+	g_return_val_if_fail (icon != NULL, NULL);
+
+	if (!icon->loaded || icon->generation != cache.generation)
+	{
+		g_clear_object (&icon->pixbuf);
+		icon->pixbuf = load_pixbuf (icon);
+		icon->generation = cache.generation;
+		icon->loaded = TRUE;
+	}
+
+	return icon->pixbuf;
+}
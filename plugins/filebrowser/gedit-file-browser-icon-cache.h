@@ -0,0 +1,34 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_ICON_CACHE_H
+#define GEDIT_FILE_BROWSER_ICON_CACHE_H
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GeditFileBrowserIcon GeditFileBrowserIcon;
+
+GeditFileBrowserIcon	*gedit_file_browser_icon_cache_lookup		(GIcon                *gicon,
+									 GdkPixbuf            *emblem,
+									 gint                  size,
+									 gint                  scale);
+
+GdkPixbuf		*gedit_file_browser_icon_cache_lookup_emblem	(const gchar          *name,
+									 gint                  size);
+
+GeditFileBrowserIcon	*gedit_file_browser_icon_ref			(GeditFileBrowserIcon *icon);
+
+void			 gedit_file_browser_icon_unref			(GeditFileBrowserIcon *icon);
+
+GIcon			*gedit_file_browser_icon_get_gicon		(GeditFileBrowserIcon *icon);
+
+GdkPixbuf		*gedit_file_browser_icon_get_emblem		(GeditFileBrowserIcon *icon);
+
+GdkPixbuf		*gedit_file_browser_icon_get_pixbuf		(GeditFileBrowserIcon *icon);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_ICON_CACHE_H */
@@ -0,0 +1,1013 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "gedit-file-browser-index.h"
+#include "gedit-file-browser-enum-types.h"
+#include "gedit-file-browser-matcher.h"
+#include "gedit-file-browser-utils.h"
+
+/* An index of the paths of all the files under a root directory, for the quick
+ * open.
+ *
+ * The tree is enumerated breadth-first in a worker thread, with the hidden and
+ * binary filters of the file browser, and the paths are added in batches in
+ * the main thread. Afterwards the index is kept current with the changes seen
+ * by the monitors of the file browser store, see
+ * gedit_file_browser_index_update().
+ *
+ * The paths are relative to the root, '/' separated, and stored in one string
+ * chunk. Each path has a mask of the characters it contains, so that most of
+ * the paths are rejected by a query without being scanned. A query that
+ * extends the previous one only scans the paths that matched the previous one.
+ */
+
+/* The worker pushes its batches at least this often */
+#define CRAWL_BATCH_USEC (16 * 1000)
+#define CRAWL_BATCH_MAX 4096
+
+/* Compact the entries when more than half of them are removed */
+#define COMPACT_MIN_REMOVED 4096
+
+#define CRAWL_ATTRIBUTES G_FILE_ATTRIBUTE_STANDARD_TYPE "," \
+			 G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," \
+			 G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP "," \
+			 G_FILE_ATTRIBUTE_STANDARD_NAME "," \
+			 G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE "," \
+			 G_FILE_ATTRIBUTE_ID_FILE
+
+#define SCORE_MATCH		16
+#define SCORE_WORD_START	24
+#define SCORE_CONSECUTIVE	16
+#define SCORE_BASENAME		8
+
+typedef struct
+{
+	/* In the string chunk, NULL once removed. */
+	const gchar *path;
+	guint64 mask;
+	guint length;
+	guint basename;
+} IndexEntry;
+
+typedef struct
+{
+	gint score;
+	guint position;
+} IndexMatch;
+
+struct _GeditFileBrowserIndex
+{
+	GObject parent_instance;
+
+	GFile *root;
+	GeditFileBrowserStoreFilterMode filter_mode;
+	gchar **binary_patterns;
+
+	GStringChunk *strings;
+	GArray *entries;
+
+	/* The files, path -> position + 1, and the set of the directories. */
+	GHashTable *positions;
+	GHashTable *directories;
+	guint n_removed;
+
+	/* Changed when an entry is added or removed. */
+	guint generation;
+
+	GCancellable *cancellable;
+	guint n_crawls;
+
+	/* The last query and its matches, to narrow the next query. */
+	gchar *last_query;
+	GArray *last_candidates;
+	guint last_generation;
+};
+
+enum
+{
+	PROP_0,
+	PROP_LOADING,
+	N_PROPERTIES
+};
+
+enum
+{
+	CHANGED,
+	N_SIGNALS
+};
+
+static GParamSpec *properties[N_PROPERTIES];
+static guint signals[N_SIGNALS];
+
+G_DEFINE_DYNAMIC_TYPE (GeditFileBrowserIndex, gedit_file_browser_index, G_TYPE_OBJECT)
+
+/* Crawling */
+
+typedef struct
+{
+	GFile *file;
+
+	/* Relative to the root, empty for the root itself. */
+	gchar *relative;
+} CrawlStart;
+
+typedef struct
+{
+	GWeakRef index;
+
+	/* Element type: owned CrawlStart. */
+	GPtrArray *starts;
+
+	GeditFileBrowserStoreFilterMode filter_mode;
+	GeditFileBrowserMatcher *binary_matcher;
+
+	/* Element type: owned path, with a trailing '/' for a directory. */
+	GMutex mutex;
+	GPtrArray *pending;
+	gboolean dispatch_pending;
+} CrawlData;
+
+static void
+crawl_start_free (CrawlStart *start)
+{
+	g_object_unref (start->file);
+	g_free (start->relative);
+	g_free (start);
+}
+
+static CrawlStart *
+crawl_start_new (GFile       *file,
+		 const gchar *relative)
+{
+	CrawlStart *start = g_new (CrawlStart, 1);
+
+	start->file = g_object_ref (file);
+	start->relative = g_strdup (relative);
+
+	return start;
+}
+
+static void
+crawl_data_clear (CrawlData *data)
+{
+	g_weak_ref_clear (&data->index);
+	g_ptr_array_unref (data->starts);
+	g_clear_pointer (&data->binary_matcher, gedit_file_browser_matcher_free);
+	g_mutex_clear (&data->mutex);
+	g_ptr_array_unref (data->pending);
+}
+
+static void
+crawl_data_release (CrawlData *data)
+{
+	g_atomic_rc_box_release_full (data, (GDestroyNotify) crawl_data_clear);
+}
+
+static guint64
+char_mask (guchar c)
+{
+	if (c >= 'a' && c <= 'z')
+		return G_GUINT64_CONSTANT (1) << (c - 'a');
+
+	if (c >= 'A' && c <= 'Z')
+		return G_GUINT64_CONSTANT (1) << (c - 'A');
+
+	if (c >= '0' && c <= '9')
+		return G_GUINT64_CONSTANT (1) << (26 + c - '0');
+
+	/* The other bytes share the remaining bits */
+	return G_GUINT64_CONSTANT (1) << (36 + c % 28);
+}
+
+static gboolean
+is_word_separator (gchar c)
+{
+	return c == '/' || c == '_' || c == '-' || c == '.' || c == ' ';
+}
+
+static void
+index_invalidate_query (GeditFileBrowserIndex *index)
+{
+	index->generation++;
+}
+
+static void
+index_add_path (GeditFileBrowserIndex *index,
+		const gchar           *path,
+		gsize                  length)
+{
+	IndexEntry entry;
+	const gchar *slash;
+	guint i;
+
+	if (length > 0 && path[length - 1] == '/')
+	{
+		gchar *directory = g_strndup (path, length - 1);
+
+		if (!g_hash_table_contains (index->directories, directory))
+			g_hash_table_add (index->directories, g_string_chunk_insert (index->strings, directory));
+
+		g_free (directory);
+		return;
+	}
+
+	if (g_hash_table_contains (index->positions, path))
+		return;
+
+	entry.path = g_string_chunk_insert_len (index->strings, path, length);
+	entry.length = length;
+	entry.mask = 0;
+
+	for (i = 0; i < length; i++)
+		entry.mask |= char_mask (path[i]);
+
+	slash = strrchr (entry.path, '/');
+	entry.basename = slash != NULL ? slash - entry.path + 1 : 0;
+
+	g_array_append_val (index->entries, entry);
+	g_hash_table_insert (index->positions,
+			     (gpointer) entry.path,
+			     GUINT_TO_POINTER (index->entries->len));
+}
+
+static void
+index_compact (GeditFileBrowserIndex *index)
+{
+	GStringChunk *strings;
+	GArray *entries;
+	GHashTable *directories;
+	GHashTableIter iter;
+	gpointer directory;
+
+	strings = g_string_chunk_new (64 * 1024);
+	entries = g_array_sized_new (FALSE, FALSE, sizeof (IndexEntry), index->entries->len - index->n_removed);
+	directories = g_hash_table_new (g_str_hash, g_str_equal);
+
+	g_hash_table_remove_all (index->positions);
+
+	for (guint i = 0; i < index->entries->len; i++)
+	{
+		IndexEntry entry = g_array_index (index->entries, IndexEntry, i);
+
+		if (entry.path == NULL)
+			continue;
+
+		entry.path = g_string_chunk_insert_len (strings, entry.path, entry.length);
+		g_array_append_val (entries, entry);
+		g_hash_table_insert (index->positions,
+				     (gpointer) entry.path,
+				     GUINT_TO_POINTER (entries->len));
+	}
+
+	g_hash_table_iter_init (&iter, index->directories);
+
+	while (g_hash_table_iter_next (&iter, &directory, NULL))
+		g_hash_table_add (directories, g_string_chunk_insert (strings, directory));
+
+	g_string_chunk_free (index->strings);
+	g_array_unref (index->entries);
+	g_hash_table_unref (index->directories);
+
+	index->strings = strings;
+	index->entries = entries;
+	index->directories = directories;
+	index->n_removed = 0;
+}
+
+static void
+index_remove_entry (GeditFileBrowserIndex *index,
+		    guint                  position)
+{
+	IndexEntry *entry = &g_array_index (index->entries, IndexEntry, position);
+
+	g_hash_table_remove (index->positions, entry->path);
+	entry->path = NULL;
+	index->n_removed++;
+}
+
+/* Returns whether a file was removed */
+static gboolean
+index_remove_path (GeditFileBrowserIndex *index,
+		   const gchar           *path)
+{
+	gpointer position;
+	GHashTableIter iter;
+	gpointer directory;
+	gsize length;
+	gboolean removed = FALSE;
+
+	position = g_hash_table_lookup (index->positions, path);
+
+	if (position != NULL)
+	{
+		index_remove_entry (index, GPOINTER_TO_UINT (position) - 1);
+		return TRUE;
+	}
+
+	/* A directory, the monitors do not report its children */
+	if (!g_hash_table_remove (index->directories, path))
+		return FALSE;
+
+	length = strlen (path);
+
+	for (guint i = 0; i < index->entries->len; i++)
+	{
+		IndexEntry *entry = &g_array_index (index->entries, IndexEntry, i);
+
+		if (entry->path != NULL &&
+		    entry->length > length &&
+		    entry->path[length] == '/' &&
+		    strncmp (entry->path, path, length) == 0)
+		{
+			index_remove_entry (index, i);
+			removed = TRUE;
+		}
+	}
+
+	g_hash_table_iter_init (&iter, index->directories);
+
+	while (g_hash_table_iter_next (&iter, &directory, NULL))
+	{
+		if (g_str_has_prefix (directory, path) &&
+		    ((const gchar *) directory)[length] == '/')
+		{
+			g_hash_table_iter_remove (&iter);
+		}
+	}
+
+	return removed;
+}
+
+static gboolean
+crawl_dispatch_cb (CrawlData *data)
+{
+	GeditFileBrowserIndex *index;
+	GPtrArray *paths;
+	guint n_entries;
+
+	g_mutex_lock (&data->mutex);
+	paths = data->pending;
+	data->pending = g_ptr_array_new_with_free_func (g_free);
+	data->dispatch_pending = FALSE;
+	g_mutex_unlock (&data->mutex);
+
+	index = g_weak_ref_get (&data->index);
+
+	if (index != NULL)
+	{
+		n_entries = index->entries->len;
+
+		for (guint i = 0; i < paths->len; i++)
+		{
+			const gchar *path = g_ptr_array_index (paths, i);
+
+			index_add_path (index, path, strlen (path));
+		}
+
+		if (index->entries->len != n_entries)
+		{
+			index_invalidate_query (index);
+			g_signal_emit (index, signals[CHANGED], 0);
+		}
+
+		g_object_unref (index);
+	}
+
+	g_ptr_array_unref (paths);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Called in the worker thread, steals the paths of @batch. */
+static void
+crawl_push (CrawlData *data,
+	    GPtrArray *batch)
+{
+	gpointer *paths;
+	gsize n_paths;
+	gboolean schedule;
+
+	if (batch->len == 0)
+		return;
+
+	paths = g_ptr_array_steal (batch, &n_paths);
+
+	g_mutex_lock (&data->mutex);
+
+	for (gsize i = 0; i < n_paths; i++)
+		g_ptr_array_add (data->pending, paths[i]);
+
+	schedule = !data->dispatch_pending;
+	data->dispatch_pending = TRUE;
+
+	g_mutex_unlock (&data->mutex);
+
+	g_free (paths);
+
+	if (schedule)
+	{
+		g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+				 (GSourceFunc) crawl_dispatch_cb,
+				 g_atomic_rc_box_acquire (data),
+				 (GDestroyNotify) crawl_data_release);
+	}
+}
+
+/* Called in the worker thread, takes @relative. A directory is added to
+   @queue, a file that is not filtered out to @batch. */
+static void
+crawl_visit (CrawlData  *data,
+	     GQueue     *queue,
+	     GHashTable *visited,
+	     GPtrArray  *batch,
+	     GFile      *file,
+	     GFileInfo  *info,
+	     gchar      *relative)
+{
+	GFileType type = g_file_info_get_file_type (info);
+
+	if (type != G_FILE_TYPE_REGULAR &&
+	    type != G_FILE_TYPE_DIRECTORY &&
+	    type != G_FILE_TYPE_SYMBOLIC_LINK)
+	{
+		g_free (relative);
+		return;
+	}
+
+	if (gedit_file_browser_utils_file_info_is_filtered (info, data->filter_mode, data->binary_matcher))
+	{
+		g_free (relative);
+		return;
+	}
+
+	if (type == G_FILE_TYPE_DIRECTORY)
+	{
+		const gchar *id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILE);
+
+		/* A link to a directory already enumerated */
+		if (id != NULL && !g_hash_table_add (visited, g_strdup (id)))
+		{
+			g_free (relative);
+			return;
+		}
+
+		g_ptr_array_add (batch, g_strconcat (relative, "/", NULL));
+		g_queue_push_tail (queue, crawl_start_new (file, relative));
+		g_free (relative);
+		return;
+	}
+
+	g_ptr_array_add (batch, relative);
+}
+
+static void
+crawl_thread (GTask        *task,
+	      gpointer      source_object,
+	      gpointer      task_data,
+	      GCancellable *cancellable)
+{
+	CrawlData *data = task_data;
+	GQueue queue = G_QUEUE_INIT;
+	GHashTable *visited;
+	GPtrArray *batch;
+	CrawlStart *directory;
+	gint64 last_push;
+
+	visited = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	batch = g_ptr_array_new_with_free_func (g_free);
+
+	for (guint i = 0; i < data->starts->len; i++)
+	{
+		CrawlStart *start = g_ptr_array_index (data->starts, i);
+		GFileInfo *info;
+
+		if (start->relative[0] == '\0')
+		{
+			g_queue_push_tail (&queue, crawl_start_new (start->file, start->relative));
+			continue;
+		}
+
+		info = g_file_query_info (start->file,
+					  CRAWL_ATTRIBUTES,
+					  G_FILE_QUERY_INFO_NONE,
+					  cancellable,
+					  NULL);
+
+		if (info != NULL)
+		{
+			crawl_visit (data, &queue, visited, batch,
+				     start->file, info, g_strdup (start->relative));
+			g_object_unref (info);
+		}
+	}
+
+	last_push = g_get_monotonic_time ();
+
+	while ((directory = g_queue_pop_head (&queue)) != NULL)
+	{
+		GFileEnumerator *enumerator;
+		GFileInfo *info;
+
+		if (g_cancellable_is_cancelled (cancellable))
+		{
+			crawl_start_free (directory);
+			break;
+		}
+
+		enumerator = g_file_enumerate_children (directory->file,
+							CRAWL_ATTRIBUTES,
+							G_FILE_QUERY_INFO_NONE,
+							cancellable,
+							NULL);
+
+		while (enumerator != NULL &&
+		       (info = g_file_enumerator_next_file (enumerator, cancellable, NULL)) != NULL)
+		{
+			GFile *child = g_file_enumerator_get_child (enumerator, info);
+			gchar *relative;
+
+			if (directory->relative[0] == '\0')
+				relative = g_strdup (g_file_info_get_name (info));
+			else
+				relative = g_strconcat (directory->relative, "/", g_file_info_get_name (info), NULL);
+
+			crawl_visit (data, &queue, visited, batch, child, info, relative);
+
+			g_object_unref (child);
+			g_object_unref (info);
+
+			if (batch->len >= CRAWL_BATCH_MAX ||
+			    g_get_monotonic_time () - last_push >= CRAWL_BATCH_USEC)
+			{
+				crawl_push (data, batch);
+				last_push = g_get_monotonic_time ();
+			}
+		}
+
+		g_clear_object (&enumerator);
+		crawl_start_free (directory);
+	}
+
+	g_queue_clear_full (&queue, (GDestroyNotify) crawl_start_free);
+
+	crawl_push (data, batch);
+
+	g_ptr_array_unref (batch);
+	g_hash_table_unref (visited);
+
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+crawl_done_cb (GObject      *source_object,
+	       GAsyncResult *result,
+	       gpointer      user_data)
+{
+	CrawlData *data = user_data;
+	GeditFileBrowserIndex *index;
+
+	/* The last batch, when its idle has not run yet */
+	crawl_dispatch_cb (data);
+
+	index = g_weak_ref_get (&data->index);
+
+	if (index != NULL)
+	{
+		if (--index->n_crawls == 0)
+			g_object_notify_by_pspec (G_OBJECT (index), properties[PROP_LOADING]);
+
+		g_object_unref (index);
+	}
+
+	crawl_data_release (data);
+}
+
+/* Takes @starts */
+static void
+index_crawl (GeditFileBrowserIndex *index,
+	     GPtrArray             *starts)
+{
+	CrawlData *data;
+	GTask *task;
+
+	data = g_atomic_rc_box_new0 (CrawlData);
+	g_weak_ref_init (&data->index, index);
+	data->starts = starts;
+	data->filter_mode = index->filter_mode;
+	data->pending = g_ptr_array_new_with_free_func (g_free);
+	g_mutex_init (&data->mutex);
+
+	if (index->binary_patterns != NULL)
+		data->binary_matcher = gedit_file_browser_matcher_new ((const gchar * const *) index->binary_patterns);
+
+	if (index->n_crawls++ == 0)
+		g_object_notify_by_pspec (G_OBJECT (index), properties[PROP_LOADING]);
+
+	task = g_task_new (NULL, index->cancellable, crawl_done_cb, data);
+	g_task_set_task_data (task, g_atomic_rc_box_acquire (data), (GDestroyNotify) crawl_data_release);
+	g_task_set_priority (task, G_PRIORITY_DEFAULT_IDLE);
+	g_task_run_in_thread (task, crawl_thread);
+	g_object_unref (task);
+}
+
+static void
+gedit_file_browser_index_get_property (GObject    *object,
+				       guint       prop_id,
+				       GValue     *value,
+				       GParamSpec *pspec)
+{
+	GeditFileBrowserIndex *index = GEDIT_FILE_BROWSER_INDEX (object);
+
+	switch (prop_id)
+	{
+		case PROP_LOADING:
+			g_value_set_boolean (value, gedit_file_browser_index_is_loading (index));
+			break;
+
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+gedit_file_browser_index_dispose (GObject *object)
+{
+	GeditFileBrowserIndex *index = GEDIT_FILE_BROWSER_INDEX (object);
+
+	if (index->cancellable != NULL)
+	{
+		g_cancellable_cancel (index->cancellable);
+		g_clear_object (&index->cancellable);
+	}
+
+	G_OBJECT_CLASS (gedit_file_browser_index_parent_class)->dispose (object);
+}
+
+static void
+gedit_file_browser_index_finalize (GObject *object)
+{
+	GeditFileBrowserIndex *index = GEDIT_FILE_BROWSER_INDEX (object);
+
+	g_clear_object (&index->root);
+	g_strfreev (index->binary_patterns);
+	g_hash_table_unref (index->positions);
+	g_hash_table_unref (index->directories);
+	g_array_unref (index->entries);
+	g_string_chunk_free (index->strings);
+	g_free (index->last_query);
+	g_clear_pointer (&index->last_candidates, g_array_unref);
+
+	G_OBJECT_CLASS (gedit_file_browser_index_parent_class)->finalize (object);
+}
+
+static void
+gedit_file_browser_index_class_init (GeditFileBrowserIndexClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->get_property = gedit_file_browser_index_get_property;
+	object_class->dispose = gedit_file_browser_index_dispose;
+	object_class->finalize = gedit_file_browser_index_finalize;
+
+	properties[PROP_LOADING] =
+		g_param_spec_boolean ("loading",
+				      "Loading",
+				      "Whether the tree is being enumerated",
+				      FALSE,
+				      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+	signals[CHANGED] =
+		g_signal_new ("changed",
+			      G_TYPE_FROM_CLASS (klass),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+}
+
+static void
+gedit_file_browser_index_class_finalize (GeditFileBrowserIndexClass *klass)
+{
+}
+
+static void
+gedit_file_browser_index_init (GeditFileBrowserIndex *index)
+{
+	index->strings = g_string_chunk_new (64 * 1024);
+	index->entries = g_array_new (FALSE, FALSE, sizeof (IndexEntry));
+	index->positions = g_hash_table_new (g_str_hash, g_str_equal);
+	index->directories = g_hash_table_new (g_str_hash, g_str_equal);
+	index->cancellable = g_cancellable_new ();
+}
+
+/**
+ * gedit_file_browser_index_new:
+ * @root: the directory to index.
+ * @filter_mode: the hidden and binary filters to apply.
+ * @binary_patterns: (nullable): the patterns of the binary files.
+ *
+ * Creates an index of the files under @root, and starts the enumeration.
+ *
+ * Returns: (transfer full): a new #GeditFileBrowserIndex.
+ */
+GeditFileBrowserIndex *
+gedit_file_browser_index_new (GFile                           *root,
+			      GeditFileBrowserStoreFilterMode  filter_mode,
+			      const gchar * const             *binary_patterns)
+{
+	GeditFileBrowserIndex *index;
+	GPtrArray *starts;
+
+	g_return_val_if_fail (G_IS_FILE (root), NULL);
+
+	index = g_object_new (GEDIT_TYPE_FILE_BROWSER_INDEX, NULL);
+	index->root = g_object_ref (root);
+	index->filter_mode = filter_mode;
+	index->binary_patterns = g_strdupv ((gchar **) binary_patterns);
+
+	starts = g_ptr_array_new_with_free_func ((GDestroyNotify) crawl_start_free);
+	g_ptr_array_add (starts, crawl_start_new (root, ""));
+	index_crawl (index, starts);
+
+	return index;
+}
+
+GFile *
+gedit_file_browser_index_get_root (GeditFileBrowserIndex *index)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index), NULL);
+
+	return index->root;
+}
+
+gboolean
+gedit_file_browser_index_is_loading (GeditFileBrowserIndex *index)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index), FALSE);
+
+	return index->n_crawls > 0;
+}
+
+guint
+gedit_file_browser_index_get_n_files (GeditFileBrowserIndex *index)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index), 0);
+
+	return index->entries->len - index->n_removed;
+}
+
+/**
+ * gedit_file_browser_index_update:
+ * @index: a #GeditFileBrowserIndex.
+ * @changed: (element-type GFile): the files created or changed.
+ * @removed: (element-type GFile): the files deleted.
+ *
+ * Applies the changes seen by a directory monitor, see the
+ * #GeditFileBrowserStore::files-changed signal. The new directories are
+ * enumerated in a worker thread.
+ */
+void
+gedit_file_browser_index_update (GeditFileBrowserIndex *index,
+				 GPtrArray             *changed,
+				 GPtrArray             *removed)
+{
+	GPtrArray *starts = NULL;
+	gboolean any_removed = FALSE;
+
+	g_return_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index));
+
+	for (guint i = 0; removed != NULL && i < removed->len; i++)
+	{
+		gchar *relative = g_file_get_relative_path (index->root, g_ptr_array_index (removed, i));
+
+		if (relative != NULL)
+		{
+			any_removed |= index_remove_path (index, relative);
+			g_free (relative);
+		}
+	}
+
+	for (guint i = 0; changed != NULL && i < changed->len; i++)
+	{
+		GFile *file = g_ptr_array_index (changed, i);
+		gchar *relative = g_file_get_relative_path (index->root, file);
+
+		if (relative != NULL &&
+		    !g_hash_table_contains (index->positions, relative) &&
+		    !g_hash_table_contains (index->directories, relative))
+		{
+			if (starts == NULL)
+				starts = g_ptr_array_new_with_free_func ((GDestroyNotify) crawl_start_free);
+
+			g_ptr_array_add (starts, crawl_start_new (file, relative));
+		}
+
+		g_free (relative);
+	}
+
+	if (starts != NULL)
+		index_crawl (index, starts);
+
+	if (any_removed)
+	{
+		if (index->n_removed >= COMPACT_MIN_REMOVED &&
+		    index->n_removed > index->entries->len / 2)
+		{
+			index_compact (index);
+		}
+
+		index_invalidate_query (index);
+		g_signal_emit (index, signals[CHANGED], 0);
+	}
+}
+
+/* The bytes of the query are matched from the end of the path, so that the
+   basename is preferred, with a bonus for the start of a word and for a run of
+   consecutive characters. Only the ASCII letters are compared without case. */
+static gboolean
+score_entry (const IndexEntry *entry,
+	     const gchar      *query,
+	     guint             query_length,
+	     gint             *score)
+{
+	const gchar *path = entry->path;
+	gint q = query_length - 1;
+	gint previous = -1;
+	gint s = 0;
+
+	for (gint i = entry->length - 1; i >= 0 && q >= 0; i--)
+	{
+		if (g_ascii_tolower (path[i]) != query[q])
+			continue;
+
+		s += SCORE_MATCH;
+
+		if (i == 0 ||
+		    is_word_separator (path[i - 1]) ||
+		    (g_ascii_islower (path[i - 1]) && g_ascii_isupper (path[i])))
+		{
+			s += SCORE_WORD_START;
+		}
+
+		if (previous == i + 1)
+			s += SCORE_CONSECUTIVE;
+
+		if ((guint) i >= entry->basename)
+			s += SCORE_BASENAME;
+
+		previous = i;
+		q--;
+	}
+
+	if (q >= 0)
+		return FALSE;
+
+	/* Prefer the shorter paths */
+	*score = s - (gint) (entry->length / 4);
+	return TRUE;
+}
+
+static gboolean
+match_is_better (const IndexMatch *match,
+		 const IndexMatch *other,
+		 GArray           *entries)
+{
+	if (match->score != other->score)
+		return match->score > other->score;
+
+	return g_array_index (entries, IndexEntry, match->position).length <
+	       g_array_index (entries, IndexEntry, other->position).length;
+}
+
+/* Keeps the best @max_results matches in @best, sorted */
+static void
+best_matches_insert (GArray     *best,
+		     guint       max_results,
+		     IndexMatch *match,
+		     GArray     *entries)
+{
+	guint i;
+
+	if (best->len == max_results &&
+	    !match_is_better (match, &g_array_index (best, IndexMatch, best->len - 1), entries))
+	{
+		return;
+	}
+
+	i = best->len;
+
+	while (i > 0 && match_is_better (match, &g_array_index (best, IndexMatch, i - 1), entries))
+		i--;
+
+	if (best->len == max_results)
+		g_array_set_size (best, best->len - 1);
+
+	g_array_insert_val (best, i, *match);
+}
+
+/**
+ * gedit_file_browser_index_query:
+ * @index: a #GeditFileBrowserIndex.
+ * @query: the characters to look for, in order.
+ * @max_results: the maximum number of results.
+ *
+ * Looks for the paths that contain the characters of @query in order, the
+ * white space excepted.
+ *
+ * Returns: (transfer container) (element-type utf8): the paths relative to
+ * the root, '/' separated, the best match first. The paths are owned by
+ * @index and valid until it changes.
+ */
+GPtrArray *
+gedit_file_browser_index_query (GeditFileBrowserIndex *index,
+				const gchar           *query,
+				guint                  max_results)
+{
+	GPtrArray *results;
+	GArray *candidates;
+	GArray *best;
+	GString *normalized;
+	guint64 mask = 0;
+	gboolean narrow;
+	guint n;
+
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index), NULL);
+	g_return_val_if_fail (query != NULL, NULL);
+
+	results = g_ptr_array_new ();
+
+	normalized = g_string_new (NULL);
+
+	for (const gchar *p = query; *p != '\0'; p++)
+	{
+		if (!g_ascii_isspace (*p))
+		{
+			g_string_append_c (normalized, g_ascii_tolower (*p));
+			mask |= char_mask (*p);
+		}
+	}
+
+	if (normalized->len == 0 || max_results == 0)
+	{
+		g_string_free (normalized, TRUE);
+		return results;
+	}
+
+	/* The paths that match the query match all its prefixes */
+	narrow = (index->last_query != NULL &&
+		  index->last_generation == index->generation &&
+		  g_str_has_prefix (normalized->str, index->last_query));
+
+	n = narrow ? index->last_candidates->len : index->entries->len;
+	candidates = g_array_new (FALSE, FALSE, sizeof (guint));
+	best = g_array_sized_new (FALSE, FALSE, sizeof (IndexMatch), max_results + 1);
+
+	for (guint i = 0; i < n; i++)
+	{
+		guint position = narrow ? g_array_index (index->last_candidates, guint, i) : i;
+		const IndexEntry *entry = &g_array_index (index->entries, IndexEntry, position);
+		IndexMatch match;
+
+		if (entry->path == NULL ||
+		    (entry->mask & mask) != mask ||
+		    !score_entry (entry, normalized->str, normalized->len, &match.score))
+		{
+			continue;
+		}
+
+		g_array_append_val (candidates, position);
+
+		match.position = position;
+		best_matches_insert (best, max_results, &match, index->entries);
+	}
+
+	for (guint i = 0; i < best->len; i++)
+	{
+		guint position = g_array_index (best, IndexMatch, i).position;
+
+		g_ptr_array_add (results, (gpointer) g_array_index (index->entries, IndexEntry, position).path);
+	}
+
+	g_free (index->last_query);
+	index->last_query = g_string_free (normalized, FALSE);
+	g_clear_pointer (&index->last_candidates, g_array_unref);
+	index->last_candidates = candidates;
+	index->last_generation = index->generation;
+
+	g_array_unref (best);
+
+	return results;
+}
+
+void
+_gedit_file_browser_index_register_type (GTypeModule *type_module)
+{
+	gedit_file_browser_index_register_type (type_module);
+}
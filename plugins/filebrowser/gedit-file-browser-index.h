@@ -0,0 +1,39 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_INDEX_H
+#define GEDIT_FILE_BROWSER_INDEX_H
+
+#include "gedit-file-browser-store.h"
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_INDEX (gedit_file_browser_index_get_type ())
+G_DECLARE_FINAL_TYPE (GeditFileBrowserIndex, gedit_file_browser_index,
+		      GEDIT, FILE_BROWSER_INDEX,
+		      GObject)
+
+GeditFileBrowserIndex	*gedit_file_browser_index_new		(GFile                           *root,
+								 GeditFileBrowserStoreFilterMode  filter_mode,
+								 const gchar * const             *binary_patterns);
+
+GFile			*gedit_file_browser_index_get_root	(GeditFileBrowserIndex           *index);
+
+gboolean		 gedit_file_browser_index_is_loading	(GeditFileBrowserIndex           *index);
+
+guint			 gedit_file_browser_index_get_n_files	(GeditFileBrowserIndex           *index);
+
+void			 gedit_file_browser_index_update	(GeditFileBrowserIndex           *index,
+								 GPtrArray                       *changed,
+								 GPtrArray                       *removed);
+
+GPtrArray		*gedit_file_browser_index_query		(GeditFileBrowserIndex           *index,
+								 const gchar                     *query,
+								 guint                            max_results);
+
+void			 _gedit_file_browser_index_register_type	(GTypeModule             *type_module);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_INDEX_H */
@@ -0,0 +1,290 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-file-browser-listing-cache.h"
+#include <glib/gstdio.h>
+
+/* A cache of the directory listings, so that the file browser can show a
+ * directory before it is enumerated, which can take seconds on a network
+ * mount.
+ *
+ * There is one file per directory in the "gedit/filebrowser" cache dir, named
+ * after the checksum of the URI of the directory. It contains a GVariant with
+ * a version number and one entry per child: the name, the display name, the
+ * file type, the hidden and backup flags, the content type, the icon and the
+ * modification time.
+ *
+ * All the functions are thread-safe, they are called by the worker loading
+ * the directory.
+ */
+
+#define CACHE_VERSION 1
+#define CACHE_FORMAT "(ua(ssuyssx))"
+#define ENTRY_FORMAT "(ssuyssx)"
+
+#define ENTRY_FLAG_HIDDEN (1 << 0)
+#define ENTRY_FLAG_BACKUP (1 << 1)
+
+static gchar *
+get_cache_filename (GFile *location)
+{
+	gchar *uri;
+	gchar *checksum;
+	gchar *filename;
+
+	uri = g_file_get_uri (location);
+	checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+	filename = g_build_filename (g_get_user_cache_dir (), "gedit", "filebrowser", checksum, NULL);
+
+	g_free (uri);
+	g_free (checksum);
+
+	return filename;
+}
+
+/*
+ * gedit_file_browser_listing_cache_read:
+ * @location: the directory.
+ *
+ * Returns: (transfer full) (nullable): the cached entries of @location, by
+ * name, or %NULL if the listing of @location is not cached.
+ */
+GHashTable *
+gedit_file_browser_listing_cache_read (GFile *location)
+{
+	gchar *filename;
+	gchar *contents;
+	gsize length;
+	GBytes *bytes;
+	GVariant *listing;
+	GVariant *entries;
+	GHashTable *cached = NULL;
+	guint32 version;
+
+	filename = get_cache_filename (location);
+
+	if (!g_file_get_contents (filename, &contents, &length, NULL))
+	{
+		g_free (filename);
+		return NULL;
+	}
+
+	g_free (filename);
+
+	bytes = g_bytes_new_take (contents, length);
+	listing = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_FORMAT), bytes, FALSE));
+	g_bytes_unref (bytes);
+
+	g_variant_get (listing, "(u@a" ENTRY_FORMAT ")", &version, &entries);
+
+	if (version == CACHE_VERSION)
+	{
+		GVariantIter iter;
+		GVariant *entry;
+
+		cached = g_hash_table_new_full (g_str_hash,
+						g_str_equal,
+						NULL,
+						(GDestroyNotify) g_variant_unref);
+
+		g_variant_iter_init (&iter, entries);
+
+		while ((entry = g_variant_iter_next_value (&iter)) != NULL)
+		{
+			/* The key is owned by the entry */
+			g_hash_table_replace (cached,
+					      (gpointer) gedit_file_browser_listing_cache_entry_get_name (entry),
+					      entry);
+		}
+	}
+
+	g_variant_unref (entries);
+	g_variant_unref (listing);
+
+	return cached;
+}
+
+/*
+ * gedit_file_browser_listing_cache_write:
+ * @location: the directory.
+ * @entries: (element-type GVariant): the entries of the children of @location.
+ *
+ * Replaces the cached listing of @location. Errors are ignored, the cache is
+ * only an optimization.
+ */
+void
+gedit_file_browser_listing_cache_write (GFile     *location,
+					GPtrArray *entries)
+{
+	GVariantBuilder builder;
+	GVariant *listing;
+	gchar *filename;
+	gchar *dirname;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a" ENTRY_FORMAT));
+
+	for (guint i = 0; i < entries->len; i++)
+		g_variant_builder_add_value (&builder, g_ptr_array_index (entries, i));
+
+	listing = g_variant_ref_sink (g_variant_new ("(u@a" ENTRY_FORMAT ")",
+						     CACHE_VERSION,
+						     g_variant_builder_end (&builder)));
+
+	filename = get_cache_filename (location);
+	dirname = g_path_get_dirname (filename);
+
+	if (g_mkdir_with_parents (dirname, 0700) == 0)
+	{
+		g_file_set_contents (filename,
+				     g_variant_get_data (listing),
+				     g_variant_get_size (listing),
+				     NULL);
+	}
+
+	g_free (dirname);
+	g_free (filename);
+	g_variant_unref (listing);
+}
+
+void
+gedit_file_browser_listing_cache_remove (GFile *location)
+{
+	gchar *filename;
+
+	filename = get_cache_filename (location);
+	g_unlink (filename);
+	g_free (filename);
+}
+
+/*
+ * gedit_file_browser_listing_cache_entry_new:
+ * @info: a #GFileInfo of a child, with the standard attributes shown by the
+ *   file browser and the ones of %GEDIT_FILE_BROWSER_LISTING_CACHE_ATTRIBUTES.
+ *
+ * Two entries are equal, with g_variant_equal(), if the file did not change.
+ *
+ * Returns: (transfer full): the entry of @info.
+ */
+GVariant *
+gedit_file_browser_listing_cache_entry_new (GFileInfo *info)
+{
+	GIcon *icon = NULL;
+	gchar *icon_string = NULL;
+	gchar const *content_type = NULL;
+	gchar const *display_name = NULL;
+	GDateTime *mtime = NULL;
+	guint8 flags = 0;
+	GVariant *entry;
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN) &&
+	    g_file_info_get_is_hidden (info))
+	{
+		flags |= ENTRY_FLAG_HIDDEN;
+	}
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP) &&
+	    g_file_info_get_is_backup (info))
+	{
+		flags |= ENTRY_FLAG_BACKUP;
+	}
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE))
+		content_type = g_file_info_get_content_type (info);
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME))
+		display_name = g_file_info_get_display_name (info);
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_ICON))
+		icon = g_file_info_get_icon (info);
+
+	if (icon != NULL)
+		icon_string = g_icon_to_string (icon);
+
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_TIME_MODIFIED))
+		mtime = g_file_info_get_modification_date_time (info);
+
+	entry = g_variant_ref_sink (g_variant_new (ENTRY_FORMAT,
+						   g_file_info_get_name (info),
+						   display_name != NULL ? display_name : "",
+						   (guint32) g_file_info_get_file_type (info),
+						   flags,
+						   content_type != NULL ? content_type : "",
+						   icon_string != NULL ? icon_string : "",
+						   mtime != NULL ? g_date_time_to_unix (mtime) * G_USEC_PER_SEC +
+								   g_date_time_get_microsecond (mtime) : (gint64) 0));
+
+	g_free (icon_string);
+	g_clear_pointer (&mtime, g_date_time_unref);
+
+	return entry;
+}
+
+gchar const *
+gedit_file_browser_listing_cache_entry_get_name (GVariant *entry)
+{
+	gchar const *name;
+
+	g_variant_get_child (entry, 0, "&s", &name);
+
+	return name;
+}
+
+/*
+ * gedit_file_browser_listing_cache_entry_to_info:
+ * @entry: an entry.
+ *
+ * Returns: (transfer full): a #GFileInfo with the attributes of @entry.
+ */
+GFileInfo *
+gedit_file_browser_listing_cache_entry_to_info (GVariant *entry)
+{
+	gchar const *name;
+	gchar const *display_name;
+	guint32 type;
+	guint8 flags;
+	gchar const *content_type;
+	gchar const *icon_string;
+	gint64 mtime;
+	GFileInfo *info;
+
+	g_variant_get (entry,
+		       "(&s&suy&s&sx)",
+		       &name,
+		       &display_name,
+		       &type,
+		       &flags,
+		       &content_type,
+		       &icon_string,
+		       &mtime);
+
+	info = g_file_info_new ();
+	g_file_info_set_name (info, name);
+	g_file_info_set_file_type (info, type);
+	g_file_info_set_is_hidden (info, (flags & ENTRY_FLAG_HIDDEN) != 0);
+	g_file_info_set_attribute_boolean (info,
+					   G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP,
+					   (flags & ENTRY_FLAG_BACKUP) != 0);
+
+	if (display_name[0] != '\0')
+		g_file_info_set_display_name (info, display_name);
+
+	if (content_type[0] != '\0')
+		g_file_info_set_content_type (info, content_type);
+
+	if (icon_string[0] != '\0')
+	{
+		GIcon *icon = g_icon_new_for_string (icon_string, NULL);
+
+		if (icon != NULL)
+		{
+			g_file_info_set_icon (info, icon);
+			g_object_unref (icon);
+		}
+	}
+
+	if (mtime != 0)
+		g_file_info_set_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime / G_USEC_PER_SEC);
+
+	return info;
+}
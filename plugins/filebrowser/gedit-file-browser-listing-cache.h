@@ -0,0 +1,33 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_LISTING_CACHE_H
+#define GEDIT_FILE_BROWSER_LISTING_CACHE_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/* The attributes to enumerate, besides the ones shown by the file browser, to
+ * create the entries of the cache.
+ */
+#define GEDIT_FILE_BROWSER_LISTING_CACHE_ATTRIBUTES G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME "," \
+						    G_FILE_ATTRIBUTE_TIME_MODIFIED
+
+GHashTable	*gedit_file_browser_listing_cache_read		(GFile      *location);
+
+void		 gedit_file_browser_listing_cache_write		(GFile      *location,
+								 GPtrArray  *entries);
+
+void		 gedit_file_browser_listing_cache_remove	(GFile      *location);
+
+GVariant	*gedit_file_browser_listing_cache_entry_new	(GFileInfo  *info);
+
+gchar const	*gedit_file_browser_listing_cache_entry_get_name (GVariant  *entry);
+
+GFileInfo	*gedit_file_browser_listing_cache_entry_to_info	(GVariant   *entry);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_LISTING_CACHE_H */
@@ -0,0 +1,202 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "gedit-file-browser-matcher.h"
+#include <string.h>
+
+/* A set of glob patterns, with the syntax of GPatternSpec, compiled once to
+ * match a file name against all of them at the same time.
+ *
+ * The patterns of the file browser are nearly all of the form "*.ext", or
+ * literal names. Those are looked up in hash tables, a suffix pattern with one
+ * lookup per distinct suffix length. The other patterns are translated to
+ * regular expressions and compiled together into one GRegex.
+ */
+
+struct _GeditFileBrowserMatcher
+{
+	/* The literal patterns. */
+	GHashTable *literals;
+
+	/* The suffixes of the patterns of the form "*suffix". */
+	GHashTable *suffixes;
+
+	/* The distinct lengths of the suffixes, in bytes. Element type:
+	 * gsize.
+	 */
+	GArray     *suffix_lengths;
+
+	/* The other patterns. Nullable. */
+	GRegex     *regex;
+
+	/* Whether there is a "*" pattern. */
+	guint       match_all : 1;
+};
+
+static gboolean
+has_wildcard (const gchar *pattern)
+{
+	return strpbrk (pattern, "*?") != NULL;
+}
+
+static void
+add_suffix (GeditFileBrowserMatcher *matcher,
+	    const gchar             *suffix)
+{
+	gsize length = strlen (suffix);
+
+	if (!g_hash_table_add (matcher->suffixes, g_strdup (suffix)))
+		return;
+
+	for (guint i = 0; i < matcher->suffix_lengths->len; i++)
+	{
+		if (g_array_index (matcher->suffix_lengths, gsize, i) == length)
+			return;
+	}
+
+	g_array_append_val (matcher->suffix_lengths, length);
+}
+
+/* Appends the regex of the glob @pattern to @regex. */
+static void
+append_glob_regex (GString     *regex,
+		   const gchar *pattern)
+{
+	const gchar *p;
+
+	for (p = pattern; *p != '\0'; p = g_utf8_next_char (p))
+	{
+		if (*p == '*')
+		{
+			g_string_append (regex, ".*");
+		}
+		else if (*p == '?')
+		{
+			g_string_append_c (regex, '.');
+		}
+		else
+		{
+			gchar *escaped;
+
+			escaped = g_regex_escape_string (p, g_utf8_next_char (p) - p);
+			g_string_append (regex, escaped);
+			g_free (escaped);
+		}
+	}
+}
+
+/*
+ * gedit_file_browser_matcher_new:
+ * @patterns: (array zero-terminated=1): the glob patterns.
+ *
+ * Returns: (transfer full): a new #GeditFileBrowserMatcher.
+ */
+GeditFileBrowserMatcher *
+gedit_file_browser_matcher_new (const gchar * const *patterns)
+{
+	GeditFileBrowserMatcher *matcher;
+	GString *regex = NULL;
+
+	g_return_val_if_fail (patterns != NULL, NULL);
+
+	matcher = g_new0 (GeditFileBrowserMatcher, 1);
+	matcher->literals = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	matcher->suffixes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	matcher->suffix_lengths = g_array_new (FALSE, FALSE, sizeof (gsize));
+
+	for (guint i = 0; patterns[i] != NULL; i++)
+	{
+		const gchar *pattern = patterns[i];
+
+		if (!g_utf8_validate (pattern, -1, NULL))
+			continue;
+
+		if (strcmp (pattern, "*") == 0)
+		{
+			matcher->match_all = TRUE;
+		}
+		else if (!has_wildcard (pattern))
+		{
+			g_hash_table_add (matcher->literals, g_strdup (pattern));
+		}
+		else if (pattern[0] == '*' && !has_wildcard (pattern + 1))
+		{
+			add_suffix (matcher, pattern + 1);
+		}
+		else
+		{
+			if (regex == NULL)
+				regex = g_string_new ("^(?:");
+			else
+				g_string_append_c (regex, '|');
+
+			append_glob_regex (regex, pattern);
+		}
+	}
+
+	if (regex != NULL)
+	{
+		g_string_append (regex, ")$");
+
+		matcher->regex = g_regex_new (regex->str,
+					      G_REGEX_OPTIMIZE | G_REGEX_DOTALL,
+					      G_REGEX_MATCH_DEFAULT,
+					      NULL);
+
+		g_string_free (regex, TRUE);
+	}
+
+	return matcher;
+}
+
+void
+gedit_file_browser_matcher_free (GeditFileBrowserMatcher *matcher)
+{
+	if (matcher != NULL)
+	{
+		g_hash_table_unref (matcher->literals);
+		g_hash_table_unref (matcher->suffixes);
+		g_array_unref (matcher->suffix_lengths);
+		g_clear_pointer (&matcher->regex, g_regex_unref);
+		g_free (matcher);
+	}
+}
+
+/*
+ * gedit_file_browser_matcher_match:
+ * @matcher: a #GeditFileBrowserMatcher.
+ * @name: a UTF-8 file name.
+ *
+ * Returns: whether @name matches one of the patterns of @matcher.
+ */
+gboolean
+gedit_file_browser_matcher_match (GeditFileBrowserMatcher *matcher,
+				  const gchar             *name)
+{
+	gsize length;
+
+	g_return_val_if_fail (matcher != NULL, FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	if (matcher->match_all)
+		return TRUE;
+
+	if (g_hash_table_contains (matcher->literals, name))
+		return TRUE;
+
+	length = strlen (name);
+
+	for (guint i = 0; i < matcher->suffix_lengths->len; i++)
+	{
+		gsize suffix_length = g_array_index (matcher->suffix_lengths, gsize, i);
+
+		if (suffix_length <= length &&
+		    g_hash_table_contains (matcher->suffixes, name + length - suffix_length))
+		{
+			return TRUE;
+		}
+	}
+
+	return matcher->regex != NULL && g_regex_match (matcher->regex, name, 0, NULL);
+}
@@ -0,0 +1,25 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_MATCHER_H
+#define GEDIT_FILE_BROWSER_MATCHER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GeditFileBrowserMatcher GeditFileBrowserMatcher;
+
+GeditFileBrowserMatcher	*gedit_file_browser_matcher_new		(const gchar * const     *patterns);
+
+void			 gedit_file_browser_matcher_free	(GeditFileBrowserMatcher *matcher);
+
+gboolean		 gedit_file_browser_matcher_match	(GeditFileBrowserMatcher *matcher,
+								 const gchar             *name);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GeditFileBrowserMatcher, gedit_file_browser_matcher_free)
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_MATCHER_H */
@@ -19,6 +19,7 @@
 
 #include "gedit-file-browser-messages.h"
 #include "gedit-file-browser-store.h"
+#include "gedit-file-browser-icon-cache.h"
 #include "messages/messages.h"
 
 #include <gedit/gedit-message.h>
@@ -45,8 +46,16 @@ typedef struct
 
 	GeditMessageBus *bus;
 	GeditFileBrowserWidget *widget;
+
+	/* The rows given an id, tracked by their iter: the iters of the
+	   store persist until their row is deleted. Key: id. Value: owned
+	   GtkTreeIter. */
 	GHashTable *row_tracking;
 
+	/* Key: the node of the iter. Value: the id, owned by
+	   @row_tracking. */
+	GHashTable *row_ids;
+
 	GHashTable *filters;
 } WindowData;
 
@@ -69,7 +78,8 @@ window_data_new (GeditWindow            *window,
 	data->row_tracking = g_hash_table_new_full (g_str_hash,
 						    g_str_equal,
 						    (GDestroyNotify)g_free,
-						    (GDestroyNotify)gtk_tree_row_reference_free);
+						    (GDestroyNotify)gtk_tree_iter_free);
+	data->row_ids = g_hash_table_new (NULL, NULL);
 
 	data->filters = g_hash_table_new_full (g_str_hash,
 					       g_str_equal,
@@ -92,6 +102,7 @@ window_data_free (GeditWindow *window)
 {
 	WindowData *data = get_window_data (window);
 
+	g_hash_table_destroy (data->row_ids);
 	g_hash_table_destroy (data->row_tracking);
 	g_hash_table_destroy (data->filters);
 
@@ -137,18 +148,35 @@ filter_data_free (FilterData *data)
 	g_slice_free (FilterData, data);
 }
 
-static GtkTreePath *
+static gboolean
 track_row_lookup (WindowData  *data,
-		  const gchar *id)
+		  const gchar *id,
+		  GtkTreeIter *iter)
 {
-	GtkTreeRowReference *ref;
+	GtkTreeIter *tracked;
+
+	tracked = g_hash_table_lookup (data->row_tracking, id);
+
+	if (tracked == NULL)
+		return FALSE;
 
-	ref = (GtkTreeRowReference *)g_hash_table_lookup (data->row_tracking, id);
+	*iter = *tracked;
+	return TRUE;
+}
+
+static void
+untrack_row (WindowData  *data,
+	     GtkTreeIter *iter)
+{
+	const gchar *id;
 
-	if (!ref)
-		return NULL;
+	id = g_hash_table_lookup (data->row_ids, iter->user_data);
 
-	return gtk_tree_row_reference_get_path (ref);
+	if (id != NULL)
+	{
+		g_hash_table_remove (data->row_ids, iter->user_data);
+		g_hash_table_remove (data->row_tracking, id);
+	}
 }
 
 static void
@@ -229,55 +257,32 @@ message_set_emblem_cb (GeditMessageBus *bus,
 {
 	gchar *id = NULL;
 	gchar *emblem = NULL;
-	GtkTreePath *path;
+	GtkTreeIter iter;
 	GeditFileBrowserStore *store;
 
 	g_object_get (message, "id", &id, "emblem", &emblem, NULL);
 
-	if (!id)
+	if (id != NULL && track_row_lookup (data, id, &iter))
 	{
-		g_free (id);
-		g_free (emblem);
-
-		return;
-	}
-
-	path = track_row_lookup (data, id);
-
-	if (path != NULL)
-	{
-		GtkTreeIter iter;
 		GValue value = G_VALUE_INIT;
 		GdkPixbuf *pixbuf = NULL;
 
 		if (emblem != NULL)
 		{
-			pixbuf = gtk_icon_theme_load_icon (gtk_icon_theme_get_default (),
-			                                   emblem,
-			                                   10,
-			                                   GTK_ICON_LOOKUP_FORCE_SIZE,
-			                                   NULL);
+			pixbuf = gedit_file_browser_icon_cache_lookup_emblem (emblem, 10);
 		}
 
 		store = gedit_file_browser_widget_get_browser_store (data->widget);
 
-		if (gtk_tree_model_get_iter (GTK_TREE_MODEL (store), &iter, path))
-		{
-			g_value_init (&value, GDK_TYPE_PIXBUF);
-			g_value_set_object (&value, pixbuf);
+		g_value_init (&value, GDK_TYPE_PIXBUF);
+		g_value_take_object (&value, pixbuf);
 
-			gedit_file_browser_store_set_value (store,
-			                                    &iter,
-			                                    GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM,
-			                                    &value);
+		gedit_file_browser_store_set_value (store,
+		                                    &iter,
+		                                    GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM,
+		                                    &value);
 
-			g_value_unset (&value);
-		}
-
-		if (pixbuf)
-		{
-			g_object_unref (pixbuf);
-		}
+		g_value_unset (&value);
 	}
 
 	g_free (id);
@@ -291,58 +296,127 @@ message_set_markup_cb (GeditMessageBus *bus,
 {
 	gchar *id = NULL;
 	gchar *markup = NULL;
-	GtkTreePath *path;
+	GtkTreeIter iter;
 	GeditFileBrowserStore *store;
 
 	g_object_get (message, "id", &id, "markup", &markup, NULL);
 
-	if (!id)
+	if (id != NULL && track_row_lookup (data, id, &iter))
 	{
-		g_free (id);
-		g_free (markup);
+		GValue value = G_VALUE_INIT;
 
-		return;
+		store = gedit_file_browser_widget_get_browser_store (data->widget);
+
+		/* NULL resets the markup to the name */
+		g_value_init (&value, G_TYPE_STRING);
+		g_value_set_string (&value, markup);
+
+		gedit_file_browser_store_set_value (store,
+		                                    &iter,
+		                                    GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP,
+		                                    &value);
+
+		g_value_unset (&value);
 	}
 
-	path = track_row_lookup (data, id);
+	g_free (id);
+	g_free (markup);
+}
 
-	if (path != NULL)
-	{
-		GtkTreeIter iter;
-		GValue value = G_VALUE_INIT;
+/* Sets the values of the tracked rows of @ids at once. The values are
+ * taken from @values, an empty string is passed as NULL.
+ */
+static void
+set_tracked_values (WindowData  *data,
+		    gint         column,
+		    gchar      **ids,
+		    gchar      **values,
+		    GType        value_type)
+{
+	GeditFileBrowserStore *store;
+	GtkTreeIter *iters;
+	GValue *gvalues;
+	guint n_ids;
+	guint n_set = 0;
 
-		store = gedit_file_browser_widget_get_browser_store (data->widget);
+	if (ids == NULL || values == NULL)
+		return;
 
-		if (gtk_tree_model_get_iter (GTK_TREE_MODEL (store), &iter, path))
-		{
-			if (markup == NULL)
-			{
-				gchar *name;
+	n_ids = MIN (g_strv_length (ids), g_strv_length (values));
 
-				gtk_tree_model_get (GTK_TREE_MODEL (store), &iter,
-				                    GEDIT_FILE_BROWSER_STORE_COLUMN_NAME, &name,
-				                    -1);
-				markup = g_markup_escape_text (name, -1);
+	iters = g_new (GtkTreeIter, n_ids);
+	gvalues = g_new0 (GValue, n_ids);
 
-				g_free (name);
-			}
+	for (guint i = 0; i < n_ids; i++)
+	{
+		const gchar *value = values[i][0] != '\0' ? values[i] : NULL;
 
-			g_value_init (&value, G_TYPE_STRING);
-			g_value_set_string (&value, markup);
+		if (!track_row_lookup (data, ids[i], &iters[n_set]))
+			continue;
 
-			gedit_file_browser_store_set_value (store,
-			                                    &iter,
-			                                    GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP,
-			                                    &value);
+		g_value_init (&gvalues[n_set], value_type);
 
-			g_value_unset (&value);
+		if (value_type == GDK_TYPE_PIXBUF)
+		{
+			if (value != NULL)
+				g_value_take_object (&gvalues[n_set], gedit_file_browser_icon_cache_lookup_emblem (value, 10));
+		}
+		else
+		{
+			g_value_set_string (&gvalues[n_set], value);
 		}
 
-		gtk_tree_path_free (path);
+		n_set++;
 	}
 
-	g_free (id);
-	g_free (markup);
+	store = gedit_file_browser_widget_get_browser_store (data->widget);
+	gedit_file_browser_store_set_values (store, column, iters, gvalues, n_set);
+
+	for (guint i = 0; i < n_set; i++)
+		g_value_unset (&gvalues[i]);
+
+	g_free (gvalues);
+	g_free (iters);
+}
+
+static void
+message_set_emblems_cb (GeditMessageBus *bus,
+			GeditMessage    *message,
+			WindowData      *data)
+{
+	gchar **ids = NULL;
+	gchar **emblems = NULL;
+
+	g_object_get (message, "ids", &ids, "emblems", &emblems, NULL);
+
+	set_tracked_values (data,
+			    GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM,
+			    ids,
+			    emblems,
+			    GDK_TYPE_PIXBUF);
+
+	g_strfreev (ids);
+	g_strfreev (emblems);
+}
+
+static void
+message_set_markups_cb (GeditMessageBus *bus,
+			GeditMessage    *message,
+			WindowData      *data)
+{
+	gchar **ids = NULL;
+	gchar **markups = NULL;
+
+	g_object_get (message, "ids", &ids, "markups", &markups, NULL);
+
+	set_tracked_values (data,
+			    GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP,
+			    ids,
+			    markups,
+			    G_TYPE_STRING);
+
+	g_strfreev (ids);
+	g_strfreev (markups);
 }
 
 static gchar *
@@ -359,23 +433,38 @@ item_id (const gchar *path,
 	return id;
 }
 
+/* A row keeps its id as long as it is in the store. */
 static gchar *
 track_row (WindowData            *data,
 	   GeditFileBrowserStore *store,
+	   GtkTreeIter           *iter,
 	   GtkTreePath           *path,
 	   GFile		 *location)
 {
-	GtkTreeRowReference *ref;
+	const gchar *tracked_id;
+	GtkTreeIter *tracked;
 	gchar *id;
+	gchar *key;
 	gchar *pathstr;
 
+	tracked_id = g_hash_table_lookup (data->row_ids, iter->user_data);
+
+	if (tracked_id != NULL)
+		return g_strdup (tracked_id);
+
 	pathstr = gtk_tree_path_to_string (path);
 	id = item_id (pathstr, location);
+	g_free (pathstr);
 
-	ref = gtk_tree_row_reference_new (GTK_TREE_MODEL (store), path);
-	g_hash_table_insert (data->row_tracking, g_strdup (id), ref);
+	/* The id of a row deleted without being untracked */
+	tracked = g_hash_table_lookup (data->row_tracking, id);
 
-	g_free (pathstr);
+	if (tracked != NULL)
+		untrack_row (data, tracked);
+
+	key = g_strdup (id);
+	g_hash_table_replace (data->row_tracking, key, gtk_tree_iter_copy (iter));
+	g_hash_table_insert (data->row_ids, iter->user_data, key);
 
 	return id;
 }
@@ -404,7 +493,7 @@ set_item_message (WindowData   *data,
 
 		if (path && gtk_tree_path_get_depth (path) != 0)
 		{
-			track_id = track_row (data, store, path, location);
+			track_id = track_row (data, store, iter, path, location);
 		}
 		else
 		{
@@ -690,6 +779,16 @@ register_methods (GeditWindow            *window,
 	                            MESSAGE_OBJECT_PATH,
 	                            "set_markup");
 
+	gedit_message_bus_register (bus,
+	                            GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS,
+	                            MESSAGE_OBJECT_PATH,
+	                            "set_emblems");
+
+	gedit_message_bus_register (bus,
+	                            GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS,
+	                            MESSAGE_OBJECT_PATH,
+	                            "set_markups");
+
 	gedit_message_bus_register (bus,
 	                            GEDIT_TYPE_FILE_BROWSER_MESSAGE_ADD_FILTER,
 	                            MESSAGE_OBJECT_PATH,
@@ -754,6 +853,8 @@ register_methods (GeditWindow            *window,
 	BUS_CONNECT (bus, set_root, data);
 	BUS_CONNECT (bus, set_emblem, data);
 	BUS_CONNECT (bus, set_markup, data);
+	BUS_CONNECT (bus, set_emblems, data);
+	BUS_CONNECT (bus, set_markups, data);
 	BUS_CONNECT (bus, add_filter, window);
 	BUS_CONNECT (bus, remove_filter, data);
 	BUS_CONNECT (bus, extend_context_menu, window);
@@ -799,6 +900,7 @@ store_before_row_deleted (GeditFileBrowserStore *store,
                           GtkTreePath           *path,
                           MessageCacheData      *data)
 {
+	WindowData *wdata = get_window_data (data->window);
 	GtkTreeIter iter;
 	guint flags = 0;
 
@@ -811,19 +913,11 @@ store_before_row_deleted (GeditFileBrowserStore *store,
 
 	if (!FILE_IS_DUMMY (flags) && !FILE_IS_FILTERED (flags))
 	{
-		WindowData *wdata = get_window_data (data->window);
-		gchar *id;
-
 		set_item_message (wdata, &iter, path, data->message);
-
-		/* Must get the ID before the plugin can modify it */
-		g_object_get (data->message, "id", &id, NULL);
-
 		gedit_message_bus_send_message_sync (wdata->bus, data->message);
-
-		g_hash_table_remove (wdata->row_tracking, id);
-		g_free (id);
 	}
+
+	untrack_row (wdata, &iter);
 }
 
 static void
@@ -1057,6 +1151,8 @@ gedit_file_browser_messages_unregister (GeditWindow *window)
 	BUS_DISCONNECT (bus, set_root, data);
 	BUS_DISCONNECT (bus, set_emblem, data);
 	BUS_DISCONNECT (bus, set_markup, data);
+	BUS_DISCONNECT (bus, set_emblems, data);
+	BUS_DISCONNECT (bus, set_markups, data);
 	BUS_DISCONNECT (bus, add_filter, window);
 	BUS_DISCONNECT (bus, remove_filter, data);
 
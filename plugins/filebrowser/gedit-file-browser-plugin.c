@@ -24,6 +24,7 @@
 #include <glib/gi18n-lib.h>
 #include <gmodule.h>
 #include <gedit/gedit-app.h>
+#include <gedit/gedit-app-activatable.h>
 #include <gedit/gedit-commands.h>
 #include <gedit/gedit-debug.h>
 #include <gedit/gedit-window.h>
@@ -37,6 +38,10 @@
 #include "gedit-file-browser-error.h"
 #include "gedit-file-browser-widget.h"
 #include "gedit-file-browser-messages.h"
+#include "gedit-file-browser-index.h"
+#include "gedit-file-browser-quick-open.h"
+#include "gedit-file-browser-search.h"
+#include "gedit-file-browser-search-panel.h"
 
 #define FILEBROWSER_BASE_SETTINGS	"org.gnome.gedit.plugins.filebrowser"
 #define FILEBROWSER_TREE_VIEW		"tree-view"
@@ -70,14 +75,26 @@ struct _GeditFileBrowserPluginPrivate
 	guint			click_policy_handle;
 
 	TeplPanelItem          *side_panel_item;
+
+	GtkWidget              *search_panel;
+	TeplPanelItem          *bottom_panel_item;
+
+	/* Created by the first quick open, for the virtual root */
+	GeditFileBrowserIndex  *index;
+
+	GeditApp               *app;
+	GeditMenuExtension     *menu_ext;
+	GeditMenuExtension     *search_menu_ext;
 };
 
 enum
 {
 	PROP_0,
-	PROP_WINDOW
+	PROP_WINDOW,
+	PROP_APP
 };
 
+static void gedit_app_activatable_iface_init	(GeditAppActivatableInterface    *iface);
 static void gedit_window_activatable_iface_init	(GeditWindowActivatableInterface *iface);
 
 static void on_location_activated_cb     (GeditFileBrowserWidget        *widget,
@@ -113,6 +130,8 @@ G_DEFINE_DYNAMIC_TYPE_EXTENDED (GeditFileBrowserPlugin,
 				G_TYPE_OBJECT,
 				0,
 				G_ADD_PRIVATE_DYNAMIC (GeditFileBrowserPlugin)
+				G_IMPLEMENT_INTERFACE_DYNAMIC (GEDIT_TYPE_APP_ACTIVATABLE,
+							       gedit_app_activatable_iface_init)
 				G_IMPLEMENT_INTERFACE_DYNAMIC (GEDIT_TYPE_WINDOW_ACTIVATABLE,
 							       gedit_window_activatable_iface_init)	\
 													\
@@ -121,6 +140,10 @@ G_DEFINE_DYNAMIC_TYPE_EXTENDED (GeditFileBrowserPlugin,
 				_gedit_file_browser_store_register_type		(type_module);		\
 				_gedit_file_browser_view_register_type		(type_module);		\
 				_gedit_file_browser_widget_register_type	(type_module);		\
+				_gedit_file_browser_index_register_type		(type_module);		\
+				_gedit_file_browser_quick_open_register_type	(type_module);		\
+				_gedit_file_browser_search_register_type	(type_module);		\
+				_gedit_file_browser_search_panel_register_type	(type_module);		\
 )
 
 static GSettings *
@@ -161,6 +184,10 @@ gedit_file_browser_plugin_dispose (GObject *object)
 	g_clear_object (&plugin->priv->nautilus_settings);
 	g_clear_object (&plugin->priv->terminal_settings);
 	g_clear_object (&plugin->priv->window);
+	g_clear_object (&plugin->priv->index);
+	g_clear_object (&plugin->priv->menu_ext);
+	g_clear_object (&plugin->priv->search_menu_ext);
+	g_clear_object (&plugin->priv->app);
 
 	G_OBJECT_CLASS (gedit_file_browser_plugin_parent_class)->dispose (object);
 }
@@ -179,6 +206,10 @@ gedit_file_browser_plugin_set_property (GObject      *object,
 			plugin->priv->window = GEDIT_WINDOW (g_value_dup_object (value));
 			break;
 
+		case PROP_APP:
+			plugin->priv->app = GEDIT_APP (g_value_dup_object (value));
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -199,6 +230,10 @@ gedit_file_browser_plugin_get_property (GObject    *object,
 			g_value_set_object (value, plugin->priv->window);
 			break;
 
+		case PROP_APP:
+			g_value_set_object (value, plugin->priv->app);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -430,6 +465,77 @@ open_in_terminal (GeditFileBrowserWidget *widget,
 	}
 }
 
+static void
+quick_open_activate_cb (GAction                *action,
+			GVariant               *parameter,
+			GeditFileBrowserPlugin *plugin)
+{
+	GeditFileBrowserPluginPrivate *priv = plugin->priv;
+	GeditFileBrowserStore *store;
+	GFile *virtual_root;
+	GtkWidget *quick_open;
+
+	store = gedit_file_browser_widget_get_browser_store (priv->tree_widget);
+	virtual_root = gedit_file_browser_store_get_virtual_root (store);
+
+	if (virtual_root == NULL)
+		return;
+
+	if (priv->index == NULL)
+	{
+		gchar **binary_patterns;
+
+		g_object_get (store, "binary-patterns", &binary_patterns, NULL);
+
+		priv->index = gedit_file_browser_index_new (virtual_root,
+							    gedit_file_browser_store_get_filter_mode (store),
+							    (const gchar * const *) binary_patterns);
+
+		g_strfreev (binary_patterns);
+	}
+
+	quick_open = gedit_file_browser_quick_open_new (priv->window, priv->index);
+	gtk_widget_show (quick_open);
+
+	g_object_unref (virtual_root);
+}
+
+static void
+find_in_files_activate_cb (GAction                *action,
+			   GVariant               *parameter,
+			   GeditFileBrowserPlugin *plugin)
+{
+	GeditFileBrowserPluginPrivate *priv = plugin->priv;
+
+	tepl_panel_set_active (gedit_window_get_bottom_panel (priv->window),
+			       priv->bottom_panel_item);
+
+	g_action_group_change_action_state (G_ACTION_GROUP (priv->window),
+					    "bottom-panel",
+					    g_variant_new_boolean (TRUE));
+
+	gedit_file_browser_search_panel_focus (GEDIT_FILE_BROWSER_SEARCH_PANEL (priv->search_panel));
+}
+
+/* The index is created again for the next quick open */
+static void
+on_index_filters_changed_cb (GeditFileBrowserStore  *store,
+			     GParamSpec             *pspec,
+			     GeditFileBrowserPlugin *plugin)
+{
+	g_clear_object (&plugin->priv->index);
+}
+
+static void
+on_files_changed_cb (GeditFileBrowserStore  *store,
+		     GPtrArray              *changed,
+		     GPtrArray              *removed,
+		     GeditFileBrowserPlugin *plugin)
+{
+	if (plugin->priv->index != NULL)
+		gedit_file_browser_index_update (plugin->priv->index, changed, removed);
+}
+
 static void
 gedit_file_browser_plugin_update_state (GeditWindowActivatable *activatable)
 {
@@ -456,7 +562,9 @@ gedit_file_browser_plugin_activate (GeditWindowActivatable *activatable)
 	GeditFileBrowserPlugin *plugin = GEDIT_FILE_BROWSER_PLUGIN (activatable);
 	GeditFileBrowserPluginPrivate *priv;
 	TeplPanel *side_panel;
+	TeplPanel *bottom_panel;
 	GeditFileBrowserStore *store;
+	GSimpleAction *action;
 
 	priv = plugin->priv;
 
@@ -538,6 +646,50 @@ gedit_file_browser_plugin_activate (GeditWindowActivatable *activatable)
 			  G_CALLBACK (on_rename_cb),
 			  priv->window);
 
+	g_signal_connect (store,
+			  "notify::filter-mode",
+			  G_CALLBACK (on_index_filters_changed_cb),
+			  plugin);
+
+	g_signal_connect (store,
+			  "notify::binary-patterns",
+			  G_CALLBACK (on_index_filters_changed_cb),
+			  plugin);
+
+	g_signal_connect (store,
+			  "files-changed",
+			  G_CALLBACK (on_files_changed_cb),
+			  plugin);
+
+	action = g_simple_action_new ("quick-open", NULL);
+	g_signal_connect (action,
+			  "activate",
+			  G_CALLBACK (quick_open_activate_cb),
+			  plugin);
+	g_action_map_add_action (G_ACTION_MAP (priv->window), G_ACTION (action));
+	g_object_unref (action);
+
+	priv->search_panel = gedit_file_browser_search_panel_new (priv->window, store);
+	gtk_widget_show_all (priv->search_panel);
+
+	g_clear_object (&priv->bottom_panel_item);
+	priv->bottom_panel_item = tepl_panel_item_new (priv->search_panel,
+						       "GeditFileBrowserSearchPanel",
+						       _("Find in Files"),
+						       NULL,
+						       0);
+
+	bottom_panel = gedit_window_get_bottom_panel (priv->window);
+	tepl_panel_add (bottom_panel, priv->bottom_panel_item);
+
+	action = g_simple_action_new ("find-in-files", NULL);
+	g_signal_connect (action,
+			  "activate",
+			  G_CALLBACK (find_in_files_activate_cb),
+			  plugin);
+	g_action_map_add_action (G_ACTION_MAP (priv->window), G_ACTION (action));
+	g_object_unref (action);
+
 	g_signal_connect (priv->window,
 	                  "tab-added",
 	                  G_CALLBACK (on_tab_added_cb),
@@ -555,10 +707,15 @@ gedit_file_browser_plugin_deactivate (GeditWindowActivatable *activatable)
 	GeditFileBrowserPlugin *plugin = GEDIT_FILE_BROWSER_PLUGIN (activatable);
 	GeditFileBrowserPluginPrivate *priv = plugin->priv;
 	TeplPanel *side_panel;
+	TeplPanel *bottom_panel;
 
 	/* Unregister messages from the bus */
 	gedit_file_browser_messages_unregister (priv->window);
 
+	g_action_map_remove_action (G_ACTION_MAP (priv->window), "quick-open");
+	g_action_map_remove_action (G_ACTION_MAP (priv->window), "find-in-files");
+	g_clear_object (&priv->index);
+
 	/* Disconnect signals */
 	g_signal_handlers_disconnect_by_func (priv->window,
 	                                      G_CALLBACK (on_tab_added_cb),
@@ -573,6 +730,11 @@ gedit_file_browser_plugin_deactivate (GeditWindowActivatable *activatable)
 	side_panel = gedit_window_get_side_panel (priv->window);
 	tepl_panel_remove (side_panel, priv->side_panel_item);
 	g_clear_object (&priv->side_panel_item);
+
+	bottom_panel = gedit_window_get_bottom_panel (priv->window);
+	tepl_panel_remove (bottom_panel, priv->bottom_panel_item);
+	g_clear_object (&priv->bottom_panel_item);
+	priv->search_panel = NULL;
 }
 
 static void
@@ -585,6 +747,49 @@ gedit_file_browser_plugin_class_init (GeditFileBrowserPluginClass *klass)
 	object_class->get_property = gedit_file_browser_plugin_get_property;
 
 	g_object_class_override_property (object_class, PROP_WINDOW, "window");
+	g_object_class_override_property (object_class, PROP_APP, "app");
+}
+
+static void
+gedit_file_browser_plugin_app_activate (GeditAppActivatable *activatable)
+{
+	GeditFileBrowserPluginPrivate *priv = GEDIT_FILE_BROWSER_PLUGIN (activatable)->priv;
+	const gchar *quick_open_accels[] = { "<Primary><Shift>O", NULL };
+	const gchar *find_in_files_accels[] = { "<Primary><Shift>F", NULL };
+	GMenuItem *item;
+
+	gtk_application_set_accels_for_action (GTK_APPLICATION (priv->app), "win.quick-open", quick_open_accels);
+	gtk_application_set_accels_for_action (GTK_APPLICATION (priv->app), "win.find-in-files", find_in_files_accels);
+
+	priv->menu_ext = gedit_app_activatable_extend_menu (activatable, "file-section");
+	item = g_menu_item_new (_("_Quick Open…"), "win.quick-open");
+	gedit_menu_extension_append_menu_item (priv->menu_ext, item);
+	g_object_unref (item);
+
+	priv->search_menu_ext = gedit_app_activatable_extend_menu (activatable, "search-section");
+	item = g_menu_item_new (_("Find in _Files…"), "win.find-in-files");
+	gedit_menu_extension_append_menu_item (priv->search_menu_ext, item);
+	g_object_unref (item);
+}
+
+static void
+gedit_file_browser_plugin_app_deactivate (GeditAppActivatable *activatable)
+{
+	GeditFileBrowserPluginPrivate *priv = GEDIT_FILE_BROWSER_PLUGIN (activatable)->priv;
+	const gchar *null_accels[] = { NULL };
+
+	gtk_application_set_accels_for_action (GTK_APPLICATION (priv->app), "win.quick-open", null_accels);
+	gtk_application_set_accels_for_action (GTK_APPLICATION (priv->app), "win.find-in-files", null_accels);
+
+	g_clear_object (&priv->menu_ext);
+	g_clear_object (&priv->search_menu_ext);
+}
+
+static void
+gedit_app_activatable_iface_init (GeditAppActivatableInterface *iface)
+{
+	iface->activate = gedit_file_browser_plugin_app_activate;
+	iface->deactivate = gedit_file_browser_plugin_app_deactivate;
 }
 
 static void
@@ -752,6 +957,9 @@ on_virtual_root_changed_cb (GeditFileBrowserStore  *store,
 	GFile *virtual_root;
 	gchar *uri_root = NULL;
 
+	/* The index is created again for the next quick open */
+	g_clear_object (&priv->index);
+
 	root = gedit_file_browser_store_get_root (store);
 
 	if (!root)
@@ -938,6 +1146,9 @@ peas_register_types (PeasObjectModule *module)
 {
 	gedit_file_browser_plugin_register_type (G_TYPE_MODULE (module));
 
+	peas_object_module_register_extension_type (module,
+						    GEDIT_TYPE_APP_ACTIVATABLE,
+						    GEDIT_TYPE_FILE_BROWSER_PLUGIN);
 	peas_object_module_register_extension_type (module,
 						    GEDIT_TYPE_WINDOW_ACTIVATABLE,
 						    GEDIT_TYPE_FILE_BROWSER_PLUGIN);
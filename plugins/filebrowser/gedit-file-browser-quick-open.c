@@ -0,0 +1,435 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <glib/gi18n-lib.h>
+#include <gedit/gedit-commands.h>
+
+#include "gedit-file-browser-quick-open.h"
+
+/* The quick open window: a search entry over the paths of a
+ * #GeditFileBrowserIndex, the selected file is opened in the window.
+ */
+
+#define MAX_RESULTS 100
+
+/* While the index is enumerated, refresh the results at most this often */
+#define REFRESH_MSEC 200
+
+enum
+{
+	COLUMN_MARKUP,
+	COLUMN_PATH,
+	N_COLUMNS
+};
+
+struct _GeditFileBrowserQuickOpen
+{
+	GtkWindow parent_instance;
+
+	GeditWindow *window;
+	GeditFileBrowserIndex *index;
+
+	GtkWidget *entry;
+	GtkWidget *tree_view;
+	GtkWidget *status;
+	GtkListStore *results;
+
+	guint refresh_id;
+};
+
+G_DEFINE_DYNAMIC_TYPE (GeditFileBrowserQuickOpen, gedit_file_browser_quick_open, GTK_TYPE_WINDOW)
+
+static void
+update_status (GeditFileBrowserQuickOpen *quick_open)
+{
+	gchar *text;
+
+	if (gedit_file_browser_index_is_loading (quick_open->index))
+	{
+		text = g_strdup_printf (_("Indexing… %u files"),
+					gedit_file_browser_index_get_n_files (quick_open->index));
+	}
+	else
+	{
+		text = g_strdup_printf (ngettext ("%u file", "%u files",
+						  gedit_file_browser_index_get_n_files (quick_open->index)),
+					gedit_file_browser_index_get_n_files (quick_open->index));
+	}
+
+	gtk_label_set_text (GTK_LABEL (quick_open->status), text);
+	g_free (text);
+}
+
+static void
+refresh_results (GeditFileBrowserQuickOpen *quick_open)
+{
+	GPtrArray *paths;
+	GtkTreeIter iter;
+
+	paths = gedit_file_browser_index_query (quick_open->index,
+						gtk_entry_get_text (GTK_ENTRY (quick_open->entry)),
+						MAX_RESULTS);
+
+	gtk_list_store_clear (quick_open->results);
+
+	for (guint i = 0; i < paths->len; i++)
+	{
+		const gchar *path = g_ptr_array_index (paths, i);
+		gchar *display;
+		gchar *basename;
+		gchar *dirname;
+		gchar *markup;
+
+		display = g_filename_display_name (path);
+		basename = g_path_get_basename (display);
+		dirname = g_path_get_dirname (display);
+
+		if (g_strcmp0 (dirname, ".") == 0)
+			markup = g_markup_printf_escaped ("<b>%s</b>", basename);
+		else
+			markup = g_markup_printf_escaped ("<b>%s</b>  <small>%s</small>", basename, dirname);
+
+		gtk_list_store_insert_with_values (quick_open->results, &iter, -1,
+						   COLUMN_MARKUP, markup,
+						   COLUMN_PATH, path,
+						   -1);
+
+		g_free (display);
+		g_free (basename);
+		g_free (dirname);
+		g_free (markup);
+	}
+
+	g_ptr_array_unref (paths);
+
+	if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (quick_open->results), &iter))
+	{
+		GtkTreeSelection *selection;
+
+		selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (quick_open->tree_view));
+		gtk_tree_selection_select_iter (selection, &iter);
+	}
+
+	update_status (quick_open);
+}
+
+static void
+open_path (GeditFileBrowserQuickOpen *quick_open,
+	   const gchar               *path)
+{
+	GFile *location;
+	gchar **components;
+
+	location = g_object_ref (gedit_file_browser_index_get_root (quick_open->index));
+	components = g_strsplit (path, "/", -1);
+
+	for (guint i = 0; components[i] != NULL; i++)
+	{
+		GFile *child = g_file_get_child (location, components[i]);
+
+		g_object_unref (location);
+		location = child;
+	}
+
+	gedit_commands_load_location (quick_open->window, location, NULL, 0, 0);
+
+	g_strfreev (components);
+	g_object_unref (location);
+
+	gtk_widget_destroy (GTK_WIDGET (quick_open));
+}
+
+static void
+open_selected (GeditFileBrowserQuickOpen *quick_open)
+{
+	GtkTreeSelection *selection;
+	GtkTreeModel *model;
+	GtkTreeIter iter;
+	gchar *path;
+
+	selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (quick_open->tree_view));
+
+	if (!gtk_tree_selection_get_selected (selection, &model, &iter))
+		return;
+
+	gtk_tree_model_get (model, &iter, COLUMN_PATH, &path, -1);
+	open_path (quick_open, path);
+	g_free (path);
+}
+
+static void
+move_selection (GeditFileBrowserQuickOpen *quick_open,
+		gint                       delta)
+{
+	GtkTreeSelection *selection;
+	GtkTreeModel *model;
+	GtkTreeIter iter;
+	GtkTreePath *path;
+	gint n_rows;
+	gint row = 0;
+
+	model = GTK_TREE_MODEL (quick_open->results);
+	n_rows = gtk_tree_model_iter_n_children (model, NULL);
+
+	if (n_rows == 0)
+		return;
+
+	selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (quick_open->tree_view));
+
+	if (gtk_tree_selection_get_selected (selection, NULL, &iter))
+	{
+		path = gtk_tree_model_get_path (model, &iter);
+		row = gtk_tree_path_get_indices (path)[0] + delta;
+		gtk_tree_path_free (path);
+	}
+
+	path = gtk_tree_path_new_from_indices (CLAMP (row, 0, n_rows - 1), -1);
+	gtk_tree_selection_select_path (selection, path);
+	gtk_tree_view_scroll_to_cell (GTK_TREE_VIEW (quick_open->tree_view), path, NULL, FALSE, 0, 0);
+	gtk_tree_path_free (path);
+}
+
+static void
+on_search_changed (GtkSearchEntry            *entry,
+		   GeditFileBrowserQuickOpen *quick_open)
+{
+	refresh_results (quick_open);
+}
+
+static void
+on_entry_activate (GtkEntry                  *entry,
+		   GeditFileBrowserQuickOpen *quick_open)
+{
+	open_selected (quick_open);
+}
+
+static void
+on_stop_search (GtkSearchEntry            *entry,
+		GeditFileBrowserQuickOpen *quick_open)
+{
+	gtk_widget_destroy (GTK_WIDGET (quick_open));
+}
+
+static gboolean
+on_entry_key_press (GtkWidget                 *entry,
+		    GdkEventKey               *event,
+		    GeditFileBrowserQuickOpen *quick_open)
+{
+	switch (event->keyval)
+	{
+		case GDK_KEY_Up:
+		case GDK_KEY_KP_Up:
+			move_selection (quick_open, -1);
+			return GDK_EVENT_STOP;
+
+		case GDK_KEY_Down:
+		case GDK_KEY_KP_Down:
+			move_selection (quick_open, 1);
+			return GDK_EVENT_STOP;
+
+		case GDK_KEY_Page_Up:
+		case GDK_KEY_KP_Page_Up:
+			move_selection (quick_open, -10);
+			return GDK_EVENT_STOP;
+
+		case GDK_KEY_Page_Down:
+		case GDK_KEY_KP_Page_Down:
+			move_selection (quick_open, 10);
+			return GDK_EVENT_STOP;
+
+		default:
+			return GDK_EVENT_PROPAGATE;
+	}
+}
+
+static void
+on_row_activated (GtkTreeView               *tree_view,
+		  GtkTreePath               *path,
+		  GtkTreeViewColumn         *column,
+		  GeditFileBrowserQuickOpen *quick_open)
+{
+	open_selected (quick_open);
+}
+
+static gboolean
+refresh_timeout_cb (GeditFileBrowserQuickOpen *quick_open)
+{
+	quick_open->refresh_id = 0;
+	refresh_results (quick_open);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+on_index_changed (GeditFileBrowserIndex     *index,
+		  GeditFileBrowserQuickOpen *quick_open)
+{
+	if (quick_open->refresh_id == 0)
+	{
+		quick_open->refresh_id = g_timeout_add (REFRESH_MSEC,
+							(GSourceFunc) refresh_timeout_cb,
+							quick_open);
+	}
+}
+
+static void
+on_index_loading_changed (GeditFileBrowserIndex     *index,
+			  GParamSpec                *pspec,
+			  GeditFileBrowserQuickOpen *quick_open)
+{
+	update_status (quick_open);
+}
+
+static void
+gedit_file_browser_quick_open_dispose (GObject *object)
+{
+	GeditFileBrowserQuickOpen *quick_open = GEDIT_FILE_BROWSER_QUICK_OPEN (object);
+
+	g_clear_handle_id (&quick_open->refresh_id, g_source_remove);
+
+	if (quick_open->index != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (quick_open->index, quick_open);
+		g_clear_object (&quick_open->index);
+	}
+
+	g_clear_object (&quick_open->window);
+	g_clear_object (&quick_open->results);
+
+	G_OBJECT_CLASS (gedit_file_browser_quick_open_parent_class)->dispose (object);
+}
+
+static void
+gedit_file_browser_quick_open_class_init (GeditFileBrowserQuickOpenClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = gedit_file_browser_quick_open_dispose;
+}
+
+static void
+gedit_file_browser_quick_open_class_finalize (GeditFileBrowserQuickOpenClass *klass)
+{
+}
+
+static void
+gedit_file_browser_quick_open_init (GeditFileBrowserQuickOpen *quick_open)
+{
+	GtkWidget *box;
+	GtkWidget *scrolled_window;
+	GtkCellRenderer *renderer;
+	GtkTreeViewColumn *column;
+
+	gtk_window_set_title (GTK_WINDOW (quick_open), _("Quick Open"));
+	gtk_window_set_default_size (GTK_WINDOW (quick_open), 600, 400);
+	gtk_window_set_modal (GTK_WINDOW (quick_open), TRUE);
+	gtk_window_set_destroy_with_parent (GTK_WINDOW (quick_open), TRUE);
+	gtk_window_set_type_hint (GTK_WINDOW (quick_open), GDK_WINDOW_TYPE_HINT_DIALOG);
+
+	box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+	gtk_container_set_border_width (GTK_CONTAINER (box), 6);
+	gtk_container_add (GTK_CONTAINER (quick_open), box);
+
+	quick_open->entry = gtk_search_entry_new ();
+	gtk_entry_set_placeholder_text (GTK_ENTRY (quick_open->entry), _("Search files by name"));
+	gtk_container_add (GTK_CONTAINER (box), quick_open->entry);
+
+	quick_open->results = gtk_list_store_new (N_COLUMNS, G_TYPE_STRING, G_TYPE_STRING);
+
+	quick_open->tree_view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (quick_open->results));
+	gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (quick_open->tree_view), FALSE);
+	gtk_tree_view_set_enable_search (GTK_TREE_VIEW (quick_open->tree_view), FALSE);
+	gtk_tree_view_set_activate_on_single_click (GTK_TREE_VIEW (quick_open->tree_view), TRUE);
+
+	renderer = gtk_cell_renderer_text_new ();
+	g_object_set (renderer, "ellipsize", PANGO_ELLIPSIZE_MIDDLE, NULL);
+	column = gtk_tree_view_column_new_with_attributes (NULL, renderer,
+							   "markup", COLUMN_MARKUP,
+							   NULL);
+	gtk_tree_view_append_column (GTK_TREE_VIEW (quick_open->tree_view), column);
+
+	scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+	gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (scrolled_window), GTK_SHADOW_IN);
+	gtk_widget_set_vexpand (scrolled_window, TRUE);
+	gtk_container_add (GTK_CONTAINER (scrolled_window), quick_open->tree_view);
+	gtk_container_add (GTK_CONTAINER (box), scrolled_window);
+
+	quick_open->status = gtk_label_new (NULL);
+	gtk_widget_set_halign (quick_open->status, GTK_ALIGN_START);
+	gtk_style_context_add_class (gtk_widget_get_style_context (quick_open->status), "dim-label");
+	gtk_container_add (GTK_CONTAINER (box), quick_open->status);
+
+	gtk_widget_show_all (box);
+
+	g_signal_connect (quick_open->entry,
+			  "search-changed",
+			  G_CALLBACK (on_search_changed),
+			  quick_open);
+
+	g_signal_connect (quick_open->entry,
+			  "activate",
+			  G_CALLBACK (on_entry_activate),
+			  quick_open);
+
+	g_signal_connect (quick_open->entry,
+			  "stop-search",
+			  G_CALLBACK (on_stop_search),
+			  quick_open);
+
+	g_signal_connect (quick_open->entry,
+			  "key-press-event",
+			  G_CALLBACK (on_entry_key_press),
+			  quick_open);
+
+	g_signal_connect (quick_open->tree_view,
+			  "row-activated",
+			  G_CALLBACK (on_row_activated),
+			  quick_open);
+}
+
+/**
+ * gedit_file_browser_quick_open_new:
+ * @window: the #GeditWindow where the files are opened.
+ * @index: the #GeditFileBrowserIndex to search.
+ *
+ * Returns: (transfer floating): a new quick open window, transient for
+ * @window.
+ */
+GtkWidget *
+gedit_file_browser_quick_open_new (GeditWindow           *window,
+				   GeditFileBrowserIndex *index)
+{
+	GeditFileBrowserQuickOpen *quick_open;
+
+	g_return_val_if_fail (GEDIT_IS_WINDOW (window), NULL);
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_INDEX (index), NULL);
+
+	quick_open = g_object_new (GEDIT_TYPE_FILE_BROWSER_QUICK_OPEN, NULL);
+	quick_open->window = g_object_ref (window);
+	quick_open->index = g_object_ref (index);
+
+	gtk_window_set_transient_for (GTK_WINDOW (quick_open), GTK_WINDOW (window));
+
+	g_signal_connect (index,
+			  "changed",
+			  G_CALLBACK (on_index_changed),
+			  quick_open);
+
+	g_signal_connect (index,
+			  "notify::loading",
+			  G_CALLBACK (on_index_loading_changed),
+			  quick_open);
+
+	update_status (quick_open);
+
+	return GTK_WIDGET (quick_open);
+}
+
+void
+_gedit_file_browser_quick_open_register_type (GTypeModule *type_module)
+{
+	gedit_file_browser_quick_open_register_type (type_module);
+}
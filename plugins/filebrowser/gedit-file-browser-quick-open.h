@@ -0,0 +1,25 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_QUICK_OPEN_H
+#define GEDIT_FILE_BROWSER_QUICK_OPEN_H
+
+#include <gedit/gedit-window.h>
+#include "gedit-file-browser-index.h"
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_QUICK_OPEN (gedit_file_browser_quick_open_get_type ())
+G_DECLARE_FINAL_TYPE (GeditFileBrowserQuickOpen, gedit_file_browser_quick_open,
+		      GEDIT, FILE_BROWSER_QUICK_OPEN,
+		      GtkWindow)
+
+GtkWidget	*gedit_file_browser_quick_open_new	(GeditWindow           *window,
+							 GeditFileBrowserIndex *index);
+
+void		 _gedit_file_browser_quick_open_register_type	(GTypeModule   *type_module);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_QUICK_OPEN_H */
@@ -0,0 +1,431 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <glib/gi18n-lib.h>
+#include <gedit/gedit-commands.h>
+
+#include "gedit-file-browser-search-panel.h"
+#include "gedit-file-browser-search.h"
+
+/* The find in files panel: the search runs from the virtual root of the file
+ * browser, and its matches are shown as they arrive, under a row per file.
+ */
+
+enum
+{
+	COLUMN_MARKUP,
+	COLUMN_PATH,
+	COLUMN_LINE,
+	COLUMN_COLUMN,
+	N_COLUMNS
+};
+
+struct _GeditFileBrowserSearchPanel
+{
+	GtkBox parent_instance;
+
+	GeditWindow *window;
+	GeditFileBrowserStore *store;
+	GeditFileBrowserSearch *search;
+
+	/* The root of the results, kept once the search is stopped */
+	GFile *root;
+
+	GtkWidget *entry;
+	GtkWidget *case_sensitive;
+	GtkWidget *regex;
+	GtkWidget *spinner;
+	GtkWidget *status;
+	GtkWidget *tree_view;
+	GtkTreeStore *results;
+
+	/* The row of the file of the last match */
+	GtkTreeIter file_iter;
+	gchar *file_path;
+
+	guint n_matches;
+	guint n_files;
+};
+
+G_DEFINE_DYNAMIC_TYPE (GeditFileBrowserSearchPanel, gedit_file_browser_search_panel, GTK_TYPE_BOX)
+
+static void
+update_status (GeditFileBrowserSearchPanel *panel)
+{
+	gchar *matches;
+	gchar *text;
+
+	/* Translators: the first part of "%s in %u files" */
+	matches = g_strdup_printf (ngettext ("%u match", "%u matches", panel->n_matches),
+				   panel->n_matches);
+
+	/* Translators: the first %s is "%u matches" */
+	text = g_strdup_printf (ngettext ("%s in %u file", "%s in %u files", panel->n_files),
+				matches,
+				panel->n_files);
+
+	if (panel->search != NULL && gedit_file_browser_search_is_truncated (panel->search))
+	{
+		gchar *truncated;
+
+		truncated = g_strdup_printf (_("%s, the search stopped at the maximum number of matches"), text);
+		g_free (text);
+		text = truncated;
+	}
+
+	gtk_label_set_text (GTK_LABEL (panel->status), text);
+
+	g_free (matches);
+	g_free (text);
+}
+
+static void
+stop_search (GeditFileBrowserSearchPanel *panel)
+{
+	if (panel->search != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (panel->search, panel);
+		gedit_file_browser_search_cancel (panel->search);
+		g_clear_object (&panel->search);
+	}
+
+	gtk_spinner_stop (GTK_SPINNER (panel->spinner));
+}
+
+static void
+on_search_matches (GeditFileBrowserSearch      *search,
+		   GPtrArray                   *matches,
+		   GeditFileBrowserSearchPanel *panel)
+{
+	for (guint i = 0; i < matches->len; i++)
+	{
+		GeditFileBrowserSearchMatch *match = g_ptr_array_index (matches, i);
+		GtkTreeIter iter;
+		gchar *markup;
+
+		if (g_strcmp0 (panel->file_path, match->path) != 0)
+		{
+			gchar *display;
+
+			display = g_filename_display_name (match->path);
+			markup = g_markup_printf_escaped ("<b>%s</b>", display);
+
+			gtk_tree_store_insert_with_values (panel->results, &panel->file_iter, NULL, -1,
+							   COLUMN_MARKUP, markup,
+							   COLUMN_PATH, match->path,
+							   COLUMN_LINE, 0,
+							   COLUMN_COLUMN, 0,
+							   -1);
+
+			g_free (display);
+			g_free (markup);
+
+			g_free (panel->file_path);
+			panel->file_path = g_strdup (match->path);
+			panel->n_files++;
+		}
+
+		markup = g_markup_printf_escaped ("<span alpha=\"60%%\">%u:</span> %s",
+						  match->line,
+						  match->text);
+
+		gtk_tree_store_insert_with_values (panel->results, &iter, &panel->file_iter, -1,
+						   COLUMN_MARKUP, markup,
+						   COLUMN_PATH, match->path,
+						   COLUMN_LINE, match->line,
+						   COLUMN_COLUMN, match->column,
+						   -1);
+
+		g_free (markup);
+		panel->n_matches++;
+
+		/* Expanded once its first match is in */
+		if (gtk_tree_store_iter_n_children (panel->results, &panel->file_iter) == 1)
+		{
+			GtkTreePath *path;
+
+			path = gtk_tree_model_get_path (GTK_TREE_MODEL (panel->results), &panel->file_iter);
+			gtk_tree_view_expand_row (GTK_TREE_VIEW (panel->tree_view), path, FALSE);
+			gtk_tree_path_free (path);
+		}
+	}
+
+	update_status (panel);
+}
+
+static void
+on_search_finished (GeditFileBrowserSearch      *search,
+		    GeditFileBrowserSearchPanel *panel)
+{
+	gtk_spinner_stop (GTK_SPINNER (panel->spinner));
+	update_status (panel);
+}
+
+static void
+start_search (GeditFileBrowserSearchPanel *panel)
+{
+	GeditFileBrowserSearchFlags flags = 0;
+	const gchar *text;
+	GFile *virtual_root;
+	gchar **binary_patterns;
+	GError *error = NULL;
+
+	stop_search (panel);
+
+	gtk_tree_store_clear (panel->results);
+	g_clear_object (&panel->root);
+	g_clear_pointer (&panel->file_path, g_free);
+	panel->n_matches = 0;
+	panel->n_files = 0;
+	gtk_label_set_text (GTK_LABEL (panel->status), NULL);
+
+	text = gtk_entry_get_text (GTK_ENTRY (panel->entry));
+	virtual_root = gedit_file_browser_store_get_virtual_root (panel->store);
+
+	if (text[0] == '\0' || virtual_root == NULL)
+	{
+		g_clear_object (&virtual_root);
+		return;
+	}
+
+	if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (panel->case_sensitive)))
+		flags |= GEDIT_FILE_BROWSER_SEARCH_FLAG_CASE_SENSITIVE;
+
+	if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (panel->regex)))
+		flags |= GEDIT_FILE_BROWSER_SEARCH_FLAG_REGEX;
+
+	g_object_get (panel->store, "binary-patterns", &binary_patterns, NULL);
+
+	panel->search = gedit_file_browser_search_new (virtual_root,
+						       text,
+						       flags,
+						       gedit_file_browser_store_get_filter_mode (panel->store),
+						       (const gchar * const *) binary_patterns,
+						       &error);
+
+	g_strfreev (binary_patterns);
+
+	if (panel->search == NULL)
+	{
+		gtk_label_set_text (GTK_LABEL (panel->status), error->message);
+		g_error_free (error);
+		g_object_unref (virtual_root);
+		return;
+	}
+
+	panel->root = virtual_root;
+
+	g_signal_connect (panel->search,
+			  "matches",
+			  G_CALLBACK (on_search_matches),
+			  panel);
+
+	g_signal_connect (panel->search,
+			  "finished",
+			  G_CALLBACK (on_search_finished),
+			  panel);
+
+	gtk_spinner_start (GTK_SPINNER (panel->spinner));
+}
+
+static void
+on_entry_activate (GtkEntry                    *entry,
+		   GeditFileBrowserSearchPanel *panel)
+{
+	start_search (panel);
+}
+
+static void
+on_stop_search (GtkSearchEntry              *entry,
+		GeditFileBrowserSearchPanel *panel)
+{
+	stop_search (panel);
+	update_status (panel);
+}
+
+static void
+on_row_activated (GtkTreeView                 *tree_view,
+		  GtkTreePath                 *path,
+		  GtkTreeViewColumn           *column,
+		  GeditFileBrowserSearchPanel *panel)
+{
+	GtkTreeModel *model = GTK_TREE_MODEL (panel->results);
+	GtkTreeIter iter;
+	gchar *relative;
+	gint line;
+	gint line_column;
+	GFile *location;
+	gchar **components;
+
+	if (panel->root == NULL || !gtk_tree_model_get_iter (model, &iter, path))
+		return;
+
+	gtk_tree_model_get (model, &iter,
+			    COLUMN_PATH, &relative,
+			    COLUMN_LINE, &line,
+			    COLUMN_COLUMN, &line_column,
+			    -1);
+
+	location = g_object_ref (panel->root);
+	components = g_strsplit (relative, "/", -1);
+
+	for (guint i = 0; components[i] != NULL; i++)
+	{
+		GFile *child = g_file_get_child (location, components[i]);
+
+		g_object_unref (location);
+		location = child;
+	}
+
+	gedit_commands_load_location (panel->window, location, NULL, line, line_column);
+
+	g_strfreev (components);
+	g_object_unref (location);
+	g_free (relative);
+}
+
+static void
+gedit_file_browser_search_panel_dispose (GObject *object)
+{
+	GeditFileBrowserSearchPanel *panel = GEDIT_FILE_BROWSER_SEARCH_PANEL (object);
+
+	if (panel->spinner != NULL)
+	{
+		stop_search (panel);
+		panel->spinner = NULL;
+	}
+
+	g_clear_object (&panel->window);
+	g_clear_object (&panel->store);
+	g_clear_object (&panel->results);
+	g_clear_object (&panel->root);
+	g_clear_pointer (&panel->file_path, g_free);
+
+	G_OBJECT_CLASS (gedit_file_browser_search_panel_parent_class)->dispose (object);
+}
+
+static void
+gedit_file_browser_search_panel_class_init (GeditFileBrowserSearchPanelClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = gedit_file_browser_search_panel_dispose;
+}
+
+static void
+gedit_file_browser_search_panel_class_finalize (GeditFileBrowserSearchPanelClass *klass)
+{
+}
+
+static void
+gedit_file_browser_search_panel_init (GeditFileBrowserSearchPanel *panel)
+{
+	GtkWidget *bar;
+	GtkWidget *scrolled_window;
+	GtkCellRenderer *renderer;
+	GtkTreeViewColumn *column;
+
+	gtk_orientable_set_orientation (GTK_ORIENTABLE (panel), GTK_ORIENTATION_VERTICAL);
+	gtk_box_set_spacing (GTK_BOX (panel), 6);
+	gtk_container_set_border_width (GTK_CONTAINER (panel), 6);
+
+	bar = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+	gtk_container_add (GTK_CONTAINER (panel), bar);
+
+	panel->entry = gtk_search_entry_new ();
+	gtk_entry_set_placeholder_text (GTK_ENTRY (panel->entry), _("Find in files"));
+	gtk_widget_set_hexpand (panel->entry, TRUE);
+	gtk_container_add (GTK_CONTAINER (bar), panel->entry);
+
+	panel->case_sensitive = gtk_check_button_new_with_mnemonic (_("_Match case"));
+	gtk_container_add (GTK_CONTAINER (bar), panel->case_sensitive);
+
+	panel->regex = gtk_check_button_new_with_mnemonic (_("Re_gular expression"));
+	gtk_container_add (GTK_CONTAINER (bar), panel->regex);
+
+	panel->spinner = gtk_spinner_new ();
+	gtk_container_add (GTK_CONTAINER (bar), panel->spinner);
+
+	panel->results = gtk_tree_store_new (N_COLUMNS,
+					     G_TYPE_STRING,
+					     G_TYPE_STRING,
+					     G_TYPE_INT,
+					     G_TYPE_INT);
+
+	panel->tree_view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (panel->results));
+	gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (panel->tree_view), FALSE);
+	gtk_tree_view_set_enable_search (GTK_TREE_VIEW (panel->tree_view), FALSE);
+
+	renderer = gtk_cell_renderer_text_new ();
+	g_object_set (renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+	column = gtk_tree_view_column_new_with_attributes (NULL, renderer,
+							   "markup", COLUMN_MARKUP,
+							   NULL);
+	gtk_tree_view_append_column (GTK_TREE_VIEW (panel->tree_view), column);
+
+	scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+	gtk_widget_set_vexpand (scrolled_window, TRUE);
+	gtk_container_add (GTK_CONTAINER (scrolled_window), panel->tree_view);
+	gtk_container_add (GTK_CONTAINER (panel), scrolled_window);
+
+	panel->status = gtk_label_new (NULL);
+	gtk_widget_set_halign (panel->status, GTK_ALIGN_START);
+	gtk_label_set_ellipsize (GTK_LABEL (panel->status), PANGO_ELLIPSIZE_END);
+	gtk_style_context_add_class (gtk_widget_get_style_context (panel->status), "dim-label");
+	gtk_container_add (GTK_CONTAINER (panel), panel->status);
+
+	g_signal_connect (panel->entry,
+			  "activate",
+			  G_CALLBACK (on_entry_activate),
+			  panel);
+
+	g_signal_connect (panel->entry,
+			  "stop-search",
+			  G_CALLBACK (on_stop_search),
+			  panel);
+
+	g_signal_connect (panel->tree_view,
+			  "row-activated",
+			  G_CALLBACK (on_row_activated),
+			  panel);
+}
+
+/**
+ * gedit_file_browser_search_panel_new:
+ * @window: the #GeditWindow where the files are opened.
+ * @store: the #GeditFileBrowserStore with the root and the filters.
+ *
+ * Returns: (transfer floating): a new find in files panel.
+ */
+GtkWidget *
+gedit_file_browser_search_panel_new (GeditWindow           *window,
+				     GeditFileBrowserStore *store)
+{
+	GeditFileBrowserSearchPanel *panel;
+
+	g_return_val_if_fail (GEDIT_IS_WINDOW (window), NULL);
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_STORE (store), NULL);
+
+	panel = g_object_new (GEDIT_TYPE_FILE_BROWSER_SEARCH_PANEL, NULL);
+	panel->window = g_object_ref (window);
+	panel->store = g_object_ref (store);
+
+	return GTK_WIDGET (panel);
+}
+
+void
+gedit_file_browser_search_panel_focus (GeditFileBrowserSearchPanel *panel)
+{
+	g_return_if_fail (GEDIT_IS_FILE_BROWSER_SEARCH_PANEL (panel));
+
+	gtk_widget_grab_focus (panel->entry);
+}
+
+void
+_gedit_file_browser_search_panel_register_type (GTypeModule *type_module)
+{
+	gedit_file_browser_search_panel_register_type (type_module);
+}
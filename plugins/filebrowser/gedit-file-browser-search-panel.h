@@ -0,0 +1,27 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_SEARCH_PANEL_H
+#define GEDIT_FILE_BROWSER_SEARCH_PANEL_H
+
+#include <gedit/gedit-window.h>
+#include "gedit-file-browser-store.h"
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_SEARCH_PANEL (gedit_file_browser_search_panel_get_type ())
+G_DECLARE_FINAL_TYPE (GeditFileBrowserSearchPanel, gedit_file_browser_search_panel,
+		      GEDIT, FILE_BROWSER_SEARCH_PANEL,
+		      GtkBox)
+
+GtkWidget	*gedit_file_browser_search_panel_new		(GeditWindow                 *window,
+								 GeditFileBrowserStore       *store);
+
+void		 gedit_file_browser_search_panel_focus		(GeditFileBrowserSearchPanel *panel);
+
+void		 _gedit_file_browser_search_panel_register_type	(GTypeModule                 *type_module);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_SEARCH_PANEL_H */
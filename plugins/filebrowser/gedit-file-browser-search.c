@@ -0,0 +1,1119 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "gedit-file-browser-search.h"
+#include "gedit-file-browser-matcher.h"
+#include "gedit-file-browser-utils.h"
+
+/* Find in files: a search of the lines of all the files under a root
+ * directory.
+ *
+ * A worker thread enumerates the tree, with the hidden and binary filters of
+ * the file browser, and hands the files to a pool of one thread per processor.
+ * The number of files handed over and not searched yet is bounded, as is the
+ * total number of matches, so the memory stays bounded whatever the size of
+ * the tree.
+ *
+ * A file is read in chunks of whole lines, so that a big file is not copied in
+ * memory and a file truncated in the meantime just ends earlier. A chunk is
+ * first scanned with memchr() for a literal that all the matches contain: the
+ * searched text itself, or the longest run of literal characters of the regular
+ * expression. Only the lines that contain it are given to the regular
+ * expression.
+ *
+ * The matches of a file are pushed at once to the main thread, where they are
+ * delivered in batches with the GeditFileBrowserSearch::matches signal.
+ */
+
+#define MAX_MATCHES 10000
+#define MAX_PENDING_FILES 256
+#define MAX_TEXT_LENGTH 256
+#define MAX_REMOTE_FILE_SIZE (16 * 1024 * 1024)
+#define READ_CHUNK_SIZE (256 * 1024)
+
+/* The rest of a file with a longer line is skipped */
+#define MAX_LINE_LENGTH (16 * 1024 * 1024)
+
+/* A file with a NUL byte in its head is binary */
+#define BINARY_SNIFF_SIZE 8192
+
+#define WALK_ATTRIBUTES G_FILE_ATTRIBUTE_STANDARD_TYPE "," \
+			G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," \
+			G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP "," \
+			G_FILE_ATTRIBUTE_STANDARD_NAME "," \
+			G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE "," \
+			G_FILE_ATTRIBUTE_STANDARD_SIZE "," \
+			G_FILE_ATTRIBUTE_ID_FILE
+
+typedef struct
+{
+	GFile *file;
+
+	/* Relative to the root, empty for the root itself. */
+	gchar *path;
+	goffset size;
+} SearchFile;
+
+typedef struct
+{
+	GWeakRef search;
+	GFile *root;
+
+	GeditFileBrowserStoreFilterMode filter_mode;
+	GeditFileBrowserMatcher *binary_matcher;
+
+	/* The literal that all the matches contain, or NULL. It is found with
+	   memchr() on its anchor byte, the rarest one, and with the other case
+	   of the anchor for a search without case. */
+	gchar *literal;
+	gsize literal_length;
+	gsize anchor;
+	gchar anchor_byte;
+	gchar anchor_alt;
+	gboolean case_sensitive;
+
+	/* NULL when the literal is the whole search. */
+	GRegex *regex;
+
+	gint n_matches;
+	gint truncated;
+
+	/* The number of files handed to the pool and not searched yet, and
+	   the matches not delivered yet. Element type: owned
+	   GeditFileBrowserSearchMatch. */
+	GMutex mutex;
+	GCond cond;
+	guint n_pending_files;
+	GPtrArray *pending;
+	gboolean dispatch_pending;
+} SearchData;
+
+struct _GeditFileBrowserSearch
+{
+	GObject parent_instance;
+
+	GFile *root;
+	GCancellable *cancellable;
+
+	guint running : 1;
+	guint truncated : 1;
+};
+
+enum
+{
+	MATCHES,
+	FINISHED,
+	N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+G_DEFINE_DYNAMIC_TYPE (GeditFileBrowserSearch, gedit_file_browser_search, G_TYPE_OBJECT)
+
+static void
+search_match_free (GeditFileBrowserSearchMatch *match)
+{
+	g_free (match->path);
+	g_free (match->text);
+	g_free (match);
+}
+
+static SearchFile *
+search_file_new (GFile       *file,
+		 const gchar *path,
+		 goffset      size)
+{
+	SearchFile *search_file = g_new (SearchFile, 1);
+
+	search_file->file = g_object_ref (file);
+	search_file->path = g_strdup (path);
+	search_file->size = size;
+
+	return search_file;
+}
+
+static void
+search_file_free (SearchFile *search_file)
+{
+	g_object_unref (search_file->file);
+	g_free (search_file->path);
+	g_free (search_file);
+}
+
+static void
+search_data_clear (SearchData *data)
+{
+	g_weak_ref_clear (&data->search);
+	g_object_unref (data->root);
+	g_clear_pointer (&data->binary_matcher, gedit_file_browser_matcher_free);
+	g_free (data->literal);
+	g_clear_pointer (&data->regex, g_regex_unref);
+	g_mutex_clear (&data->mutex);
+	g_cond_clear (&data->cond);
+	g_ptr_array_unref (data->pending);
+}
+
+static void
+search_data_release (SearchData *data)
+{
+	g_atomic_rc_box_release_full (data, (GDestroyNotify) search_data_clear);
+}
+
+/* Takes @literal */
+static void
+search_data_set_literal (SearchData *data,
+			 gchar      *literal)
+{
+	gint best_rank = G_MAXINT;
+
+	data->literal = literal;
+	data->literal_length = strlen (literal);
+
+	for (gsize i = 0; i < data->literal_length; i++)
+	{
+		guchar c = literal[i];
+		gint rank;
+
+		if (c == ' ')
+			rank = 3;
+		else if (g_ascii_islower (c))
+			rank = 2;
+		else if (g_ascii_isupper (c))
+			rank = 1;
+		else
+			rank = 0;
+
+		/* Two bytes to look for */
+		if (!data->case_sensitive && g_ascii_isalpha (c))
+			rank += 2;
+
+		if (rank < best_rank)
+		{
+			best_rank = rank;
+			data->anchor = i;
+		}
+	}
+
+	data->anchor_byte = literal[data->anchor];
+
+	if (!data->case_sensitive && g_ascii_isalpha (data->anchor_byte))
+	{
+		data->anchor_alt = g_ascii_islower (data->anchor_byte) ?
+				   g_ascii_toupper (data->anchor_byte) :
+				   g_ascii_tolower (data->anchor_byte);
+	}
+}
+
+static void
+required_literal_end_run (GString *run,
+			  GString *best,
+			  gssize  *last_char)
+{
+	if (run->len > best->len)
+		g_string_assign (best, run->str);
+
+	g_string_truncate (run, 0);
+	*last_char = -1;
+}
+
+/* Returns: the longest run of literal characters at the top level of
+   @pattern, that all the matches of @pattern contain, or NULL. */
+static gchar *
+regex_get_required_literal (const gchar *pattern)
+{
+	GString *run = g_string_new (NULL);
+	GString *best = g_string_new (NULL);
+	gssize last_char = -1;
+	gint depth = 0;
+	const gchar *p = pattern;
+
+	while (*p != '\0')
+	{
+		switch (*p)
+		{
+			case '\\':
+				if (p[1] == '\0' || strchr ("xopPkgcNQE0123456789", p[1]) != NULL)
+					goto none;
+
+				/* A class of characters or an assertion */
+				if (g_ascii_isalnum (p[1]))
+				{
+					required_literal_end_run (run, best, &last_char);
+				}
+				else if (depth == 0)
+				{
+					last_char = run->len;
+					g_string_append_c (run, p[1]);
+				}
+
+				p += 2;
+				break;
+
+			case '[':
+				required_literal_end_run (run, best, &last_char);
+				p++;
+
+				if (*p == '^')
+					p++;
+				if (*p == ']')
+					p++;
+
+				while (*p != '\0' && *p != ']')
+				{
+					if (p[0] == '[' && p[1] == ':')
+					{
+						const gchar *end = strstr (p, ":]");
+
+						if (end == NULL)
+							goto none;
+
+						p = end + 2;
+						continue;
+					}
+
+					if (p[0] == '\\' && p[1] != '\0')
+						p++;
+
+					p++;
+				}
+
+				if (*p == '\0')
+					goto none;
+
+				p++;
+				break;
+
+			case '(':
+				/* Options change the meaning of what follows */
+				if (p[1] == '?' && p[2] != ':')
+					goto none;
+
+				required_literal_end_run (run, best, &last_char);
+				depth++;
+				p++;
+				break;
+
+			case ')':
+				required_literal_end_run (run, best, &last_char);
+
+				if (--depth < 0)
+					goto none;
+
+				p++;
+				break;
+
+			case '|':
+				if (depth == 0)
+					goto none;
+
+				p++;
+				break;
+
+			case '*':
+			case '?':
+			case '{':
+				/* The previous character is optional */
+				if (last_char >= 0)
+					g_string_truncate (run, last_char);
+
+				required_literal_end_run (run, best, &last_char);
+
+				if (*p == '{')
+				{
+					const gchar *end = strchr (p, '}');
+
+					p = end != NULL ? end + 1 : p + 1;
+				}
+				else
+				{
+					p++;
+				}
+				break;
+
+			case '+':
+			case '.':
+			case '^':
+			case '$':
+				required_literal_end_run (run, best, &last_char);
+				p++;
+				break;
+
+			default:
+			{
+				gint length = g_utf8_skip[*(const guchar *) p];
+
+				if (depth == 0)
+				{
+					last_char = run->len;
+					g_string_append_len (run, p, length);
+				}
+
+				while (length-- > 0 && *p != '\0')
+					p++;
+				break;
+			}
+		}
+	}
+
+	required_literal_end_run (run, best, &last_char);
+	g_string_free (run, TRUE);
+
+	if (best->len > 0)
+		return g_string_free (best, FALSE);
+
+	g_string_free (best, TRUE);
+	return NULL;
+
+none:
+	g_string_free (run, TRUE);
+	g_string_free (best, TRUE);
+	return NULL;
+}
+
+/* Whether folding the case of ASCII only finds all that the Unicode case
+   folding of the regular expressions would: K and S also match the Kelvin
+   sign U+212A and the long s U+017F. */
+static gboolean
+str_has_ascii_case_only (const gchar *str)
+{
+	for (; *str != '\0'; str++)
+	{
+		if ((guchar) *str >= 0x80 || strchr ("KkSs", *str) != NULL)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Called in the worker threads */
+static const gchar *
+find_literal (const SearchData *data,
+	      const gchar      *haystack,
+	      gsize             length)
+{
+	const gchar *next_anchor = NULL;
+	const gchar *next_alt = NULL;
+	gboolean anchor_done = FALSE;
+	gboolean alt_done = data->anchor_alt == '\0';
+	const gchar *p;
+	const gchar *last;
+
+	if (length < data->literal_length)
+		return NULL;
+
+	p = haystack + data->anchor;
+	last = haystack + length - data->literal_length + data->anchor;
+
+	while (p <= last)
+	{
+		const gchar *found;
+		const gchar *candidate;
+
+		if (!anchor_done && (next_anchor == NULL || next_anchor < p))
+		{
+			next_anchor = memchr (p, data->anchor_byte, last - p + 1);
+			anchor_done = next_anchor == NULL;
+		}
+
+		if (!alt_done && (next_alt == NULL || next_alt < p))
+		{
+			next_alt = memchr (p, data->anchor_alt, last - p + 1);
+			alt_done = next_alt == NULL;
+		}
+
+		if (next_anchor != NULL && next_alt != NULL)
+			found = MIN (next_anchor, next_alt);
+		else
+			found = next_anchor != NULL ? next_anchor : next_alt;
+
+		if (found == NULL)
+			return NULL;
+
+		candidate = found - data->anchor;
+
+		if (data->case_sensitive ?
+		    memcmp (candidate, data->literal, data->literal_length) == 0 :
+		    g_ascii_strncasecmp (candidate, data->literal, data->literal_length) == 0)
+		{
+			return candidate;
+		}
+
+		p = found + 1;
+	}
+
+	return NULL;
+}
+
+static guint
+count_newlines (const gchar *start,
+		const gchar *end)
+{
+	guint count = 0;
+
+	while (start < end && (start = memchr (start, '\n', end - start)) != NULL)
+	{
+		count++;
+		start++;
+	}
+
+	return count;
+}
+
+/* Returns: the byte offset of the match in @line, or -1 */
+static gssize
+match_line (const SearchData *data,
+	    const gchar      *line,
+	    gsize             length,
+	    gssize            literal_offset)
+{
+	GMatchInfo *match_info;
+	gssize offset = -1;
+
+	if (data->regex == NULL)
+		return literal_offset;
+
+	/* The lines that are not valid UTF-8 are skipped */
+	if (!g_utf8_validate_len (line, length, NULL))
+		return -1;
+
+	if (g_regex_match_full (data->regex, line, length, 0, G_REGEX_MATCH_DEFAULT, &match_info, NULL))
+	{
+		gint start;
+
+		g_match_info_fetch_pos (match_info, 0, &start, NULL);
+		offset = start;
+	}
+
+	g_match_info_free (match_info);
+
+	return offset;
+}
+
+/* Returns: FALSE when the maximum number of matches is reached */
+static gboolean
+search_add_match (SearchData  *data,
+		  GPtrArray   *matches,
+		  const gchar *path,
+		  guint        line_number,
+		  const gchar *line,
+		  gsize        length,
+		  gsize        offset)
+{
+	GeditFileBrowserSearchMatch *match;
+	const gchar *text = line;
+
+	if (g_atomic_int_add (&data->n_matches, 1) >= MAX_MATCHES)
+	{
+		g_atomic_int_set (&data->truncated, TRUE);
+		return FALSE;
+	}
+
+	while (text < line + length && (*text == ' ' || *text == '\t'))
+		text++;
+
+	length -= text - line;
+
+	if (length > 0 && text[length - 1] == '\r')
+		length--;
+
+	match = g_new (GeditFileBrowserSearchMatch, 1);
+	match->path = g_strdup (path);
+	match->line = line_number;
+	match->text = g_utf8_make_valid (text, MIN (length, MAX_TEXT_LENGTH));
+
+	if (g_utf8_validate_len (line, offset, NULL))
+		match->column = g_utf8_strlen (line, offset) + 1;
+	else
+		match->column = offset + 1;
+
+	g_ptr_array_add (matches, match);
+
+	return TRUE;
+}
+
+/* @buffer starts at a line start, and @line_number is the number of that line.
+   It is updated to the number of the line at the end of @buffer.
+
+   Returns: FALSE when the search of the file must stop */
+static gboolean
+search_buffer (SearchData   *data,
+	       const gchar  *path,
+	       const gchar  *buffer,
+	       gsize         length,
+	       guint        *line_number,
+	       GPtrArray    *matches,
+	       GCancellable *cancellable)
+{
+	const gchar *end = buffer + length;
+	const gchar *p = buffer;
+	const gchar *counted = buffer;
+
+	/* @p is always at the start of a line */
+	while (p < end)
+	{
+		const gchar *hit = p;
+		const gchar *line;
+		const gchar *line_end;
+		gssize offset;
+
+		if (data->literal != NULL)
+		{
+			hit = find_literal (data, p, end - p);
+
+			if (hit == NULL)
+				break;
+		}
+
+		line = hit;
+
+		while (line > p && line[-1] != '\n')
+			line--;
+
+		line_end = memchr (hit, '\n', end - hit);
+
+		if (line_end == NULL)
+			line_end = end;
+
+		*line_number += count_newlines (counted, line);
+		counted = line;
+
+		offset = match_line (data, line, line_end - line, hit - line);
+
+		if (offset >= 0 &&
+		    !search_add_match (data, matches, path, *line_number, line, line_end - line, offset))
+		{
+			return FALSE;
+		}
+
+		if (g_cancellable_is_cancelled (cancellable))
+			return FALSE;
+
+		p = line_end + 1;
+	}
+
+	*line_number += count_newlines (counted, end);
+
+	return TRUE;
+}
+
+static void
+search_file (SearchData   *data,
+	     SearchFile   *file,
+	     GPtrArray    *matches,
+	     GCancellable *cancellable)
+{
+	GFileInputStream *stream;
+	gchar *buffer;
+	gsize size = READ_CHUNK_SIZE;
+	gsize length = 0;
+	guint line_number = 1;
+	gboolean sniffed = FALSE;
+
+	if (!g_file_is_native (file->file) && file->size > MAX_REMOTE_FILE_SIZE)
+		return;
+
+	stream = g_file_read (file->file, cancellable, NULL);
+
+	if (stream == NULL)
+		return;
+
+	buffer = g_malloc (size);
+
+	/* @buffer holds @length bytes, from the start of a line */
+	while (TRUE)
+	{
+		gssize n_read;
+		const gchar *lines_end;
+
+		/* No line end in the whole buffer */
+		if (length == size)
+		{
+			if (size >= MAX_LINE_LENGTH)
+				break;
+
+			size *= 2;
+			buffer = g_realloc (buffer, size);
+		}
+
+		n_read = g_input_stream_read (G_INPUT_STREAM (stream),
+					      buffer + length,
+					      size - length,
+					      cancellable,
+					      NULL);
+
+		if (n_read < 0)
+			break;
+
+		length += n_read;
+
+		if (!sniffed && (length >= BINARY_SNIFF_SIZE || n_read == 0))
+		{
+			if (memchr (buffer, '\0', MIN (length, BINARY_SNIFF_SIZE)) != NULL)
+				break;
+
+			sniffed = TRUE;
+		}
+
+		/* The end of the file, the last line has no line end */
+		if (n_read == 0)
+		{
+			if (length > 0)
+				search_buffer (data, file->path, buffer, length, &line_number, matches, cancellable);
+
+			break;
+		}
+
+		if (!sniffed)
+			continue;
+
+		lines_end = buffer + length;
+
+		while (lines_end > buffer && lines_end[-1] != '\n')
+			lines_end--;
+
+		if (lines_end == buffer)
+			continue;
+
+		if (!search_buffer (data, file->path, buffer, lines_end - buffer, &line_number, matches, cancellable))
+			break;
+
+		length -= lines_end - buffer;
+		memmove (buffer, lines_end, length);
+	}
+
+	g_free (buffer);
+	g_object_unref (stream);
+}
+
+static gboolean
+search_dispatch_cb (SearchData *data)
+{
+	GeditFileBrowserSearch *search;
+	GPtrArray *matches;
+
+	g_mutex_lock (&data->mutex);
+	matches = data->pending;
+	data->pending = g_ptr_array_new_with_free_func ((GDestroyNotify) search_match_free);
+	data->dispatch_pending = FALSE;
+	g_mutex_unlock (&data->mutex);
+
+	search = g_weak_ref_get (&data->search);
+
+	if (search != NULL)
+	{
+		if (matches->len > 0 && !g_cancellable_is_cancelled (search->cancellable))
+			g_signal_emit (search, signals[MATCHES], 0, matches);
+
+		g_object_unref (search);
+	}
+
+	g_ptr_array_unref (matches);
+
+	return G_SOURCE_REMOVE;
+}
+
+typedef struct
+{
+	SearchData *data;
+	GCancellable *cancellable;
+} SearchPoolData;
+
+/* Called in the threads of the pool */
+static void
+search_file_func (SearchFile     *file,
+		  SearchPoolData *pool_data)
+{
+	SearchData *data = pool_data->data;
+	GPtrArray *matches;
+	gpointer *stolen;
+	gsize n_stolen;
+	gboolean schedule = FALSE;
+
+	matches = g_ptr_array_new_with_free_func ((GDestroyNotify) search_match_free);
+
+	if (!g_cancellable_is_cancelled (pool_data->cancellable) &&
+	    !g_atomic_int_get (&data->truncated))
+	{
+		search_file (data, file, matches, pool_data->cancellable);
+	}
+
+	stolen = g_ptr_array_steal (matches, &n_stolen);
+
+	g_mutex_lock (&data->mutex);
+
+	for (gsize i = 0; i < n_stolen; i++)
+		g_ptr_array_add (data->pending, stolen[i]);
+
+	if (n_stolen > 0 && !data->dispatch_pending)
+	{
+		data->dispatch_pending = TRUE;
+		schedule = TRUE;
+	}
+
+	data->n_pending_files--;
+	g_cond_signal (&data->cond);
+
+	g_mutex_unlock (&data->mutex);
+
+	if (schedule)
+	{
+		g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+				 (GSourceFunc) search_dispatch_cb,
+				 g_atomic_rc_box_acquire (data),
+				 (GDestroyNotify) search_data_release);
+	}
+
+	g_free (stolen);
+	g_ptr_array_unref (matches);
+	search_file_free (file);
+}
+
+/* Returns: FALSE when the walk must stop */
+static gboolean
+walk_push_file (SearchData   *data,
+		GThreadPool  *pool,
+		GFile        *file,
+		const gchar  *path,
+		goffset       size,
+		GCancellable *cancellable)
+{
+	g_mutex_lock (&data->mutex);
+
+	while (data->n_pending_files >= MAX_PENDING_FILES)
+		g_cond_wait (&data->cond, &data->mutex);
+
+	data->n_pending_files++;
+
+	g_mutex_unlock (&data->mutex);
+
+	if (g_cancellable_is_cancelled (cancellable) ||
+	    g_atomic_int_get (&data->truncated))
+	{
+		g_mutex_lock (&data->mutex);
+		data->n_pending_files--;
+		g_mutex_unlock (&data->mutex);
+
+		return FALSE;
+	}
+
+	g_thread_pool_push (pool, search_file_new (file, path, size), NULL);
+
+	return TRUE;
+}
+
+static void
+walk_thread (GTask        *task,
+	     gpointer      source_object,
+	     gpointer      task_data,
+	     GCancellable *cancellable)
+{
+	SearchData *data = task_data;
+	SearchPoolData pool_data = { data, cancellable };
+	GThreadPool *pool;
+	GQueue queue = G_QUEUE_INIT;
+	GHashTable *visited;
+	SearchFile *directory;
+	gboolean stop = FALSE;
+
+	pool = g_thread_pool_new_full ((GFunc) search_file_func,
+				       &pool_data,
+				       (GDestroyNotify) search_file_free,
+				       g_get_num_processors (),
+				       FALSE,
+				       NULL);
+
+	visited = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	g_queue_push_tail (&queue, search_file_new (data->root, "", 0));
+
+	while (!stop && (directory = g_queue_pop_head (&queue)) != NULL)
+	{
+		GFileEnumerator *enumerator;
+		GFileInfo *info;
+
+		enumerator = g_file_enumerate_children (directory->file,
+							WALK_ATTRIBUTES,
+							G_FILE_QUERY_INFO_NONE,
+							cancellable,
+							NULL);
+
+		while (!stop &&
+		       enumerator != NULL &&
+		       (info = g_file_enumerator_next_file (enumerator, cancellable, NULL)) != NULL)
+		{
+			GFileType type = g_file_info_get_file_type (info);
+			GFile *child;
+			gchar *path;
+
+			if ((type != G_FILE_TYPE_REGULAR && type != G_FILE_TYPE_DIRECTORY) ||
+			    gedit_file_browser_utils_file_info_is_filtered (info, data->filter_mode, data->binary_matcher))
+			{
+				g_object_unref (info);
+				continue;
+			}
+
+			child = g_file_enumerator_get_child (enumerator, info);
+
+			if (directory->path[0] == '\0')
+				path = g_strdup (g_file_info_get_name (info));
+			else
+				path = g_strconcat (directory->path, "/", g_file_info_get_name (info), NULL);
+
+			if (type == G_FILE_TYPE_DIRECTORY)
+			{
+				const gchar *id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILE);
+
+				/* Not a link to a directory already enumerated */
+				if (id == NULL || g_hash_table_add (visited, g_strdup (id)))
+					g_queue_push_tail (&queue, search_file_new (child, path, 0));
+			}
+			else
+			{
+				stop = !walk_push_file (data, pool, child, path,
+							g_file_info_get_size (info),
+							cancellable);
+			}
+
+			g_free (path);
+			g_object_unref (child);
+			g_object_unref (info);
+		}
+
+		g_clear_object (&enumerator);
+		search_file_free (directory);
+
+		stop |= g_cancellable_is_cancelled (cancellable);
+	}
+
+	g_queue_clear_full (&queue, (GDestroyNotify) search_file_free);
+	g_hash_table_unref (visited);
+
+	/* Wait for the files handed over, or drop them when cancelled */
+	g_thread_pool_free (pool, g_cancellable_is_cancelled (cancellable), TRUE);
+
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+walk_done_cb (GObject      *source_object,
+	      GAsyncResult *result,
+	      gpointer      user_data)
+{
+	SearchData *data = user_data;
+	GeditFileBrowserSearch *search;
+
+	/* The last matches, when their idle has not run yet */
+	search_dispatch_cb (data);
+
+	search = g_weak_ref_get (&data->search);
+
+	if (search != NULL)
+	{
+		search->running = FALSE;
+		search->truncated = g_atomic_int_get (&data->truncated) != 0;
+
+		g_signal_emit (search, signals[FINISHED], 0);
+		g_object_unref (search);
+	}
+
+	search_data_release (data);
+}
+
+static void
+gedit_file_browser_search_dispose (GObject *object)
+{
+	GeditFileBrowserSearch *search = GEDIT_FILE_BROWSER_SEARCH (object);
+
+	if (search->cancellable != NULL)
+	{
+		g_cancellable_cancel (search->cancellable);
+		g_clear_object (&search->cancellable);
+	}
+
+	g_clear_object (&search->root);
+
+	G_OBJECT_CLASS (gedit_file_browser_search_parent_class)->dispose (object);
+}
+
+static void
+gedit_file_browser_search_class_init (GeditFileBrowserSearchClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	object_class->dispose = gedit_file_browser_search_dispose;
+
+	/**
+	 * GeditFileBrowserSearch::matches:
+	 * @search: the #GeditFileBrowserSearch.
+	 * @matches: (element-type GeditFileBrowserSearchMatch): the new
+	 *   matches, those of a file are contiguous and in order.
+	 */
+	signals[MATCHES] =
+		g_signal_new ("matches",
+			      G_TYPE_FROM_CLASS (klass),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 1,
+			      G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+	signals[FINISHED] =
+		g_signal_new ("finished",
+			      G_TYPE_FROM_CLASS (klass),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL, NULL,
+			      G_TYPE_NONE, 0);
+}
+
+static void
+gedit_file_browser_search_class_finalize (GeditFileBrowserSearchClass *klass)
+{
+}
+
+static void
+gedit_file_browser_search_init (GeditFileBrowserSearch *search)
+{
+	search->cancellable = g_cancellable_new ();
+}
+
+/**
+ * gedit_file_browser_search_new:
+ * @root: the directory to search.
+ * @text: the text to look for, or a regular expression.
+ * @flags: the #GeditFileBrowserSearchFlags.
+ * @filter_mode: the hidden and binary filters to apply.
+ * @binary_patterns: (nullable): the patterns of the binary files.
+ * @error: a #GError.
+ *
+ * Creates a search of the lines of the files under @root that contain @text,
+ * and starts it.
+ *
+ * Returns: (transfer full) (nullable): a new #GeditFileBrowserSearch, or %NULL
+ * if @text is not a valid regular expression.
+ */
+GeditFileBrowserSearch *
+gedit_file_browser_search_new (GFile                           *root,
+			       const gchar                     *text,
+			       GeditFileBrowserSearchFlags      flags,
+			       GeditFileBrowserStoreFilterMode  filter_mode,
+			       const gchar * const             *binary_patterns,
+			       GError                         **error)
+{
+	GeditFileBrowserSearch *search;
+	SearchData *data;
+	GTask *task;
+
+	g_return_val_if_fail (G_IS_FILE (root), NULL);
+	g_return_val_if_fail (text != NULL && text[0] != '\0', NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	data = g_atomic_rc_box_new0 (SearchData);
+	data->root = g_object_ref (root);
+	data->filter_mode = filter_mode;
+	data->case_sensitive = (flags & GEDIT_FILE_BROWSER_SEARCH_FLAG_CASE_SENSITIVE) != 0;
+	data->pending = g_ptr_array_new_with_free_func ((GDestroyNotify) search_match_free);
+	g_mutex_init (&data->mutex);
+	g_cond_init (&data->cond);
+
+	if (binary_patterns != NULL)
+		data->binary_matcher = gedit_file_browser_matcher_new (binary_patterns);
+
+	/* The literal comparison only folds the case of ASCII */
+	if (!(flags & GEDIT_FILE_BROWSER_SEARCH_FLAG_REGEX) &&
+	    (data->case_sensitive || str_has_ascii_case_only (text)))
+	{
+		search_data_set_literal (data, g_strdup (text));
+	}
+	else
+	{
+		gchar *pattern;
+		gchar *literal;
+
+		if (flags & GEDIT_FILE_BROWSER_SEARCH_FLAG_REGEX)
+			pattern = g_strdup (text);
+		else
+			pattern = g_regex_escape_string (text, -1);
+
+		data->regex = g_regex_new (pattern,
+					   data->case_sensitive ? G_REGEX_DEFAULT : G_REGEX_CASELESS,
+					   G_REGEX_MATCH_DEFAULT,
+					   error);
+
+		literal = data->regex != NULL ? regex_get_required_literal (pattern) : NULL;
+		g_free (pattern);
+
+		if (data->regex == NULL)
+		{
+			search_data_release (data);
+			return NULL;
+		}
+
+		if (literal != NULL && (data->case_sensitive || str_has_ascii_case_only (literal)))
+			search_data_set_literal (data, literal);
+		else
+			g_free (literal);
+	}
+
+	search = g_object_new (GEDIT_TYPE_FILE_BROWSER_SEARCH, NULL);
+	search->root = g_object_ref (root);
+	search->running = TRUE;
+	g_weak_ref_init (&data->search, search);
+
+	task = g_task_new (NULL, search->cancellable, walk_done_cb, data);
+	g_task_set_task_data (task, g_atomic_rc_box_acquire (data), (GDestroyNotify) search_data_release);
+	g_task_set_priority (task, G_PRIORITY_DEFAULT_IDLE);
+	g_task_run_in_thread (task, walk_thread);
+	g_object_unref (task);
+
+	return search;
+}
+
+GFile *
+gedit_file_browser_search_get_root (GeditFileBrowserSearch *search)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_SEARCH (search), NULL);
+
+	return search->root;
+}
+
+/**
+ * gedit_file_browser_search_cancel:
+ * @search: a #GeditFileBrowserSearch.
+ *
+ * Stops the search. No more matches are delivered, the
+ * GeditFileBrowserSearch::finished signal is still emitted.
+ */
+void
+gedit_file_browser_search_cancel (GeditFileBrowserSearch *search)
+{
+	g_return_if_fail (GEDIT_IS_FILE_BROWSER_SEARCH (search));
+
+	if (search->cancellable != NULL)
+		g_cancellable_cancel (search->cancellable);
+}
+
+gboolean
+gedit_file_browser_search_is_running (GeditFileBrowserSearch *search)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_SEARCH (search), FALSE);
+
+	return search->running;
+}
+
+/* Whether the search stopped at the maximum number of matches */
+gboolean
+gedit_file_browser_search_is_truncated (GeditFileBrowserSearch *search)
+{
+	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_SEARCH (search), FALSE);
+
+	return search->truncated;
+}
+
+void
+_gedit_file_browser_search_register_type (GTypeModule *type_module)
+{
+	gedit_file_browser_search_register_type (type_module);
+}
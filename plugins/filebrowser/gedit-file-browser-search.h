@@ -0,0 +1,59 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_SEARCH_H
+#define GEDIT_FILE_BROWSER_SEARCH_H
+
+#include "gedit-file-browser-store.h"
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_SEARCH (gedit_file_browser_search_get_type ())
+G_DECLARE_FINAL_TYPE (GeditFileBrowserSearch, gedit_file_browser_search,
+		      GEDIT, FILE_BROWSER_SEARCH,
+		      GObject)
+
+typedef enum
+{
+	GEDIT_FILE_BROWSER_SEARCH_FLAG_CASE_SENSITIVE = 1 << 0,
+	GEDIT_FILE_BROWSER_SEARCH_FLAG_REGEX          = 1 << 1
+} GeditFileBrowserSearchFlags;
+
+typedef struct _GeditFileBrowserSearchMatch GeditFileBrowserSearchMatch;
+
+struct _GeditFileBrowserSearchMatch
+{
+	/* Relative to the root, '/' separated. */
+	gchar *path;
+
+	/* Both start at 1, the column is in characters. */
+	guint line;
+	guint column;
+
+	/* The line, valid UTF-8, without the leading white space and
+	 * truncated.
+	 */
+	gchar *text;
+};
+
+GeditFileBrowserSearch	*gedit_file_browser_search_new		(GFile                           *root,
+								 const gchar                     *text,
+								 GeditFileBrowserSearchFlags      flags,
+								 GeditFileBrowserStoreFilterMode  filter_mode,
+								 const gchar * const             *binary_patterns,
+								 GError                         **error);
+
+GFile			*gedit_file_browser_search_get_root	(GeditFileBrowserSearch          *search);
+
+void			 gedit_file_browser_search_cancel	(GeditFileBrowserSearch          *search);
+
+gboolean		 gedit_file_browser_search_is_running	(GeditFileBrowserSearch          *search);
+
+gboolean		 gedit_file_browser_search_is_truncated	(GeditFileBrowserSearch          *search);
+
+void			 _gedit_file_browser_search_register_type	(GTypeModule             *type_module);
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_SEARCH_H */
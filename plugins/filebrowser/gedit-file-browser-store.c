@@ -29,6 +29,9 @@
 #include "gedit-file-browser-enum-types.h"
 #include "gedit-file-browser-error.h"
 #include "gedit-file-browser-utils.h"
+#include "gedit-file-browser-listing-cache.h"
+#include "gedit-file-browser-matcher.h"
+#include "gedit-file-browser-icon-cache.h"
 
 #define NODE_IS_DIR(node)		(FILE_IS_DIR((node)->flags))
 #define NODE_IS_HIDDEN(node)		(FILE_IS_HIDDEN((node)->flags))
@@ -39,13 +42,28 @@
 
 #define FILE_BROWSER_NODE_DIR(node)	((FileBrowserNodeDir *)(node))
 
-#define DIRECTORY_LOAD_ITEMS_PER_CALLBACK 100
+/* How long the worker enumerating a directory accumulates entries before
+ * queuing them to the main thread, and how long the main thread spends per
+ * dispatch to add them to the model. */
+#define DIRECTORY_LOAD_CHUNK_USEC (16 * 1000)
+#define DIRECTORY_LOAD_BATCH_USEC (8 * 1000)
+
+/* How long the events of a directory monitor are coalesced, and how many
+ * children can be queued before the queue is flushed anyway. */
+#define MONITOR_COALESCE_MSEC 150
+#define MONITOR_QUEUE_MAX 4096
+
+/* The listing of a directory is cached when its enumeration takes longer. */
+#define DIRECTORY_CACHE_MIN_USEC (200 * 1000)
+
 #define STANDARD_ATTRIBUTE_TYPES G_FILE_ATTRIBUTE_STANDARD_TYPE "," \
 				 G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," \
 			 	 G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP "," \
 				 G_FILE_ATTRIBUTE_STANDARD_NAME "," \
 				 G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE "," \
 				 G_FILE_ATTRIBUTE_STANDARD_ICON
+#define LOAD_ATTRIBUTE_TYPES STANDARD_ATTRIBUTE_TYPES "," \
+			     GEDIT_FILE_BROWSER_LISTING_CACHE_ATTRIBUTES
 
 typedef struct _FileBrowserNode    FileBrowserNode;
 typedef struct _FileBrowserNodeDir FileBrowserNodeDir;
@@ -65,11 +83,71 @@ struct _AsyncData
 	gboolean               removed;
 };
 
+/* A child enumerated by the worker loading a directory. */
+typedef struct
+{
+	GFile     *file;
+
+	/* For the icon, which is looked up in the main thread. */
+	GFileInfo *info;
+
+	gchar     *name;
+	gchar     *markup;
+	gchar     *collate_key;
+	guint      flags;
+
+	/* Whether the entry replaces the one of the cached listing. */
+	gboolean   replace;
+} LoadEntry;
+
+typedef struct
+{
+	/* Element type: owned LoadEntry, sorted. */
+	GPtrArray *entries;
+
+	/* The first entry not added to the model yet. */
+	guint      pos;
+
+	/* The files of the cached listing that do not exist anymore. Element
+	 * type: owned GFile. Nullable.
+	 */
+	GPtrArray *removed;
+
+	/* Whether the chunk replaces or removes nodes of the cached listing. */
+	gboolean   reconcile;
+} LoadChunk;
+
+/* Shared between the main thread and the worker loading the directory,
+ * reference counted with g_atomic_rc_box_acquire().
+ */
 struct _AsyncNode
 {
+	/* Only accessed in the main thread, while not cancelled. */
 	FileBrowserNodeDir *dir;
 	GCancellable       *cancellable;
-	GSList             *original_children;
+
+	/* Read-only once the worker is started. */
+	GFile              *location;
+	GMainContext       *context;
+
+	/* The files of the children when the loading started, so that we do
+	 * not have to check if a file already exists among the ones we just
+	 * added.
+	 */
+	GHashTable         *original_files;
+
+	GMutex              mutex;
+
+	/* Element type: owned LoadChunk. Protected by @mutex. */
+	GQueue              chunks;
+
+	/* Whether a dispatch of the chunks is scheduled in the main thread.
+	 * Protected by @mutex.
+	 */
+	gboolean            dispatch_pending;
+
+	/* Whether the worker is done. Only accessed in the main thread. */
+	gboolean            enumerated;
 };
 
 typedef struct {
@@ -87,22 +165,64 @@ struct _FileBrowserNode
 	gchar           *name;
 	gchar           *markup;
 
-	GdkPixbuf       *icon;
-	GdkPixbuf       *emblem;
+	/* The key of @name to sort the nodes. */
+	gchar           *collate_key;
+
+	/* Shared with the nodes with the same icon and emblem. */
+	GeditFileBrowserIcon *icon;
 
 	FileBrowserNode *parent;
+
+	/* The index in the children of the parent. */
+	guint            index;
+
 	gint             pos;
 	gboolean         inserted;
+
+	/* Whether the node is counted as inserted in the visible index of its
+	 * parent. */
+	gboolean         indexed;
 };
 
 struct _FileBrowserNodeDir
 {
 	FileBrowserNode        node;
-	GSList                *children;
+
+	/* Element type: owned FileBrowserNode, sorted with the sort func of
+	 * the model, the dummy node first.
+	 */
+	GPtrArray             *children;
+
+	/* The visible index: a Fenwick tree (1-based, of guint) over the
+	 * inserted state of the children, so that the number of inserted
+	 * children before a child and the nth inserted child are found in
+	 * O(log n), and a child changing state is updated in O(log n). Valid
+	 * while visible_index_stamp is equal to the one of the model, it is
+	 * rebuilt when the children array changes.
+	 */
+	GArray                *visible_index;
+	guint                  visible_index_stamp;
+	guint                  n_inserted;
 
 	GCancellable          *cancellable;
 	GFileMonitor          *monitor;
 	GeditFileBrowserStore *model;
+
+	/* The children with pending monitor events. Element type: owned
+	 * GFile. Nullable.
+	 */
+	GHashTable            *monitor_queue;
+	guint                  monitor_timeout_id;
+
+	/* Of the flush of the monitor queue in progress, if any. */
+	GCancellable          *monitor_cancellable;
+
+	/* The children by file, while the directory is reconciled with its
+	 * cached listing, so that the stale ones are found in O(1). Cleared
+	 * when the files of the children change. Key type: owned GFile.
+	 * Nullable.
+	 */
+	GHashTable            *reconcile_nodes;
 };
 
 struct _GeditFileBrowserStorePrivate
@@ -116,10 +236,25 @@ struct _GeditFileBrowserStorePrivate
 	gpointer                          filter_user_data;
 
 	gchar                           **binary_patterns;
-	GPtrArray                        *binary_pattern_specs;
+	GeditFileBrowserMatcher          *binary_matcher;
+
+	/* The files that do not match are filtered. Nullable. */
+	GeditFileBrowserMatcher          *filter_matcher;
 
 	SortFunc                          sort_func;
 
+	/* Changed when the visibility of all the nodes may have changed, to
+	 * invalidate the visible index of all the directories.
+	 */
+	guint                             visible_index_stamp;
+
+	/* The number of children in the monitor queues of all the
+	 * directories, and the number of monitor events that did not need a
+	 * query of their own.
+	 */
+	guint                             monitor_queue_depth;
+	guint                             monitor_events_dropped;
+
 	GSList                           *async_handles;
 	MountInfo                        *mount_info;
 };
@@ -189,8 +324,13 @@ static gint model_sort_default                              (FileBrowserNode
 							     FileBrowserNode        *node2);
 static void model_check_dummy                               (GeditFileBrowserStore  *model,
 							     FileBrowserNode        *node);
-static void next_files_async 				    (GFileEnumerator        *enumerator,
-							     AsyncNode              *async);
+static void model_clear_monitor_queue                       (GeditFileBrowserStore  *model,
+							     FileBrowserNodeDir     *dir);
+static void on_directory_monitor_event                      (GFileMonitor           *monitor,
+							     GFile                  *file,
+							     GFile                  *other_file,
+							     GFileMonitorEvent       event_type,
+							     FileBrowserNode        *parent);
 
 static void delete_files                                    (AsyncData              *data);
 
@@ -210,7 +350,9 @@ enum {
 	PROP_ROOT,
 	PROP_VIRTUAL_ROOT,
 	PROP_FILTER_MODE,
-	PROP_BINARY_PATTERNS
+	PROP_BINARY_PATTERNS,
+	PROP_MONITOR_QUEUE_DEPTH,
+	PROP_MONITOR_EVENTS_DROPPED
 };
 
 /* Signals */
@@ -225,6 +367,7 @@ enum
 	END_REFRESH,
 	UNLOAD,
 	BEFORE_ROW_DELETED,
+	FILES_CHANGED,
 	NUM_SIGNALS
 };
 
@@ -249,11 +392,9 @@ gedit_file_browser_store_finalize (GObject *object)
 	/* Free all the nodes */
 	file_browser_node_free (obj, obj->priv->root);
 
-	if (obj->priv->binary_patterns != NULL)
-	{
-		g_strfreev (obj->priv->binary_patterns);
-		g_ptr_array_unref (obj->priv->binary_pattern_specs);
-	}
+	g_strfreev (obj->priv->binary_patterns);
+	gedit_file_browser_matcher_free (obj->priv->binary_matcher);
+	gedit_file_browser_matcher_free (obj->priv->filter_matcher);
 
 	/* Cancel any asynchronous operations */
 	for (GSList *item = obj->priv->async_handles; item; item = item->next)
@@ -302,6 +443,12 @@ gedit_file_browser_store_get_property (GObject    *object,
 		case PROP_BINARY_PATTERNS:
 			g_value_set_boxed (value, obj->priv->binary_patterns);
 			break;
+		case PROP_MONITOR_QUEUE_DEPTH:
+			g_value_set_uint (value, obj->priv->monitor_queue_depth);
+			break;
+		case PROP_MONITOR_EVENTS_DROPPED:
+			g_value_set_uint (value, obj->priv->monitor_events_dropped);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -371,6 +518,20 @@ gedit_file_browser_store_class_init (GeditFileBrowserStoreClass *klass)
 					 		     G_TYPE_STRV,
 					 		     G_PARAM_READWRITE));
 
+	g_object_class_install_property (object_class, PROP_MONITOR_QUEUE_DEPTH,
+					 g_param_spec_uint ("monitor-queue-depth",
+							    "Monitor Queue Depth",
+							    "The number of files with pending monitor events",
+							    0, G_MAXUINT, 0,
+							    G_PARAM_READABLE));
+
+	g_object_class_install_property (object_class, PROP_MONITOR_EVENTS_DROPPED,
+					 g_param_spec_uint ("monitor-events-dropped",
+							    "Monitor Events Dropped",
+							    "The number of monitor events coalesced or ignored",
+							    0, G_MAXUINT, 0,
+							    G_PARAM_READABLE));
+
 	model_signals[BEGIN_LOADING] =
 	    g_signal_new ("begin-loading",
 			  G_OBJECT_CLASS_TYPE (object_class),
@@ -433,6 +594,18 @@ gedit_file_browser_store_class_init (GeditFileBrowserStoreClass *klass)
 			  NULL, NULL, NULL,
 			  G_TYPE_NONE, 1,
 			  GTK_TYPE_TREE_PATH | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+	/* Emitted when the monitor events of a loaded directory have been
+	   applied, with the files created or changed and the files deleted */
+	model_signals[FILES_CHANGED] =
+	    g_signal_new ("files-changed",
+			  G_OBJECT_CLASS_TYPE (object_class),
+			  G_SIGNAL_RUN_LAST,
+			  G_STRUCT_OFFSET (GeditFileBrowserStoreClass, files_changed),
+			  NULL, NULL, NULL,
+			  G_TYPE_NONE, 2,
+			  G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE,
+			  G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
 }
 
 static void
@@ -482,6 +655,7 @@ gedit_file_browser_store_init (GeditFileBrowserStore *obj)
 	/* Default filter mode is hiding the hidden files */
 	obj->priv->filter_mode = gedit_file_browser_store_filter_mode_get_default ();
 	obj->priv->sort_func = model_sort_default;
+	obj->priv->visible_index_stamp = 1;
 }
 
 static gboolean
@@ -531,6 +705,219 @@ model_node_inserted (GeditFileBrowserStore *model,
 	       (model_node_visibility (model, node) && node->inserted);
 }
 
+static FileBrowserNode *
+dir_get_child (FileBrowserNodeDir *dir,
+	       guint               index)
+{
+	return g_ptr_array_index (dir->children, index);
+}
+
+static void
+dir_renumber_children (FileBrowserNodeDir *dir,
+		       guint               from)
+{
+	for (guint i = from; i < dir->children->len; i++)
+		dir_get_child (dir, i)->index = i;
+}
+
+/* To call when the children array of @node changes. */
+static void
+dir_invalidate_visible_index (FileBrowserNode *node)
+{
+	if (node != NULL && NODE_IS_DIR (node))
+		FILE_BROWSER_NODE_DIR (node)->visible_index_stamp = 0;
+}
+
+/* To call when the files of the children of @node change. */
+static void
+dir_clear_reconcile_nodes (FileBrowserNode *node)
+{
+	if (node != NULL && NODE_IS_DIR (node))
+		g_clear_pointer (&FILE_BROWSER_NODE_DIR (node)->reconcile_nodes, g_hash_table_unref);
+}
+
+static void
+model_invalidate_visible_index (GeditFileBrowserStore *model)
+{
+	model->priv->visible_index_stamp++;
+
+	if (model->priv->visible_index_stamp == 0)
+		model->priv->visible_index_stamp++;
+}
+
+static void
+model_set_virtual_root (GeditFileBrowserStore *model,
+			FileBrowserNode       *node)
+{
+	model->priv->virtual_root = node;
+	model_invalidate_visible_index (model);
+}
+
+static gboolean
+dir_visible_index_valid (GeditFileBrowserStore *model,
+			 FileBrowserNodeDir    *dir)
+{
+	return dir->visible_index_stamp == model->priv->visible_index_stamp;
+}
+
+static guint *
+dir_get_visible_index (GeditFileBrowserStore *model,
+		       FileBrowserNodeDir    *dir)
+{
+	guint *tree;
+	guint n = dir->children->len;
+
+	if (dir_visible_index_valid (model, dir))
+		return (guint *) dir->visible_index->data;
+
+	g_array_set_size (dir->visible_index, n + 1);
+	tree = (guint *) dir->visible_index->data;
+	tree[0] = 0;
+	dir->n_inserted = 0;
+
+	for (guint i = 0; i < n; i++)
+	{
+		FileBrowserNode *child = dir_get_child (dir, i);
+
+		child->indexed = model_node_inserted (model, child);
+		tree[i + 1] = child->indexed ? 1 : 0;
+		dir->n_inserted += tree[i + 1];
+	}
+
+	/* Build the tree in place, in linear time */
+	for (guint i = 1; i <= n; i++)
+	{
+		guint parent = i + (i & -i);
+
+		if (parent <= n)
+			tree[parent] += tree[i];
+	}
+
+	dir->visible_index_stamp = model->priv->visible_index_stamp;
+
+	return tree;
+}
+
+/* To call when the inserted state of @node may have changed, that is its
+ * inserted flag or its visibility. */
+static void
+node_update_visible_index (GeditFileBrowserStore *model,
+			   FileBrowserNode       *node)
+{
+	FileBrowserNodeDir *dir;
+	gboolean inserted;
+	guint *tree;
+
+	if (node->parent == NULL)
+		return;
+
+	dir = FILE_BROWSER_NODE_DIR (node->parent);
+
+	/* It will be rebuilt when needed */
+	if (!dir_visible_index_valid (model, dir))
+		return;
+
+	inserted = model_node_inserted (model, node);
+
+	if (inserted == node->indexed)
+		return;
+
+	node->indexed = inserted;
+	tree = (guint *) dir->visible_index->data;
+
+	for (guint i = node->index + 1; i <= dir->children->len; i += i & -i)
+	{
+		if (inserted)
+			tree[i]++;
+		else
+			tree[i]--;
+	}
+
+	if (inserted)
+		dir->n_inserted++;
+	else
+		dir->n_inserted--;
+}
+
+static guint
+dir_n_inserted (GeditFileBrowserStore *model,
+		FileBrowserNodeDir    *dir)
+{
+	dir_get_visible_index (model, dir);
+	return dir->n_inserted;
+}
+
+/* Returns the number of inserted children among the first @n ones. */
+static guint
+dir_count_inserted (GeditFileBrowserStore *model,
+		    FileBrowserNodeDir    *dir,
+		    guint                  n)
+{
+	guint *tree = dir_get_visible_index (model, dir);
+	guint num = 0;
+
+	for (guint i = n; i > 0; i -= i & -i)
+		num += tree[i];
+
+	return num;
+}
+
+/* Returns the number of inserted siblings before @node. */
+static guint
+node_inserted_rank (GeditFileBrowserStore *model,
+		    FileBrowserNode       *node)
+{
+	return dir_count_inserted (model, FILE_BROWSER_NODE_DIR (node->parent), node->index);
+}
+
+static FileBrowserNode *
+dir_nth_inserted (GeditFileBrowserStore *model,
+		  FileBrowserNodeDir    *dir,
+		  guint                  n)
+{
+	guint *tree = dir_get_visible_index (model, dir);
+	guint len = dir->children->len;
+	guint pos = 0;
+	guint step = 1;
+
+	if (n >= dir->n_inserted)
+		return NULL;
+
+	while (step <= len / 2)
+		step <<= 1;
+
+	/* Find the last position having at most n inserted children up to
+	 * it, the next child is the nth inserted one */
+	for (; step > 0; step >>= 1)
+	{
+		if (pos + step <= len && tree[pos + step] <= n)
+		{
+			pos += step;
+			n -= tree[pos];
+		}
+	}
+
+	return dir_get_child (dir, pos);
+}
+
+static gboolean
+dir_has_inserted_child (GeditFileBrowserStore *model,
+			FileBrowserNodeDir    *dir)
+{
+	if (dir_visible_index_valid (model, dir))
+		return dir->n_inserted > 0;
+
+	/* Cheaper than rebuilding the visible index, the first real child is
+	 * usually inserted. */
+	for (guint i = 0; i < dir->children->len; i++)
+	{
+		if (model_node_inserted (model, dir_get_child (dir, i)))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
 /* Interface implementation */
 
 static GtkTreeModelFlags
@@ -578,32 +965,19 @@ gedit_file_browser_store_get_iter (GtkTreeModel *tree_model,
 
 	for (guint i = 0; i < depth; ++i)
 	{
-		GSList *item;
-		gint num = 0;
-
 		if (node == NULL)
 			return FALSE;
 
 		if (!NODE_IS_DIR (node))
 			return FALSE;
 
-		for (item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-		{
-			FileBrowserNode *child = (FileBrowserNode *)(item->data);
-
-			if (model_node_inserted (model, child))
-			{
-				if (num == indices[i])
-					break;
+		if (indices[i] < 0)
+			return FALSE;
 
-				num++;
-			}
-		}
+		node = dir_nth_inserted (model, FILE_BROWSER_NODE_DIR (node), indices[i]);
 
-		if (item == NULL)
+		if (node == NULL)
 			return FALSE;
-
-		node = (FileBrowserNode *)(item->data);
 	}
 
 	iter->user_data = node;
@@ -618,7 +992,6 @@ gedit_file_browser_store_get_path_real (GeditFileBrowserStore *model,
 					FileBrowserNode       *node)
 {
 	GtkTreePath *path = gtk_tree_path_new ();
-	gint num = 0;
 
 	while (node != model->priv->virtual_root)
 	{
@@ -628,32 +1001,17 @@ gedit_file_browser_store_get_path_real (GeditFileBrowserStore *model,
 			return NULL;
 		}
 
-		num = 0;
-
-		for (GSList *item = FILE_BROWSER_NODE_DIR (node->parent)->children; item; item = item->next)
+		/* The node itself may not be inserted yet */
+		if (!model_node_visibility (model, node))
 		{
-			FileBrowserNode *check = (FileBrowserNode *)(item->data);
-
-			if (model_node_visibility (model, check) && (check == node || check->inserted))
-			{
-				if (check == node)
-				{
-					gtk_tree_path_prepend_index (path, num);
-					break;
-				}
-
-				++num;
-			}
-			else if (check == node)
-			{
-				if (NODE_IS_DUMMY (node))
-					g_warning ("Dummy not visible???");
+			if (NODE_IS_DUMMY (node))
+				g_warning ("Dummy not visible???");
 
-				gtk_tree_path_free (path);
-				return NULL;
-			}
+			gtk_tree_path_free (path);
+			return NULL;
 		}
 
+		gtk_tree_path_prepend_index (path, node_inserted_rank (model, node));
 		node = node->parent;
 	}
 
@@ -700,7 +1058,8 @@ gedit_file_browser_store_get_value (GtkTreeModel *tree_model,
 			g_value_set_uint (value, node->flags);
 			break;
 		case GEDIT_FILE_BROWSER_STORE_COLUMN_ICON:
-			g_value_set_object (value, node->icon);
+			if (node->icon != NULL)
+				g_value_set_object (value, gedit_file_browser_icon_get_pixbuf (node->icon));
 			break;
 		case GEDIT_FILE_BROWSER_STORE_COLUMN_ICON_NAME:
 			g_value_set_string (value, node->icon_name);
@@ -709,7 +1068,8 @@ gedit_file_browser_store_get_value (GtkTreeModel *tree_model,
 			g_value_set_string (value, node->name);
 			break;
 		case GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM:
-			g_value_set_object (value, node->emblem);
+			if (node->icon != NULL)
+				g_value_set_object (value, gedit_file_browser_icon_get_emblem (node->icon));
 			break;
 		default:
 			g_return_if_reached ();
@@ -722,7 +1082,8 @@ gedit_file_browser_store_iter_next (GtkTreeModel *tree_model,
 {
 	GeditFileBrowserStore *model;
 	FileBrowserNode *node;
-	GSList *first;
+	FileBrowserNodeDir *dir;
+	FileBrowserNode *next;
 
 	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model), FALSE);
 	g_return_val_if_fail (iter != NULL, FALSE);
@@ -734,18 +1095,17 @@ gedit_file_browser_store_iter_next (GtkTreeModel *tree_model,
 	if (node->parent == NULL)
 		return FALSE;
 
-	first = g_slist_next (g_slist_find (FILE_BROWSER_NODE_DIR (node->parent)->children, node));
+	dir = FILE_BROWSER_NODE_DIR (node->parent);
 
-	for (GSList *item = first; item; item = item->next)
-	{
-		if (model_node_inserted (model, (FileBrowserNode *)(item->data)))
-		{
-			iter->user_data = item->data;
-			return TRUE;
-		}
-	}
+	/* The next inserted child is the one with as many inserted children
+	 * before it as up to and including this node */
+	next = dir_nth_inserted (model, dir, dir_count_inserted (model, dir, node->index + 1));
 
-	return FALSE;
+	if (next == NULL)
+		return FALSE;
+
+	iter->user_data = next;
+	return TRUE;
 }
 
 static gboolean
@@ -772,16 +1132,13 @@ gedit_file_browser_store_iter_children (GtkTreeModel *tree_model,
 	if (!NODE_IS_DIR (node))
 		return FALSE;
 
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-	{
-		if (model_node_inserted (model, (FileBrowserNode *)(item->data)))
-		{
-			iter->user_data = item->data;
-			return TRUE;
-		}
-	}
+	node = dir_nth_inserted (model, FILE_BROWSER_NODE_DIR (node), 0);
 
-	return FALSE;
+	if (node == NULL)
+		return FALSE;
+
+	iter->user_data = node;
+	return TRUE;
 }
 
 static gboolean
@@ -791,13 +1148,7 @@ filter_tree_model_iter_has_child_real (GeditFileBrowserStore *model,
 	if (!NODE_IS_DIR (node))
 		return FALSE;
 
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-	{
-		if (model_node_inserted (model, (FileBrowserNode *)(item->data)))
-			return TRUE;
-	}
-
-	return FALSE;
+	return dir_has_inserted_child (model, FILE_BROWSER_NODE_DIR (node));
 }
 
 static gboolean
@@ -826,7 +1177,6 @@ gedit_file_browser_store_iter_n_children (GtkTreeModel *tree_model,
 {
 	FileBrowserNode *node;
 	GeditFileBrowserStore *model;
-	gint num = 0;
 
 	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model), FALSE);
 	g_return_val_if_fail (iter == NULL || iter->user_data != NULL, FALSE);
@@ -841,13 +1191,7 @@ gedit_file_browser_store_iter_n_children (GtkTreeModel *tree_model,
 	if (!NODE_IS_DIR (node))
 		return 0;
 
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-	{
-		if (model_node_inserted (model, (FileBrowserNode *)(item->data)))
-			++num;
-	}
-
-	return num;
+	return dir_n_inserted (model, FILE_BROWSER_NODE_DIR (node));
 }
 
 static gboolean
@@ -858,7 +1202,6 @@ gedit_file_browser_store_iter_nth_child (GtkTreeModel *tree_model,
 {
 	FileBrowserNode *node;
 	GeditFileBrowserStore *model;
-	gint num = 0;
 
 	g_return_val_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model), FALSE);
 	g_return_val_if_fail (parent == NULL || parent->user_data != NULL, FALSE);
@@ -870,24 +1213,16 @@ gedit_file_browser_store_iter_nth_child (GtkTreeModel *tree_model,
 	else
 		node = (FileBrowserNode *)(parent->user_data);
 
-	if (!NODE_IS_DIR (node))
+	if (!NODE_IS_DIR (node) || n < 0)
 		return FALSE;
 
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-	{
-		if (model_node_inserted (model, (FileBrowserNode *)(item->data)))
-		{
-			if (num == n)
-			{
-				iter->user_data = item->data;
-				return TRUE;
-			}
+	node = dir_nth_inserted (model, FILE_BROWSER_NODE_DIR (node), n);
 
-			++num;
-		}
-	}
+	if (node == NULL)
+		return FALSE;
 
-	return FALSE;
+	iter->user_data = node;
+	return TRUE;
 }
 
 static gboolean
@@ -923,6 +1258,7 @@ gedit_file_browser_store_row_inserted (GtkTreeModel *tree_model,
 	FileBrowserNode *node = (FileBrowserNode *)(iter->user_data);
 
 	node->inserted = TRUE;
+	node_update_visible_index (GEDIT_FILE_BROWSER_STORE (tree_model), node);
 }
 
 static gboolean
@@ -1001,80 +1337,77 @@ model_end_loading (GeditFileBrowserStore *model,
 	g_signal_emit (model, model_signals[END_LOADING], 0, &iter);
 }
 
-static void
-model_node_update_visibility (GeditFileBrowserStore *model,
-			      FileBrowserNode       *node)
+/* Called with the filtered flag of @node unset */
+static gboolean
+model_node_is_filtered (GeditFileBrowserStore *model,
+			FileBrowserNode       *node)
 {
 	GtkTreeIter iter;
 
-	node->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
-
 	if (FILTER_HIDDEN (model->priv->filter_mode) &&
 	    NODE_IS_HIDDEN (node))
 	{
-		node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
-		return;
+		return TRUE;
 	}
 
 	if (FILTER_BINARY (model->priv->filter_mode) && !NODE_IS_DIR (node))
 	{
 		if (!NODE_IS_TEXT (node))
 		{
-			node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
-			return;
+			return TRUE;
 		}
-		else if (model->priv->binary_patterns != NULL)
+		else if (model->priv->binary_matcher != NULL &&
+			 gedit_file_browser_matcher_match (model->priv->binary_matcher, node->name))
 		{
-			gssize name_length = strlen (node->name);
-			gchar *name_reversed = g_utf8_strreverse (node->name, name_length);
-
-			for (guint i = 0; i < model->priv->binary_pattern_specs->len; ++i)
-			{
-				GPatternSpec *spec = g_ptr_array_index (model->priv->binary_pattern_specs, i);
-
-				if (g_pattern_spec_match (spec, name_length, node->name, name_reversed))
-				{
-					node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
-					g_free (name_reversed);
-					return;
-				}
-			}
-
-			g_free (name_reversed);
+			return TRUE;
 		}
 	}
 
+	if (model->priv->filter_matcher != NULL &&
+	    !NODE_IS_DIR (node) && !NODE_IS_DUMMY (node) && node->name != NULL &&
+	    !gedit_file_browser_matcher_match (model->priv->filter_matcher, node->name))
+	{
+		return TRUE;
+	}
+
 	if (model->priv->filter_func)
 	{
 		iter.user_data = node;
 
 		if (!model->priv->filter_func (model, &iter, model->priv->filter_user_data))
-			node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
+			return TRUE;
 	}
+
+	return FALSE;
+}
+
+static void
+model_node_update_visibility (GeditFileBrowserStore *model,
+			      FileBrowserNode       *node)
+{
+	node->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
+
+	if (model_node_is_filtered (model, node))
+		node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_FILTERED;
+
+	node_update_visible_index (model, node);
 }
 
 static gint
 collate_nodes (FileBrowserNode *node1,
 	       FileBrowserNode *node2)
 {
-	if (node1->name == NULL)
+	if (node1->collate_key == NULL)
 	{
 		return -1;
 	}
-	else if (node2->name == NULL)
+	else if (node2->collate_key == NULL)
 	{
 		return 1;
 	}
 	else
 	{
-		gchar *k1 = g_utf8_collate_key_for_filename (node1->name, -1);
-		gchar *k2 = g_utf8_collate_key_for_filename (node2->name, -1);
-		gint result = strcmp (k1, k2);
-
-		g_free (k1);
-		g_free (k2);
-
-		return result;
+		return strcmp (node1->collate_key, node2->collate_key);
 	}
 }
 
@@ -1099,6 +1432,25 @@ model_sort_default (FileBrowserNode *node1,
 	return collate_nodes (node1, node2);
 }
 
+static gint
+compare_nodes (gconstpointer a,
+	       gconstpointer b,
+	       gpointer      user_data)
+{
+	GeditFileBrowserStore *model = GEDIT_FILE_BROWSER_STORE (user_data);
+
+	return model->priv->sort_func (*(FileBrowserNode **)a, *(FileBrowserNode **)b);
+}
+
+static void
+dir_sort_children (GeditFileBrowserStore *model,
+		   FileBrowserNodeDir    *dir)
+{
+	g_ptr_array_sort_with_data (dir->children, compare_nodes, model);
+	dir_renumber_children (dir, 0);
+	dir_invalidate_visible_index ((FileBrowserNode *)dir);
+}
+
 static void
 model_resort_node (GeditFileBrowserStore *model,
 		   FileBrowserNode       *node)
@@ -1108,7 +1460,7 @@ model_resort_node (GeditFileBrowserStore *model,
 	if (!model_node_visibility (model, node->parent))
 	{
 		/* Just sort the children of the parent */
-		dir->children = g_slist_sort (dir->children, (GCompareFunc)(model->priv->sort_func));
+		dir_sort_children (model, dir);
 	}
 	else
 	{
@@ -1118,22 +1470,22 @@ model_resort_node (GeditFileBrowserStore *model,
 		gint pos = 0;
 
 		/* Store current positions */
-		for (GSList *item = dir->children; item; item = item->next)
+		for (guint i = 0; i < dir->children->len; i++)
 		{
-			FileBrowserNode *child = (FileBrowserNode *)(item->data);
+			FileBrowserNode *child = dir_get_child (dir, i);
 
 			if (model_node_visibility (model, child))
 				child->pos = pos++;
 		}
 
-		dir->children = g_slist_sort (dir->children, (GCompareFunc)(model->priv->sort_func));
+		dir_sort_children (model, dir);
 		neworder = g_new (gint, pos);
 		pos = 0;
 
 		/* Store the new positions */
-		for (GSList *item = dir->children; item; item = item->next)
+		for (guint i = 0; i < dir->children->len; i++)
 		{
-			FileBrowserNode *child = (FileBrowserNode *)(item->data);
+			FileBrowserNode *child = dir_get_child (dir, i);
 
 			if (model_node_visibility (model, child))
 				neworder[pos++] = child->pos;
@@ -1209,6 +1561,7 @@ row_deleted (GeditFileBrowserStore *model,
 
 	hidden = FILE_IS_HIDDEN (node->flags);
 	node->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
+	node_update_visible_index (model, node);
 
 	/* Create temporary copies of the path as the signals may alter it */
 
@@ -1221,11 +1574,27 @@ row_deleted (GeditFileBrowserStore *model,
 	if (hidden)
 		node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
 
+	node_update_visible_index (model, node);
+
 	copy = gtk_tree_path_copy (path);
 	gtk_tree_model_row_deleted (GTK_TREE_MODEL (model), copy);
 	gtk_tree_path_free (copy);
 }
 
+/* The path that @node, in the tree, has or would have once visible, or NULL if
+   its parent is not visible. */
+static GtkTreePath *
+model_get_refilter_path (GeditFileBrowserStore *model,
+			 FileBrowserNode       *node)
+{
+	GtkTreePath *path = gedit_file_browser_store_get_path_real (model, node->parent);
+
+	if (path != NULL)
+		gtk_tree_path_append_index (path, node_inserted_rank (model, node));
+
+	return path;
+}
+
 static void
 model_refilter_node (GeditFileBrowserStore  *model,
 		     FileBrowserNode        *node,
@@ -1234,7 +1603,6 @@ model_refilter_node (GeditFileBrowserStore  *model,
 	gboolean old_visible;
 	gboolean new_visible;
 	FileBrowserNodeDir *dir;
-	GSList *item;
 	GtkTreeIter iter;
 	GtkTreePath *tmppath = NULL;
 	gboolean in_tree;
@@ -1250,10 +1618,14 @@ model_refilter_node (GeditFileBrowserStore  *model,
 	if (path == NULL)
 	{
 		if (in_tree)
-			tmppath = gedit_file_browser_store_get_path_real (model, node);
+			tmppath = model_get_refilter_path (model, node);
 		else
 			tmppath = gtk_tree_path_new_first ();
 
+		/* No row to insert or delete under a hidden parent */
+		if (tmppath == NULL)
+			return;
+
 		path = &tmppath;
 	}
 
@@ -1264,8 +1636,8 @@ model_refilter_node (GeditFileBrowserStore  *model,
 
 		dir = FILE_BROWSER_NODE_DIR (node);
 
-		for (item = dir->children; item; item = item->next)
-			model_refilter_node (model, (FileBrowserNode *)(item->data), path);
+		for (guint i = 0; i < dir->children->len; i++)
+			model_refilter_node (model, dir_get_child (dir, i), path);
 
 		if (in_tree)
 			gtk_tree_path_up (*path);
@@ -1311,6 +1683,7 @@ file_browser_node_set_name (FileBrowserNode *node)
 {
 	g_free (node->name);
 	g_free (node->markup);
+	g_free (node->collate_key);
 
 	if (node->file)
 		node->name = gedit_file_browser_utils_file_basename (node->file);
@@ -1318,9 +1691,15 @@ file_browser_node_set_name (FileBrowserNode *node)
 		node->name = NULL;
 
 	if (node->name)
+	{
 		node->markup = g_markup_escape_text (node->name, -1);
+		node->collate_key = g_utf8_collate_key_for_filename (node->name, -1);
+	}
 	else
+	{
 		node->markup = NULL;
+		node->collate_key = NULL;
+	}
 }
 
 static void
@@ -1358,6 +1737,8 @@ file_browser_node_dir_new (GeditFileBrowserStore *model,
 
 	node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_DIRECTORY;
 
+	FILE_BROWSER_NODE_DIR (node)->children = g_ptr_array_new ();
+	FILE_BROWSER_NODE_DIR (node)->visible_index = g_array_new (FALSE, FALSE, sizeof (guint));
 	FILE_BROWSER_NODE_DIR (node)->model = model;
 
 	return node;
@@ -1367,14 +1748,18 @@ static void
 file_browser_node_free_children (GeditFileBrowserStore *model,
 				 FileBrowserNode       *node)
 {
+	FileBrowserNodeDir *dir;
+
 	if (node == NULL || !NODE_IS_DIR (node))
 		return;
 
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
-		file_browser_node_free (model, (FileBrowserNode *)(item->data));
+	dir = FILE_BROWSER_NODE_DIR (node);
+
+	for (guint i = 0; i < dir->children->len; i++)
+		file_browser_node_free (model, dir_get_child (dir, i));
 
-	g_slist_free (FILE_BROWSER_NODE_DIR (node)->children);
-	FILE_BROWSER_NODE_DIR (node)->children = NULL;
+	g_ptr_array_set_size (dir->children, 0);
+	dir_invalidate_visible_index (node);
 
 	/* This node is no longer loaded */
 	node->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_LOADED;
@@ -1399,13 +1784,30 @@ file_browser_node_free (GeditFileBrowserStore *model,
 			model_end_loading (model, node);
 		}
 
+		dir_clear_reconcile_nodes (node);
 		file_browser_node_free_children (model, node);
+		g_ptr_array_unref (dir->children);
+		g_array_unref (dir->visible_index);
 
 		if (dir->monitor)
 		{
 			g_file_monitor_cancel (dir->monitor);
 			g_object_unref (dir->monitor);
 		}
+
+		model_clear_monitor_queue (model, dir);
+	}
+
+	/* Not to be found when reconciling the parent anymore */
+	if (node->parent != NULL && node->file != NULL)
+	{
+		GHashTable *reconcile_nodes = FILE_BROWSER_NODE_DIR (node->parent)->reconcile_nodes;
+
+		if (reconcile_nodes != NULL &&
+		    g_hash_table_lookup (reconcile_nodes, node->file) == node)
+		{
+			g_hash_table_remove (reconcile_nodes, node->file);
+		}
 	}
 
 	if (node->file)
@@ -1414,15 +1816,12 @@ file_browser_node_free (GeditFileBrowserStore *model,
 		g_object_unref (node->file);
 	}
 
-	if (node->icon)
-		g_object_unref (node->icon);
-
-	if (node->emblem)
-		g_object_unref (node->emblem);
+	g_clear_pointer (&node->icon, gedit_file_browser_icon_unref);
 
 	g_free (node->icon_name);
 	g_free (node->name);
 	g_free (node->markup);
+	g_free (node->collate_key);
 
 	if (NODE_IS_DIR (node))
 		g_slice_free (FileBrowserNodeDir, (FileBrowserNodeDir *)node);
@@ -1449,14 +1848,17 @@ model_remove_node_children (GeditFileBrowserStore *model,
 {
 	FileBrowserNodeDir *dir;
 	GtkTreePath *path_child;
-	GSList *list;
+	GPtrArray *children;
+	guint *ranks;
+	guint first;
+	guint shift = 0;
 
 	if (node == NULL || !NODE_IS_DIR (node))
 		return;
 
 	dir = FILE_BROWSER_NODE_DIR (node);
 
-	if (dir->children == NULL)
+	if (dir->children->len == 0)
 		return;
 
 	if (!model_node_visibility (model, node))
@@ -1473,14 +1875,38 @@ model_remove_node_children (GeditFileBrowserStore *model,
 	else
 		path_child = gtk_tree_path_copy (path);
 
-	gtk_tree_path_down (path_child);
+	gtk_tree_path_append_index (path_child, 0);
+
+	children = g_ptr_array_copy (dir->children, NULL, NULL);
+	ranks = g_new (guint, children->len + 1);
+	ranks[0] = 0;
+
+	for (guint i = 0; i < children->len; i++)
+		ranks[i + 1] = ranks[i] + (model_node_inserted (model, g_ptr_array_index (children, i)) ? 1 : 0);
 
-	list = g_slist_copy (dir->children);
+	/* The dummy goes first, as it always did */
+	first = 0;
+
+	if (NODE_IS_DUMMY ((FileBrowserNode *)g_ptr_array_index (children, 0)))
+	{
+		/* The dummy row may still be there if loading was interrupted */
+		shift = ranks[1];
+		first = 1;
+
+		model_remove_node (model, g_ptr_array_index (children, 0), path_child, free_nodes);
+	}
 
-	for (GSList *item = list; item; item = item->next)
-		model_remove_node (model, (FileBrowserNode *)(item->data), path_child, free_nodes);
+	/* Then remove the children from the last one, so that removing them
+	 * from the array is cheap and the paths of the ones before do not
+	 * change */
+	for (guint i = children->len; i > first; i--)
+	{
+		gtk_tree_path_get_indices (path_child)[gtk_tree_path_get_depth (path_child) - 1] = ranks[i - 1] - shift;
+		model_remove_node (model, g_ptr_array_index (children, i - 1), path_child, free_nodes);
+	}
 
-	g_slist_free (list);
+	g_free (ranks);
+	g_ptr_array_unref (children);
 	gtk_tree_path_free (path_child);
 }
 
@@ -1524,8 +1950,13 @@ model_remove_node (GeditFileBrowserStore *model,
 
 	/* Remove the node from the parents children list */
 	if (free_nodes && parent)
-		FILE_BROWSER_NODE_DIR (node->parent)->children =
-			g_slist_remove (FILE_BROWSER_NODE_DIR (node->parent)->children, node);
+	{
+		FileBrowserNodeDir *parent_dir = FILE_BROWSER_NODE_DIR (parent);
+
+		g_ptr_array_remove_index (parent_dir->children, node->index);
+		dir_renumber_children (parent_dir, node->index);
+		dir_invalidate_visible_index (parent);
+	}
 
 	/* If this is the virtual root, than set the parent as the virtual root */
 	if (node == model->priv->virtual_root)
@@ -1561,9 +1992,9 @@ model_clear (GeditFileBrowserStore *model,
 	{
 		FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (model->priv->virtual_root);
 
-		if (dir->children != NULL)
+		if (dir->children->len > 0)
 		{
-			FileBrowserNode *dummy = (FileBrowserNode *)(dir->children->data);
+			FileBrowserNode *dummy = dir_get_child (dir, 0);
 
 			if (NODE_IS_DUMMY (dummy) && model_node_visibility (model, dummy))
 			{
@@ -1602,6 +2033,8 @@ file_browser_node_unload (GeditFileBrowserStore *model,
 		dir->cancellable = NULL;
 	}
 
+	dir_clear_reconcile_nodes (node);
+
 	if (dir->monitor)
 	{
 		g_file_monitor_cancel (dir->monitor);
@@ -1610,85 +2043,84 @@ file_browser_node_unload (GeditFileBrowserStore *model,
 		dir->monitor = NULL;
 	}
 
+	model_clear_monitor_queue (model, dir);
+
 	node->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_LOADED;
 }
 
 static void
-model_recomposite_icon_real (GeditFileBrowserStore *tree_model,
-			     FileBrowserNode       *node,
-			     GFileInfo             *info)
+model_set_icon (FileBrowserNode *node,
+		GIcon           *gicon,
+		GdkPixbuf       *emblem)
 {
-	GdkPixbuf *icon;
+	GeditFileBrowserIcon *icon;
+	gint icon_size;
 
-	g_return_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model));
-	g_return_if_fail (node != NULL);
+	gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, &icon_size, NULL);
 
-	if (node->file == NULL)
-		return;
+	icon = gedit_file_browser_icon_cache_lookup (gicon, emblem, icon_size, 1);
 
-	if (info)
-	{
-		GIcon *gicon = g_file_info_get_icon (info);
+	g_clear_pointer (&node->icon, gedit_file_browser_icon_unref);
+	node->icon = icon;
+}
 
-		if (gicon != NULL)
-			icon = gedit_file_browser_utils_pixbuf_from_icon (gicon, GTK_ICON_SIZE_MENU);
-		else
-			icon = NULL;
-	}
-	else
-	{
-		icon = gedit_file_browser_utils_pixbuf_from_file (node->file, GTK_ICON_SIZE_MENU, FALSE);
-	}
+/* The icon of the node, queried if it has none yet. */
+static GIcon *
+model_dup_gicon (FileBrowserNode *node)
+{
+	GFileInfo *info;
+	GIcon *gicon = NULL;
 
-	/* Fallback to the same icon as the file browser */
-	if (!icon)
-		icon = gedit_file_browser_utils_pixbuf_from_theme ("text-x-generic", GTK_ICON_SIZE_MENU);
+	if (node->icon != NULL)
+		gicon = gedit_file_browser_icon_get_gicon (node->icon);
 
-	if (node->icon)
-		g_object_unref (node->icon);
+	if (gicon != NULL)
+		return g_object_ref (gicon);
 
-	if (node->emblem)
-	{
-		gint icon_size;
+	info = g_file_query_info (node->file,
+				  G_FILE_ATTRIBUTE_STANDARD_ICON,
+				  G_FILE_QUERY_INFO_NONE,
+				  NULL,
+				  NULL);
 
-		gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, NULL, &icon_size);
+	if (info != NULL)
+	{
+		gicon = g_file_info_get_icon (info);
 
-		if (icon == NULL)
-		{
-			node->icon = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (node->emblem),
-						     gdk_pixbuf_get_has_alpha (node->emblem),
-						     gdk_pixbuf_get_bits_per_sample (node->emblem),
-						     icon_size,
-						     icon_size);
-		}
-		else
-		{
-			node->icon = gdk_pixbuf_copy (icon);
-			g_object_unref (icon);
-		}
+		if (gicon != NULL)
+			g_object_ref (gicon);
 
-		gdk_pixbuf_composite (node->emblem, node->icon,
-				      icon_size - 10, icon_size - 10, 10,
-				      10, icon_size - 10, icon_size - 10,
-				      1, 1, GDK_INTERP_NEAREST, 255);
-	}
-	else
-	{
-		node->icon = icon;
+		g_object_unref (info);
 	}
+
+	return gicon;
 }
 
+/* The icon is taken from @info, or else kept. The emblem is kept. */
 static void
-model_recomposite_icon (GeditFileBrowserStore *tree_model,
-			GtkTreeIter           *iter)
+model_recomposite_icon_real (GeditFileBrowserStore *tree_model,
+			     FileBrowserNode       *node,
+			     GFileInfo             *info)
 {
+	GIcon *gicon;
+	GdkPixbuf *emblem;
+
 	g_return_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model));
-	g_return_if_fail (iter != NULL);
-	g_return_if_fail (iter->user_data != NULL);
+	g_return_if_fail (node != NULL);
+
+	if (node->file == NULL)
+		return;
+
+	if (info == NULL)
+		gicon = model_dup_gicon (node);
+	else if ((gicon = g_file_info_get_icon (info)) != NULL)
+		g_object_ref (gicon);
+
+	emblem = node->icon != NULL ? gedit_file_browser_icon_get_emblem (node->icon) : NULL;
 
-	model_recomposite_icon_real (tree_model,
-				     (FileBrowserNode *)(iter->user_data),
-				     NULL);
+	model_set_icon (node, gicon, emblem);
+
+	g_clear_object (&gicon);
 }
 
 static FileBrowserNode *
@@ -1736,23 +2168,26 @@ model_check_dummy (GeditFileBrowserStore *model,
 		GtkTreePath *path;
 		guint flags;
 
-		if (dir->children == NULL)
+		if (dir->children->len == 0)
 		{
 			model_add_dummy_node (model, node);
 			return;
 		}
 
-		dummy = (FileBrowserNode *)(dir->children->data);
+		dummy = dir_get_child (dir, 0);
 
 		if (!NODE_IS_DUMMY (dummy))
 		{
 			dummy = model_create_dummy_node (model, node);
-			dir->children = g_slist_prepend (dir->children, dummy);
+			g_ptr_array_insert (dir->children, 0, dummy);
+			dir_renumber_children (dir, 0);
+			dir_invalidate_visible_index (node);
 		}
 
 		if (!model_node_visibility (model, node))
 		{
 			dummy->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
+			node_update_visible_index (model, dummy);
 			return;
 		}
 
@@ -1760,10 +2195,12 @@ model_check_dummy (GeditFileBrowserStore *model,
 		   for real children */
 		flags = dummy->flags;
 		dummy->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
+		node_update_visible_index (model, dummy);
 
 		if (!filter_tree_model_iter_has_child_real (model, node))
 		{
 			dummy->flags &= ~GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
+			node_update_visible_index (model, dummy);
 
 			if (FILE_IS_HIDDEN (flags))
 			{
@@ -1796,11 +2233,30 @@ insert_node_sorted (GeditFileBrowserStore *model,
 		    FileBrowserNode       *parent)
 {
 	FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (parent);
+	guint low = 0;
+	guint high = dir->children->len;
 
 	if (model->priv->sort_func == NULL)
-		dir->children = g_slist_append (dir->children, child);
+	{
+		low = high;
+	}
 	else
-		dir->children = g_slist_insert_sorted (dir->children, child, (GCompareFunc)(model->priv->sort_func));
+	{
+		/* Before the first child that is not smaller */
+		while (low < high)
+		{
+			guint middle = low + (high - low) / 2;
+
+			if (model->priv->sort_func (dir_get_child (dir, middle), child) < 0)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+	}
+
+	g_ptr_array_insert (dir->children, low, child);
+	dir_renumber_children (dir, low);
+	dir_invalidate_visible_index (parent);
 }
 
 static void
@@ -1828,137 +2284,119 @@ model_add_node (GeditFileBrowserStore *model,
 	model_check_dummy (model, child);
 }
 
+/* Takes ownership of @children. @sorted is whether @children is already in
+ * the order of the sort function. */
 static void
 model_add_nodes_batch (GeditFileBrowserStore *model,
-		       GSList                *children,
-		       FileBrowserNode       *parent)
+		       GPtrArray             *children,
+		       FileBrowserNode       *parent,
+		       gboolean               sorted)
 {
 	FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (parent);
-	GSList *sorted_children = g_slist_sort (children, (GCompareFunc)model->priv->sort_func);
-	GSList *child = sorted_children;
-	GSList *prev = NULL;
-	GSList *l = dir->children;
+	GPtrArray *merged;
+	GtkTreePath *parent_path = NULL;
+	guint old_pos = 0;
+	guint new_pos = 0;
+	guint rank = 0;
+
+	if (!sorted)
+		g_ptr_array_sort_with_data (children, compare_nodes, model);
 
 	model_check_dummy (model, parent);
 
-	while (child)
+	/* Merge the sorted children in one pass */
+	merged = g_ptr_array_sized_new (dir->children->len + children->len);
+
+	while (old_pos < dir->children->len || new_pos < children->len)
 	{
-		FileBrowserNode *node = child->data;
-		GtkTreeIter iter;
-		GtkTreePath *path;
+		FileBrowserNode *node;
 
-		/* Reached the end of the first list, just append the second */
-		if (l == NULL)
+		if (new_pos == children->len ||
+		    (old_pos < dir->children->len &&
+		     model->priv->sort_func (dir_get_child (dir, old_pos),
+					     g_ptr_array_index (children, new_pos)) <= 0))
 		{
-			dir->children = g_slist_concat (dir->children, child);
-
-			for (l = child; l; l = l->next)
-			{
-				if (model_node_visibility (model, parent) &&
-				    model_node_visibility (model, l->data))
-				{
-					iter.user_data = l->data;
-					path = gedit_file_browser_store_get_path_real (model, l->data);
-
-					/* Emit row inserted */
-					row_inserted (model, &path, &iter);
-					gtk_tree_path_free (path);
-				}
-
-				model_check_dummy (model, l->data);
-			}
-
-			break;
+			node = dir_get_child (dir, old_pos++);
 		}
-
-		if (model->priv->sort_func (l->data, node) > 0)
+		else
 		{
-			GSList *next_child;
+			node = g_ptr_array_index (children, new_pos++);
+		}
 
-			if (prev == NULL)
-			{
-				/* Prepend to the list */
-				dir->children = g_slist_prepend (dir->children, child);
-			}
-			else
-			{
-				prev->next = child;
-			}
+		node->index = merged->len;
+		g_ptr_array_add (merged, node);
+	}
 
-			next_child = child->next;
-			prev = child;
-			child->next = l;
-			child = next_child;
+	g_ptr_array_unref (dir->children);
+	dir->children = merged;
+	dir_invalidate_visible_index (parent);
 
-			if (model_node_visibility (model, parent) &&
-			    model_node_visibility (model, node))
-			{
-				iter.user_data = node;
-				path = gedit_file_browser_store_get_path_real (model, node);
+	if (model_node_visibility (model, parent))
+		parent_path = gedit_file_browser_store_get_path_real (model, parent);
 
-				/* Emit row inserted */
-				row_inserted (model, &path, &iter);
-				gtk_tree_path_free (path);
-			}
+	/* The new nodes are not inserted yet, so they are skipped by the
+	   model until their row is inserted, in order */
+	new_pos = 0;
 
-			model_check_dummy (model, node);
+	for (guint i = 0; i < dir->children->len && new_pos < children->len; i++)
+	{
+		FileBrowserNode *node = dir_get_child (dir, i);
 
-			/* Try again at the same l position with the next child */
-		}
-		else
+		if (node != g_ptr_array_index (children, new_pos))
 		{
-			/* Move to the next item in the list */
-			prev = l;
-			l = l->next;
+			if (model_node_inserted (model, node))
+				rank++;
+
+			continue;
 		}
-	}
-}
 
-static gchar const *
-backup_content_type (GFileInfo *info)
-{
-	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP) &&
-	    g_file_info_get_is_backup (info))
-	{
-		gchar const *content = g_file_info_get_content_type (info);
+		new_pos++;
 
-		if (content == NULL || g_content_type_equals (content, "application/x-trash"))
+		if (parent_path != NULL && model_node_visibility (model, node))
 		{
-			return "text/plain";
+			GtkTreePath *path = gtk_tree_path_copy (parent_path);
+			GtkTreeIter iter;
+
+			gtk_tree_path_append_index (path, rank);
+			iter.user_data = node;
+
+			/* Emit row inserted */
+			row_inserted (model, &path, &iter);
+			gtk_tree_path_free (path);
+
+			rank++;
 		}
 
-		return content;
+		model_check_dummy (model, node);
 	}
 
-	return NULL;
+	if (parent_path != NULL)
+		gtk_tree_path_free (parent_path);
+
+	g_ptr_array_unref (children);
 }
 
-static gboolean
-content_type_is_text (gchar const *content_type)
+/* Can be called in a worker thread. */
+static guint
+file_info_get_flags (GFileInfo *info)
 {
-#ifdef G_OS_WIN32
-	gchar *mime;
-	gboolean ret;
-#endif
-
-	if (!content_type || g_content_type_is_unknown (content_type))
-		return TRUE;
+	guint flags = 0;
 
-#ifndef G_OS_WIN32
-	return (g_content_type_is_a (content_type, "text/plain") ||
-		g_content_type_equals (content_type, "application/x-zerosize"));
-#else
-	if (g_content_type_is_a (content_type, "text"))
-		return TRUE;
+	if (gedit_file_browser_utils_file_info_is_hidden (info))
+	{
+		flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
+	}
 
-	/* This covers a rare case in which on Windows the PerceivedType is
-	   not set to "text" but the Content Type is set to text/plain */
-	mime = g_content_type_get_mime_type (content_type);
-	ret = g_strcmp0 (mime, "text/plain") == 0;
-	g_free (mime);
+	if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY)
+	{
+		flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_DIRECTORY;
+	}
+	else if (gedit_file_browser_utils_file_info_is_text (info))
+	{
+		flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_TEXT;
+	}
 
-	return ret;
-#endif
+	return flags;
 }
 
 static void
@@ -1967,9 +2405,7 @@ file_browser_node_set_from_info (GeditFileBrowserStore *model,
 				 GFileInfo             *info,
 				 gboolean               isadded)
 {
-	gchar const *content;
 	gboolean free_info = FALSE;
-	GtkTreePath *path;
 	gchar *uri;
 	GError *error = NULL;
 
@@ -1997,26 +2433,7 @@ file_browser_node_set_from_info (GeditFileBrowserStore *model,
 		free_info = TRUE;
 	}
 
-	if ((g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN) &&
-	     g_file_info_get_is_hidden (info)) ||
-	    (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP) &&
-	     g_file_info_get_is_backup (info)))
-	{
-		node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN;
-	}
-
-	if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY)
-	{
-		node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_DIRECTORY;
-	}
-	else
-	{
-		if (!(content = backup_content_type (info)))
-			content = g_file_info_get_content_type (info);
-
-		if (content_type_is_text (content))
-			node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_IS_TEXT;
-	}
+	node->flags |= file_info_get_flags (info);
 
 	model_recomposite_icon_real (model, node, info);
 
@@ -2025,10 +2442,7 @@ file_browser_node_set_from_info (GeditFileBrowserStore *model,
 
 	if (isadded)
 	{
-		path = gedit_file_browser_store_get_path_real (model, node);
-		model_refilter_node (model, node, &path);
-		gtk_tree_path_free (path);
-
+		model_refilter_node (model, node, NULL);
 		model_check_dummy (model, node->parent);
 	}
 	else
@@ -2038,12 +2452,12 @@ file_browser_node_set_from_info (GeditFileBrowserStore *model,
 }
 
 static FileBrowserNode *
-node_list_contains_file (GSList *children,
-			 GFile  *file)
+dir_find_child_by_file (FileBrowserNodeDir *dir,
+			GFile              *file)
 {
-	for (GSList *item = children; item; item = item->next)
+	for (guint i = 0; i < dir->children->len; i++)
 	{
-		FileBrowserNode *node = (FileBrowserNode *)(item->data);
+		FileBrowserNode *node = dir_get_child (dir, i);
 
 		if (node->file != NULL && g_file_equal (node->file, file))
 			return node;
@@ -2062,7 +2476,7 @@ model_add_node_from_file (GeditFileBrowserStore *model,
 	gboolean free_info = FALSE;
 	GError *error = NULL;
 
-	if ((node = node_list_contains_file (FILE_BROWSER_NODE_DIR (parent)->children, file)) == NULL)
+	if ((node = dir_find_child_by_file (FILE_BROWSER_NODE_DIR (parent), file)) == NULL)
 	{
 		if (info == NULL)
 		{
@@ -2101,88 +2515,1092 @@ model_add_node_from_file (GeditFileBrowserStore *model,
 	return node;
 }
 
-/* We pass in a copy of the list of parent->children so that we do
- * not have to check if a file already exists among the ones we just
- * added */
-static void
-model_add_nodes_from_files (GeditFileBrowserStore *model,
-			    FileBrowserNode       *parent,
-			    GSList                *original_children,
-			    GList                 *files)
-{
-	GSList *nodes = NULL;
+static FileBrowserNode *
+model_add_node_from_dir (GeditFileBrowserStore *model,
+			 FileBrowserNode       *parent,
+			 GFile                 *file)
+{
+	FileBrowserNode *node;
+
+	/* Check if it already exists */
+	if ((node = dir_find_child_by_file (FILE_BROWSER_NODE_DIR (parent), file)) == NULL)
+	{
+		node = file_browser_node_dir_new (model, file, parent);
+		file_browser_node_set_from_info (model, node, NULL, FALSE);
+
+		if (node->name == NULL)
+			file_browser_node_set_name (node);
+
+		node->icon_name = g_strdup ("folder-symbolic");
+
+		model_add_node (model, node, parent);
+	}
+
+	return node;
+}
+
+/* Directory loading.
+ *
+ * The children of a directory are enumerated in a worker thread, which also
+ * computes their flags, their name and their collate key, and sorts them by
+ * chunks. The sorted chunks are queued to the main thread, which creates the
+ * nodes and merges them in the model in batches sized by a time budget, so
+ * that a large directory, or a slow mount, never blocks a frame.
+ */
+
+static void
+load_entry_free (LoadEntry *entry)
+{
+	if (entry != NULL)
+	{
+		g_clear_object (&entry->file);
+		g_clear_object (&entry->info);
+		g_free (entry->name);
+		g_free (entry->markup);
+		g_free (entry->collate_key);
+		g_free (entry);
+	}
+}
+
+static void
+load_chunk_free (LoadChunk *chunk)
+{
+	if (chunk != NULL)
+	{
+		g_ptr_array_unref (chunk->entries);
+		g_clear_pointer (&chunk->removed, g_ptr_array_unref);
+		g_free (chunk);
+	}
+}
+
+static void
+async_node_clear (AsyncNode *async)
+{
+	g_object_unref (async->cancellable);
+	g_object_unref (async->location);
+	g_main_context_unref (async->context);
+	g_hash_table_unref (async->original_files);
+	g_queue_clear_full (&async->chunks, (GDestroyNotify) load_chunk_free);
+	g_mutex_clear (&async->mutex);
+}
+
+static void
+async_node_release (AsyncNode *async)
+{
+	g_atomic_rc_box_release_full (async, (GDestroyNotify) async_node_clear);
+}
+
+/* Can be called in a worker thread. */
+static gboolean
+file_info_is_listed (GFileInfo *info)
+{
+	GFileType type = g_file_info_get_file_type (info);
+	gchar const *name;
+
+	/* Skip all non regular, non directory files */
+	if (type != G_FILE_TYPE_REGULAR &&
+	    type != G_FILE_TYPE_DIRECTORY &&
+	    type != G_FILE_TYPE_SYMBOLIC_LINK)
+	{
+		return FALSE;
+	}
+
+	name = g_file_info_get_name (info);
+
+	/* Skip '.' and '..' directories */
+	if (type == G_FILE_TYPE_DIRECTORY &&
+	    (strcmp (name, ".") == 0 ||
+	     strcmp (name, "..") == 0))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Can be called in a worker thread. */
+static LoadEntry *
+load_entry_new_for_file (GFile     *file,
+			 GFileInfo *info)
+{
+	LoadEntry *entry;
+
+	entry = g_new0 (LoadEntry, 1);
+	entry->file = g_object_ref (file);
+	entry->info = g_object_ref (info);
+
+	/* The same name as file_browser_node_set_name(), without querying
+	   the display name of each local file again */
+	if (g_file_has_uri_scheme (file, "file") &&
+	    g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME))
+	{
+		entry->name = g_strdup (g_file_info_get_display_name (info));
+	}
+	else
+	{
+		entry->name = gedit_file_browser_utils_file_basename (file);
+	}
+
+	entry->markup = g_markup_escape_text (entry->name, -1);
+	entry->collate_key = g_utf8_collate_key_for_filename (entry->name, -1);
+	entry->flags = file_info_get_flags (info);
+
+	return entry;
+}
+
+/* In the worker thread. Returns %NULL for the children that are skipped. */
+static LoadEntry *
+load_entry_new (AsyncNode *async,
+		GFileInfo *info)
+{
+	LoadEntry *entry = NULL;
+	GFile *file;
+
+	if (!file_info_is_listed (info))
+		return NULL;
+
+	file = g_file_get_child (async->location, g_file_info_get_name (info));
+
+	if (!g_hash_table_contains (async->original_files, file))
+		entry = load_entry_new_for_file (file, info);
+
+	g_object_unref (file);
+
+	return entry;
+}
+
+/* The same order as model_sort_default(). */
+static gint
+compare_load_entries (gconstpointer a,
+		      gconstpointer b)
+{
+	LoadEntry const *entry1 = *(LoadEntry **)a;
+	LoadEntry const *entry2 = *(LoadEntry **)b;
+	gboolean dir1 = FILE_IS_DIR (entry1->flags);
+	gboolean dir2 = FILE_IS_DIR (entry2->flags);
+
+	if (dir1 != dir2)
+		return dir1 ? -1 : 1;
+
+	return strcmp (entry1->collate_key, entry2->collate_key);
+}
+
+static gboolean dispatch_load_chunks_cb (gpointer user_data);
+
+/* In the worker thread. Takes ownership of @entries and @removed. */
+static void
+async_node_push_chunk (AsyncNode *async,
+		       GPtrArray *entries,
+		       GPtrArray *removed)
+{
+	LoadChunk *chunk;
+	gboolean schedule;
+
+	g_ptr_array_sort (entries, compare_load_entries);
+
+	chunk = g_new0 (LoadChunk, 1);
+	chunk->entries = entries;
+	chunk->removed = removed;
+	chunk->reconcile = removed != NULL;
+
+	for (guint i = 0; i < entries->len && !chunk->reconcile; i++)
+		chunk->reconcile = ((LoadEntry *)g_ptr_array_index (entries, i))->replace;
+
+	g_mutex_lock (&async->mutex);
+	g_queue_push_tail (&async->chunks, chunk);
+	schedule = !async->dispatch_pending;
+	async->dispatch_pending = TRUE;
+	g_mutex_unlock (&async->mutex);
+
+	if (schedule)
+	{
+		GSource *source = g_idle_source_new ();
+
+		g_source_set_static_name (source, "[gedit] dispatch_load_chunks_cb");
+		g_source_set_callback (source,
+				       dispatch_load_chunks_cb,
+				       g_atomic_rc_box_acquire (async),
+				       (GDestroyNotify) async_node_release);
+		g_source_attach (source, async->context);
+		g_source_unref (source);
+	}
+}
+
+static GPtrArray *
+load_entries_new (void)
+{
+	return g_ptr_array_new_with_free_func ((GDestroyNotify) load_entry_free);
+}
+
+/* In the worker thread. */
+static void
+async_node_push_cached (AsyncNode  *async,
+			GHashTable *cached)
+{
+	GPtrArray *entries = load_entries_new ();
+	GHashTableIter iter;
+	GVariant *cache_entry;
+
+	g_hash_table_iter_init (&iter, cached);
+
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &cache_entry))
+	{
+		GFileInfo *info = gedit_file_browser_listing_cache_entry_to_info (cache_entry);
+		LoadEntry *entry;
+
+		if ((entry = load_entry_new (async, info)) != NULL)
+			g_ptr_array_add (entries, entry);
+
+		g_object_unref (info);
+	}
+
+	async_node_push_chunk (async, entries, NULL);
+}
+
+/* In the worker thread. @cached contains the entries of the cached listing
+ * that were not enumerated.
+ */
+static void
+async_node_push_removed (AsyncNode  *async,
+			 GHashTable *cached)
+{
+	GPtrArray *removed = g_ptr_array_new_with_free_func (g_object_unref);
+	GHashTableIter iter;
+	gchar const *name;
+
+	g_hash_table_iter_init (&iter, cached);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &name, NULL))
+		g_ptr_array_add (removed, g_file_get_child (async->location, name));
+
+	async_node_push_chunk (async, load_entries_new (), removed);
+}
+
+static void
+load_directory_thread (GTask        *task,
+		       gpointer      source_object,
+		       gpointer      task_data,
+		       GCancellable *cancellable)
+{
+	AsyncNode *async = task_data;
+	GFileEnumerator *enumerator;
+	GHashTable *cached;
+	GPtrArray *listing;
+	GPtrArray *entries = NULL;
+	gboolean changed;
+	gint64 start;
+	gint64 chunk_start = 0;
+	GError *error = NULL;
+
+	start = g_get_monotonic_time ();
+
+	/* Show the cached listing first, it is reconciled with the
+	   enumeration below */
+	cached = gedit_file_browser_listing_cache_read (async->location);
+
+	if (cached != NULL)
+		async_node_push_cached (async, cached);
+
+	changed = cached == NULL;
+
+	enumerator = g_file_enumerate_children (async->location,
+						LOAD_ATTRIBUTE_TYPES,
+						G_FILE_QUERY_INFO_NONE,
+						cancellable,
+						&error);
+
+	if (enumerator == NULL)
+	{
+		if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+			gedit_file_browser_listing_cache_remove (async->location);
+
+		g_clear_pointer (&cached, g_hash_table_unref);
+		g_task_return_error (task, error);
+		return;
+	}
+
+	listing = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref);
+
+	while (TRUE)
+	{
+		GFileInfo *info;
+		GVariant *cache_entry;
+		LoadEntry *entry;
+		gboolean replace = FALSE;
+
+		if (!g_file_enumerator_iterate (enumerator, &info, NULL, cancellable, &error) ||
+		    info == NULL)
+		{
+			break;
+		}
+
+		if (!file_info_is_listed (info))
+			continue;
+
+		cache_entry = gedit_file_browser_listing_cache_entry_new (info);
+		g_ptr_array_add (listing, cache_entry);
+
+		if (cached != NULL)
+		{
+			GVariant *cached_entry = g_hash_table_lookup (cached, g_file_info_get_name (info));
+
+			if (cached_entry != NULL)
+			{
+				replace = !g_variant_equal (cached_entry, cache_entry);
+				g_hash_table_remove (cached, g_file_info_get_name (info));
+
+				/* Already shown */
+				if (!replace)
+					continue;
+			}
+
+			changed = TRUE;
+		}
+
+		if ((entry = load_entry_new (async, info)) == NULL)
+			continue;
+
+		entry->replace = replace;
+
+		if (entries == NULL)
+		{
+			entries = load_entries_new ();
+			chunk_start = g_get_monotonic_time ();
+		}
+
+		g_ptr_array_add (entries, entry);
+
+		if (g_get_monotonic_time () - chunk_start >= DIRECTORY_LOAD_CHUNK_USEC)
+			async_node_push_chunk (async, g_steal_pointer (&entries), NULL);
+	}
+
+	if (entries != NULL)
+		async_node_push_chunk (async, entries, NULL);
+
+	g_file_enumerator_close (enumerator, NULL, NULL);
+	g_object_unref (enumerator);
+
+	if (error == NULL)
+	{
+		/* The children that do not exist anymore */
+		if (cached != NULL && g_hash_table_size (cached) > 0)
+		{
+			async_node_push_removed (async, cached);
+			changed = TRUE;
+		}
+
+		/* Only the directories that are slow to enumerate are cached,
+		   they are then kept up to date */
+		if (changed &&
+		    (cached != NULL || g_get_monotonic_time () - start >= DIRECTORY_CACHE_MIN_USEC))
+		{
+			gedit_file_browser_listing_cache_write (async->location, listing);
+		}
+	}
+
+	g_clear_pointer (&cached, g_hash_table_unref);
+	g_ptr_array_unref (listing);
+
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_boolean (task, TRUE);
+}
+
+static FileBrowserNode *
+file_browser_node_new_from_entry (GeditFileBrowserStore *model,
+				  FileBrowserNode       *parent,
+				  LoadEntry             *entry)
+{
+	FileBrowserNode *node;
+
+	if (FILE_IS_DIR (entry->flags))
+		node = file_browser_node_dir_new (model, NULL, parent);
+	else
+		node = file_browser_node_new (NULL, parent);
+
+	node->file = g_steal_pointer (&entry->file);
+	node->name = g_steal_pointer (&entry->name);
+	node->markup = g_steal_pointer (&entry->markup);
+	node->collate_key = g_steal_pointer (&entry->collate_key);
+	node->flags |= entry->flags;
+
+	model_recomposite_icon_real (model, node, entry->info);
+	model_node_update_visibility (model, node);
+
+	return node;
+}
+
+/* Takes ownership of @nodes1 and @nodes2, both sorted. */
+static GPtrArray *
+merge_sorted_nodes (GeditFileBrowserStore *model,
+		    GPtrArray             *nodes1,
+		    GPtrArray             *nodes2)
+{
+	GPtrArray *merged;
+	guint pos1 = 0;
+	guint pos2 = 0;
+
+	if (nodes1 == NULL)
+		return nodes2;
+
+	merged = g_ptr_array_sized_new (nodes1->len + nodes2->len);
+
+	while (pos1 < nodes1->len || pos2 < nodes2->len)
+	{
+		if (pos2 == nodes2->len ||
+		    (pos1 < nodes1->len &&
+		     model->priv->sort_func (g_ptr_array_index (nodes1, pos1),
+					     g_ptr_array_index (nodes2, pos2)) <= 0))
+		{
+			g_ptr_array_add (merged, g_ptr_array_index (nodes1, pos1++));
+		}
+		else
+		{
+			g_ptr_array_add (merged, g_ptr_array_index (nodes2, pos2++));
+		}
+	}
+
+	g_ptr_array_unref (nodes1);
+	g_ptr_array_unref (nodes2);
+
+	return merged;
+}
+
+static void model_remove_nodes_batch (GeditFileBrowserStore *model,
+				      FileBrowserNode       *parent,
+				      GPtrArray             *nodes);
+
+static void
+collect_child_file (GHashTable *children,
+		    GFile      *file,
+		    GPtrArray  *removed)
+{
+	FileBrowserNode *node = g_hash_table_lookup (children, file);
+
+	/* A file can be both replaced and removed, remove its node once */
+	if (node != NULL)
+	{
+		g_hash_table_remove (children, file);
+		g_ptr_array_add (removed, node);
+	}
+}
+
+/* Removes the nodes of the cached listing that @chunk replaces or removes. */
+static void
+model_reconcile_chunk (GeditFileBrowserStore *model,
+		       FileBrowserNode       *parent,
+		       LoadChunk             *chunk)
+{
+	FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (parent);
+	GPtrArray *removed;
+
+	/* Look up the children once for all the chunks of the loading, the
+	   nodes of the cached listing are all added by the first chunk */
+	if (dir->reconcile_nodes == NULL)
+	{
+		dir->reconcile_nodes = g_hash_table_new_full (g_file_hash,
+							      (GEqualFunc) g_file_equal,
+							      g_object_unref,
+							      NULL);
+
+		for (guint i = 0; i < dir->children->len; i++)
+		{
+			FileBrowserNode *child = dir_get_child (dir, i);
+
+			if (child->file != NULL)
+				g_hash_table_insert (dir->reconcile_nodes, g_object_ref (child->file), child);
+		}
+	}
+
+	removed = g_ptr_array_new ();
+
+	for (guint i = 0; i < chunk->entries->len; i++)
+	{
+		LoadEntry *entry = g_ptr_array_index (chunk->entries, i);
+
+		if (entry->replace)
+			collect_child_file (dir->reconcile_nodes, entry->file, removed);
+	}
+
+	if (chunk->removed != NULL)
+	{
+		for (guint i = 0; i < chunk->removed->len; i++)
+			collect_child_file (dir->reconcile_nodes, g_ptr_array_index (chunk->removed, i), removed);
+	}
+
+	model_remove_nodes_batch (model, parent, removed);
+}
+
+static void
+model_directory_loaded (AsyncNode *async)
+{
+	FileBrowserNodeDir *dir = async->dir;
+	FileBrowserNode *parent = (FileBrowserNode *)dir;
+
+	/* We're done loading */
+	g_object_unref (dir->cancellable);
+	dir->cancellable = NULL;
+
+	dir_clear_reconcile_nodes (parent);
+
+/*
+ * FIXME: This is temporarly, it is a bug in gio:
+ * http://bugzilla.gnome.org/show_bug.cgi?id=565924
+ */
+#ifndef G_OS_WIN32
+	if (g_file_is_native (parent->file) && dir->monitor == NULL)
+	{
+		dir->monitor = g_file_monitor_directory (parent->file,
+							 G_FILE_MONITOR_NONE,
+							 NULL,
+							 NULL);
+		if (dir->monitor != NULL)
+		{
+			g_signal_connect (dir->monitor,
+					  "changed",
+					  G_CALLBACK (on_directory_monitor_event),
+					  parent);
+		}
+	}
+#endif
+
+	model_check_dummy (dir->model, parent);
+	model_end_loading (dir->model, parent);
+}
+
+static gboolean
+dispatch_load_chunks_cb (gpointer user_data)
+{
+	AsyncNode *async = user_data;
+	GeditFileBrowserStore *model;
+	FileBrowserNode *parent;
+	GPtrArray *nodes = NULL;
+	gboolean sorted;
+	gint64 deadline;
+	gboolean done;
+
+	/* The directory may be freed already */
+	if (g_cancellable_is_cancelled (async->cancellable))
+		return G_SOURCE_REMOVE;
+
+	parent = (FileBrowserNode *)async->dir;
+	model = async->dir->model;
+	sorted = model->priv->sort_func == model_sort_default;
+	deadline = g_get_monotonic_time () + DIRECTORY_LOAD_BATCH_USEC;
+
+	while (g_get_monotonic_time () < deadline)
+	{
+		LoadChunk *chunk;
+		GPtrArray *chunk_nodes;
+
+		g_mutex_lock (&async->mutex);
+		chunk = g_queue_peek_head (&async->chunks);
+		g_mutex_unlock (&async->mutex);
+
+		if (chunk == NULL)
+			break;
+
+		if (chunk->reconcile && chunk->pos == 0)
+		{
+			/* The nodes to replace may still be pending */
+			if (nodes != NULL)
+				model_add_nodes_batch (model, g_steal_pointer (&nodes), parent, sorted);
+
+			model_reconcile_chunk (model, parent, chunk);
+
+			if (g_cancellable_is_cancelled (async->cancellable))
+				return G_SOURCE_REMOVE;
+		}
+
+		chunk_nodes = g_ptr_array_new ();
+
+		while (chunk->pos < chunk->entries->len &&
+		       g_get_monotonic_time () < deadline)
+		{
+			LoadEntry *entry = g_ptr_array_index (chunk->entries, chunk->pos++);
+
+			g_ptr_array_add (chunk_nodes,
+					 file_browser_node_new_from_entry (model, parent, entry));
+		}
+
+		if (chunk->pos == chunk->entries->len)
+		{
+			g_mutex_lock (&async->mutex);
+			g_queue_pop_head (&async->chunks);
+			g_mutex_unlock (&async->mutex);
+
+			load_chunk_free (chunk);
+		}
+
+		nodes = merge_sorted_nodes (model, nodes, chunk_nodes);
+	}
+
+	if (nodes != NULL && nodes->len > 0)
+		model_add_nodes_batch (model, nodes, parent, sorted);
+	else if (nodes != NULL)
+		g_ptr_array_unref (nodes);
+
+	/* A handler of the row-inserted signal may have unloaded the
+	   directory */
+	if (g_cancellable_is_cancelled (async->cancellable))
+		return G_SOURCE_REMOVE;
+
+	g_mutex_lock (&async->mutex);
+	done = g_queue_is_empty (&async->chunks);
+
+	if (done)
+		async->dispatch_pending = FALSE;
+
+	g_mutex_unlock (&async->mutex);
+
+	if (!done)
+		return G_SOURCE_CONTINUE;
+
+	if (async->enumerated)
+		model_directory_loaded (async);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+load_directory_cb (GObject      *source_object,
+		   GAsyncResult *result,
+		   gpointer      user_data)
+{
+	AsyncNode *async = user_data;
+	FileBrowserNodeDir *dir = async->dir;
+	GError *error = NULL;
+
+	g_task_propagate_boolean (G_TASK (result), &error);
+
+	/* Simply return if we were cancelled, the directory may be freed */
+	if (g_cancellable_is_cancelled (async->cancellable))
+	{
+		g_clear_error (&error);
+	}
+	else if (error != NULL)
+	{
+		/* Otherwise handle the error appropriately */
+		g_signal_emit (dir->model,
+			       model_signals[ERROR],
+			       0,
+			       GEDIT_FILE_BROWSER_ERROR_LOAD_DIRECTORY,
+			       error->message);
+
+		file_browser_node_unload (dir->model, (FileBrowserNode *)dir, TRUE);
+		g_error_free (error);
+	}
+	else
+	{
+		gboolean dispatch_pending;
+
+		async->enumerated = TRUE;
+
+		g_mutex_lock (&async->mutex);
+		dispatch_pending = async->dispatch_pending;
+		g_mutex_unlock (&async->mutex);
+
+		/* Otherwise the last dispatch finishes the loading */
+		if (!dispatch_pending)
+			model_directory_loaded (async);
+	}
+
+	async_node_release (async);
+}
+
+static void
+model_load_directory (GeditFileBrowserStore *model,
+		      FileBrowserNode       *node)
+{
+	FileBrowserNodeDir *dir;
+	AsyncNode *async;
+	GTask *task;
+
+	g_return_if_fail (NODE_IS_DIR (node));
+
+	dir = FILE_BROWSER_NODE_DIR (node);
+
+	/* Cancel a previous load */
+	if (dir->cancellable != NULL)
+		file_browser_node_unload (dir->model, node, TRUE);
+
+	node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_LOADED;
+	model_begin_loading (model, node);
+
+	dir->cancellable = g_cancellable_new ();
+
+	async = g_atomic_rc_box_new0 (AsyncNode);
+	async->dir = dir;
+	async->cancellable = g_object_ref (dir->cancellable);
+	async->location = g_object_ref (node->file);
+	async->context = g_main_context_ref_thread_default ();
+	async->original_files = g_hash_table_new_full (g_file_hash,
+						       (GEqualFunc) g_file_equal,
+						       g_object_unref,
+						       NULL);
+	g_mutex_init (&async->mutex);
+	g_queue_init (&async->chunks);
+
+	for (guint i = 0; i < dir->children->len; i++)
+	{
+		FileBrowserNode *child = dir_get_child (dir, i);
+
+		if (child->file != NULL)
+			g_hash_table_add (async->original_files, g_object_ref (child->file));
+	}
+
+	/* Start loading in a worker thread */
+	task = g_task_new (NULL, async->cancellable, load_directory_cb, async);
+	g_task_set_task_data (task,
+			      g_atomic_rc_box_acquire (async),
+			      (GDestroyNotify) async_node_release);
+	g_task_run_in_thread (task, load_directory_thread);
+	g_object_unref (task);
+}
+
+/* Directory monitoring.
+ *
+ * The events of the monitor of a directory are coalesced in a queue of the
+ * children that changed, for a short window. The queue is then flushed: the
+ * children are queried in a worker thread, and the main thread applies the
+ * result in one go, the removed nodes with one pass over the children and the
+ * new nodes with one sorted merge.
+ */
+
+typedef struct
+{
+	/* Element type: owned GFile. */
+	GPtrArray *files;
+
+	/* The children that exist. Element type: owned LoadEntry, sorted. */
+	GPtrArray *entries;
+
+	/* The children that do not exist anymore. Element type: owned GFile. */
+	GPtrArray *removed;
+} MonitorFlush;
+
+static void
+monitor_flush_free (MonitorFlush *flush)
+{
+	if (flush != NULL)
+	{
+		g_ptr_array_unref (flush->files);
+		g_ptr_array_unref (flush->entries);
+		g_ptr_array_unref (flush->removed);
+		g_free (flush);
+	}
+}
+
+static void model_schedule_monitor_flush (FileBrowserNodeDir *dir);
+
+/* Not notified for each event, not to add to the cost of an event storm. */
+static void
+model_notify_monitor_stats (GeditFileBrowserStore *model)
+{
+	g_object_notify (G_OBJECT (model), "monitor-queue-depth");
+	g_object_notify (G_OBJECT (model), "monitor-events-dropped");
+}
+
+static void
+model_clear_monitor_queue (GeditFileBrowserStore *model,
+			   FileBrowserNodeDir    *dir)
+{
+	g_clear_handle_id (&dir->monitor_timeout_id, g_source_remove);
+
+	if (dir->monitor_cancellable != NULL)
+	{
+		g_cancellable_cancel (dir->monitor_cancellable);
+		g_clear_object (&dir->monitor_cancellable);
+	}
+
+	if (dir->monitor_queue != NULL)
+	{
+		model->priv->monitor_queue_depth -= g_hash_table_size (dir->monitor_queue);
+		g_clear_pointer (&dir->monitor_queue, g_hash_table_unref);
+		model_notify_monitor_stats (model);
+	}
+}
+
+static void
+monitor_flush_thread (GTask        *task,
+		      gpointer      source_object,
+		      gpointer      task_data,
+		      GCancellable *cancellable)
+{
+	MonitorFlush *flush = task_data;
+
+	for (guint i = 0; i < flush->files->len; i++)
+	{
+		GFile *file = g_ptr_array_index (flush->files, i);
+		GFileInfo *info;
+
+		if (g_cancellable_is_cancelled (cancellable))
+			break;
+
+		info = g_file_query_info (file,
+					  LOAD_ATTRIBUTE_TYPES,
+					  G_FILE_QUERY_INFO_NONE,
+					  cancellable,
+					  NULL);
+
+		if (info != NULL && file_info_is_listed (info))
+			g_ptr_array_add (flush->entries, load_entry_new_for_file (file, info));
+		else
+			g_ptr_array_add (flush->removed, g_object_ref (file));
+
+		g_clear_object (&info);
+	}
+
+	g_ptr_array_sort (flush->entries, compare_load_entries);
+
+	if (!g_task_return_error_if_cancelled (task))
+		g_task_return_boolean (task, TRUE);
+}
+
+static void
+model_update_node_from_entry (GeditFileBrowserStore *model,
+			      FileBrowserNode       *node,
+			      LoadEntry             *entry)
+{
+	guint flags = GEDIT_FILE_BROWSER_STORE_FLAG_IS_HIDDEN |
+		      GEDIT_FILE_BROWSER_STORE_FLAG_IS_TEXT;
+	GtkTreePath *path;
+
+	node->flags = (node->flags & ~flags) | (entry->flags & flags);
+	model_recomposite_icon_real (model, node, entry->info);
+
+	model_refilter_node (model, node, NULL);
+
+	if (model_node_visibility (model, node))
+	{
+		GtkTreeIter iter;
+
+		iter.user_data = node;
+		path = gedit_file_browser_store_get_path_real (model, node);
+		row_changed (model, &path, &iter);
+		gtk_tree_path_free (path);
+	}
+}
+
+/* Removes and frees @nodes, children of @parent, with one pass over the
+ * children of @parent. Takes ownership of @nodes.
+ */
+static void
+model_remove_nodes_batch (GeditFileBrowserStore *model,
+			  FileBrowserNode       *parent,
+			  GPtrArray             *nodes)
+{
+	FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (parent);
+	GPtrArray *deferred;
+	GHashTable *removed;
+	GHashTableIter iter;
+	FileBrowserNode *node;
+	guint n = 0;
+
+	removed = g_hash_table_new (NULL, NULL);
+	deferred = g_ptr_array_new ();
+
+	for (guint i = 0; i < nodes->len; i++)
+	{
+		GtkTreePath *path;
+
+		node = g_ptr_array_index (nodes, i);
+
+		/* The virtual root moves up, let model_remove_node() do it
+		   once the others are removed */
+		if (node == model->priv->virtual_root ||
+		    node_has_parent (model->priv->virtual_root, node))
+		{
+			g_ptr_array_add (deferred, node);
+			continue;
+		}
+
+		/* The rows are deleted first, the children array is only
+		   changed once at the end so that the paths stay valid */
+		path = gedit_file_browser_store_get_path_real (model, node);
+		model_remove_node_children (model, node, path, TRUE);
+
+		if (model_node_visibility (model, node))
+			row_deleted (model, node, path);
+
+		gtk_tree_path_free (path);
+		g_hash_table_add (removed, node);
+	}
+
+	if (g_hash_table_size (removed) > 0)
+	{
+		for (guint i = 0; i < dir->children->len; i++)
+		{
+			FileBrowserNode *child = dir_get_child (dir, i);
+
+			if (!g_hash_table_contains (removed, child))
+			{
+				child->index = n;
+				dir->children->pdata[n++] = child;
+			}
+		}
+
+		g_ptr_array_set_size (dir->children, n);
+		dir_invalidate_visible_index (parent);
+
+		if (model_node_visibility (model, parent))
+			model_check_dummy (model, parent);
+	}
+
+	g_hash_table_iter_init (&iter, removed);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &node, NULL))
+		file_browser_node_free (model, node);
+
+	for (guint i = 0; i < deferred->len; i++)
+		model_remove_node (model, g_ptr_array_index (deferred, i), NULL, TRUE);
+
+	g_hash_table_unref (removed);
+	g_ptr_array_unref (deferred);
+	g_ptr_array_unref (nodes);
+}
+
+static void
+monitor_flush_cb (GObject      *source_object,
+		  GAsyncResult *result,
+		  gpointer      user_data)
+{
+	FileBrowserNodeDir *dir = user_data;
+	FileBrowserNode *parent = (FileBrowserNode *)dir;
+	GeditFileBrowserStore *model;
+	MonitorFlush *flush = g_task_get_task_data (G_TASK (result));
+	GHashTable *children;
+	GPtrArray *removed;
+	GPtrArray *added;
+
+	/* The directory may be freed already */
+	if (!g_task_propagate_boolean (G_TASK (result), NULL))
+		return;
+
+	model = dir->model;
+	g_clear_object (&dir->monitor_cancellable);
+
+	/* Look up all the children at once */
+	children = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
+
+	for (guint i = 0; i < dir->children->len; i++)
+	{
+		FileBrowserNode *child = dir_get_child (dir, i);
+
+		if (child->file != NULL)
+			g_hash_table_insert (children, child->file, child);
+	}
+
+	removed = g_ptr_array_new ();
+	added = g_ptr_array_new ();
+
+	for (guint i = 0; i < flush->removed->len; i++)
+	{
+		FileBrowserNode *node = g_hash_table_lookup (children, g_ptr_array_index (flush->removed, i));
+
+		if (node != NULL)
+			g_ptr_array_add (removed, node);
+	}
 
-	for (GList *item = files; item; item = item->next)
+	for (guint i = 0; i < flush->entries->len; i++)
 	{
-		GFileInfo *info = G_FILE_INFO (item->data);
-		GFileType type = g_file_info_get_file_type (info);
-		gchar const *name;
-		GFile *file;
-		FileBrowserNode *node;
+		LoadEntry *entry = g_ptr_array_index (flush->entries, i);
+		FileBrowserNode *node = g_hash_table_lookup (children, entry->file);
 
-		/* Skip all non regular, non directory files */
-		if (type != G_FILE_TYPE_REGULAR &&
-		    type != G_FILE_TYPE_DIRECTORY &&
-		    type != G_FILE_TYPE_SYMBOLIC_LINK)
+		if (node != NULL && NODE_IS_DIR (node) == FILE_IS_DIR (entry->flags))
 		{
-			g_object_unref (info);
+			model_update_node_from_entry (model, node, entry);
 			continue;
 		}
 
-		name = g_file_info_get_name (info);
+		/* A file replaced by a directory, or the other way around */
+		if (node != NULL)
+			g_ptr_array_add (removed, node);
+
+		g_ptr_array_add (added, file_browser_node_new_from_entry (model, parent, entry));
+	}
 
-		/* Skip '.' and '..' directories */
-		if (type == G_FILE_TYPE_DIRECTORY &&
-		    (strcmp (name, ".") == 0 ||
-		     strcmp (name, "..") == 0))
-		{
-			g_object_unref (info);
-			continue;
-		}
+	g_hash_table_unref (children);
 
-		file = g_file_get_child (parent->file, name);
-		if (!(node = node_list_contains_file (original_children, file)))
-		{
-			if (type == G_FILE_TYPE_DIRECTORY)
-				node = file_browser_node_dir_new (model, file, parent);
-			else
-				node = file_browser_node_new (file, parent);
+	model_remove_nodes_batch (model, parent, removed);
 
-			file_browser_node_set_from_info (model, node, info, FALSE);
+	if (added->len > 0)
+		model_add_nodes_batch (model, added, parent, model->priv->sort_func == model_sort_default);
+	else
+		g_ptr_array_unref (added);
+
+	if (g_signal_has_handler_pending (model, model_signals[FILES_CHANGED], 0, FALSE))
+	{
+		GPtrArray *changed = g_ptr_array_sized_new (flush->entries->len);
+
+		for (guint i = 0; i < flush->entries->len; i++)
+		{
+			LoadEntry *entry = g_ptr_array_index (flush->entries, i);
 
-			nodes = g_slist_prepend (nodes, node);
+			g_ptr_array_add (changed, entry->file);
 		}
 
-		g_object_unref (file);
-		g_object_unref (info);
+		g_signal_emit (model, model_signals[FILES_CHANGED], 0, changed, flush->removed);
+		g_ptr_array_unref (changed);
 	}
 
-	if (nodes)
-		model_add_nodes_batch (model, nodes, parent);
+	/* The events received in the meantime */
+	if (dir->monitor_queue != NULL &&
+	    g_hash_table_size (dir->monitor_queue) > 0 &&
+	    dir->monitor_timeout_id == 0)
+	{
+		model_schedule_monitor_flush (dir);
+	}
 }
 
-static FileBrowserNode *
-model_add_node_from_dir (GeditFileBrowserStore *model,
-			 FileBrowserNode       *parent,
-			 GFile                 *file)
+static gboolean
+monitor_flush_timeout_cb (FileBrowserNodeDir *dir)
 {
-	FileBrowserNode *node;
+	GeditFileBrowserStore *model = dir->model;
+	MonitorFlush *flush;
+	GHashTableIter iter;
+	GFile *file;
+	GTask *task;
 
-	/* Check if it already exists */
-	if ((node = node_list_contains_file (FILE_BROWSER_NODE_DIR (parent)->children, file)) == NULL)
-	{
-		node = file_browser_node_dir_new (model, file, parent);
-		file_browser_node_set_from_info (model, node, NULL, FALSE);
+	dir->monitor_timeout_id = 0;
 
-		if (node->name == NULL)
-			file_browser_node_set_name (node);
+	/* Wait for the previous flush */
+	if (dir->monitor_cancellable != NULL)
+		return G_SOURCE_REMOVE;
 
-		node->icon_name = g_strdup ("folder-symbolic");
+	flush = g_new0 (MonitorFlush, 1);
+	flush->files = g_ptr_array_new_with_free_func (g_object_unref);
+	flush->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) load_entry_free);
+	flush->removed = g_ptr_array_new_with_free_func (g_object_unref);
 
-		model_add_node (model, node, parent);
+	g_hash_table_iter_init (&iter, dir->monitor_queue);
+
+	while (g_hash_table_iter_next (&iter, (gpointer *) &file, NULL))
+	{
+		g_ptr_array_add (flush->files, file);
+		g_hash_table_iter_steal (&iter);
 	}
 
-	return node;
+	model->priv->monitor_queue_depth -= flush->files->len;
+	model_notify_monitor_stats (model);
+
+	dir->monitor_cancellable = g_cancellable_new ();
+
+	task = g_task_new (NULL, dir->monitor_cancellable, monitor_flush_cb, dir);
+	g_task_set_task_data (task, flush, (GDestroyNotify) monitor_flush_free);
+	g_task_run_in_thread (task, monitor_flush_thread);
+	g_object_unref (task);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+model_schedule_monitor_flush (FileBrowserNodeDir *dir)
+{
+	dir->monitor_timeout_id = g_timeout_add (MONITOR_COALESCE_MSEC,
+						 (GSourceFunc) monitor_flush_timeout_cb,
+						 dir);
 }
 
 static void
@@ -2193,196 +3611,53 @@ on_directory_monitor_event (GFileMonitor      *monitor,
 			    FileBrowserNode   *parent)
 {
 	FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (parent);
-	FileBrowserNode *node;
+	GeditFileBrowserStore *model = dir->model;
 
 	switch (event_type)
 	{
 		case G_FILE_MONITOR_EVENT_DELETED:
-			node = node_list_contains_file (dir->children, file);
-
-			if (node != NULL)
-				model_remove_node (dir->model, node, NULL, TRUE);
-			break;
 		case G_FILE_MONITOR_EVENT_CREATED:
-			if (g_file_query_exists (file, NULL))
-				model_add_node_from_file (dir->model, parent, file, NULL);
-
+		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+		case G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED:
 			break;
 		default:
-			break;
+			/* Followed by one of the above, or not shown */
+			model->priv->monitor_events_dropped++;
+			return;
 	}
-}
-
-static void
-async_node_free (AsyncNode *async)
-{
-	g_object_unref (async->cancellable);
-	g_slist_free (async->original_children);
-	g_slice_free (AsyncNode, async);
-}
-
-static void
-model_iterate_next_files_cb (GFileEnumerator *enumerator,
-			     GAsyncResult    *result,
-			     AsyncNode       *async)
-{
-	GError *error = NULL;
-	GList *files = g_file_enumerator_next_files_finish (enumerator, result, &error);
-	FileBrowserNodeDir *dir = async->dir;
-	FileBrowserNode *parent = (FileBrowserNode *)dir;
-
-	if (files == NULL)
-	{
-		g_file_enumerator_close (enumerator, NULL, NULL);
-		g_object_unref (enumerator);
-		async_node_free (async);
-
-		if (!error)
-		{
-			/* We're done loading */
-			g_object_unref (dir->cancellable);
-			dir->cancellable = NULL;
-
-/*
- * FIXME: This is temporarly, it is a bug in gio:
- * http://bugzilla.gnome.org/show_bug.cgi?id=565924
- */
-#ifndef G_OS_WIN32
-			if (g_file_is_native (parent->file) && dir->monitor == NULL)
-			{
-				dir->monitor = g_file_monitor_directory (parent->file,
-									 G_FILE_MONITOR_NONE,
-									 NULL,
-									 NULL);
-				if (dir->monitor != NULL)
-				{
-					g_signal_connect (dir->monitor,
-							  "changed",
-							  G_CALLBACK (on_directory_monitor_event),
-							  parent);
-				}
-			}
-#endif
-
-			model_check_dummy (dir->model, parent);
-			model_end_loading (dir->model, parent);
-		}
-		else
-		{
-			/* Simply return if we were cancelled */
-			if (error->domain == G_IO_ERROR && error->code == G_IO_ERROR_CANCELLED)
-				return;
-
-			/* Otherwise handle the error appropriately */
-			g_signal_emit (dir->model,
-				       model_signals[ERROR],
-				       0,
-				       GEDIT_FILE_BROWSER_ERROR_LOAD_DIRECTORY,
-				       error->message);
 
-			file_browser_node_unload (dir->model, (FileBrowserNode *)parent, TRUE);
-			g_error_free (error);
-		}
-	}
-	else if (g_cancellable_is_cancelled (async->cancellable))
-	{
-		/* Check cancel state manually */
-		g_file_enumerator_close (enumerator, NULL, NULL);
-		g_object_unref (enumerator);
-		async_node_free (async);
-	}
-	else
+	if (dir->monitor_queue == NULL)
 	{
-		model_add_nodes_from_files (dir->model, parent, async->original_children, files);
-
-		g_list_free (files);
-		next_files_async (enumerator, async);
+		dir->monitor_queue = g_hash_table_new_full (g_file_hash,
+							    (GEqualFunc) g_file_equal,
+							    g_object_unref,
+							    NULL);
 	}
-}
-
-static void
-next_files_async (GFileEnumerator *enumerator,
-		  AsyncNode       *async)
-{
-	g_file_enumerator_next_files_async (enumerator,
-					    DIRECTORY_LOAD_ITEMS_PER_CALLBACK,
-					    G_PRIORITY_DEFAULT,
-					    async->cancellable,
-					    (GAsyncReadyCallback)model_iterate_next_files_cb,
-					    async);
-}
-
-static void
-model_iterate_children_cb (GFile        *file,
-			   GAsyncResult *result,
-			   AsyncNode    *async)
-{
-	GError *error = NULL;
-	GFileEnumerator *enumerator;
 
-	if (g_cancellable_is_cancelled (async->cancellable))
+	/* The state of the file is queried when the queue is flushed, so the
+	   events of a file already in the queue are coalesced */
+	if (!g_hash_table_add (dir->monitor_queue, g_object_ref (file)))
 	{
-		async_node_free (async);
+		model->priv->monitor_events_dropped++;
 		return;
 	}
 
-	if (!(enumerator = g_file_enumerate_children_finish (file, result, &error)))
-	{
-		/* Simply return if we were cancelled or if the dir is not there */
-		FileBrowserNodeDir *dir = async->dir;
-
-		/* Otherwise handle the error appropriately */
-		g_signal_emit (dir->model,
-			       model_signals[ERROR],
-			       0,
-			       GEDIT_FILE_BROWSER_ERROR_LOAD_DIRECTORY,
-			       error->message);
+	model->priv->monitor_queue_depth++;
 
-		file_browser_node_unload (dir->model, (FileBrowserNode *)dir, TRUE);
-		g_error_free (error);
-		async_node_free (async);
+	if (g_hash_table_size (dir->monitor_queue) >= MONITOR_QUEUE_MAX &&
+	    dir->monitor_timeout_id != 0 &&
+	    dir->monitor_cancellable == NULL)
+	{
+		/* Do not wait for the end of the window */
+		g_source_remove (dir->monitor_timeout_id);
+		monitor_flush_timeout_cb (dir);
 	}
-	else
+	else if (dir->monitor_timeout_id == 0 && dir->monitor_cancellable == NULL)
 	{
-		next_files_async (enumerator, async);
+		model_schedule_monitor_flush (dir);
 	}
 }
 
-static void
-model_load_directory (GeditFileBrowserStore *model,
-		      FileBrowserNode       *node)
-{
-	FileBrowserNodeDir *dir;
-	AsyncNode *async;
-
-	g_return_if_fail (NODE_IS_DIR (node));
-
-	dir = FILE_BROWSER_NODE_DIR (node);
-
-	/* Cancel a previous load */
-	if (dir->cancellable != NULL)
-		file_browser_node_unload (dir->model, node, TRUE);
-
-	node->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_LOADED;
-	model_begin_loading (model, node);
-
-	dir->cancellable = g_cancellable_new ();
-
-	async = g_slice_new (AsyncNode);
-	async->dir = dir;
-	async->cancellable = g_object_ref (dir->cancellable);
-	async->original_children = g_slist_copy (dir->children);
-
-	/* Start loading async */
-	g_file_enumerate_children_async (node->file,
-					 STANDARD_ATTRIBUTE_TYPES,
-					 G_FILE_QUERY_INFO_NONE,
-					 G_PRIORITY_DEFAULT,
-					 async->cancellable,
-					 (GAsyncReadyCallback)model_iterate_children_cb,
-					 async);
-}
-
 static GList *
 get_parent_files (GeditFileBrowserStore *model,
 		  GFile                 *file)
@@ -2412,7 +3687,7 @@ model_fill (GeditFileBrowserStore  *model,
 {
 	gboolean free_path = FALSE;
 	GtkTreeIter iter = {0,};
-	GSList *item;
+	FileBrowserNodeDir *dir;
 	FileBrowserNode *child;
 
 	if (node == NULL)
@@ -2448,9 +3723,11 @@ model_fill (GeditFileBrowserStore  *model,
 		/* Go to the first child */
 		gtk_tree_path_down (*path);
 
-		for (item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
+		dir = FILE_BROWSER_NODE_DIR (node);
+
+		for (guint i = 0; i < dir->children->len; i++)
 		{
-			child = (FileBrowserNode *) (item->data);
+			child = dir_get_child (dir, i);
 
 			if (model_node_visibility (model, child))
 			{
@@ -2479,21 +3756,19 @@ set_virtual_root_from_node (GeditFileBrowserStore *model,
 	FileBrowserNode *next = prev->parent;
 	FileBrowserNode *check;
 	FileBrowserNodeDir *dir;
-	GSList *copy;
 	GtkTreePath *empty = NULL;
 
 	/* Free all the nodes below that we don't need in cache */
 	while (prev != model->priv->root)
 	{
 		dir = FILE_BROWSER_NODE_DIR (next);
-		copy = g_slist_copy (dir->children);
 
-		for (GSList *item = copy; item; item = item->next)
+		if (prev == node)
 		{
-			check = (FileBrowserNode *)(item->data);
-
-			if (prev == node)
+			for (guint i = 0; i < dir->children->len; i++)
 			{
+				check = dir_get_child (dir, i);
+
 				/* Only free the children, keeping this depth in cache */
 				if (check != node)
 				{
@@ -2501,33 +3776,48 @@ set_virtual_root_from_node (GeditFileBrowserStore *model,
 					file_browser_node_unload (model, check, FALSE);
 				}
 			}
-			else if (check != prev)
+		}
+		else
+		{
+			GPtrArray *copy = g_ptr_array_copy (dir->children, NULL, NULL);
+
+			/* Only keep the node in the chain */
+			g_ptr_array_set_size (dir->children, 0);
+			g_ptr_array_add (dir->children, prev);
+			prev->index = 0;
+			dir_invalidate_visible_index (next);
+
+			for (guint i = 0; i < copy->len; i++)
 			{
-				/* Only free when the node is not in the chain */
-				dir->children = g_slist_remove (dir->children, check);
-				file_browser_node_free (model, check);
+				check = g_ptr_array_index (copy, i);
+
+				if (check != prev)
+					file_browser_node_free (model, check);
 			}
-		}
 
-		if (prev != node)
+			g_ptr_array_unref (copy);
 			file_browser_node_unload (model, next, FALSE);
+		}
 
-		g_slist_free (copy);
 		prev = next;
 		next = prev->parent;
 	}
 
 	/* Free all the nodes up that we don't need in cache */
-	for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
+	dir = FILE_BROWSER_NODE_DIR (node);
+
+	for (guint i = 0; i < dir->children->len; i++)
 	{
-		check = (FileBrowserNode *)(item->data);
+		check = dir_get_child (dir, i);
 
 		if (NODE_IS_DIR (check))
 		{
-			for (copy = FILE_BROWSER_NODE_DIR (check)->children; copy; copy = copy->next)
+			FileBrowserNodeDir *check_dir = FILE_BROWSER_NODE_DIR (check);
+
+			for (guint j = 0; j < check_dir->children->len; j++)
 			{
-				file_browser_node_free_children (model, (FileBrowserNode*) (copy->data));
-				file_browser_node_unload (model, (FileBrowserNode*) (copy->data), FALSE);
+				file_browser_node_free_children (model, dir_get_child (check_dir, j));
+				file_browser_node_unload (model, dir_get_child (check_dir, j), FALSE);
 			}
 		}
 		else if (NODE_IS_DUMMY (check))
@@ -2537,7 +3827,7 @@ set_virtual_root_from_node (GeditFileBrowserStore *model,
 	}
 
 	/* Now finally, set the virtual root, and load it up! */
-	model->priv->virtual_root = node;
+	model_set_virtual_root (model, node);
 
 	/* Notify that the virtual-root has changed before loading up new nodes so that the
 	   "root_changed" signal can be emitted before any "inserted" signals */
@@ -2590,9 +3880,9 @@ model_find_node_children (GeditFileBrowserStore *model,
 
 	dir = FILE_BROWSER_NODE_DIR (parent);
 
-	for (GSList *children = dir->children; children; children = children->next)
+	for (guint i = 0; i < dir->children->len; i++)
 	{
-		child = (FileBrowserNode *)(children->data);
+		child = dir_get_child (dir, i);
 
 		result = model_find_node (model, child, file);
 
@@ -2692,7 +3982,7 @@ handle_root_error (GeditFileBrowserStore *model,
 
 	/* Set the virtual root to the root */
 	root = model->priv->root;
-	model->priv->virtual_root = root;
+	model_set_virtual_root (model, root);
 
 	/* Set the root to be loaded */
 	root->flags |= GEDIT_FILE_BROWSER_STORE_FLAG_LOADED;
@@ -2813,13 +4103,71 @@ gedit_file_browser_store_new (GFile *root)
 	                                               NULL));
 }
 
+/* Returns whether the value of the node changed. */
+static gboolean
+model_node_set_value (GeditFileBrowserStore *tree_model,
+		      FileBrowserNode       *node,
+		      gint                   column,
+		      GValue                *value)
+{
+	if (column == GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP)
+	{
+		gchar *markup;
+
+		g_return_val_if_fail (G_VALUE_HOLDS_STRING (value), FALSE);
+
+		markup = g_value_dup_string (value);
+
+		if (!markup)
+			markup = g_markup_escape_text (node->name, -1);
+
+		if (g_strcmp0 (node->markup, markup) == 0)
+		{
+			g_free (markup);
+			return FALSE;
+		}
+
+		g_free (node->markup);
+		node->markup = markup;
+
+		return TRUE;
+	}
+	else if (column == GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM)
+	{
+		GdkPixbuf *emblem;
+		GIcon *gicon;
+
+		g_return_val_if_fail (G_VALUE_HOLDS_OBJECT (value), FALSE);
+
+		emblem = g_value_get_object (value);
+
+		g_return_val_if_fail (GDK_IS_PIXBUF (emblem) || emblem == NULL, FALSE);
+
+		if (node->file == NULL)
+			return FALSE;
+
+		if (node->icon != NULL && gedit_file_browser_icon_get_emblem (node->icon) == emblem)
+			return FALSE;
+
+		gicon = model_dup_gicon (node);
+		model_set_icon (node, gicon, emblem);
+		g_clear_object (&gicon);
+
+		return TRUE;
+	}
+
+	g_return_val_if_fail (column == GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP ||
+	                      column == GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM, FALSE);
+
+	return FALSE;
+}
+
 void
 gedit_file_browser_store_set_value (GeditFileBrowserStore *tree_model,
 				    GtkTreeIter           *iter,
 				    gint                   column,
 				    GValue                *value)
 {
-	gpointer data;
 	FileBrowserNode *node;
 	GtkTreePath *path;
 
@@ -2829,48 +4177,73 @@ gedit_file_browser_store_set_value (GeditFileBrowserStore *tree_model,
 
 	node = (FileBrowserNode *)(iter->user_data);
 
-	if (column == GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP)
+	if (model_node_set_value (tree_model, node, column, value) &&
+	    model_node_visibility (tree_model, node))
 	{
-		g_return_if_fail (G_VALUE_HOLDS_STRING (value));
-
-		data = g_value_dup_string (value);
-
-		if (!data)
-			data = g_strdup (node->name);
-
-		g_free (node->markup);
-		node->markup = data;
+		path = gedit_file_browser_store_get_path (GTK_TREE_MODEL (tree_model), iter);
+		row_changed (tree_model, &path, iter);
+		gtk_tree_path_free (path);
 	}
-	else if (column == GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM)
-	{
-		g_return_if_fail (G_VALUE_HOLDS_OBJECT (value));
-
-		data = g_value_get_object (value);
+}
 
-		g_return_if_fail (GDK_IS_PIXBUF (data) || data == NULL);
+/**
+ * gedit_file_browser_store_set_values:
+ * @tree_model: a #GeditFileBrowserStore.
+ * @column: the column to set, as for gedit_file_browser_store_set_value().
+ * @iters: (array length=n_values): the rows.
+ * @values: (array length=n_values): the value for each row.
+ * @n_values: the number of rows.
+ *
+ * Like gedit_file_browser_store_set_value() for many rows at once. The
+ * #GtkTreeModel::row-changed signal is emitted once per row, after all the
+ * values are set, and not for the rows whose value is unchanged.
+ */
+void
+gedit_file_browser_store_set_values (GeditFileBrowserStore *tree_model,
+				     gint                   column,
+				     GtkTreeIter           *iters,
+				     GValue                *values,
+				     guint                  n_values)
+{
+	GHashTable *changed;
+	GHashTableIter hash_iter;
+	gpointer node;
 
-		if (node->emblem)
-			g_object_unref (node->emblem);
+	g_return_if_fail (GEDIT_IS_FILE_BROWSER_STORE (tree_model));
+	g_return_if_fail (iters != NULL || n_values == 0);
+	g_return_if_fail (values != NULL || n_values == 0);
 
-		if (data)
-			node->emblem = g_object_ref (GDK_PIXBUF (data));
-		else
-			node->emblem = NULL;
+	changed = g_hash_table_new (NULL, NULL);
 
-		model_recomposite_icon (tree_model, iter);
-	}
-	else
+	for (guint i = 0; i < n_values; i++)
 	{
-		g_return_if_fail (column == GEDIT_FILE_BROWSER_STORE_COLUMN_MARKUP ||
-		                  column == GEDIT_FILE_BROWSER_STORE_COLUMN_EMBLEM);
+		if (iters[i].user_data == NULL)
+		{
+			g_warn_if_reached ();
+			continue;
+		}
+
+		if (model_node_set_value (tree_model, iters[i].user_data, column, &values[i]))
+			g_hash_table_add (changed, iters[i].user_data);
 	}
 
-	if (model_node_visibility (tree_model, node))
+	g_hash_table_iter_init (&hash_iter, changed);
+
+	while (g_hash_table_iter_next (&hash_iter, &node, NULL))
 	{
-		path = gedit_file_browser_store_get_path (GTK_TREE_MODEL (tree_model), iter);
-		row_changed (tree_model, &path, iter);
+		GtkTreeIter iter;
+		GtkTreePath *path;
+
+		if (!model_node_visibility (tree_model, node))
+			continue;
+
+		iter.user_data = node;
+		path = gedit_file_browser_store_get_path_real (tree_model, node);
+		gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_model), path, &iter);
 		gtk_tree_path_free (path);
 	}
+
+	g_hash_table_unref (changed);
 }
 
 GeditFileBrowserStoreResult
@@ -3046,7 +4419,7 @@ gedit_file_browser_store_set_root_and_virtual_root (GeditFileBrowserStore *model
 	file_browser_node_free (model, model->priv->root);
 
 	model->priv->root = NULL;
-	model->priv->virtual_root = NULL;
+	model_set_virtual_root (model, NULL);
 
 	if (root != NULL)
 	{
@@ -3129,11 +4502,13 @@ _gedit_file_browser_store_iter_collapsed (GeditFileBrowserStore *model,
 
 	if (NODE_IS_DIR (node) && NODE_LOADED (node))
 	{
+		FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (node);
+
 		/* Unload children of the children, keeping 1 depth in cache */
 
-		for (GSList *item = FILE_BROWSER_NODE_DIR (node)->children; item; item = item->next)
+		for (guint i = 0; i < dir->children->len; i++)
 		{
-			node = (FileBrowserNode *)(item->data);
+			node = dir_get_child (dir, i);
 
 			if (NODE_IS_DIR (node) && NODE_LOADED (node))
 			{
@@ -3189,32 +4564,43 @@ gedit_file_browser_store_set_binary_patterns (GeditFileBrowserStore  *model,
 {
 	g_return_if_fail (GEDIT_IS_FILE_BROWSER_STORE (model));
 
-	if (model->priv->binary_patterns != NULL)
-	{
-		g_strfreev (model->priv->binary_patterns);
-		g_ptr_array_unref (model->priv->binary_pattern_specs);
-	}
+	g_strfreev (model->priv->binary_patterns);
+	g_clear_pointer (&model->priv->binary_matcher, gedit_file_browser_matcher_free);
 
 	model->priv->binary_patterns = g_strdupv ((gchar **)binary_patterns);
 
-	if (binary_patterns == NULL)
-	{
-		model->priv->binary_pattern_specs = NULL;
-	}
-	else
-	{
-		gssize n_patterns = g_strv_length ((gchar **) binary_patterns);
+	if (binary_patterns != NULL)
+		model->priv->binary_matcher = gedit_file_browser_matcher_new (binary_patterns);
+
+	model_refilter (model);
+
+	g_object_notify (G_OBJECT (model), "binary-patterns");
+}
+
+/**
+ * gedit_file_browser_store_set_filter_pattern:
+ * @model: a #GeditFileBrowserStore.
+ * @pattern: (nullable): a glob pattern, or %NULL.
+ *
+ * Filters the files, but not the directories, whose name does not match
+ * @pattern.
+ */
+void
+gedit_file_browser_store_set_filter_pattern (GeditFileBrowserStore *model,
+					     const gchar           *pattern)
+{
+	g_return_if_fail (GEDIT_IS_FILE_BROWSER_STORE (model));
+
+	g_clear_pointer (&model->priv->filter_matcher, gedit_file_browser_matcher_free);
 
-		model->priv->binary_pattern_specs = g_ptr_array_sized_new (n_patterns);
-		g_ptr_array_set_free_func (model->priv->binary_pattern_specs, (GDestroyNotify) g_pattern_spec_free);
+	if (pattern != NULL)
+	{
+		const gchar *patterns[] = { pattern, NULL };
 
-		for (guint i = 0; binary_patterns[i] != NULL; ++i)
-			g_ptr_array_add (model->priv->binary_pattern_specs, g_pattern_spec_new (binary_patterns[i]));
+		model->priv->filter_matcher = gedit_file_browser_matcher_new (patterns);
 	}
 
 	model_refilter (model);
-
-	g_object_notify (G_OBJECT (model), "binary-patterns");
 }
 
 void
@@ -3266,8 +4652,10 @@ reparent_node (FileBrowserNode *node,
 	{
 		FileBrowserNodeDir *dir = FILE_BROWSER_NODE_DIR (node);
 
-		for (GSList *child = dir->children; child; child = child->next)
-			reparent_node ((FileBrowserNode *)child->data, TRUE);
+		dir_clear_reconcile_nodes (node);
+
+		for (guint i = 0; i < dir->children->len; i++)
+			reparent_node (dir_get_child (dir, i), TRUE);
 	}
 }
 
@@ -3306,6 +4694,7 @@ gedit_file_browser_store_rename (GeditFileBrowserStore  *model,
 	{
 		previous = node->file;
 		node->file = file;
+		dir_clear_reconcile_nodes (node->parent);
 
 		/* This makes sure the actual info for the node is requeried */
 		file_browser_node_set_name (node);
@@ -117,6 +117,9 @@ struct _GeditFileBrowserStoreClass {
 	                             GFile                 *location);
 	void (* before_row_deleted) (GeditFileBrowserStore *model,
 	                             GtkTreePath           *path);
+	void (* files_changed)      (GeditFileBrowserStore *model,
+	                             GPtrArray             *changed,
+	                             GPtrArray             *removed);
 };
 
 GType                            gedit_file_browser_store_get_type                       (void) G_GNUC_CONST;
@@ -146,6 +149,11 @@ void                             gedit_file_browser_store_set_value
                                                                                           GtkTreeIter                      *iter,
                                                                                           gint                              column,
                                                                                           GValue                           *value);
+void                             gedit_file_browser_store_set_values                     (GeditFileBrowserStore            *tree_model,
+                                                                                          gint                              column,
+                                                                                          GtkTreeIter                      *iters,
+                                                                                          GValue                           *values,
+                                                                                          guint                             n_values);
 void                             _gedit_file_browser_store_iter_expanded                 (GeditFileBrowserStore            *model,
                                                                                           GtkTreeIter                      *iter);
 void                             _gedit_file_browser_store_iter_collapsed                (GeditFileBrowserStore            *model,
@@ -159,6 +167,8 @@ void                             gedit_file_browser_store_set_filter_func
 const gchar * const             *gedit_file_browser_store_get_binary_patterns            (GeditFileBrowserStore            *model);
 void                             gedit_file_browser_store_set_binary_patterns            (GeditFileBrowserStore            *model,
                                                                                           const gchar                     **binary_patterns);
+void                             gedit_file_browser_store_set_filter_pattern             (GeditFileBrowserStore            *model,
+                                                                                          const gchar                      *pattern);
 void                             gedit_file_browser_store_refilter                       (GeditFileBrowserStore            *model);
 GeditFileBrowserStoreFilterMode  gedit_file_browser_store_filter_mode_get_default        (void);
 void                             gedit_file_browser_store_refresh                        (GeditFileBrowserStore            *model);
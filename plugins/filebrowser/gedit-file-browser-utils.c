@@ -220,4 +220,106 @@ gedit_file_browser_utils_confirmation_dialog (GeditWindow    *window,
 	return (ret == GTK_RESPONSE_OK);
 }
 
+static gchar const *
+backup_content_type (GFileInfo *info)
+{
+	if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP) &&
+	    g_file_info_get_is_backup (info))
+	{
+		gchar const *content = g_file_info_get_content_type (info);
+
+		if (content == NULL || g_content_type_equals (content, "application/x-trash"))
+		{
+			return "text/plain";
+		}
+
+		return content;
+	}
+
+	return NULL;
+}
+
+static gboolean
+content_type_is_text (gchar const *content_type)
+{
+#ifdef G_OS_WIN32
+	gchar *mime;
+	gboolean ret;
+#endif
+
+	if (!content_type || g_content_type_is_unknown (content_type))
+		return TRUE;
+
+#ifndef G_OS_WIN32
+	return (g_content_type_is_a (content_type, "text/plain") ||
+		g_content_type_equals (content_type, "application/x-zerosize"));
+#else
+	if (g_content_type_is_a (content_type, "text"))
+		return TRUE;
+
+	/* This covers a rare case in which on Windows the PerceivedType is
+	   not set to "text" but the Content Type is set to text/plain */
+	mime = g_content_type_get_mime_type (content_type);
+	ret = g_strcmp0 (mime, "text/plain") == 0;
+	g_free (mime);
+
+	return ret;
+#endif
+}
+
+/* Can be called in a worker thread. */
+gboolean
+gedit_file_browser_utils_file_info_is_hidden (GFileInfo *info)
+{
+	return ((g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN) &&
+		 g_file_info_get_is_hidden (info)) ||
+		(g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP) &&
+		 g_file_info_get_is_backup (info)));
+}
+
+/* Can be called in a worker thread. */
+gboolean
+gedit_file_browser_utils_file_info_is_text (GFileInfo *info)
+{
+	gchar const *content;
+
+	if (!(content = backup_content_type (info)))
+		content = g_file_info_get_content_type (info);
+
+	return content_type_is_text (content);
+}
+
+/* Can be called in a worker thread. For the enumerations of a whole tree:
+   @info has the fast content type, guessed from the name, instead of the
+   content type, as sniffing the content of all the files would dominate the
+   enumeration. */
+gboolean
+gedit_file_browser_utils_file_info_is_filtered (GFileInfo                       *info,
+						GeditFileBrowserStoreFilterMode  filter_mode,
+						GeditFileBrowserMatcher         *binary_matcher)
+{
+	const gchar *content_type;
+
+	if ((filter_mode & GEDIT_FILE_BROWSER_STORE_FILTER_MODE_HIDE_HIDDEN) &&
+	    gedit_file_browser_utils_file_info_is_hidden (info))
+	{
+		return TRUE;
+	}
+
+	if (!(filter_mode & GEDIT_FILE_BROWSER_STORE_FILTER_MODE_HIDE_BINARY) ||
+	    g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY)
+	{
+		return FALSE;
+	}
+
+	content_type = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE);
+
+	if (content_type != NULL)
+		g_file_info_set_content_type (info, content_type);
+
+	return (!gedit_file_browser_utils_file_info_is_text (info) ||
+		(binary_matcher != NULL &&
+		 gedit_file_browser_matcher_match (binary_matcher, g_file_info_get_name (info))));
+}
+
 /* ex:set ts=8 noet: */
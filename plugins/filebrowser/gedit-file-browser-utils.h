@@ -23,6 +23,8 @@
 
 #include <gedit/gedit-window.h>
 #include <gio/gio.h>
+#include "gedit-file-browser-store.h"
+#include "gedit-file-browser-matcher.h"
 
 gchar           *gedit_file_browser_utils_name_from_themed_icon         (GIcon          *icon);
 GdkPixbuf	*gedit_file_browser_utils_pixbuf_from_theme	        (gchar const    *name,
@@ -35,6 +37,11 @@ GdkPixbuf	*gedit_file_browser_utils_pixbuf_from_file        	(GFile          *fi
 									 gboolean        use_symbolic);
 gchar           *gedit_file_browser_utils_symbolic_icon_name_from_file  (GFile *file);
 gchar		*gedit_file_browser_utils_file_basename		        (GFile          *file);
+gboolean	 gedit_file_browser_utils_file_info_is_hidden	        (GFileInfo      *info);
+gboolean	 gedit_file_browser_utils_file_info_is_text	        (GFileInfo      *info);
+gboolean	 gedit_file_browser_utils_file_info_is_filtered	        (GFileInfo                       *info,
+									 GeditFileBrowserStoreFilterMode  filter_mode,
+									 GeditFileBrowserMatcher         *binary_matcher);
 
 gboolean	 gedit_file_browser_utils_confirmation_dialog	        (GeditWindow    *window,
 									 GtkMessageType  type,
@@ -141,8 +141,6 @@ struct _GeditFileBrowserWidgetPrivate
 
 	GSList                  *filter_funcs;
 	gulong                   filter_id;
-	gulong                   glob_filter_id;
-	GPatternSpec            *filter_pattern;
 	gchar                   *filter_pattern_str;
 
 	GList                   *locations;
@@ -1036,10 +1034,6 @@ gedit_file_browser_widget_init (GeditFileBrowserWidget *obj)
 	gedit_file_browser_store_set_filter_mode (obj->priv->file_store,
 						  GEDIT_FILE_BROWSER_STORE_FILTER_MODE_HIDE_HIDDEN |
 						  GEDIT_FILE_BROWSER_STORE_FILTER_MODE_HIDE_BINARY);
-	gedit_file_browser_store_set_filter_func (obj->priv->file_store,
-						  (GeditFileBrowserStoreFilterFunc) filter_real,
-						  obj);
-
 	g_signal_connect (obj->priv->treeview, "notify::model",
 			  G_CALLBACK (on_model_set), obj);
 	g_signal_connect (obj->priv->treeview, "error",
@@ -1237,33 +1231,6 @@ popup_menu (GeditFileBrowserWidget *obj,
 	return TRUE;
 }
 
-static gboolean
-filter_glob (GeditFileBrowserWidget *obj,
-	     GeditFileBrowserStore  *store,
-	     GtkTreeIter            *iter,
-	     gpointer                user_data)
-{
-	gchar *name;
-	gboolean result;
-	guint flags;
-
-	if (obj->priv->filter_pattern == NULL)
-		return TRUE;
-
-	gtk_tree_model_get (GTK_TREE_MODEL (store), iter,
-			    GEDIT_FILE_BROWSER_STORE_COLUMN_NAME, &name,
-			    GEDIT_FILE_BROWSER_STORE_COLUMN_FLAGS, &flags,
-			    -1);
-
-	if (FILE_IS_DIR (flags) || FILE_IS_DUMMY (flags))
-		result = TRUE;
-	else
-		result = g_pattern_spec_match_string (obj->priv->filter_pattern, name);
-
-	g_free (name);
-	return result;
-}
-
 static void
 rename_selected_file (GeditFileBrowserWidget *obj)
 {
@@ -1574,8 +1541,6 @@ set_filter_pattern_real (GeditFileBrowserWidget *obj,
                         gchar const             *pattern,
                         gboolean                 update_entry)
 {
-	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (obj->priv->treeview));
-
 	if (pattern != NULL && *pattern == '\0')
 		pattern = NULL;
 
@@ -1593,36 +1558,11 @@ set_filter_pattern_real (GeditFileBrowserWidget *obj,
 	else
 		obj->priv->filter_pattern_str = g_strdup (pattern);
 
-	if (obj->priv->filter_pattern)
-	{
-		g_pattern_spec_free (obj->priv->filter_pattern);
-		obj->priv->filter_pattern = NULL;
-	}
-
-	if (pattern == NULL)
-	{
-		if (obj->priv->glob_filter_id != 0)
-		{
-			gedit_file_browser_widget_remove_filter (obj, obj->priv->glob_filter_id);
-			obj->priv->glob_filter_id = 0;
-		}
-	}
-	else
-	{
-		obj->priv->filter_pattern = g_pattern_spec_new (pattern);
-
-		if (obj->priv->glob_filter_id == 0)
-			obj->priv->glob_filter_id = gedit_file_browser_widget_add_filter (obj,
-											  filter_glob,
-											  NULL,
-											  NULL);
-	}
-
 	if (update_entry)
 		gtk_entry_set_text (GTK_ENTRY (obj->priv->filter_entry), obj->priv->filter_pattern_str);
 
-	if (GEDIT_IS_FILE_BROWSER_STORE (model))
-		gedit_file_browser_store_refilter (GEDIT_FILE_BROWSER_STORE (model));
+	/* Matched by the store directly on the names of the nodes */
+	gedit_file_browser_store_set_filter_pattern (obj->priv->file_store, pattern);
 
 	g_object_notify (G_OBJECT (obj), "filter-pattern");
 }
@@ -1756,8 +1696,17 @@ gedit_file_browser_widget_add_filter (GeditFileBrowserWidget           *obj,
 
 	obj->priv->filter_funcs = g_slist_append (obj->priv->filter_funcs, f);
 
-	if (GEDIT_IS_FILE_BROWSER_STORE (model))
+	/* The store only calls back when there are filters */
+	if (obj->priv->filter_funcs->next == NULL)
+	{
+		gedit_file_browser_store_set_filter_func (obj->priv->file_store,
+							  (GeditFileBrowserStoreFilterFunc) filter_real,
+							  obj);
+	}
+	else if (GEDIT_IS_FILE_BROWSER_STORE (model))
+	{
 		gedit_file_browser_store_refilter (GEDIT_FILE_BROWSER_STORE (model));
+	}
 
 	return f->id;
 }
@@ -1777,9 +1726,13 @@ gedit_file_browser_widget_remove_filter (GeditFileBrowserWidget *obj,
 			if (func->destroy_notify)
 				func->destroy_notify (func->user_data);
 
-			obj->priv->filter_funcs = g_slist_remove_link (obj->priv->filter_funcs, item);
+			obj->priv->filter_funcs = g_slist_delete_link (obj->priv->filter_funcs, item);
 
 			filter_func_free (func);
+
+			if (obj->priv->filter_funcs == NULL)
+				gedit_file_browser_store_set_filter_func (obj->priv->file_store, NULL, NULL);
+
 			break;
 		}
 	}
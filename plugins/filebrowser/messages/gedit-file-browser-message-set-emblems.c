@@ -0,0 +1,127 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "gedit-file-browser-message-set-emblems.h"
+
+/* The batch version of set_emblem: the emblem of ids[i] is emblems[i], an
+ * empty string removes the emblem.
+ */
+
+enum
+{
+	PROP_0,
+
+	PROP_IDS,
+	PROP_EMBLEMS,
+};
+
+struct _GeditFileBrowserMessageSetEmblemsPrivate
+{
+	gchar **ids;
+	gchar **emblems;
+};
+
+G_DEFINE_TYPE_EXTENDED (GeditFileBrowserMessageSetEmblems,
+                        gedit_file_browser_message_set_emblems,
+                        GEDIT_TYPE_MESSAGE,
+                        0,
+                        G_ADD_PRIVATE (GeditFileBrowserMessageSetEmblems))
+
+static void
+gedit_file_browser_message_set_emblems_finalize (GObject *obj)
+{
+	GeditFileBrowserMessageSetEmblems *msg = GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS (obj);
+
+	g_strfreev (msg->priv->ids);
+	g_strfreev (msg->priv->emblems);
+
+	G_OBJECT_CLASS (gedit_file_browser_message_set_emblems_parent_class)->finalize (obj);
+}
+
+static void
+gedit_file_browser_message_set_emblems_get_property (GObject    *obj,
+                                                     guint       prop_id,
+                                                     GValue     *value,
+                                                     GParamSpec *pspec)
+{
+	GeditFileBrowserMessageSetEmblems *msg;
+
+	msg = GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS (obj);
+
+	switch (prop_id)
+	{
+		case PROP_IDS:
+			g_value_set_boxed (value, msg->priv->ids);
+			break;
+		case PROP_EMBLEMS:
+			g_value_set_boxed (value, msg->priv->emblems);
+			break;
+	}
+}
+
+static void
+gedit_file_browser_message_set_emblems_set_property (GObject      *obj,
+                                                     guint         prop_id,
+                                                     GValue const *value,
+                                                     GParamSpec   *pspec)
+{
+	GeditFileBrowserMessageSetEmblems *msg;
+
+	msg = GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS (obj);
+
+	switch (prop_id)
+	{
+		case PROP_IDS:
+		{
+			g_strfreev (msg->priv->ids);
+			msg->priv->ids = g_value_dup_boxed (value);
+			break;
+		}
+		case PROP_EMBLEMS:
+		{
+			g_strfreev (msg->priv->emblems);
+			msg->priv->emblems = g_value_dup_boxed (value);
+			break;
+		}
+	}
+}
+
+static void
+gedit_file_browser_message_set_emblems_class_init (GeditFileBrowserMessageSetEmblemsClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->finalize = gedit_file_browser_message_set_emblems_finalize;
+
+	object_class->get_property = gedit_file_browser_message_set_emblems_get_property;
+	object_class->set_property = gedit_file_browser_message_set_emblems_set_property;
+
+	g_object_class_install_property (object_class,
+	                                 PROP_IDS,
+	                                 g_param_spec_boxed ("ids",
+	                                                     "Ids",
+	                                                     "Ids",
+	                                                     G_TYPE_STRV,
+	                                                     G_PARAM_READWRITE |
+	                                                     G_PARAM_CONSTRUCT |
+	                                                     G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class,
+	                                 PROP_EMBLEMS,
+	                                 g_param_spec_boxed ("emblems",
+	                                                     "Emblems",
+	                                                     "Emblems",
+	                                                     G_TYPE_STRV,
+	                                                     G_PARAM_READWRITE |
+	                                                     G_PARAM_CONSTRUCT |
+	                                                     G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gedit_file_browser_message_set_emblems_init (GeditFileBrowserMessageSetEmblems *message)
+{
+	message->priv = gedit_file_browser_message_set_emblems_get_instance_private (message);
+}
@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_H
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_H
+
+#include <gedit/gedit-message.h>
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS            (gedit_file_browser_message_set_emblems_get_type ())
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS,\
+                                                                GeditFileBrowserMessageSetEmblems))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_CONST(obj)      (G_TYPE_CHECK_INSTANCE_CAST ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS,\
+                                                                GeditFileBrowserMessageSetEmblems const))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS,\
+                                                                GeditFileBrowserMessageSetEmblemsClass))
+#define GEDIT_IS_FILE_BROWSER_MESSAGE_SET_EMBLEMS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS))
+#define GEDIT_IS_FILE_BROWSER_MESSAGE_SET_EMBLEMS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_EMBLEMS,\
+                                                                GeditFileBrowserMessageSetEmblemsClass))
+
+typedef struct _GeditFileBrowserMessageSetEmblems        GeditFileBrowserMessageSetEmblems;
+typedef struct _GeditFileBrowserMessageSetEmblemsClass   GeditFileBrowserMessageSetEmblemsClass;
+typedef struct _GeditFileBrowserMessageSetEmblemsPrivate GeditFileBrowserMessageSetEmblemsPrivate;
+
+struct _GeditFileBrowserMessageSetEmblems
+{
+	GeditMessage parent;
+
+	GeditFileBrowserMessageSetEmblemsPrivate *priv;
+};
+
+struct _GeditFileBrowserMessageSetEmblemsClass
+{
+	GeditMessageClass parent_class;
+};
+
+GType gedit_file_browser_message_set_emblems_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_MESSAGE_SET_EMBLEMS_H */
@@ -0,0 +1,127 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "gedit-file-browser-message-set-markups.h"
+
+/* The batch version of set_markup: the markup of ids[i] is markups[i], an
+ * empty string resets the markup to the name.
+ */
+
+enum
+{
+	PROP_0,
+
+	PROP_IDS,
+	PROP_MARKUPS,
+};
+
+struct _GeditFileBrowserMessageSetMarkupsPrivate
+{
+	gchar **ids;
+	gchar **markups;
+};
+
+G_DEFINE_TYPE_EXTENDED (GeditFileBrowserMessageSetMarkups,
+                        gedit_file_browser_message_set_markups,
+                        GEDIT_TYPE_MESSAGE,
+                        0,
+                        G_ADD_PRIVATE (GeditFileBrowserMessageSetMarkups))
+
+static void
+gedit_file_browser_message_set_markups_finalize (GObject *obj)
+{
+	GeditFileBrowserMessageSetMarkups *msg = GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS (obj);
+
+	g_strfreev (msg->priv->ids);
+	g_strfreev (msg->priv->markups);
+
+	G_OBJECT_CLASS (gedit_file_browser_message_set_markups_parent_class)->finalize (obj);
+}
+
+static void
+gedit_file_browser_message_set_markups_get_property (GObject    *obj,
+                                                     guint       prop_id,
+                                                     GValue     *value,
+                                                     GParamSpec *pspec)
+{
+	GeditFileBrowserMessageSetMarkups *msg;
+
+	msg = GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS (obj);
+
+	switch (prop_id)
+	{
+		case PROP_IDS:
+			g_value_set_boxed (value, msg->priv->ids);
+			break;
+		case PROP_MARKUPS:
+			g_value_set_boxed (value, msg->priv->markups);
+			break;
+	}
+}
+
+static void
+gedit_file_browser_message_set_markups_set_property (GObject      *obj,
+                                                     guint         prop_id,
+                                                     GValue const *value,
+                                                     GParamSpec   *pspec)
+{
+	GeditFileBrowserMessageSetMarkups *msg;
+
+	msg = GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS (obj);
+
+	switch (prop_id)
+	{
+		case PROP_IDS:
+		{
+			g_strfreev (msg->priv->ids);
+			msg->priv->ids = g_value_dup_boxed (value);
+			break;
+		}
+		case PROP_MARKUPS:
+		{
+			g_strfreev (msg->priv->markups);
+			msg->priv->markups = g_value_dup_boxed (value);
+			break;
+		}
+	}
+}
+
+static void
+gedit_file_browser_message_set_markups_class_init (GeditFileBrowserMessageSetMarkupsClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->finalize = gedit_file_browser_message_set_markups_finalize;
+
+	object_class->get_property = gedit_file_browser_message_set_markups_get_property;
+	object_class->set_property = gedit_file_browser_message_set_markups_set_property;
+
+	g_object_class_install_property (object_class,
+	                                 PROP_IDS,
+	                                 g_param_spec_boxed ("ids",
+	                                                     "Ids",
+	                                                     "Ids",
+	                                                     G_TYPE_STRV,
+	                                                     G_PARAM_READWRITE |
+	                                                     G_PARAM_CONSTRUCT |
+	                                                     G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property (object_class,
+	                                 PROP_MARKUPS,
+	                                 g_param_spec_boxed ("markups",
+	                                                     "Markups",
+	                                                     "Markups",
+	                                                     G_TYPE_STRV,
+	                                                     G_PARAM_READWRITE |
+	                                                     G_PARAM_CONSTRUCT |
+	                                                     G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gedit_file_browser_message_set_markups_init (GeditFileBrowserMessageSetMarkups *message)
+{
+	message->priv = gedit_file_browser_message_set_markups_get_instance_private (message);
+}
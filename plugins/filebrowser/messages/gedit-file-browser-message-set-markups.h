@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2026 - The gedit Team
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_H
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_H
+
+#include <gedit/gedit-message.h>
+
+G_BEGIN_DECLS
+
+#define GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS            (gedit_file_browser_message_set_markups_get_type ())
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS,\
+                                                                GeditFileBrowserMessageSetMarkups))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_CONST(obj)      (G_TYPE_CHECK_INSTANCE_CAST ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS,\
+                                                                GeditFileBrowserMessageSetMarkups const))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS,\
+                                                                GeditFileBrowserMessageSetMarkupsClass))
+#define GEDIT_IS_FILE_BROWSER_MESSAGE_SET_MARKUPS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS))
+#define GEDIT_IS_FILE_BROWSER_MESSAGE_SET_MARKUPS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS))
+#define GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),\
+                                                                GEDIT_TYPE_FILE_BROWSER_MESSAGE_SET_MARKUPS,\
+                                                                GeditFileBrowserMessageSetMarkupsClass))
+
+typedef struct _GeditFileBrowserMessageSetMarkups        GeditFileBrowserMessageSetMarkups;
+typedef struct _GeditFileBrowserMessageSetMarkupsClass   GeditFileBrowserMessageSetMarkupsClass;
+typedef struct _GeditFileBrowserMessageSetMarkupsPrivate GeditFileBrowserMessageSetMarkupsPrivate;
+
+struct _GeditFileBrowserMessageSetMarkups
+{
+	GeditMessage parent;
+
+	GeditFileBrowserMessageSetMarkupsPrivate *priv;
+};
+
+struct _GeditFileBrowserMessageSetMarkupsClass
+{
+	GeditMessageClass parent_class;
+};
+
+GType gedit_file_browser_message_set_markups_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* GEDIT_FILE_BROWSER_MESSAGE_SET_MARKUPS_H */
@@ -9,7 +9,9 @@
 #include "gedit-file-browser-message-id.h"
 #include "gedit-file-browser-message-id-location.h"
 #include "gedit-file-browser-message-set-emblem.h"
+#include "gedit-file-browser-message-set-emblems.h"
 #include "gedit-file-browser-message-set-markup.h"
+#include "gedit-file-browser-message-set-markups.h"
 #include "gedit-file-browser-message-set-root.h"
 
 #endif /* GEDIT_FILE_BROWER_MESSAGES_MESSAGES_H */